@@ -13,10 +13,12 @@
  */
 #include <glog/logging.h>
 
+#include <limits>
 #include <utility>
 #include <vector>
 #include <string>
 #include <memory>
+#include <cstring>
 
 #include "arrow_all_to_all.hpp"
 #include "../ctx/arrow_memory_pool_utils.hpp"
@@ -36,7 +38,12 @@ ArrowAllToAll::ArrowAllToAll(std::shared_ptr<cylon::CylonContext> &ctx,
   pool_ = cylon::ToArrowPool(ctx);
   completed_ = false;
   finishCalled_ = false;
-  allocator_ = new ArrowAllocator(pool_);
+  allocator_ = new ArrowAllocator(pool_, std::stoll(ctx->GetConfig(
+      CylonContext::ALLTOALL_RECEIVE_REGION_BYTES_CONFIG, std::to_string(8 << 20))));
+  packThreshold_ = std::stoll(ctx->GetConfig(CylonContext::ALLTOALL_PACK_THRESHOLD_CONFIG,
+                                             std::to_string(1 << 20)));
+  maxTargetBytes_ = std::stoll(ctx->GetConfig(CylonContext::ALLTOALL_MAX_TARGET_BYTES_CONFIG,
+                                              std::to_string(64LL << 20)));
 
   // we need to pass the correct arguments
   all_ = std::make_shared<AllToAll>(ctx, source, targets, edgeId, this, allocator_);
@@ -57,14 +64,186 @@ int ArrowAllToAll::insert(const std::shared_ptr<arrow::Table> &arrow, int32_t ta
   return insert(arrow, target, -1);
 }
 
+/**
+ * @return total size of the buffers of the table
+ */
+static int64_t TableBytes(const std::shared_ptr<arrow::Table> &table) {
+  int64_t bytes = 0;
+  for (const auto &column : table->columns()) {
+    for (const auto &chunk : column->chunks()) {
+      for (const auto &buffer : chunk->data()->buffers) {
+        if (buffer != nullptr) {
+          bytes += buffer->size();
+        }
+      }
+    }
+  }
+  return bytes;
+}
+
+// largest length and row count the int headers and message lengths can carry
+static constexpr int64_t kMaxHeaderValue = std::numeric_limits<int>::max();
+
+/**
+ * @return true if the length of every array and the size of every buffer of the table fit in the
+ * headers, so that the table can be sent column by column
+ */
+static bool FitsHeaders(const std::shared_ptr<arrow::Table> &table) {
+  for (const auto &column : table->columns()) {
+    for (const auto &chunk : column->chunks()) {
+      if (chunk->length() > kMaxHeaderValue) {
+        return false;
+      }
+      for (const auto &buffer : chunk->data()->buffers) {
+        if (buffer != nullptr && buffer->size() > kMaxHeaderValue) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// the buffers of a packed table are aligned to this many bytes
+static constexpr int64_t kPackAlignment = 64;
+
+static inline int64_t PackPadded(int64_t bytes) {
+  return (bytes + kPackAlignment - 1) / kPackAlignment * kPackAlignment;
+}
+
+/**
+ * Copy the buffers of a table in to a single buffer. The buffer starts with a descriptor of int64
+ * values: the number of columns, for every column its number of chunks, for every chunk its
+ * length, offset, null count and number of buffers, and for every buffer its offset in the packed
+ * buffer and its size (-1 for a missing buffer). The buffers follow the descriptor, each aligned
+ * to kPackAlignment bytes
+ * @param table
+ * @param pool
+ * @param packed
+ * @return
+ */
+static arrow::Status PackTable(const std::shared_ptr<arrow::Table> &table,
+                               arrow::MemoryPool *pool,
+                               std::shared_ptr<arrow::Buffer> *packed) {
+  int64_t descriptor_values = 1;
+  int64_t data_bytes = 0;
+  for (const auto &column : table->columns()) {
+    descriptor_values++;
+    for (const auto &chunk : column->chunks()) {
+      const auto &buffers = chunk->data()->buffers;
+      descriptor_values += 4 + 2 * static_cast<int64_t>(buffers.size());
+      for (const auto &buffer : buffers) {
+        if (buffer != nullptr) {
+          data_bytes += PackPadded(buffer->size());
+        }
+      }
+    }
+  }
+
+  const int64_t descriptor_bytes = PackPadded(descriptor_values * sizeof(int64_t));
+  arrow::Status status = arrow::AllocateBuffer(pool, descriptor_bytes + data_bytes, packed);
+  if (!status.ok()) {
+    return status;
+  }
+  uint8_t *base = (*packed)->mutable_data();
+  auto *descriptor = reinterpret_cast<int64_t *>(base);
+  int64_t d = 0;
+  int64_t offset = descriptor_bytes;
+  descriptor[d++] = table->num_columns();
+  for (const auto &column : table->columns()) {
+    descriptor[d++] = column->num_chunks();
+    for (const auto &chunk : column->chunks()) {
+      const std::shared_ptr<arrow::ArrayData> &data = chunk->data();
+      descriptor[d++] = data->length;
+      descriptor[d++] = data->offset;
+      descriptor[d++] = chunk->null_count();
+      descriptor[d++] = static_cast<int64_t>(data->buffers.size());
+      for (const auto &buffer : data->buffers) {
+        if (buffer == nullptr) {
+          descriptor[d++] = 0;
+          descriptor[d++] = -1;
+        } else {
+          descriptor[d++] = offset;
+          descriptor[d++] = buffer->size();
+          std::memcpy(base + offset, buffer->data(), buffer->size());
+          offset += PackPadded(buffer->size());
+        }
+      }
+    }
+  }
+  return arrow::Status::OK();
+}
+
+/**
+ * Create a table from a buffer packed by PackTable. The arrays refer to slices of the packed
+ * buffer, nothing is copied
+ * @param schema
+ * @param packed
+ * @return the table
+ */
+static std::shared_ptr<arrow::Table> UnpackTable(const std::shared_ptr<arrow::Schema> &schema,
+                                                 const std::shared_ptr<arrow::Buffer> &packed) {
+  const auto *descriptor = reinterpret_cast<const int64_t *>(packed->data());
+  int64_t d = 0;
+  const int64_t columns = descriptor[d++];
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> chunked_arrays;
+  chunked_arrays.reserve(columns);
+  for (int64_t c = 0; c < columns; c++) {
+    const std::shared_ptr<arrow::DataType> &type = schema->field(c)->type();
+    const int64_t chunks = descriptor[d++];
+    arrow::ArrayVector arrays;
+    arrays.reserve(chunks);
+    for (int64_t a = 0; a < chunks; a++) {
+      const int64_t length = descriptor[d++];
+      const int64_t offset = descriptor[d++];
+      const int64_t null_count = descriptor[d++];
+      const int64_t num_buffers = descriptor[d++];
+      std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+      buffers.reserve(num_buffers);
+      for (int64_t b = 0; b < num_buffers; b++) {
+        const int64_t buffer_offset = descriptor[d++];
+        const int64_t buffer_size = descriptor[d++];
+        buffers.push_back(buffer_size < 0 ? nullptr
+                                          : arrow::SliceBuffer(packed, buffer_offset,
+                                                               buffer_size));
+      }
+      arrays.push_back(arrow::MakeArray(arrow::ArrayData::Make(type, length, std::move(buffers),
+                                                               null_count, offset)));
+    }
+    chunked_arrays.push_back(std::make_shared<arrow::ChunkedArray>(std::move(arrays), type));
+  }
+  return arrow::Table::Make(schema, chunked_arrays);
+}
+
 int ArrowAllToAll::insert(std::shared_ptr<arrow::Table> arrow, int32_t target, int32_t reference) {
-  // todo: check weather we have enough memory
   // lets save the table into pending and move on
+  if (!FitsHeaders(arrow)) {
+    return 0;
+  }
   std::shared_ptr<PendingSendTable> st = inputs_[target];
+  const int64_t bytes = TableBytes(arrow);
+  // a table larger than the limit is accepted once the queue of the target is empty
+  if (maxTargetBytes_ > 0 && st->bytes > 0 && st->bytes + bytes > maxTargetBytes_) {
+    return -1;
+  }
+  inFlightBytes_ += bytes;
+  st->bytes += bytes;
   st->pending.push(std::make_pair(arrow, reference));
   return 1;
 }
 
+int64_t ArrowAllToAll::inFlightBytes() const {
+  return inFlightBytes_;
+}
+
+uint64_t ArrowAllToAll::events() {
+  return all_->events();
+}
+
+void ArrowAllToAll::waitForEvents() {
+  all_->waitForEvents();
+}
+
 bool ArrowAllToAll::isComplete() {
   if (completed_) {
     return true;
@@ -72,12 +251,43 @@ bool ArrowAllToAll::isComplete() {
   bool isAllEmpty = true;
   // we need to send the buffers
   for (const auto &t : inputs_) {
-    if (t.second->status == ARROW_HEADER_INIT) {
-      if (!t.second->pending.empty()) {
-        t.second->currentTable = t.second->pending.front();
+    // small tables go as a single packed message
+    while (t.second->status == ARROW_HEADER_INIT && !t.second->pending.empty()) {
+      const auto &next = t.second->pending.front();
+      const int64_t bytes = TableBytes(next.first);
+      // a threshold of 0 disables packing, even for empty tables. The row count and the packed
+      // size have to fit in the header and the message length
+      std::shared_ptr<arrow::Buffer> packed;
+      if (packThreshold_ > 0 && bytes <= packThreshold_
+          && next.first->num_rows() <= kMaxHeaderValue) {
+        arrow::Status status = PackTable(next.first, pool_, &packed);
+        if (!status.ok()) {
+          LOG(FATAL) << "Failed to pack table " << status.ToString();
+        }
+        if (packed->size() > kMaxHeaderValue) {
+          packed.reset();
+        }
+      }
+      if (packed == nullptr) {
+        t.second->currentTable = next;
         t.second->pending.pop();
         t.second->status = ARROW_HEADER_COLUMN_CONTINUE;
+        break;
       }
+
+      int hdr[6];
+      hdr[0] = ARROW_PACKED_TABLE;
+      hdr[1] = 0;
+      hdr[2] = 1;
+      hdr[3] = next.first->num_columns();
+      hdr[4] = static_cast<int>(next.first->num_rows());
+      hdr[5] = next.second;
+      if (all_->insert(packed->mutable_data(), static_cast<int>(packed->size()), t.first,
+                       hdr, 6) <= 0) {
+        break;
+      }
+      t.second->inFlight.emplace(next.first, packed, 1, bytes);
+      t.second->pending.pop();
     }
 
     if (t.second->status == ARROW_HEADER_COLUMN_CONTINUE) {
@@ -94,6 +304,9 @@ bool ArrowAllToAll::isComplete() {
           std::shared_ptr<arrow::ArrayData> data = arr->data();
           while (static_cast<size_t>(t.second->bufferIndex) < data->buffers.size()) {
             std::shared_ptr<arrow::Buffer> buf = data->buffers[t.second->bufferIndex];
+            // arrays without nulls may not have a validity bitmap, those are sent empty
+            uint8_t *buf_data = buf == nullptr ? nullptr : buf->mutable_data();
+            int buf_size = buf == nullptr ? 0 : static_cast<int>(buf->size());
             int hdr[6];
             hdr[0] = t.second->columnIndex;
             hdr[1] = t.second->bufferIndex;
@@ -102,13 +315,13 @@ bool ArrowAllToAll::isComplete() {
             hdr[4] = data->length;
             hdr[5] = t.second->currentTable.second;
             // lets send this buffer, we need to send the length at this point
-            bool accept = all_->insert(buf->mutable_data(),
-                                       static_cast<int>(buf->size()), t.first, hdr, 6);
+            bool accept = all_->insert(buf_data, buf_size, t.first, hdr, 6) > 0;
             if (!accept) {
               canContinue = false;
               break;
             }
             t.second->bufferIndex++;
+            t.second->buffersSent++;
           }
           // if we can continue, that means we are finished with this array
           if (canContinue) {
@@ -125,6 +338,16 @@ bool ArrowAllToAll::isComplete() {
 
       // if we are at this stage, we have sent everything for this , so lets resets
       if (canContinue) {
+        // keep the table until its buffers are sent
+        const std::shared_ptr<arrow::Table> &sent = t.second->currentTable.first;
+        if (t.second->buffersSent > 0) {
+          t.second->inFlight.emplace(sent, nullptr, t.second->buffersSent, TableBytes(sent));
+        } else {
+          inFlightBytes_ -= TableBytes(sent);
+          t.second->bytes -= TableBytes(sent);
+        }
+        t.second->currentTable = {};
+        t.second->buffersSent = 0;
         t.second->columnIndex = 0;
         t.second->arrayIndex = 0;
         t.second->bufferIndex = 0;
@@ -172,6 +395,15 @@ bool ArrowAllToAll::onReceive(int source, std::shared_ptr<Buffer> buffer, int le
   receivedBuffers_++;
   // create the buffer hosting the value
   std::shared_ptr<arrow::Buffer> buf = std::dynamic_pointer_cast<ArrowBuffer>(buffer)->getBuf();
+  if (table->packed) {
+    table->packed = false;
+    recv_callback_->onReceive(source, UnpackTable(schema_, buf), table->reference);
+    return true;
+  }
+  // an empty validity bitmap means the array has no nulls
+  if (table->bufferIndex == 0 && length == 0) {
+    buf = nullptr;
+  }
   table->buffers.push_back(buf);
   // now check weather we have the expected number of buffers received
   if (table->noBuffers == table->bufferIndex + 1) {
@@ -212,6 +444,11 @@ bool ArrowAllToAll::onReceiveHeader(int source, int fin, int *buffer, int length
     }
 
     std::shared_ptr<PendingReceiveTable> table = receives_[source];
+    if (buffer[0] == ARROW_PACKED_TABLE) {
+      table->packed = true;
+      table->reference = buffer[5];
+      return true;
+    }
     table->columnIndex = buffer[0];
     table->bufferIndex = buffer[1];
     table->noBuffers = buffer[2];
@@ -225,7 +462,17 @@ bool ArrowAllToAll::onReceiveHeader(int source, int fin, int *buffer, int length
 }
 
 bool ArrowAllToAll::onSendComplete(int target, void *buffer, int length) {
-//    pool_->Free((uint8_t *)buffer, length);
+  // the buffers of a target are sent in order, so this is a buffer of the oldest table in flight
+  std::shared_ptr<PendingSendTable> st = inputs_[target];
+  if (st->inFlight.empty()) {
+    return false;
+  }
+  auto &table = st->inFlight.front();
+  if (--std::get<2>(table) == 0) {
+    inFlightBytes_ -= std::get<3>(table);
+    st->bytes -= std::get<3>(table);
+    st->inFlight.pop();
+  }
   return false;
 }
 
@@ -239,7 +486,30 @@ Status ArrowAllocator::Allocate(int64_t length, std::shared_ptr<Buffer> *buffer)
   return Status::OK();
 }
 
-ArrowAllocator::ArrowAllocator(arrow::MemoryPool *pool) : pool(pool) {}
+Status ArrowAllocator::AllocateForSource(int source, int64_t length,
+                                         std::shared_ptr<Buffer> *buffer) {
+  // large messages would waste most of a region
+  if (region_bytes <= 0 || length > region_bytes / 4) {
+    return Allocate(length, buffer);
+  }
+
+  const int64_t padded = PackPadded(length);
+  Region &region = regions[source];
+  if (region.buffer == nullptr || region.used + padded > region.buffer->size()) {
+    arrow::Status status = arrow::AllocateBuffer(pool, region_bytes, &region.buffer);
+    if (status != arrow::Status::OK()) {
+      return Status(static_cast<int>(status.code()), status.message());
+    }
+    region.used = 0;
+  }
+  *buffer = std::make_shared<ArrowBuffer>(
+      arrow::SliceMutableBuffer(region.buffer, region.used, length));
+  region.used += padded;
+  return Status::OK();
+}
+
+ArrowAllocator::ArrowAllocator(arrow::MemoryPool *pool, int64_t region_bytes)
+    : pool(pool), region_bytes(region_bytes) {}
 
 ArrowAllocator::~ArrowAllocator() = default;
 
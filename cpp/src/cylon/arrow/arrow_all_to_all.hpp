@@ -17,6 +17,9 @@
 
 #include <arrow/api.h>
 #include <arrow/table.h>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
 
 #include "../net/buffer.hpp"
 #include "../net/ops/all_to_all.hpp"
@@ -39,6 +42,8 @@ struct PendingSendTable {
   int target{};
   // pending tables to be sent with it's reference
   std::queue<std::pair<std::shared_ptr<arrow::Table>, int32_t>> pending{};
+  // bytes of the tables inserted for this target and not completely sent
+  int64_t bytes{};
 
   // keep the current table, reference pair
   std::pair<std::shared_ptr<arrow::Table>, int32_t> currentTable{};
@@ -51,6 +56,13 @@ struct PendingSendTable {
   int arrayIndex{};
   // the current buffer inde
   int bufferIndex{};
+  // number of buffers of the current table handed to the all to all
+  int buffersSent{};
+
+  // tables handed to the all to all, with their packed buffer (if packed), the number of their
+  // buffers not sent yet and their size. they are kept alive until all the buffers are sent
+  std::queue<std::tuple<std::shared_ptr<arrow::Table>, std::shared_ptr<arrow::Buffer>, int,
+                        int64_t>> inFlight{};
 };
 
 struct PendingReceiveTable {
@@ -68,6 +80,8 @@ struct PendingReceiveTable {
   int length{};
   // the reference
   int reference{};
+  // the next buffer is a packed table
+  bool packed{};
   // keep the current columns
   std::vector<std::shared_ptr<arrow::ChunkedArray>> currentArrays;
   // keep the current buffers
@@ -104,20 +118,43 @@ class ArrowBuffer : public Buffer {
 };
 
 /**
- * Arrow table specific allocator
+ * Arrow table specific allocator. Messages of a source are received in to consecutive slices of
+ * a region of region_bytes allocated for that source, so that the received arrays are slices of a
+ * few large buffers. A region is freed when the arrays of all its slices are freed
  */
 class ArrowAllocator : public Allocator {
  public:
-  explicit ArrowAllocator(arrow::MemoryPool *pool);
+  /**
+   * @param pool
+   * @param region_bytes size of the receive regions, 0 allocates every message separately
+   */
+  explicit ArrowAllocator(arrow::MemoryPool *pool, int64_t region_bytes = 0);
   virtual ~ArrowAllocator();
 
   Status Allocate(int64_t length, std::shared_ptr<Buffer> *buffer) override;
+
+  Status AllocateForSource(int source, int64_t length, std::shared_ptr<Buffer> *buffer) override;
  private:
+  struct Region {
+    std::shared_ptr<arrow::Buffer> buffer;
+    int64_t used;
+  };
+
   arrow::MemoryPool *pool;
+  int64_t region_bytes;
+  // the region each source is receiving in to
+  std::unordered_map<int, Region> regions;
 };
 
 /**
- * We are going to take a table as input and send its columns one by one
+ * Header column index of a packed table
+ */
+constexpr int ARROW_PACKED_TABLE = -1;
+
+/**
+ * We are going to take a table as input and send its columns one by one. Tables smaller than the
+ * pack threshold (ALLTOALL_PACK_THRESHOLD_CONFIG of the context) are instead copied in to a single
+ * buffer with a descriptor of their arrays and buffers, and sent as one message
  */
 class ArrowAllToAll : public ReceiveCallback {
  public:
@@ -135,23 +172,24 @@ class ArrowAllToAll : public ReceiveCallback {
                 std::shared_ptr<arrow::Schema> schema);
 
   /**
-   * Insert a buffer to be sent, if the buffer is accepted return true
+   * Insert a table to be sent. A table is rejected while the tables queued for the target are
+   * above the ALLTOALL_MAX_TARGET_BYTES_CONFIG limit, it can be inserted again once isComplete
+   * has sent them. A table with an array longer, or a buffer larger, than an int can describe in
+   * the headers can't be sent
    *
-   * @param buffer the buffer to send
-   * @param length the length of the message
-   * @param target the target to send the message
-   * @return true if the buffer is accepted
+   * @param arrow the table to send
+   * @param target the target to send the table
+   * @return 1 if the table is accepted, -1 if it is rejected for now, 0 if it can't be sent
    */
   int insert(const std::shared_ptr<arrow::Table> &arrow, int32_t target);
 
   /**
-   * Insert a buffer to be sent, if the buffer is accepted return true
+   * Insert a table to be sent, see insert(arrow, target)
    *
-   * @param buffer the buffer to send
-   * @param length the length of the message
-   * @param target the target to send the message
+   * @param arrow the table to send
+   * @param target the target to send the table
    * @param reference a reference that can be sent in the header
-   * @return true if the buffer is accepted
+   * @return 1 if the table is accepted, -1 if it is rejected for now, 0 if it can't be sent
    */
   int insert(std::shared_ptr<arrow::Table> arrow, int32_t target, int32_t reference);
 
@@ -167,6 +205,21 @@ class ArrowAllToAll : public ReceiveCallback {
    */
   void finish();
 
+  /**
+   * @return bytes of the inserted tables that are not completely sent yet
+   */
+  int64_t inFlightBytes() const;
+
+  /**
+   * @return number of sends and receives posted or completed by the channel so far
+   */
+  uint64_t events();
+
+  /**
+   * Block until one of the posted sends or receives of the channel completes
+   */
+  void waitForEvents();
+
   /*
    * Close the operation
    */
@@ -253,6 +306,21 @@ class ArrowAllToAll : public ReceiveCallback {
 
   bool completed_;
   bool finishCalled_;
+
+  /**
+   * Bytes of the tables inserted and not completely sent
+   */
+  int64_t inFlightBytes_ = 0;
+
+  /**
+   * Tables up to this many bytes are packed in to a single buffer, 0 disables packing
+   */
+  int64_t packThreshold_ = 0;
+
+  /**
+   * Bytes of the tables a target can have queued, 0 disables the limit
+   */
+  int64_t maxTargetBytes_ = 0;
 };
 }
 #endif //CYLON_ARROW_H
@@ -79,7 +79,7 @@ std::shared_ptr<ArrowComparator> GetComparator(const std::shared_ptr<arrow::Data
     case arrow::Type::UINT16:return std::make_shared<NumericArrowComparator<arrow::UInt16Type>>();
     case arrow::Type::INT16:return std::make_shared<NumericArrowComparator<arrow::Int16Type>>();
     case arrow::Type::UINT32:return std::make_shared<NumericArrowComparator<arrow::UInt32Type>>();
-    case arrow::Type::INT32:return std::make_shared<NumericArrowComparator<arrow::Int16Type>>();
+    case arrow::Type::INT32:return std::make_shared<NumericArrowComparator<arrow::Int32Type>>();
     case arrow::Type::UINT64:return std::make_shared<NumericArrowComparator<arrow::UInt64Type>>();
     case arrow::Type::INT64:return std::make_shared<NumericArrowComparator<arrow::Int64Type>>();
     case arrow::Type::HALF_FLOAT:
@@ -17,21 +17,543 @@
 
 #include <arrow/api.h>
 #include <arrow/compute/kernel.h>
+#include <arrow/util/string_view.h>
 #include <glog/logging.h>
 #include "../status.hpp"
 #include "../join/join_config.hpp"
 #include "iostream"
+#include <unordered_map>
 #include <unordered_set>
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include "../util/flat_hash_multimap.hpp"
+#include "../util/murmur3.hpp"
+#include "../util/murmur3_batch.hpp"
+#include "../util/thread_pool.hpp"
 
 namespace cylon {
 
 /**
- * Kernel to join indices using hashing
+ * Key type used by the hash join kernels for a CTYPE. Numeric keys are used as they are
+ */
+template<typename CTYPE>
+struct HashJoinKeyTraits {
+  using KEY = CTYPE;
+  using HASH = std::hash<CTYPE>;
+  using EQUAL = std::equal_to<CTYPE>;
+
+  static inline KEY Make(const CTYPE &value) {
+    return value;
+  }
+
+  /**
+   * 32 bit hashes of the keys, used to radix partition them. Integer keys are hashed a buffer at
+   * a time by the batch murmur3 kernel
+   */
+  static void PartitionHashes(const KEY *keys, int64_t length, uint32_t *out) {
+    PartitionHashes(keys, length, out, std::is_integral<CTYPE>());
+  }
+
+ private:
+  static void PartitionHashes(const KEY *keys, int64_t length, uint32_t *out, std::true_type) {
+    cylon::util::MurmurHash3_x86_32_Batch(reinterpret_cast<const uint8_t *>(keys), length,
+                                          sizeof(KEY), 0, out);
+  }
+
+  // floating point keys equal as values (0.0 and -0.0) can differ in the bits, so the std::hash
+  // of the values is used
+  static void PartitionHashes(const KEY *keys, int64_t length, uint32_t *out, std::false_type) {
+    HASH hash;
+    for (int64_t i = 0; i < length; i++) {
+      out[i] = static_cast<uint32_t>(cylon::util::MixHash(hash(keys[i])) >> 32);
+    }
+  }
+};
+
+/**
+ * A string/binary key of the hash join. The view points to the value buffer of the arrow array,
+ * so the bytes are never copied, and the murmur3 hash of the bytes is computed once per row
+ */
+struct HashedStringView {
+  arrow::util::string_view view;
+  uint32_t hash;
+};
+
+/**
+ * String and binary keys are hashed once with murmur3 and the hashes are compared before the
+ * bytes
+ */
+template<>
+struct HashJoinKeyTraits<arrow::util::string_view> {
+  using KEY = HashedStringView;
+
+  struct HASH {
+    inline size_t operator()(const HashedStringView &key) const {
+      return key.hash;
+    }
+  };
+
+  struct EQUAL {
+    inline bool operator()(const HashedStringView &key1, const HashedStringView &key2) const {
+      return key1.hash == key2.hash && key1.view == key2.view;
+    }
+  };
+
+  static inline KEY Make(const arrow::util::string_view &value) {
+    uint32_t hash = 0;
+    cylon::util::MurmurHash3_x86_32(value.data(), static_cast<int>(value.size()), 0, &hash);
+    return HashedStringView{value, hash};
+  }
+
+  static void PartitionHashes(const KEY *keys, int64_t length, uint32_t *out) {
+    for (int64_t i = 0; i < length; i++) {
+      out[i] = keys[i].hash;
+    }
+  }
+};
+
+/**
+ * Kernel to join indices using hashing. The build side is loaded in to an open addressing
+ * multi-map (cylon::util::FlatHashMultiMap). If a thread pool is given, the probe side is split
+ * in to morsels which are probed in parallel.
  * @tparam ARROW_ARRAY_TYPE arrow array type to be used for static type casting
  */
 template<class ARROW_ARRAY_TYPE, typename CTYPE>
 class ArrowArrayIdxHashJoinKernel {
+ public:
+  using ARROW_TYPE = typename ARROW_ARRAY_TYPE::TypeClass;
+  using KEY_TRAITS = HashJoinKeyTraits<CTYPE>;
+  using KEY_TYPE = typename KEY_TRAITS::KEY;
+  using MMAP_TYPE = typename cylon::util::FlatHashMultiMap<KEY_TYPE,
+                                                           typename KEY_TRAITS::HASH,
+                                                           typename KEY_TRAITS::EQUAL>;
+
+  /**
+   * @param thread_pool thread pool to run the probe phase, nullptr to probe on the calling thread
+   */
+  explicit ArrowArrayIdxHashJoinKernel(cylon::util::ThreadPool *thread_pool = nullptr)
+      : thread_pool(thread_pool) {}
+
+  /**
+   * perform index hash join
+   * @param left_idx_col
+   * @param right_idx_col
+   * @param join_type
+   * @param left_table_indices row indices of the left table
+   * @param right_table_indices row indices of the right table
+   * @return 0 if success; non-zero otherwise
+   */
+  int IdxHashJoin(const std::shared_ptr<arrow::Array> &left_idx_col,
+                  const std::shared_ptr<arrow::Array> &right_idx_col,
+                  const cylon::join::config::JoinType join_type,
+                  std::shared_ptr<std::vector<int64_t>> &left_table_indices,
+                  std::shared_ptr<std::vector<int64_t>> &right_table_indices) {
+    switch (join_type) {
+      case cylon::join::config::JoinType::RIGHT: {
+        // build hashmap using left col idx
+        Join(left_idx_col, right_idx_col, true, false, left_table_indices, right_table_indices);
+        break;
+      }
+      case cylon::join::config::JoinType::LEFT: {
+        // build hashmap using right col idx
+        Join(right_idx_col, left_idx_col, true, false, right_table_indices, left_table_indices);
+        break;
+      }
+      case cylon::join::config::JoinType::INNER: {
+        // build hashmap using col idx with smaller len
+        if (left_idx_col->length() < right_idx_col->length()) {
+          Join(left_idx_col, right_idx_col, false, false, left_table_indices, right_table_indices);
+        } else {
+          Join(right_idx_col, left_idx_col, false, false, right_table_indices, left_table_indices);
+        }
+        break;
+      }
+      case cylon::join::config::JoinType::FULL_OUTER: {
+        // build hashmap using col idx with smaller len
+        if (left_idx_col->length() < right_idx_col->length()) {
+          Join(left_idx_col, right_idx_col, true, true, left_table_indices, right_table_indices);
+        } else {
+          Join(right_idx_col, left_idx_col, true, true, right_table_indices, left_table_indices);
+        }
+        break;
+      }
+      default: {
+        LOG(ERROR) << "not implemented!";
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+ private:
+  // rows of the probe side handled by a single task
+  static constexpr int64_t kMorselRows = 1 << 16;
+
+  cylon::util::ThreadPool *thread_pool;
+
+  /**
+   * Build the hashmap on the build column and probe it with the probe column
+   * @param fill_probe add the unmatched probe rows with -1
+   * @param fill_build add the unmatched build rows with -1
+   */
+  void Join(const std::shared_ptr<arrow::Array> &build_idx_col,
+            const std::shared_ptr<arrow::Array> &probe_idx_col,
+            bool fill_probe,
+            bool fill_build,
+            std::shared_ptr<std::vector<int64_t>> &build_table_indices,
+            std::shared_ptr<std::vector<int64_t>> &probe_table_indices) {
+    MMAP_TYPE idx_map(build_idx_col->length());
+    BuildPhase(build_idx_col, idx_map);
+
+    // matched rows of the build side, these are set concurrently by the probe tasks
+    std::unique_ptr<std::atomic<bool>[]> matched;
+    if (fill_build) {
+      matched.reset(new std::atomic<bool>[build_idx_col->length()]());
+    }
+    ProbePhase(idx_map, probe_idx_col, fill_probe, matched.get(),
+               build_table_indices, probe_table_indices);
+
+    // fill the unmatched rows with -1
+    if (fill_build) {
+      for (int64_t row = 0; row < build_idx_col->length(); row++) {
+        if (!matched[row].load(std::memory_order_relaxed)) {
+          build_table_indices->push_back(row);
+          probe_table_indices->push_back(-1);
+        }
+      }
+    }
+  }
+
+  // build hashmap. rows are inserted in reverse, so that the chains are in ascending row order
+  void BuildPhase(const std::shared_ptr<arrow::Array> &smaller_idx_col,
+                  MMAP_TYPE &smaller_idx_map) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto reader0 = std::static_pointer_cast<ARROW_ARRAY_TYPE>(smaller_idx_col);
+    for (int64_t i = reader0->length() - 1; i >= 0; i--) {
+      smaller_idx_map.Insert(KEY_TRAITS::Make((CTYPE) reader0->GetView(i)), i);
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    LOG(INFO) << "build_phase " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+        .count();
+  }
+
+  // probes the hashmap, morsel by morsel if a thread pool is available
+  void ProbePhase(const MMAP_TYPE &smaller_idx_map,
+                  const std::shared_ptr<arrow::Array> &larger_idx_col,
+                  bool fill_probe,
+                  std::atomic<bool> *matched,
+                  std::shared_ptr<std::vector<int64_t>> &smaller_table_indices,
+                  std::shared_ptr<std::vector<int64_t>> &larger_table_indices) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto reader1 = std::static_pointer_cast<ARROW_ARRAY_TYPE>(larger_idx_col);
+    const int64_t len = reader1->length();
+    if (thread_pool == nullptr || thread_pool->GetThreads() <= 1 || len <= kMorselRows) {
+      ProbeMorsel(smaller_idx_map, *reader1, 0, len, fill_probe, matched,
+                  *smaller_table_indices, *larger_table_indices);
+    } else {
+      const int64_t morsels = (len + kMorselRows - 1) / kMorselRows;
+      std::vector<std::vector<int64_t>> smaller_parts(morsels), larger_parts(morsels);
+      thread_pool->ParallelFor(morsels, [&](int64_t m) {
+        ProbeMorsel(smaller_idx_map, *reader1, m * kMorselRows,
+                    std::min(len, (m + 1) * kMorselRows), fill_probe, matched,
+                    smaller_parts[m], larger_parts[m]);
+      });
+      cylon::util::ParallelConcat(thread_pool, smaller_parts, *smaller_table_indices);
+      cylon::util::ParallelConcat(thread_pool, larger_parts, *larger_table_indices);
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    LOG(INFO) << "probe_phase " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+        .count();
+  }
+
+  // probes rows [start, end) of the larger column. fills -1 for no matches if fill_probe is set
+  // and marks the matched rows of the smaller column if matched is not null
+  static void ProbeMorsel(const MMAP_TYPE &smaller_idx_map,
+                          const ARROW_ARRAY_TYPE &reader1,
+                          int64_t start,
+                          int64_t end,
+                          bool fill_probe,
+                          std::atomic<bool> *matched,
+                          std::vector<int64_t> &smaller_output,
+                          std::vector<int64_t> &larger_output) {
+    for (int64_t i = start; i < end; ++i) {
+      int64_t row = smaller_idx_map.Find(KEY_TRAITS::Make((CTYPE) reader1.GetView(i)));
+      if (row < 0) {
+        if (fill_probe) {
+          smaller_output.push_back(-1);
+          larger_output.push_back(i);
+        }
+        continue;
+      }
+      for (; row >= 0; row = smaller_idx_map.Next(row)) {
+        if (matched != nullptr) {
+          matched[row].store(true, std::memory_order_relaxed);
+        }
+        smaller_output.push_back(row);
+        larger_output.push_back(i);
+      }
+    }
+  }
+};
+
+/**
+ * Kernel to join indices using a partitioned (radix) hash join. Both columns are partitioned on
+ * the high bits of the key hash so that the hash table of a build partition fits in the cache,
+ * and then every partition is built and probed independently. The partitions are written
+ * through cache line sized software write combining buffers. If a thread pool is given, the
+ * partitions are joined in parallel.
+ * @tparam ARROW_ARRAY_TYPE arrow array type to be used for static type casting
+ */
+template<class ARROW_ARRAY_TYPE, typename CTYPE>
+class ArrowArrayRadixHashJoinKernel {
+ public:
+  using ARROW_TYPE = typename ARROW_ARRAY_TYPE::TypeClass;
+  using KEY_TRAITS = HashJoinKeyTraits<CTYPE>;
+  using KEY_TYPE = typename KEY_TRAITS::KEY;
+  using MMAP_TYPE = typename cylon::util::FlatHashMultiMap<KEY_TYPE,
+                                                           typename KEY_TRAITS::HASH,
+                                                           typename KEY_TRAITS::EQUAL>;
+
+  /**
+   * @param thread_pool thread pool to join the partitions, nullptr to join on the calling thread
+   */
+  explicit ArrowArrayRadixHashJoinKernel(cylon::util::ThreadPool *thread_pool = nullptr)
+      : thread_pool(thread_pool) {}
+
+  /**
+   * perform index hash join
+   * @param left_idx_col
+   * @param right_idx_col
+   * @param join_type
+   * @param left_table_indices row indices of the left table
+   * @param right_table_indices row indices of the right table
+   * @return 0 if success; non-zero otherwise
+   */
+  int IdxHashJoin(const std::shared_ptr<arrow::Array> &left_idx_col,
+                  const std::shared_ptr<arrow::Array> &right_idx_col,
+                  const cylon::join::config::JoinType join_type,
+                  std::shared_ptr<std::vector<int64_t>> &left_table_indices,
+                  std::shared_ptr<std::vector<int64_t>> &right_table_indices) {
+    switch (join_type) {
+      case cylon::join::config::JoinType::RIGHT: {
+        // build using left col idx
+        Join(left_idx_col, right_idx_col, true, false, left_table_indices, right_table_indices);
+        break;
+      }
+      case cylon::join::config::JoinType::LEFT: {
+        // build using right col idx
+        Join(right_idx_col, left_idx_col, true, false, right_table_indices, left_table_indices);
+        break;
+      }
+      case cylon::join::config::JoinType::INNER: {
+        // build using col idx with smaller len
+        if (left_idx_col->length() < right_idx_col->length()) {
+          Join(left_idx_col, right_idx_col, false, false, left_table_indices, right_table_indices);
+        } else {
+          Join(right_idx_col, left_idx_col, false, false, right_table_indices, left_table_indices);
+        }
+        break;
+      }
+      case cylon::join::config::JoinType::FULL_OUTER: {
+        // build using col idx with smaller len
+        if (left_idx_col->length() < right_idx_col->length()) {
+          Join(left_idx_col, right_idx_col, true, true, left_table_indices, right_table_indices);
+        } else {
+          Join(right_idx_col, left_idx_col, true, true, right_table_indices, left_table_indices);
+        }
+        break;
+      }
+      default: {
+        LOG(ERROR) << "not implemented!";
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+ private:
+  // rows of a build partition, chosen so that the partition hash table stays within L2
+  static constexpr int64_t kPartitionRows = 1 << 14;
+  static constexpr int kMaxRadixBits = 12;
+
+  cylon::util::ThreadPool *thread_pool;
+
+  struct Tuple {
+    KEY_TYPE key;
+    int64_t row;
+  };
+
+  // number of tuples in a software write combining buffer (one cache line)
+  static constexpr int kBufferTuples = sizeof(Tuple) >= 64 ? 1 : 64 / sizeof(Tuple);
+
+  static int RadixBits(int64_t build_rows) {
+    int bits = 0;
+    while (bits < kMaxRadixBits && (build_rows >> bits) > kPartitionRows) {
+      bits++;
+    }
+    return bits;
+  }
+
+  /**
+   * Partition the column in to 2^bits partitions. Tuples of partition p are written to
+   * [offsets[p], offsets[p + 1]) of the tuples vector
+   */
+  void RadixPartition(const std::shared_ptr<arrow::Array> &idx_col,
+                      int bits,
+                      std::vector<Tuple> &tuples,
+                      std::vector<int64_t> &offsets) {
+    auto reader = std::static_pointer_cast<ARROW_ARRAY_TYPE>(idx_col);
+    const int64_t len = reader->length();
+    const int64_t partitions = 1LL << bits;
+
+    // histogram pass
+    std::vector<KEY_TYPE> keys(len);
+    std::vector<uint16_t> partition_of(len, 0);
+    std::vector<int64_t> counts(partitions, 0);
+    for (int64_t i = 0; i < len; i++) {
+      keys[i] = KEY_TRAITS::Make((CTYPE) reader->GetView(i));
+    }
+    if (bits > 0) {
+      std::vector<uint32_t> hashes(len);
+      KEY_TRAITS::PartitionHashes(keys.data(), len, hashes.data());
+      for (int64_t i = 0; i < len; i++) {
+        uint16_t p = hashes[i] >> (32 - bits);
+        partition_of[i] = p;
+        counts[p]++;
+      }
+    } else {
+      counts[0] = len;
+    }
+
+    offsets.assign(partitions + 1, 0);
+    for (int64_t p = 0; p < partitions; p++) {
+      offsets[p + 1] = offsets[p] + counts[p];
+    }
+
+    // scatter pass, through the write combining buffers
+    tuples.resize(len);
+    std::vector<int64_t> positions(offsets.begin(), offsets.end() - 1);
+    std::vector<Tuple> buffers(partitions * kBufferTuples);
+    std::vector<int> fill(partitions, 0);
+    for (int64_t i = 0; i < len; i++) {
+      uint16_t p = partition_of[i];
+      Tuple *buffer = &buffers[p * kBufferTuples];
+      buffer[fill[p]++] = Tuple{keys[i], i};
+      if (fill[p] == kBufferTuples) {
+        std::copy(buffer, buffer + kBufferTuples, tuples.begin() + positions[p]);
+        positions[p] += kBufferTuples;
+        fill[p] = 0;
+      }
+    }
+    for (int64_t p = 0; p < partitions; p++) {
+      Tuple *buffer = &buffers[p * kBufferTuples];
+      std::copy(buffer, buffer + fill[p], tuples.begin() + positions[p]);
+    }
+  }
+
+  /**
+   * Partition both columns and join each pair of partitions
+   * @param fill_probe add the unmatched probe rows with -1
+   * @param fill_build add the unmatched build rows with -1
+   */
+  void Join(const std::shared_ptr<arrow::Array> &build_idx_col,
+            const std::shared_ptr<arrow::Array> &probe_idx_col,
+            bool fill_probe,
+            bool fill_build,
+            std::shared_ptr<std::vector<int64_t>> &build_table_indices,
+            std::shared_ptr<std::vector<int64_t>> &probe_table_indices) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    const int bits = RadixBits(build_idx_col->length());
+    std::vector<Tuple> build_tuples, probe_tuples;
+    std::vector<int64_t> build_offsets, probe_offsets;
+    RadixPartition(build_idx_col, bits, build_tuples, build_offsets);
+    RadixPartition(probe_idx_col, bits, probe_tuples, probe_offsets);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    LOG(INFO) << "radix_partition_phase " << (1 << bits) << " "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+    const int64_t partitions = 1LL << bits;
+    if (thread_pool == nullptr || thread_pool->GetThreads() <= 1) {
+      for (int64_t p = 0; p < partitions; p++) {
+        JoinPartition(build_tuples, build_offsets[p], build_offsets[p + 1],
+                      probe_tuples, probe_offsets[p], probe_offsets[p + 1],
+                      fill_probe, fill_build, *build_table_indices, *probe_table_indices);
+      }
+    } else {
+      // partitions are independent, so they are joined in parallel
+      std::vector<std::vector<int64_t>> build_parts(partitions), probe_parts(partitions);
+      thread_pool->ParallelFor(partitions, [&](int64_t p) {
+        JoinPartition(build_tuples, build_offsets[p], build_offsets[p + 1],
+                      probe_tuples, probe_offsets[p], probe_offsets[p + 1],
+                      fill_probe, fill_build, build_parts[p], probe_parts[p]);
+      });
+      cylon::util::ParallelConcat(thread_pool, build_parts, *build_table_indices);
+      cylon::util::ParallelConcat(thread_pool, probe_parts, *probe_table_indices);
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+    LOG(INFO) << "build_probe_phase "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t3 - t2).count();
+  }
+
+  // build and probe a single partition
+  static void JoinPartition(const std::vector<Tuple> &build_tuples,
+                            int64_t build_start,
+                            int64_t build_end,
+                            const std::vector<Tuple> &probe_tuples,
+                            int64_t probe_start,
+                            int64_t probe_end,
+                            bool fill_probe,
+                            bool fill_build,
+                            std::vector<int64_t> &build_table_indices,
+                            std::vector<int64_t> &probe_table_indices) {
+    const int64_t build_len = build_end - build_start;
+
+    // build using local rows of the partition, in reverse to keep the chains in row order
+    MMAP_TYPE idx_map(build_len);
+    for (int64_t i = build_len - 1; i >= 0; i--) {
+      idx_map.Insert(build_tuples[build_start + i].key, i);
+    }
+
+    std::vector<bool> matched(fill_build ? build_len : 0, false);
+    for (int64_t i = probe_start; i < probe_end; i++) {
+      const Tuple &probe = probe_tuples[i];
+      int64_t row = idx_map.Find(probe.key);
+      if (row < 0) {
+        if (fill_probe) {
+          build_table_indices.push_back(-1);
+          probe_table_indices.push_back(probe.row);
+        }
+        continue;
+      }
+      for (; row >= 0; row = idx_map.Next(row)) {
+        if (fill_build) {
+          matched[row] = true;
+        }
+        build_table_indices.push_back(build_tuples[build_start + row].row);
+        probe_table_indices.push_back(probe.row);
+      }
+    }
+
+    if (fill_build) {
+      for (int64_t i = 0; i < build_len; i++) {
+        if (!matched[i]) {
+          build_table_indices.push_back(build_tuples[build_start + i].row);
+          probe_table_indices.push_back(-1);
+        }
+      }
+    }
+  }
+};
+
+/**
+ * Kernel to join indices using a std::unordered_multimap. This is the node based version of
+ * ArrowArrayIdxHashJoinKernel and is kept as a baseline for benchmarks
+ * @tparam ARROW_ARRAY_TYPE arrow array type to be used for static type casting
+ */
+template<class ARROW_ARRAY_TYPE, typename CTYPE>
+class ArrowArrayIdxMultiMapHashJoinKernel {
  public:
   using ARROW_TYPE = typename ARROW_ARRAY_TYPE::TypeClass;
   using MMAP_TYPE = typename std::unordered_multimap<CTYPE, int64_t>;
@@ -93,8 +93,23 @@ ArrowJoinWithPartition::ArrowJoinWithPartition(std::shared_ptr<cylon::CylonConte
                                       schema, pool);
 }
 
+bool ArrowJoinWithPartition::insertPartitions(
+    std::queue<std::pair<std::shared_ptr<arrow::Table>, int>> *partitions, bool left) {
+  while (!partitions->empty()) {
+    const auto &partition = partitions->front();
+    int inserted = left ? join_->leftInsert(partition.first, partition.second)
+                        : join_->rightInsert(partition.first, partition.second);
+    if (inserted <= 0) {
+      return false;
+    }
+    partitions->pop();
+  }
+  return true;
+}
+
 bool ArrowJoinWithPartition::isComplete() {
-  if (!leftUnPartitionedTables_.empty()) {
+  // a table is partitioned only after the partitions of the previous one are accepted
+  if (insertPartitions(&leftPartitions_, true) && !leftUnPartitionedTables_.empty()) {
     std::shared_ptr<arrow::Table> left_tab = leftUnPartitionedTables_.front();
     // keep arrays for each target, these arrays are used for creating the table
     std::unordered_map<int,
@@ -142,12 +157,13 @@ bool ArrowJoinWithPartition::isComplete() {
     // now insert these array to
     for (const auto &x : data_arrays) {
       std::shared_ptr<arrow::Table> table = arrow::Table::Make(left_tab->schema(), *x.second);
-      join_->leftInsert(table, x.first);
+      leftPartitions_.emplace(table, x.first);
     }
     leftUnPartitionedTables_.pop();
+    insertPartitions(&leftPartitions_, true);
   }
 
-  if (!rightUnPartitionedTables_.empty()) {
+  if (insertPartitions(&rightPartitions_, false) && !rightUnPartitionedTables_.empty()) {
     std::shared_ptr<arrow::Table> left_tab = rightUnPartitionedTables_.front();
     // keep arrays for each target, these arrays are used for creating the table
     std::unordered_map<int,
@@ -193,9 +209,16 @@ bool ArrowJoinWithPartition::isComplete() {
     // now insert these array to
     for (const auto &x : data_arrays) {
       std::shared_ptr<arrow::Table> table = arrow::Table::Make(left_tab->schema(), *x.second);
-      join_->rightInsert(table, x.first);
+      rightPartitions_.emplace(table, x.first);
     }
     rightUnPartitionedTables_.pop();
+    insertPartitions(&rightPartitions_, false);
+  }
+
+  if (!leftPartitions_.empty() || !rightPartitions_.empty()) {
+    // send the queued tables, so that the rejected partitions are accepted
+    join_->isComplete();
+    return false;
   }
   return finished_ && rightUnPartitionedTables_.empty() && leftUnPartitionedTables_.empty() &&
          join_->isComplete();
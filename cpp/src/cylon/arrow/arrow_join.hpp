@@ -187,6 +187,9 @@ class ArrowJoinWithPartition {
   // keep track of the un partitioned tables
   std::queue<std::shared_ptr<arrow::Table>> leftUnPartitionedTables_;
   std::queue<std::shared_ptr<arrow::Table>> rightUnPartitionedTables_;
+  // partitions the all to alls did not accept yet, with their targets
+  std::queue<std::pair<std::shared_ptr<arrow::Table>, int>> leftPartitions_;
+  std::queue<std::pair<std::shared_ptr<arrow::Table>, int>> rightPartitions_;
   std::shared_ptr<ArrowJoin> join_;
 
   int workerId_;
@@ -195,6 +198,13 @@ class ArrowJoinWithPartition {
   std::vector<int32_t> targets_;
   int leftColumnIndex_;
   int rightColumnIndex_;
+
+  /**
+   * Insert the partitions in order until the all to all rejects one
+   * @return true if all the partitions are inserted
+   */
+  bool insertPartitions(std::queue<std::pair<std::shared_ptr<arrow::Table>, int>> *partitions,
+                        bool left);
 };
 
 }
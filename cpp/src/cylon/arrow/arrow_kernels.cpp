@@ -14,6 +14,9 @@
 
 #include "arrow_kernels.hpp"
 
+#include <arrow/util/bit_util.h>
+
+#include <cstring>
 #include <vector>
 #include <unordered_map>
 #include <utility>
@@ -60,6 +63,58 @@ cylon::Status CreateSplitter(const std::shared_ptr<arrow::DataType> &type,
   return cylon::Status::OK();
 }
 
+arrow::Status ArrowArraySplitKernel::SplitValidity(
+    const std::shared_ptr<arrow::Array> &values,
+    const std::vector<int64_t> &partitions,
+    const std::vector<uint32_t> &counts,
+    std::vector<std::shared_ptr<arrow::Buffer>> *bitmaps,
+    std::vector<int64_t> *null_counts) {
+  bitmaps->assign(counts.size(), nullptr);
+  null_counts->assign(counts.size(), 0);
+  if (values->null_count() == 0) {
+    return arrow::Status::OK();
+  }
+
+  std::vector<uint8_t *> bits(counts.size());
+  for (size_t p = 0; p < counts.size(); p++) {
+    const int64_t bytes = arrow::BitUtil::BytesForBits(counts[p]);
+    arrow::Status st = arrow::AllocateBuffer(pool_, bytes, &(*bitmaps)[p]);
+    if (!st.ok()) {
+      return st;
+    }
+    bits[p] = (*bitmaps)[p]->mutable_data();
+    std::memset(bits[p], 0, bytes);
+  }
+
+  const uint8_t *validity = values->null_bitmap_data();
+  const int64_t offset = values->offset();
+  std::vector<int64_t> positions(counts.size(), 0);
+  for (size_t i = 0; i < partitions.size(); i++) {
+    const int64_t p = partitions[i];
+    if (arrow::BitUtil::GetBit(validity, offset + i)) {
+      arrow::BitUtil::SetBit(bits[p], positions[p]);
+    } else {
+      (*null_counts)[p]++;
+    }
+    positions[p]++;
+  }
+  return arrow::Status::OK();
+}
+
+arrow::Status ArrowArraySplitKernel::AllocateValueBuffers(
+    const std::vector<uint32_t> &counts,
+    int64_t byte_width,
+    std::vector<std::shared_ptr<arrow::Buffer>> *buffers) {
+  buffers->resize(counts.size());
+  for (size_t p = 0; p < counts.size(); p++) {
+    arrow::Status st = arrow::AllocateBuffer(pool_, counts[p] * byte_width, &(*buffers)[p]);
+    if (!st.ok()) {
+      return st;
+    }
+  }
+  return arrow::Status::OK();
+}
+
 int FixedBinaryArraySplitKernel::Split(std::shared_ptr<arrow::Array> &values,
                                        const std::vector<int64_t> &partitions,
                                        const std::vector<int32_t> &targets,
@@ -67,32 +122,33 @@ int FixedBinaryArraySplitKernel::Split(std::shared_ptr<arrow::Array> &values,
                                        std::vector<uint32_t> &counts) {
   auto reader =
       std::static_pointer_cast<arrow::FixedSizeBinaryArray>(values);
-  std::unordered_map<int, std::shared_ptr<arrow::FixedSizeBinaryBuilder>> builders;
-
-  for (size_t i = 0; i < targets.size(); i++) {
-    int target = targets[i];
-    std::shared_ptr<arrow::FixedSizeBinaryBuilder> b =
-        std::make_shared<arrow::FixedSizeBinaryBuilder>(type_, pool_);
-    arrow::Status st = b->Reserve(counts[i]);
-    builders.insert(std::pair<int, std::shared_ptr<arrow::FixedSizeBinaryBuilder>>(target, b));
+  const int32_t byte_width = reader->byte_width();
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers, bitmaps;
+  std::vector<int64_t> null_counts;
+  arrow::Status st = AllocateValueBuffers(counts, byte_width, &buffers);
+  if (st.ok()) {
+    st = SplitValidity(values, partitions, counts, &bitmaps, &null_counts);
+  }
+  if (!st.ok()) {
+    LOG(FATAL) << "Failed to allocate the partitions " << st.message();
+    return -1;
   }
 
+  std::vector<uint8_t *> data(counts.size());
+  for (size_t p = 0; p < counts.size(); p++) {
+    data[p] = buffers[p]->mutable_data();
+  }
+  const uint8_t *raw_values = reader->raw_values();
   for (size_t i = 0; i < partitions.size(); i++) {
-    std::shared_ptr<arrow::FixedSizeBinaryBuilder> b = builders[partitions.at(i)];
-    if (b->Append(reader->Value(i)) != arrow::Status::OK()) {
-      LOG(FATAL) << "Failed to merge";
-      return -1;
-    }
+    uint8_t *&dest = data[partitions[i]];
+    std::memcpy(dest, raw_values + i * byte_width, byte_width);
+    dest += byte_width;
   }
 
   for (int it : targets) {
-    std::shared_ptr<arrow::FixedSizeBinaryBuilder> b = builders[it];
-    std::shared_ptr<arrow::Array> array;
-    if (b->Finish(&array) != arrow::Status::OK()) {
-      LOG(FATAL) << "Failed to merge";
-      return -1;
-    }
-    out.insert(std::pair<int, std::shared_ptr<arrow::Array>>(it, array));
+    auto array_data = arrow::ArrayData::Make(type_, counts[it], {bitmaps[it], buffers[it]},
+                                             null_counts[it]);
+    out.insert(std::pair<int, std::shared_ptr<arrow::Array>>(it, arrow::MakeArray(array_data)));
   }
   return 0;
 }
@@ -104,31 +160,55 @@ int BinaryArraySplitKernel::Split(std::shared_ptr<arrow::Array> &values,
                                   std::vector<uint32_t> &counts) {
   auto reader =
       std::static_pointer_cast<arrow::BinaryArray>(values);
-  std::unordered_map<int, std::shared_ptr<arrow::BinaryBuilder>> builders;
+  const int32_t *value_offsets = reader->raw_value_offsets();
+  const uint8_t *value_data = reader->value_data()->data();
 
-  for (int it : targets) {
-    std::shared_ptr<arrow::BinaryBuilder> b = std::make_shared<arrow::BinaryBuilder>(type_, pool_);
-    builders.insert(std::pair<int, std::shared_ptr<arrow::BinaryBuilder>>(it, b));
+  // bytes of each partition, so that the data buffers are allocated once
+  std::vector<int64_t> bytes(counts.size(), 0);
+  for (size_t i = 0; i < partitions.size(); i++) {
+    bytes[partitions[i]] += value_offsets[i + 1] - value_offsets[i];
   }
 
-  for (size_t i = 0; i < partitions.size(); i++) {
-    std::shared_ptr<arrow::BinaryBuilder> b = builders[partitions.at(i)];
-    int length = 0;
-    const uint8_t *value = reader->GetValue(i, &length);
-    if (b->Append(value, length) != arrow::Status::OK()) {
-      LOG(FATAL) << "Failed to merge";
-      return -1;
+  std::vector<std::shared_ptr<arrow::Buffer>> offset_buffers, data_buffers, bitmaps;
+  std::vector<int64_t> null_counts;
+  arrow::Status st;
+  offset_buffers.resize(counts.size());
+  data_buffers.resize(counts.size());
+  for (size_t p = 0; p < counts.size() && st.ok(); p++) {
+    st = arrow::AllocateBuffer(pool_, (counts[p] + 1) * sizeof(int32_t), &offset_buffers[p]);
+    if (st.ok()) {
+      st = arrow::AllocateBuffer(pool_, bytes[p], &data_buffers[p]);
     }
   }
+  if (st.ok()) {
+    st = SplitValidity(values, partitions, counts, &bitmaps, &null_counts);
+  }
+  if (!st.ok()) {
+    LOG(FATAL) << "Failed to allocate the partitions " << st.message();
+    return -1;
+  }
+
+  std::vector<int32_t *> offsets(counts.size());
+  std::vector<uint8_t *> data(counts.size());
+  std::vector<int32_t> data_positions(counts.size(), 0);
+  for (size_t p = 0; p < counts.size(); p++) {
+    offsets[p] = reinterpret_cast<int32_t *>(offset_buffers[p]->mutable_data());
+    *(offsets[p]++) = 0;
+    data[p] = data_buffers[p]->mutable_data();
+  }
+  for (size_t i = 0; i < partitions.size(); i++) {
+    const int64_t p = partitions[i];
+    const int32_t length = value_offsets[i + 1] - value_offsets[i];
+    std::memcpy(data[p] + data_positions[p], value_data + value_offsets[i], length);
+    data_positions[p] += length;
+    *(offsets[p]++) = data_positions[p];
+  }
 
   for (int it : targets) {
-    std::shared_ptr<arrow::BinaryBuilder> b = builders[it];
-    std::shared_ptr<arrow::Array> array;
-    if (b->Finish(&array) != arrow::Status::OK()) {
-      LOG(FATAL) << "Failed to merge";
-      return -1;
-    }
-    out.insert(std::pair<int, std::shared_ptr<arrow::Array>>(it, array));
+    auto array_data = arrow::ArrayData::Make(type_, counts[it],
+                                             {bitmaps[it], offset_buffers[it], data_buffers[it]},
+                                             null_counts[it]);
+    out.insert(std::pair<int, std::shared_ptr<arrow::Array>>(it, arrow::MakeArray(array_data)));
   }
   return 0;
 }
@@ -248,6 +328,16 @@ int CreateSorter(std::shared_ptr<arrow::DataType> type,
       break;
     case arrow::Type::DOUBLE:kernel = new DoubleArraySorter(type, pool);
       break;
+    case arrow::Type::DATE32:kernel = new Date32ArraySorter(type, pool);
+      break;
+    case arrow::Type::DATE64:kernel = new Date64ArraySorter(type, pool);
+      break;
+    case arrow::Type::TIMESTAMP:kernel = new TimestampArraySorter(type, pool);
+      break;
+    case arrow::Type::TIME32:kernel = new Time32ArraySorter(type, pool);
+      break;
+    case arrow::Type::TIME64:kernel = new Time64ArraySorter(type, pool);
+      break;
     case arrow::Type::STRING:kernel = new ArrowStringSortKernel(type, pool);
       break;
     case arrow::Type::BINARY:kernel = new ArrowBinarySortKernel(type, pool);
@@ -262,13 +352,157 @@ int CreateSorter(std::shared_ptr<arrow::DataType> type,
 }
 
 arrow::Status SortIndices(arrow::MemoryPool *memory_pool, std::shared_ptr<arrow::Array> values,
-                          std::shared_ptr<arrow::Array> *offsets) {
+                          std::shared_ptr<arrow::Array> *offsets,
+                          cylon::util::ThreadPool *thread_pool) {
   std::shared_ptr<ArrowArraySortKernel> out;
   CreateSorter(values->type(), memory_pool, &out);
+  out->SetThreadPool(thread_pool);
   out->Sort(values, offsets);
   return arrow::Status::OK();
 }
 
+// the heap is used while k is smaller than this fraction of the rows
+static constexpr int64_t kTopKHeapRatio = 16;
+
+/**
+ * Select the best k valid rows, with get_value(i) returning a comparable value of row i
+ */
+template<typename GET_VALUE>
+static void TopKRows(const std::shared_ptr<arrow::Array> &values, int64_t k, bool ascending,
+					 GET_VALUE get_value, std::vector<int64_t> *rows) {
+  const int64_t length = values->length();
+  if (k == 0) {
+	return;
+  }
+  // true if row a comes before row b
+  auto better = [&](int64_t a, int64_t b) {
+	auto value_a = get_value(a);
+	auto value_b = get_value(b);
+	if (value_a < value_b) {
+	  return ascending;
+	}
+	if (value_b < value_a) {
+	  return !ascending;
+	}
+	return a < b;
+  };
+  const bool has_nulls = values->null_count() > 0;
+
+  if (k * kTopKHeapRatio < length) {
+	// a max heap of the selected rows, with the worst row on top
+	rows->reserve(k);
+	for (int64_t i = 0; i < length; i++) {
+	  if (has_nulls && values->IsNull(i)) {
+		continue;
+	  }
+	  if (static_cast<int64_t>(rows->size()) < k) {
+		rows->push_back(i);
+		std::push_heap(rows->begin(), rows->end(), better);
+	  } else if (better(i, rows->front())) {
+		std::pop_heap(rows->begin(), rows->end(), better);
+		rows->back() = i;
+		std::push_heap(rows->begin(), rows->end(), better);
+	  }
+	}
+	std::sort_heap(rows->begin(), rows->end(), better);
+  } else {
+	rows->reserve(length - values->null_count());
+	for (int64_t i = 0; i < length; i++) {
+	  if (!has_nulls || values->IsValid(i)) {
+		rows->push_back(i);
+	  }
+	}
+	if (k < static_cast<int64_t>(rows->size())) {
+	  std::nth_element(rows->begin(), rows->begin() + k, rows->end(), better);
+	  rows->resize(k);
+	}
+	std::sort(rows->begin(), rows->end(), better);
+  }
+}
+
+template<typename TYPE>
+static void TopKNumeric(const std::shared_ptr<arrow::Array> &values, int64_t k, bool ascending,
+						std::vector<int64_t> *rows) {
+  const auto *data = std::static_pointer_cast<arrow::NumericArray<TYPE>>(values)->raw_values();
+  TopKRows(values, k, ascending, [data](int64_t i) { return data[i]; }, rows);
+}
+
+arrow::Status TopKIndices(arrow::MemoryPool *memory_pool,
+						  const std::shared_ptr<arrow::Array> &values, int64_t k, bool ascending,
+						  std::shared_ptr<arrow::Array> *offsets) {
+  if (k < 0) {
+	return arrow::Status::Invalid("k should be non negative: ", k);
+  }
+  k = std::min(k, values->length());
+  std::vector<int64_t> rows;
+  switch (values->type_id()) {
+	case arrow::Type::BOOL: {
+	  auto array = std::static_pointer_cast<arrow::BooleanArray>(values);
+	  TopKRows(values, k, ascending, [&array](int64_t i) { return array->Value(i); }, &rows);
+	  break;
+	}
+	case arrow::Type::UINT8:TopKNumeric<arrow::UInt8Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::INT8:TopKNumeric<arrow::Int8Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::UINT16:TopKNumeric<arrow::UInt16Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::INT16:TopKNumeric<arrow::Int16Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::UINT32:TopKNumeric<arrow::UInt32Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::INT32:TopKNumeric<arrow::Int32Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::UINT64:TopKNumeric<arrow::UInt64Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::INT64:TopKNumeric<arrow::Int64Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::FLOAT:TopKNumeric<arrow::FloatType>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::DOUBLE:TopKNumeric<arrow::DoubleType>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::DATE32:TopKNumeric<arrow::Date32Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::DATE64:TopKNumeric<arrow::Date64Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::TIMESTAMP:TopKNumeric<arrow::TimestampType>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::TIME32:TopKNumeric<arrow::Time32Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::TIME64:TopKNumeric<arrow::Time64Type>(values, k, ascending, &rows);
+	  break;
+	case arrow::Type::STRING:
+	case arrow::Type::BINARY: {
+	  auto array = std::static_pointer_cast<arrow::BinaryArray>(values);
+	  TopKRows(values, k, ascending, [&array](int64_t i) { return array->GetView(i); }, &rows);
+	  break;
+	}
+	case arrow::Type::FIXED_SIZE_BINARY: {
+	  auto array = std::static_pointer_cast<arrow::FixedSizeBinaryArray>(values);
+	  TopKRows(values, k, ascending, [&array](int64_t i) { return array->GetView(i); }, &rows);
+	  break;
+	}
+	default:
+	  return arrow::Status::NotImplemented("Un-supported type for top k: ",
+										   values->type()->ToString());
+  }
+  // fill with nulls if there are not enough values
+  for (int64_t i = 0; static_cast<int64_t>(rows.size()) < k && i < values->length(); i++) {
+	if (values->IsNull(i)) {
+	  rows.push_back(i);
+	}
+  }
+
+  std::shared_ptr<arrow::Buffer> indices_buf;
+  arrow::Status status = AllocateBuffer(memory_pool, k * sizeof(uint64_t) + 1, &indices_buf);
+  if (!status.ok()) {
+	return status;
+  }
+  std::copy(rows.begin(), rows.end(), reinterpret_cast<int64_t *>(indices_buf->mutable_data()));
+  *offsets = std::make_shared<arrow::UInt64Array>(k, indices_buf);
+  return arrow::Status::OK();
+}
+
 int CreateInplaceSorter(std::shared_ptr<arrow::DataType> type,
                         arrow::MemoryPool *pool,
                         std::shared_ptr<ArrowArrayInplaceSortKernel> *out) {
@@ -294,6 +528,16 @@ int CreateInplaceSorter(std::shared_ptr<arrow::DataType> type,
       break;
     case arrow::Type::DOUBLE:kernel = new DoubleArrayInplaceSorter(type, pool);
       break;
+    case arrow::Type::DATE32:kernel = new Date32ArrayInplaceSorter(type, pool);
+      break;
+    case arrow::Type::DATE64:kernel = new Date64ArrayInplaceSorter(type, pool);
+      break;
+    case arrow::Type::TIMESTAMP:kernel = new TimestampArrayInplaceSorter(type, pool);
+      break;
+    case arrow::Type::TIME32:kernel = new Time32ArrayInplaceSorter(type, pool);
+      break;
+    case arrow::Type::TIME64:kernel = new Time64ArrayInplaceSorter(type, pool);
+      break;
     default:LOG(FATAL) << "Un-known type";
       return -1;
   }
@@ -303,9 +547,11 @@ int CreateInplaceSorter(std::shared_ptr<arrow::DataType> type,
 
 arrow::Status SortIndicesInPlace(arrow::MemoryPool *memory_pool,
                                  std::shared_ptr<arrow::Array> values,
-                                 std::shared_ptr<arrow::UInt64Array> *offsets) {
+                                 std::shared_ptr<arrow::UInt64Array> *offsets,
+                                 cylon::util::ThreadPool *thread_pool) {
   std::shared_ptr<ArrowArrayInplaceSortKernel> out;
   CreateInplaceSorter(values->type(), memory_pool, &out);
+  out->SetThreadPool(thread_pool);
   out->Sort(values, offsets);
   return arrow::Status::OK();
 }
@@ -20,21 +20,31 @@
 #include <glog/logging.h>
 #include "../status.hpp"
 #include "util/sort.hpp"
+#include "util/radix_sort.hpp"
+#include "util/thread_pool.hpp"
 
 namespace cylon {
 
+/**
+ * Splits an array in to the partitions of its rows.
+ *
+ * The partitions are built in two passes over the rows. The first one, done by the caller,
+ * counts the rows of every partition (counts). Then the value, offset and validity buffers of
+ * every partition are allocated once with their final size and the rows are scattered straight
+ * in to them, without going through the arrow builders.
+ */
 class ArrowArraySplitKernel {
  public:
   explicit ArrowArraySplitKernel(std::shared_ptr<arrow::DataType> type,
 								 arrow::MemoryPool *pool) : type_(type), pool_(pool) {}
 
   /**
-   * Merge the values in the column and return an array
-   * @param ctx
+   * Split the values in to an array for each target
    * @param values
+   * @param partitions partition of each row, one of the targets
    * @param targets
-   * @param out_length
-   * @param out
+   * @param out target -> array of the rows of the target
+   * @param counts number of rows of each target
    * @return
    */
   virtual int Split(std::shared_ptr<arrow::Array> &values,
@@ -43,6 +53,33 @@ class ArrowArraySplitKernel {
                     std::unordered_map<int, std::shared_ptr<arrow::Array>> &out,
                     std::vector<uint32_t> &counts) = 0;
  protected:
+  /**
+   * Allocate the validity bitmaps of the partitions and scatter the validity of the rows in to
+   * them. If the values have no nulls the bitmaps are left null
+   * @param values
+   * @param partitions
+   * @param counts
+   * @param bitmaps validity bitmap of each partition
+   * @param null_counts null count of each partition
+   * @return
+   */
+  arrow::Status SplitValidity(const std::shared_ptr<arrow::Array> &values,
+							  const std::vector<int64_t> &partitions,
+							  const std::vector<uint32_t> &counts,
+							  std::vector<std::shared_ptr<arrow::Buffer>> *bitmaps,
+							  std::vector<int64_t> *null_counts);
+
+  /**
+   * Allocate a buffer for the values of each partition
+   * @param counts number of rows of each partition
+   * @param byte_width bytes of a value
+   * @param buffers
+   * @return
+   */
+  arrow::Status AllocateValueBuffers(const std::vector<uint32_t> &counts,
+									 int64_t byte_width,
+									 std::vector<std::shared_ptr<arrow::Buffer>> *buffers);
+
   std::shared_ptr<arrow::DataType> type_;
   arrow::MemoryPool *pool_;
 };
@@ -59,27 +96,36 @@ class ArrowArrayNumericSplitKernel : public ArrowArraySplitKernel {
             const std::vector<int32_t> &targets,
             std::unordered_map<int, std::shared_ptr<arrow::Array>> &out,
             std::vector<uint32_t> &counts) override {
-	auto reader =
-		std::static_pointer_cast<arrow::NumericArray<TYPE>>(values);
-	std::vector<std::shared_ptr<arrow::NumericBuilder<TYPE>>> builders;
-
-    for (size_t i = 0; i < targets.size(); i++) {
-	  std::shared_ptr<arrow::NumericBuilder<TYPE>> b = std::make_shared<arrow::NumericBuilder<TYPE>>(type_, pool_);
-      b->Reserve(counts[i]);
-	  builders.push_back(b);
+	using T = typename TYPE::c_type;
+	auto reader = std::static_pointer_cast<arrow::NumericArray<TYPE>>(values);
+	std::vector<std::shared_ptr<arrow::Buffer>> buffers, bitmaps;
+	std::vector<int64_t> null_counts;
+	arrow::Status st = AllocateValueBuffers(counts, sizeof(T), &buffers);
+	if (st.ok()) {
+	  st = SplitValidity(values, partitions, counts, &bitmaps, &null_counts);
+	}
+	if (!st.ok()) {
+	  LOG(FATAL) << "Failed to allocate the partitions " << st.message();
+	  return -1;
 	}
 
-    size_t kI = partitions.size();
-    for (size_t i = 0; i < kI; i++) {
-	  std::shared_ptr<arrow::NumericBuilder<TYPE>> b = builders[partitions[i]];
-	  b->UnsafeAppend(reader->Value(i));
+	std::vector<T *> data(counts.size());
+	for (size_t p = 0; p < counts.size(); p++) {
+	  data[p] = reinterpret_cast<T *>(buffers[p]->mutable_data());
+	}
+	// scatter, data[p] is the next free slot of the partition
+	const T *raw_values = reader->raw_values();
+	const size_t kI = partitions.size();
+	for (size_t i = 0; i < kI; i++) {
+	  *(data[partitions[i]]++) = raw_values[i];
 	}
 
-	for (long target : targets) {
-	  std::shared_ptr<arrow::NumericBuilder<TYPE>> b = builders[target];
-	  std::shared_ptr<arrow::Array> array;
-	  b->Finish(&array);
-	  out.insert(std::pair<int, std::shared_ptr<arrow::Array>>(target, array));
+	for (int32_t target : targets) {
+	  auto array_data = arrow::ArrayData::Make(type_, counts[target],
+											   {bitmaps[target], buffers[target]},
+											   null_counts[target]);
+	  out.insert(std::pair<int, std::shared_ptr<arrow::Array>>(target,
+															   arrow::MakeArray(array_data)));
 	}
 	return 0;
   }
@@ -145,11 +191,25 @@ class ArrowArraySortKernel {
    */
   virtual int Sort(std::shared_ptr<arrow::Array> values,
 				   std::shared_ptr<arrow::Array> *out) = 0;
+
+  /**
+   * Thread pool used by the kernels that sort in parallel
+   * @param thread_pool can be nullptr
+   */
+  void SetThreadPool(cylon::util::ThreadPool *thread_pool) {
+	thread_pool_ = thread_pool;
+  }
  protected:
   std::shared_ptr<arrow::DataType> type_;
   arrow::MemoryPool *pool_;
+  cylon::util::ThreadPool *thread_pool_ = nullptr;
 };
 
+/**
+ * Arrays shorter than this are sorted with a comparison sort instead of a radix sort
+ */
+constexpr int64_t kRadixSortMinRows = 1024;
+
 template<typename TYPE>
 class ArrowArrayNumericSortKernel : public ArrowArraySortKernel {
  public:
@@ -174,13 +234,22 @@ class ArrowArrayNumericSortKernel : public ArrowArraySortKernel {
 	for (int64_t i = 0; i < values->length(); i++) {
 	  indices_begin[i] = i;
 	}
-	int64_t *indices_end = indices_begin + values->length();
-	std::sort(indices_begin, indices_end, [left_data](uint64_t left, uint64_t right) {
-	  return left_data[left] < left_data[right];
-	});
+	if (kRadixSortable && values->length() >= kRadixSortMinRows) {
+	  cylon::util::RadixSortIndices(left_data, values->length(), indices_begin,
+									static_cast<T *>(nullptr), thread_pool_);
+	} else {
+	  int64_t *indices_end = indices_begin + values->length();
+	  std::sort(indices_begin, indices_end, [left_data](uint64_t left, uint64_t right) {
+		return left_data[left] < left_data[right];
+	  });
+	}
 	*offsets = std::make_shared<arrow::UInt64Array>(values->length(), indices_buf);
 	return 0;
   }
+
+ private:
+  // half floats are stored as uint16_t, which does not have the order of the values
+  static constexpr bool kRadixSortable = !std::is_same<TYPE, arrow::HalfFloatType>::value;
 };
 
 using UInt8ArraySorter = ArrowArrayNumericSortKernel<arrow::UInt8Type>;
@@ -194,8 +263,37 @@ using Int64ArraySorter = ArrowArrayNumericSortKernel<arrow::Int64Type>;
 using HalfFloatArraySorter = ArrowArrayNumericSortKernel<arrow::HalfFloatType>;
 using FloatArraySorter = ArrowArrayNumericSortKernel<arrow::FloatType>;
 using DoubleArraySorter = ArrowArrayNumericSortKernel<arrow::DoubleType>;
-
+using Date32ArraySorter = ArrowArrayNumericSortKernel<arrow::Date32Type>;
+using Date64ArraySorter = ArrowArrayNumericSortKernel<arrow::Date64Type>;
+using TimestampArraySorter = ArrowArrayNumericSortKernel<arrow::TimestampType>;
+using Time32ArraySorter = ArrowArrayNumericSortKernel<arrow::Time32Type>;
+using Time64ArraySorter = ArrowArrayNumericSortKernel<arrow::Time64Type>;
+
+/**
+ * Sort the values of an array to indices
+ * @param memory_pool
+ * @param values
+ * @param offsets indices of the values in the sorted order
+ * @param thread_pool thread pool for the radix sort of numeric arrays, can be nullptr
+ * @return
+ */
 arrow::Status SortIndices(arrow::MemoryPool *memory_pool, std::shared_ptr<arrow::Array> values,
+						  std::shared_ptr<arrow::Array> *offsets,
+						  cylon::util::ThreadPool *thread_pool = nullptr);
+
+/**
+ * Select the indices of the k smallest (or largest) values of an array, in sorted order, without
+ * sorting the whole array. Small k keep a bounded heap of the best rows, larger k select the rows
+ * with nth_element. Nulls come after all the values. Ties are resolved by the row index.
+ * @param memory_pool
+ * @param values
+ * @param k number of rows to select
+ * @param ascending select the smallest values if true, the largest otherwise
+ * @param offsets output, UInt64 array of min(k, length) indices
+ * @return
+ */
+arrow::Status TopKIndices(arrow::MemoryPool *memory_pool,
+						  const std::shared_ptr<arrow::Array> &values, int64_t k, bool ascending,
 						  std::shared_ptr<arrow::Array> *offsets);
 
 class ArrowArrayInplaceSortKernel {
@@ -214,9 +312,18 @@ class ArrowArrayInplaceSortKernel {
    */
   virtual int Sort(std::shared_ptr<arrow::Array> values,
                    std::shared_ptr<arrow::UInt64Array> *out) = 0;
+
+  /**
+   * Thread pool used by the kernels that sort in parallel
+   * @param thread_pool can be nullptr
+   */
+  void SetThreadPool(cylon::util::ThreadPool *thread_pool) {
+    thread_pool_ = thread_pool;
+  }
  protected:
   std::shared_ptr<arrow::DataType> type_;
   arrow::MemoryPool *pool_;
+  cylon::util::ThreadPool *thread_pool_ = nullptr;
 };
 
 template<typename TYPE>
@@ -246,10 +353,18 @@ class ArrowArrayInplaceNumericSortKernel : public ArrowArrayInplaceSortKernel {
     for (int64_t i = 0; i < length; i++) {
       indices_begin[i] = i;
     }
-    cylon::util::quicksort(left_data, 0, length, indices_begin);
+    if (kRadixSortable && length >= kRadixSortMinRows) {
+      cylon::util::RadixSortIndices(left_data, length, indices_begin, left_data, thread_pool_);
+    } else {
+      cylon::util::quicksort(left_data, 0, length, indices_begin);
+    }
     *offsets = std::make_shared<arrow::UInt64Array>(length, indices_buf);
     return 0;
   }
+
+ private:
+  // half floats are stored as uint16_t, which does not have the order of the values
+  static constexpr bool kRadixSortable = !std::is_same<TYPE, arrow::HalfFloatType>::value;
 };
 
 using UInt8ArrayInplaceSorter = ArrowArrayInplaceNumericSortKernel<arrow::UInt8Type>;
@@ -263,10 +378,24 @@ using Int64ArrayInplaceSorter = ArrowArrayInplaceNumericSortKernel<arrow::Int64T
 using HalfFloatArrayInplaceSorter = ArrowArrayInplaceNumericSortKernel<arrow::HalfFloatType>;
 using FloatArrayInplaceSorter = ArrowArrayInplaceNumericSortKernel<arrow::FloatType>;
 using DoubleArrayInplaceSorter = ArrowArrayInplaceNumericSortKernel<arrow::DoubleType>;
-
+using Date32ArrayInplaceSorter = ArrowArrayInplaceNumericSortKernel<arrow::Date32Type>;
+using Date64ArrayInplaceSorter = ArrowArrayInplaceNumericSortKernel<arrow::Date64Type>;
+using TimestampArrayInplaceSorter = ArrowArrayInplaceNumericSortKernel<arrow::TimestampType>;
+using Time32ArrayInplaceSorter = ArrowArrayInplaceNumericSortKernel<arrow::Time32Type>;
+using Time64ArrayInplaceSorter = ArrowArrayInplaceNumericSortKernel<arrow::Time64Type>;
+
+/**
+ * Sort the values of an array in place
+ * @param memory_pool
+ * @param values
+ * @param offsets original indices of the sorted values
+ * @param thread_pool thread pool for the radix sort, can be nullptr
+ * @return
+ */
 arrow::Status SortIndicesInPlace(arrow::MemoryPool *memory_pool,
                                  std::shared_ptr<arrow::Array> values,
-                                 std::shared_ptr<arrow::UInt64Array> *offsets);
+                                 std::shared_ptr<arrow::UInt64Array> *offsets,
+                                 cylon::util::ThreadPool *thread_pool = nullptr);
 
 }
 
@@ -0,0 +1,355 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arrow_normalized_keys.hpp"
+
+#include <algorithm>
+#include <string>
+
+#include "util/radix_sort.hpp"
+
+namespace cylon {
+
+// strings and binaries up to this length are fully encoded, longer ones only keep a prefix
+static constexpr int64_t kMaxBinaryBytes = 16;
+// smaller tables are sorted with a comparison sort
+static constexpr int64_t kRadixSortMinRows = 1024;
+
+/**
+ * Write the radix key of each value in big endian order
+ */
+template<typename ARROW_TYPE>
+static void EncodeNumeric(const std::shared_ptr<arrow::Array> &array, bool ascending,
+						  int64_t offset, int64_t width, uint8_t *rows) {
+  using T = typename ARROW_TYPE::c_type;
+  using KEY = typename cylon::util::RadixKey<T>::KEY;
+  auto values = std::static_pointer_cast<arrow::NumericArray<ARROW_TYPE>>(array);
+  const T *data = values->raw_values();
+  for (int64_t i = 0; i < array->length(); i++) {
+	if (array->IsNull(i)) {
+	  continue;
+	}
+	KEY key = cylon::util::RadixKey<T>::Encode(data[i]);
+	if (!ascending) {
+	  key = static_cast<KEY>(~key);
+	}
+	uint8_t *encoded = rows + i * width + offset;
+	for (int b = sizeof(KEY) - 1; b >= 0; b--) {
+	  encoded[b] = static_cast<uint8_t>(key);
+	  key = static_cast<KEY>(key >> 8);
+	}
+  }
+}
+
+static void EncodeBoolean(const std::shared_ptr<arrow::Array> &array, bool ascending,
+						  int64_t offset, int64_t width, uint8_t *rows) {
+  auto values = std::static_pointer_cast<arrow::BooleanArray>(array);
+  for (int64_t i = 0; i < array->length(); i++) {
+	if (!array->IsNull(i)) {
+	  rows[i * width + offset] = static_cast<uint8_t>(values->Value(i) == ascending ? 1 : 0);
+	}
+  }
+}
+
+/**
+ * Write the bytes of each value zero padded to bytes, followed by the length if the values are
+ * fully encoded
+ */
+static void EncodeBinary(const std::shared_ptr<arrow::Array> &array, bool ascending,
+						 int64_t offset, int64_t width, int64_t bytes, bool with_length,
+						 uint8_t *rows) {
+  const bool fixed_size = array->type_id() == arrow::Type::FIXED_SIZE_BINARY;
+  for (int64_t i = 0; i < array->length(); i++) {
+	if (array->IsNull(i)) {
+	  continue;
+	}
+	const uint8_t *value;
+	int32_t length;
+	if (fixed_size) {
+	  auto values = std::static_pointer_cast<arrow::FixedSizeBinaryArray>(array);
+	  value = values->GetValue(i);
+	  length = values->byte_width();
+	} else {
+	  value = std::static_pointer_cast<arrow::BinaryArray>(array)->GetValue(i, &length);
+	}
+	uint8_t *encoded = rows + i * width + offset;
+	const int64_t copied = std::min<int64_t>(length, bytes);
+	std::memcpy(encoded, value, copied);
+	if (with_length) {
+	  encoded[bytes] = static_cast<uint8_t>(length);
+	}
+	if (!ascending) {
+	  for (int64_t b = 0; b < bytes + (with_length ? 1 : 0); b++) {
+		encoded[b] = static_cast<uint8_t>(~encoded[b]);
+	  }
+	}
+  }
+}
+
+/**
+ * @return the number of bytes of a fully encoded fixed width value, or -1 for variable width types
+ */
+static int64_t FixedEncodedWidth(const std::shared_ptr<arrow::DataType> &type) {
+  switch (type->id()) {
+	case arrow::Type::BOOL:
+	case arrow::Type::UINT8:
+	case arrow::Type::INT8:return 1;
+	case arrow::Type::UINT16:
+	case arrow::Type::INT16:return 2;
+	case arrow::Type::UINT32:
+	case arrow::Type::INT32:
+	case arrow::Type::FLOAT:
+	case arrow::Type::DATE32:
+	case arrow::Type::TIME32:return 4;
+	case arrow::Type::UINT64:
+	case arrow::Type::INT64:
+	case arrow::Type::DOUBLE:
+	case arrow::Type::DATE64:
+	case arrow::Type::TIMESTAMP:
+	case arrow::Type::TIME64:return 8;
+	default:return -1;
+  }
+}
+
+arrow::Status NormalizedKeys::Make(const std::vector<std::shared_ptr<arrow::Array>> &columns,
+								   const std::vector<SortKey> &sort_keys,
+								   std::shared_ptr<NormalizedKeys> *out) {
+  if (sort_keys.empty()) {
+	return arrow::Status::Invalid("At least one sort key is required");
+  }
+  auto keys = std::make_shared<NormalizedKeys>();
+  keys->length_ = columns.empty() ? 0 : columns[0]->length();
+
+  // layout of the encoded rows
+  for (const SortKey &sort_key : sort_keys) {
+	if (sort_key.column < 0 || sort_key.column >= static_cast<int>(columns.size())) {
+	  return arrow::Status::IndexError("Sort column out of range: ", sort_key.column);
+	}
+	const std::shared_ptr<arrow::Array> &array = columns[sort_key.column];
+	EncodedKey key{array, sort_key.ascending, sort_key.nulls_first, 0, 0, true};
+	key.offset = keys->width_ + (array->null_count() > 0 ? 1 : 0);
+	const std::shared_ptr<arrow::DataType> &type = array->type();
+	if (type->id() == arrow::Type::STRING || type->id() == arrow::Type::BINARY) {
+	  auto values = std::static_pointer_cast<arrow::BinaryArray>(array);
+	  int64_t max_length = 0;
+	  for (int64_t i = 0; i < array->length(); i++) {
+		max_length = std::max<int64_t>(max_length, values->value_length(i));
+	  }
+	  key.exact = max_length <= kMaxBinaryBytes;
+	  // the length byte follows the fully encoded values
+	  key.width = key.exact ? max_length + 1 : kMaxBinaryBytes;
+	} else if (type->id() == arrow::Type::FIXED_SIZE_BINARY) {
+	  int64_t byte_width = std::static_pointer_cast<arrow::FixedSizeBinaryType>(type)->byte_width();
+	  key.exact = byte_width <= kMaxBinaryBytes;
+	  key.width = std::min(byte_width, kMaxBinaryBytes);
+	} else {
+	  key.width = FixedEncodedWidth(type);
+	  if (key.width < 0) {
+		return arrow::Status::NotImplemented("Un-supported sort key type: ", type->ToString());
+	  }
+	}
+	if (!key.exact && keys->first_inexact_key_ < 0) {
+	  keys->first_inexact_key_ = static_cast<int>(keys->keys_.size());
+	}
+	keys->width_ = key.offset + key.width;
+	keys->keys_.push_back(key);
+  }
+
+  // null rows only set the null byte, so that all the nulls of a key are equal
+  keys->rows_.resize(keys->length_ * keys->width_, 0);
+  uint8_t *rows = keys->rows_.data();
+  const int64_t width = keys->width_;
+  for (const EncodedKey &key : keys->keys_) {
+	const std::shared_ptr<arrow::Array> &array = key.array;
+	if (array->null_count() > 0) {
+	  const uint8_t null_byte = key.nulls_first ? 0 : 1;
+	  for (int64_t i = 0; i < keys->length_; i++) {
+		rows[i * width + key.offset - 1] = array->IsNull(i) ? null_byte : 1 - null_byte;
+	  }
+	}
+	switch (array->type_id()) {
+	  case arrow::Type::BOOL:EncodeBoolean(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::UINT8:
+		EncodeNumeric<arrow::UInt8Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::INT8:
+		EncodeNumeric<arrow::Int8Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::UINT16:
+		EncodeNumeric<arrow::UInt16Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::INT16:
+		EncodeNumeric<arrow::Int16Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::UINT32:
+		EncodeNumeric<arrow::UInt32Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::INT32:
+		EncodeNumeric<arrow::Int32Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::UINT64:
+		EncodeNumeric<arrow::UInt64Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::INT64:
+		EncodeNumeric<arrow::Int64Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::FLOAT:
+		EncodeNumeric<arrow::FloatType>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::DOUBLE:
+		EncodeNumeric<arrow::DoubleType>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::DATE32:
+		EncodeNumeric<arrow::Date32Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::DATE64:
+		EncodeNumeric<arrow::Date64Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::TIMESTAMP:
+		EncodeNumeric<arrow::TimestampType>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::TIME32:
+		EncodeNumeric<arrow::Time32Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::TIME64:
+		EncodeNumeric<arrow::Time64Type>(array, key.ascending, key.offset, width, rows);
+		break;
+	  case arrow::Type::STRING:
+	  case arrow::Type::BINARY:
+		EncodeBinary(array, key.ascending, key.offset, width, key.exact ? key.width - 1 : key.width,
+					 key.exact, rows);
+		break;
+	  case arrow::Type::FIXED_SIZE_BINARY:
+		EncodeBinary(array, key.ascending, key.offset, width, key.width, false, rows);
+		break;
+	  default:
+		return arrow::Status::NotImplemented("Un-supported sort key type: ",
+											 array->type()->ToString());
+	}
+  }
+  *out = keys;
+  return arrow::Status::OK();
+}
+
+int NormalizedKeys::CompareValues(const EncodedKey &key, int64_t row1, int64_t row2) const {
+  const std::shared_ptr<arrow::Array> &array = key.array;
+  bool null1 = array->IsNull(row1), null2 = array->IsNull(row2);
+  if (null1 || null2) {
+	if (null1 && null2) {
+	  return 0;
+	}
+	return (null1 == key.nulls_first) ? -1 : 1;
+  }
+  const uint8_t *value1, *value2;
+  int32_t length1, length2;
+  if (array->type_id() == arrow::Type::FIXED_SIZE_BINARY) {
+	auto values = std::static_pointer_cast<arrow::FixedSizeBinaryArray>(array);
+	value1 = values->GetValue(row1);
+	value2 = values->GetValue(row2);
+	length1 = length2 = values->byte_width();
+  } else {
+	auto values = std::static_pointer_cast<arrow::BinaryArray>(array);
+	value1 = values->GetValue(row1, &length1);
+	value2 = values->GetValue(row2, &length2);
+  }
+  int result = std::memcmp(value1, value2, std::min(length1, length2));
+  if (result == 0) {
+	result = length1 < length2 ? -1 : (length1 > length2 ? 1 : 0);
+  }
+  return key.ascending ? result : -result;
+}
+
+int NormalizedKeys::Compare(int64_t row1, int64_t row2) const {
+  const uint8_t *encoded1 = &rows_[row1 * width_];
+  const uint8_t *encoded2 = &rows_[row2 * width_];
+  if (IsExact()) {
+	return std::memcmp(encoded1, encoded2, width_);
+  }
+  // the keys before the first inexact key are fully encoded
+  int64_t exact_bytes = keys_[first_inexact_key_].offset;
+  int result = std::memcmp(encoded1, encoded2, exact_bytes);
+  if (result != 0) {
+	return result;
+  }
+  for (size_t k = first_inexact_key_; k < keys_.size(); k++) {
+	const EncodedKey &key = keys_[k];
+	// the null byte and the (prefix of the) value
+	const int64_t start = k == 0 ? 0 : keys_[k - 1].offset + keys_[k - 1].width;
+	result = std::memcmp(encoded1 + start, encoded2 + start, key.offset + key.width - start);
+	if (result == 0 && !key.exact) {
+	  result = CompareValues(key, row1, row2);
+	}
+	if (result != 0) {
+	  return result;
+	}
+  }
+  return 0;
+}
+
+arrow::Status SortIndicesMultiColumns(arrow::MemoryPool *memory_pool,
+									  const std::vector<std::shared_ptr<arrow::Array>> &columns,
+									  const std::vector<SortKey> &sort_keys,
+									  std::shared_ptr<arrow::Array> *offsets,
+									  cylon::util::ThreadPool *thread_pool) {
+  std::shared_ptr<NormalizedKeys> keys;
+  arrow::Status status = NormalizedKeys::Make(columns, sort_keys, &keys);
+  if (!status.ok()) {
+	return status;
+  }
+  const int64_t length = keys->Length();
+  std::shared_ptr<arrow::Buffer> indices_buf;
+  status = AllocateBuffer(memory_pool, length * sizeof(uint64_t) + 1, &indices_buf);
+  if (!status.ok()) {
+	return status;
+  }
+  auto *indices = reinterpret_cast<int64_t *>(indices_buf->mutable_data());
+  // ties are broken by the row index to keep the sort stable
+  auto less = [&keys](int64_t row1, int64_t row2) {
+	int result = keys->Compare(row1, row2);
+	return result < 0 || (result == 0 && row1 < row2);
+  };
+
+  if (length < kRadixSortMinRows) {
+	for (int64_t i = 0; i < length; i++) {
+	  indices[i] = i;
+	}
+	std::sort(indices, indices + length, less);
+  } else {
+	std::vector<uint64_t> prefixes(length);
+	for (int64_t i = 0; i < length; i++) {
+	  prefixes[i] = keys->Prefix(i);
+	}
+	cylon::util::RadixSortIndices(prefixes.data(), length, indices, prefixes.data(), thread_pool);
+	// the prefixes are the whole encodings of narrow exact keys, otherwise sort the rows with
+	// equal prefixes by the rest of the keys
+	if (keys->Width() > 8 || !keys->IsExact()) {
+	  int64_t start = 0;
+	  while (start < length) {
+		int64_t end = start + 1;
+		while (end < length && prefixes[end] == prefixes[start]) {
+		  end++;
+		}
+		if (end - start > 1) {
+		  std::sort(indices + start, indices + end, less);
+		}
+		start = end;
+	  }
+	}
+  }
+  *offsets = std::make_shared<arrow::UInt64Array>(length, indices_buf);
+  return arrow::Status::OK();
+}
+
+}  // namespace cylon
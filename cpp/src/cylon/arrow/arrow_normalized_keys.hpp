@@ -0,0 +1,146 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_ARROW_ARROW_NORMALIZED_KEYS_HPP_
+#define CYLON_CPP_SRC_CYLON_ARROW_ARROW_NORMALIZED_KEYS_HPP_
+
+#include <arrow/api.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "util/thread_pool.hpp"
+
+namespace cylon {
+
+/**
+ * A column of a multi column sort, with its direction and the position of the nulls
+ */
+struct SortKey {
+  SortKey(int column, bool ascending = true, bool nulls_first = false)
+	  : column(column), ascending(ascending), nulls_first(nulls_first) {}
+
+  int column;
+  bool ascending;
+  bool nulls_first;
+};
+
+/**
+ * The sort keys of the rows encoded to fixed width byte strings, so that comparing two rows is a
+ * memcmp of their encodings.
+ *
+ * Every key takes a null byte (only if the column has nulls) followed by the value in big endian
+ * order, with the sign bit flipped for signed and floating point values, and all the bits
+ * inverted for descending keys. Strings and binaries up to kMaxBinaryBytes are zero padded and
+ * followed by their length. Longer ones only keep a prefix, and rows with equal encodings are
+ * compared on the actual values of those keys.
+ */
+class NormalizedKeys {
+ public:
+  /**
+   * Encode the sort keys of the rows
+   * @param columns single chunk columns of the table
+   * @param sort_keys sort keys, indexing the columns
+   * @param out the encoded keys
+   * @return
+   */
+  static arrow::Status Make(const std::vector<std::shared_ptr<arrow::Array>> &columns,
+							const std::vector<SortKey> &sort_keys,
+							std::shared_ptr<NormalizedKeys> *out);
+
+  /**
+   * @return width of an encoded row in bytes
+   */
+  int64_t Width() const {
+	return width_;
+  }
+
+  /**
+   * @return number of rows
+   */
+  int64_t Length() const {
+	return length_;
+  }
+
+  /**
+   * @return true if rows with equal encodings have equal keys
+   */
+  bool IsExact() const {
+	return first_inexact_key_ < 0;
+  }
+
+  /**
+   * @return the first 8 bytes of the encoding of a row as a big endian integer, so that the order
+   * of the prefixes is the order of the rows
+   */
+  inline uint64_t Prefix(int64_t row) const {
+	const uint8_t *encoded = &rows_[row * width_];
+	const int64_t bytes = std::min<int64_t>(width_, 8);
+	uint64_t prefix = 0;
+	for (int64_t b = 0; b < bytes; b++) {
+	  prefix = (prefix << 8) | encoded[b];
+	}
+	return bytes == 8 ? prefix : prefix << (8 * (8 - bytes));
+  }
+
+  /**
+   * Compare two rows
+   * @return negative if row1 comes before row2, 0 if the keys are equal and positive otherwise
+   */
+  int Compare(int64_t row1, int64_t row2) const;
+
+ private:
+  struct EncodedKey {
+	std::shared_ptr<arrow::Array> array;
+	bool ascending;
+	bool nulls_first;
+	// offset of the key in the encoded row and the number of bytes it takes
+	int64_t offset;
+	int64_t width;
+	// whether the encoding holds the whole value
+	bool exact;
+  };
+
+  int CompareValues(const EncodedKey &key, int64_t row1, int64_t row2) const;
+
+  std::vector<EncodedKey> keys_;
+  std::vector<uint8_t> rows_;
+  int64_t width_ = 0;
+  int64_t length_ = 0;
+  int first_inexact_key_ = -1;
+};
+
+/**
+ * Sort the rows of a table by multiple keys and return the sorted indices.
+ *
+ * The keys are encoded with NormalizedKeys, the rows are radix sorted on the first 8 bytes of the
+ * encodings and the rows with equal prefixes are sorted by the rest of the encodings. The sort
+ * is stable.
+ * @param memory_pool
+ * @param columns single chunk columns of the table
+ * @param sort_keys
+ * @param offsets output, UInt64 array of the sorted indices
+ * @param thread_pool thread pool for the radix sort, can be nullptr
+ * @return
+ */
+arrow::Status SortIndicesMultiColumns(arrow::MemoryPool *memory_pool,
+									  const std::vector<std::shared_ptr<arrow::Array>> &columns,
+									  const std::vector<SortKey> &sort_keys,
+									  std::shared_ptr<arrow::Array> *offsets,
+									  cylon::util::ThreadPool *thread_pool = nullptr);
+
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_ARROW_ARROW_NORMALIZED_KEYS_HPP_
@@ -47,8 +47,8 @@ std::shared_ptr<ArrowPartitionKernel> GetPartitionKernel(arrow::MemoryPool *pool
     case arrow::Type::FIXED_SIZE_BINARY:
       kernel = std::make_shared<FixedSizeBinaryHashPartitionKernel>(pool);
       break;
-    default:LOG(FATAL) << "Un-known type";
-      return NULLPTR;
+    // the callers report the unsupported type
+    default:return NULLPTR;
   }
   return kernel;
 }
@@ -64,6 +64,9 @@ cylon::Status HashPartitionArray(arrow::MemoryPool *pool,
                                  std::vector<int64_t> *outPartitions,
                                  std::vector<uint32_t> &counts) {
   std::shared_ptr<ArrowPartitionKernel> kernel = GetPartitionKernel(pool, values);
+  if (kernel == NULLPTR) {
+    return cylon::Status(cylon::NotImplemented, "Not implemented or unsupported data type.");
+  }
   kernel->Partition(values, targets, outPartitions, counts);
   return cylon::Status::OK();
 }
@@ -78,19 +81,19 @@ cylon::Status HashPartitionArrays(arrow::MemoryPool *pool,
   for (const auto &array : values) {
     auto hash_kernel = GetPartitionKernel(pool, array);
     if (hash_kernel == NULLPTR) {
-      LOG(FATAL) << "Un-known type";
       return cylon::Status(cylon::NotImplemented, "Not implemented or unsupported data type.");
     }
     hash_kernels.push_back(hash_kernel);
   }
 
+  // hash a column at a time, so that the kernels can hash whole buffers
+  std::vector<uint64_t> hash_codes(length, 1);
+  for (size_t array_index = 0; array_index < values.size(); array_index++) {
+    hash_kernels[array_index]->UpdateHash(values[array_index], hash_codes.data());
+  }
+  outPartitions->reserve(outPartitions->size() + length);
   for (int64_t index = 0; index < length; index++) {
-    int64_t hash_code = 1;
-    int64_t array_index = 0;
-    for (const auto &array : values) {
-      hash_code = 31 * hash_code + hash_kernels[array_index++]->ToHash(array, index);
-    }
-    int kX = targets[hash_code % targets.size()];
+    int kX = targets[hash_codes[index] % targets.size()];
     outPartitions->push_back(kX);
     counts[kX]++;
   }
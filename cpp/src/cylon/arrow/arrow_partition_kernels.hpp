@@ -16,11 +16,13 @@
 #define CYLON_ARROW_PARTITION_KERNELS_H
 
 #include <memory>
+#include <type_traits>
 #include <vector>
 #include <arrow/api.h>
 #include <glog/logging.h>
 
 #include "../util/murmur3.hpp"
+#include "../util/murmur3_batch.hpp"
 #include "../status.hpp"
 
 namespace cylon {
@@ -44,6 +46,20 @@ class ArrowPartitionKernel {
 
   virtual uint32_t ToHash(const std::shared_ptr<arrow::Array> &values,
                           int64_t index) = 0;
+
+  /**
+   * Combine the hashes of all the values in to the row hashes,
+   * row_hashes[i] = 31 * row_hashes[i] + ToHash(values, i)
+   * @param values
+   * @param row_hashes values->length() row hashes to update
+   */
+  virtual void UpdateHash(const std::shared_ptr<arrow::Array> &values, uint64_t *row_hashes) {
+    const int64_t length = values->length();
+    for (int64_t i = 0; i < length; i++) {
+      row_hashes[i] = 31 * row_hashes[i] + ToHash(values, i);
+    }
+  }
+
  protected:
   arrow::MemoryPool *pool_;
 };
@@ -67,6 +83,14 @@ class FixedSizeBinaryHashPartitionKernel : public ArrowPartitionKernel {
     }
   }
 
+  void UpdateHash(const std::shared_ptr<arrow::Array> &values, uint64_t *row_hashes) override {
+    auto reader = std::static_pointer_cast<arrow::FixedSizeBinaryArray>(values);
+    const uint8_t *validity = values->null_count() > 0 ? values->null_bitmap_data() : nullptr;
+    cylon::util::MurmurHash3_x86_32_Combine(reader->raw_values(), values->length(),
+                                            reader->byte_width(), validity, values->offset(),
+                                            row_hashes);
+  }
+
   int Partition(const std::shared_ptr<arrow::Array> &values,
                 const std::vector<int> &targets,
                 std::vector<int64_t> *partitions,
@@ -74,14 +98,12 @@ class FixedSizeBinaryHashPartitionKernel : public ArrowPartitionKernel {
     auto reader = std::static_pointer_cast<arrow::FixedSizeBinaryArray>(values);
     int64_t kI = reader->length();
     unsigned long target_size = targets.size();
-    int32_t byte_width = reader->byte_width();
+    std::vector<uint32_t> hashes(kI);
+    cylon::util::MurmurHash3_x86_32_Batch(reader->raw_values(), kI, reader->byte_width(), 0,
+                                          hashes.data());
+    partitions->reserve(partitions->size() + kI);
     for (int64_t i = 0; i < kI; i++) {
-      auto lValue = reader->GetValue(i);
-      uint32_t hash = 0;
-      uint32_t seed = 0;
-      // do the hash as we know the bit width
-      cylon::util::MurmurHash3_x86_32(lValue, byte_width, seed, &hash);
-      int kX = targets.at(hash % target_size);
+      int kX = targets.at(hashes[i] % target_size);
       partitions->push_back(kX);
       counts[kX]++;
     }
@@ -157,6 +179,18 @@ class NumericHashPartitionKernel : public ArrowPartitionKernel {
 
   }
 
+  void UpdateHash(const std::shared_ptr<arrow::Array> &values, uint64_t *row_hashes) override {
+    if (!kRawValues) {
+      ArrowPartitionKernel::UpdateHash(values, row_hashes);
+      return;
+    }
+    auto reader = std::static_pointer_cast<arrow::NumericArray<TYPE>>(values);
+    const uint8_t *validity = values->null_count() > 0 ? values->null_bitmap_data() : nullptr;
+    cylon::util::MurmurHash3_x86_32_Combine(
+        reinterpret_cast<const uint8_t *>(reader->raw_values()), values->length(),
+        sizeof(CTYPE), validity, values->offset(), row_hashes);
+  }
+
   int Partition(const std::shared_ptr<arrow::Array> &values,
                 const std::vector<int> &targets,
                 std::vector<int64_t> *partitions,
@@ -166,20 +200,25 @@ class NumericHashPartitionKernel : public ArrowPartitionKernel {
     int bitWidth = type->bit_width() / 8;
     unsigned long target_size = targets.size();
     int64_t length = reader->length();
+    // do the hash as we know the bit width
+    std::vector<uint32_t> hashes(length);
+    cylon::util::MurmurHash3_x86_32_Batch(
+        reinterpret_cast<const uint8_t *>(reader->raw_values()), length, bitWidth, 0,
+        hashes.data());
+    partitions->reserve(partitions->size() + length);
     for (int64_t i = 0; i < length; i++) {
-      auto lValue = reader->Value(i);
-      void *val = (void *) &(lValue);
-      uint32_t hash = 0;
-      uint32_t seed = 0;
-      // do the hash as we know the bit width
-      cylon::util::MurmurHash3_x86_32(val, bitWidth, seed, &hash);
-      int kX = targets[hash % target_size];
+      int kX = targets[hashes[i] % target_size];
       partitions->push_back(kX);
       counts[kX]++;
     }
     // now build the
     return 0;
   }
+
+ private:
+  // whether ToHash hashes the values as they are in the arrow buffer, so that the whole buffer
+  // can be hashed at once. Half floats are converted to CTYPE before hashing
+  static constexpr bool kRawValues = std::is_same<typename TYPE::c_type, CTYPE>::value;
 };
 
 using UInt8ArrayHashPartitioner = NumericHashPartitionKernel<arrow::UInt8Type, uint8_t>;
@@ -19,7 +19,6 @@
 #include <table.hpp>
 #include <ctx/arrow_memory_pool_utils.hpp>
 #include <net/comm_operations.hpp>
-#include <net/mpi/mpi_operations.hpp>
 
 #include "compute/aggregates.hpp"
 
@@ -29,7 +28,7 @@ namespace compute {
 /**
  * All reduce for numeric types
  * @tparam NUM_ARROW_T arrow numeric type
- * @param comm_type
+ * @param ctx
  * @param send sending container
  * @param output output result
  * @param data_type
@@ -39,7 +38,7 @@ namespace compute {
 template<typename NUM_ARROW_T,
     typename = typename std::enable_if<
         arrow::is_number_type<NUM_ARROW_T>::value | arrow::is_boolean_type<NUM_ARROW_T>::value>::type>
-cylon::Status AllReduce(cylon::net::CommType comm_type,
+cylon::Status AllReduce(std::shared_ptr<cylon::CylonContext> &ctx,
                         const arrow::compute::Datum &send,
                         std::shared_ptr<Result> &output,
                         const std::shared_ptr<DataType> &data_type,
@@ -49,29 +48,22 @@ cylon::Status AllReduce(cylon::net::CommType comm_type,
   const std::shared_ptr<NUM_ARROW_SCALAR_T> &send_scalar = std::static_pointer_cast<NUM_ARROW_SCALAR_T>(send.scalar());
   std::shared_ptr<NUM_ARROW_SCALAR_T> recv_scalar = std::make_shared<NUM_ARROW_SCALAR_T>();
 
-  switch (comm_type) {
-    case net::LOCAL: {
-      output = std::make_shared<Result>(send);
-      return cylon::Status::OK();
-    }
-    case cylon::net::CommType::MPI: {
-      cylon::Status status = cylon::mpi::AllReduce(&(send_scalar->value),
-                                                   &(recv_scalar->value),
-                                                   send.length(),
-                                                   data_type,
-                                                   reduce_op);
-      // build the output datum 
-      if (status.is_ok()) {
-        arrow::compute::Datum global_result(recv_scalar);
-        output = std::make_shared<Result>(global_result);
-      }
-
-      return status;
-    }
-    case net::TCP: // fall through
-    case net::UCX: // fall through
-    default: return cylon::Status(cylon::Code::NotImplemented, "Mode is not supported!");
+  if (!ctx->IsDistributed()) {
+    output = std::make_shared<Result>(send);
+    return cylon::Status::OK();
+  }
+
+  cylon::Status status = ctx->GetCommunicator()->AllReduce(&(send_scalar->value),
+                                                           &(recv_scalar->value),
+                                                           send.length(),
+                                                           data_type,
+                                                           reduce_op);
+  // build the output datum
+  if (status.is_ok()) {
+    arrow::compute::Datum global_result(recv_scalar);
+    output = std::make_shared<Result>(global_result);
   }
+  return status;
 }
 
 cylon::Status DoAllReduce(std::shared_ptr<cylon::CylonContext> &ctx,
@@ -79,70 +71,69 @@ cylon::Status DoAllReduce(std::shared_ptr<cylon::CylonContext> &ctx,
                           std::shared_ptr<Result> &receive,
                           const std::shared_ptr<DataType> &data_type,
                           cylon::net::ReduceOp reduce_op) {
-  auto comm_type = ctx->GetCommType();
   switch (data_type->getType()) {
     case Type::BOOL:
-      return cylon::compute::AllReduce<arrow::BooleanType>(comm_type,
+      return cylon::compute::AllReduce<arrow::BooleanType>(ctx,
                                                            send,
                                                            receive,
                                                            data_type,
                                                            reduce_op);
     case Type::UINT8:
-      return cylon::compute::AllReduce<arrow::UInt8Type>(comm_type,
+      return cylon::compute::AllReduce<arrow::UInt8Type>(ctx,
                                                          send,
                                                          receive,
                                                          data_type,
                                                          reduce_op);
     case Type::INT8:
-      return cylon::compute::AllReduce<arrow::Int8Type>(comm_type,
+      return cylon::compute::AllReduce<arrow::Int8Type>(ctx,
                                                         send,
                                                         receive,
                                                         data_type,
                                                         reduce_op);
     case Type::UINT16:
-      return cylon::compute::AllReduce<arrow::UInt16Type>(comm_type,
+      return cylon::compute::AllReduce<arrow::UInt16Type>(ctx,
                                                           send,
                                                           receive,
                                                           data_type,
                                                           reduce_op);
     case Type::INT16:
-      return cylon::compute::AllReduce<arrow::Int16Type>(comm_type,
+      return cylon::compute::AllReduce<arrow::Int16Type>(ctx,
                                                          send,
                                                          receive,
                                                          data_type,
                                                          reduce_op);
     case Type::UINT32:
-      return cylon::compute::AllReduce<arrow::UInt32Type>(comm_type,
+      return cylon::compute::AllReduce<arrow::UInt32Type>(ctx,
                                                           send,
                                                           receive,
                                                           data_type,
                                                           reduce_op);
     case Type::INT32:
-      return cylon::compute::AllReduce<arrow::Int32Type>(comm_type,
+      return cylon::compute::AllReduce<arrow::Int32Type>(ctx,
                                                          send,
                                                          receive,
                                                          data_type,
                                                          reduce_op);
     case Type::UINT64:
-      return cylon::compute::AllReduce<arrow::UInt64Type>(comm_type,
+      return cylon::compute::AllReduce<arrow::UInt64Type>(ctx,
                                                           send,
                                                           receive,
                                                           data_type,
                                                           reduce_op);
     case Type::INT64:
-      return cylon::compute::AllReduce<arrow::Int64Type>(comm_type,
+      return cylon::compute::AllReduce<arrow::Int64Type>(ctx,
                                                          send,
                                                          receive,
                                                          data_type,
                                                          reduce_op);
     case Type::FLOAT:
-      return cylon::compute::AllReduce<arrow::FloatType>(comm_type,
+      return cylon::compute::AllReduce<arrow::FloatType>(ctx,
                                                          send,
                                                          receive,
                                                          data_type,
                                                          reduce_op);
     case Type::DOUBLE:
-      return cylon::compute::AllReduce<arrow::DoubleType>(comm_type,
+      return cylon::compute::AllReduce<arrow::DoubleType>(ctx,
                                                           send,
                                                           receive,
                                                           data_type,
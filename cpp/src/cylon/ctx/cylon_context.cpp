@@ -13,15 +13,30 @@
  */
 
 #include <glog/logging.h>
+#include <mpi.h>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "cylon_context.hpp"
 #include "arrow/memory_pool.h"
 #include "../net/mpi/mpi_communicator.hpp"
+#include "../net/shm/shm_communicator.hpp"
+#include "../net/tcp/tcp_communicator.hpp"
 
 namespace cylon {
 
+constexpr const char *CylonContext::THREADS_CONFIG;
+constexpr const char *CylonContext::SHUFFLE_SLICE_ROWS_CONFIG;
+constexpr const char *CylonContext::SHUFFLE_MAX_IN_FLIGHT_BYTES_CONFIG;
+constexpr const char *CylonContext::ALLTOALL_PACK_THRESHOLD_CONFIG;
+constexpr const char *CylonContext::ALLTOALL_RECEIVE_REGION_BYTES_CONFIG;
+constexpr const char *CylonContext::ALLTOALL_MAX_TARGET_BYTES_CONFIG;
+constexpr const char *CylonContext::SHUFFLE_COMBINE_CHUNKS_CONFIG;
+constexpr const char *CylonContext::PROGRESS_STRATEGY_CONFIG;
+constexpr const char *CylonContext::PROGRESS_THREAD_CONFIG;
+constexpr const char *CylonContext::PROGRESS_SPINS_CONFIG;
+
 std::shared_ptr<CylonContext> CylonContext::Init() {
   return std::make_shared<CylonContext>(false);
 }
@@ -36,11 +51,39 @@ std::shared_ptr<CylonContext> CylonContext::InitDistributed(const std::shared_pt
     ctx->communicator->Init(config);
     ctx->is_distributed = true;
     return ctx;
+  } else if (config->Type() == net::CommType::SHM) {
+    auto ctx = std::make_shared<CylonContext>(true);
+    ctx->communicator = std::make_shared<net::SHMCommunicator>();
+    ctx->communicator->Init(config);
+    ctx->is_distributed = true;
+    return ctx;
+  } else if (config->Type() == net::CommType::TCP) {
+    auto ctx = std::make_shared<CylonContext>(true);
+    ctx->communicator = std::make_shared<net::TCPCommunicator>();
+    ctx->communicator->Init(config);
+    ctx->is_distributed = true;
+    return ctx;
   } else {
     throw "Unsupported communication type";
   }
   return nullptr;
 }
+std::shared_ptr<CylonContext> CylonContext::Split(int color, int key) {
+  if (color < 0) {
+    if (this->is_distributed) {
+      this->communicator->Split(color, key);
+    }
+    return nullptr;
+  }
+  auto ctx = std::make_shared<CylonContext>(this->is_distributed);
+  if (this->is_distributed) {
+    ctx->communicator = this->communicator->Split(color, key);
+  }
+  ctx->config = this->config;
+  ctx->memory_pool = this->memory_pool;
+  return ctx;
+}
+
 std::shared_ptr<net::Communicator> CylonContext::GetCommunicator() const {
   if (!is_distributed) {
     LOG(FATAL) << "No communicator available for local mode!";
@@ -58,7 +101,14 @@ void CylonContext::setDistributed(bool distributed) {
 }
 
 void CylonContext::AddConfig(const std::string &key, const std::string &value) {
-  this->config.insert(std::pair<std::string, std::string>(key, value));
+  this->config[key] = value;
+  if (key == THREADS_CONFIG) {
+    // the pool will be recreated with the new thread count
+    this->thread_pool.reset();
+  } else if (key == PROGRESS_STRATEGY_CONFIG || key == PROGRESS_THREAD_CONFIG
+      || key == PROGRESS_SPINS_CONFIG) {
+    this->progress_engine.reset();
+  }
 }
 std::string CylonContext::GetConfig(const std::string &key, const std::string &def) {
   auto find = this->config.find(key);
@@ -103,6 +153,43 @@ cylon::MemoryPool *CylonContext::GetMemoryPool() {
 void CylonContext::SetMemoryPool(cylon::MemoryPool *mem_pool) {
   this->memory_pool = mem_pool;
 }
+std::shared_ptr<cylon::util::ThreadPool> CylonContext::GetThreadPool() {
+  if (this->thread_pool == nullptr) {
+    int threads = std::stoi(this->GetConfig(THREADS_CONFIG, "1"));
+    this->thread_pool = std::make_shared<cylon::util::ThreadPool>(threads);
+  }
+  return this->thread_pool;
+}
+
+std::shared_ptr<cylon::net::ProgressEngine> CylonContext::GetProgressEngine() {
+  if (this->progress_engine == nullptr) {
+    std::string strategy_name = this->GetConfig(PROGRESS_STRATEGY_CONFIG, "yield");
+    net::ProgressStrategy strategy = net::ProgressStrategy::SPIN_YIELD;
+    if (strategy_name == "spin") {
+      strategy = net::ProgressStrategy::SPIN;
+    } else if (strategy_name == "block") {
+      strategy = net::ProgressStrategy::BLOCKING;
+    } else if (strategy_name != "yield") {
+      LOG(WARNING) << "Unknown progress strategy " << strategy_name << ", using yield";
+    }
+
+    bool progress_thread = this->GetConfig(PROGRESS_THREAD_CONFIG, "false") == "true";
+    if (progress_thread && net::IsMPIBased(this->GetCommType())) {
+      int provided;
+      MPI_Query_thread(&provided);
+      if (provided < MPI_THREAD_SERIALIZED) {
+        LOG(WARNING) << "MPI does not support MPI_THREAD_SERIALIZED, progressing inline";
+        progress_thread = false;
+      }
+    }
+
+    int spins = std::stoi(this->GetConfig(PROGRESS_SPINS_CONFIG, "1000"));
+    this->progress_engine = std::make_shared<net::ProgressEngine>(strategy, progress_thread,
+                                                                  spins);
+  }
+  return this->progress_engine;
+}
+
 int32_t CylonContext::GetNextSequence() {
   return this->sequence_no++;
 }
@@ -20,6 +20,8 @@
 #include "../net/comm_config.hpp"
 #include "../net/communicator.hpp"
 #include "memory_pool.hpp"
+#include "../util/thread_pool.hpp"
+#include "../net/progress_engine.hpp"
 
 namespace cylon {
 
@@ -34,8 +36,72 @@ class CylonContext {
   std::shared_ptr<cylon::net::Communicator> communicator{};
   cylon::MemoryPool *memory_pool{};
   int32_t sequence_no = 0;
+  std::shared_ptr<cylon::util::ThreadPool> thread_pool{};
+  std::shared_ptr<cylon::net::ProgressEngine> progress_engine{};
 
  public:
+  /**
+   * Configuration key for the number of threads used by the local operations of a worker
+   */
+  static constexpr const char *THREADS_CONFIG = "cylon.threads";
+
+  /**
+   * Configuration key for the number of rows of a slice of a streaming shuffle (default 1M).
+   * Tables with more rows are partitioned and sent slice by slice, 0 disables streaming
+   */
+  static constexpr const char *SHUFFLE_SLICE_ROWS_CONFIG = "cylon.shuffle.slice_rows";
+
+  /**
+   * Configuration key for the bytes a streaming shuffle keeps in flight (default 256MB). The next
+   * slice is partitioned only after the sends go below this
+   */
+  static constexpr const char *SHUFFLE_MAX_IN_FLIGHT_BYTES_CONFIG =
+      "cylon.shuffle.max_in_flight_bytes";
+
+  /**
+   * Configuration key for the size in bytes up to which an ArrowAllToAll packs a table in to a
+   * single message instead of sending each buffer separately (default 1MB), 0 disables packing
+   */
+  static constexpr const char *ALLTOALL_PACK_THRESHOLD_CONFIG = "cylon.alltoall.pack_threshold";
+
+  /**
+   * Configuration key for the size of the regions an ArrowAllToAll receives the messages of a
+   * source in to (default 8MB), 0 allocates a buffer for every message
+   */
+  static constexpr const char *ALLTOALL_RECEIVE_REGION_BYTES_CONFIG =
+      "cylon.alltoall.receive_region_bytes";
+
+  /**
+   * Configuration key for the bytes of the tables an ArrowAllToAll queues for a target (default
+   * 64MB). Further tables are rejected until the queued ones are sent, 0 disables the limit
+   */
+  static constexpr const char *ALLTOALL_MAX_TARGET_BYTES_CONFIG =
+      "cylon.alltoall.max_target_bytes";
+
+  /**
+   * Configuration key for combining the chunks of the table received by Table::Shuffle in to a
+   * single chunk, true (default) or false. Without it the table keeps a chunk for every received
+   * partition, which refer to the receive buffers without copying
+   */
+  static constexpr const char *SHUFFLE_COMBINE_CHUNKS_CONFIG = "cylon.shuffle.combine_chunks";
+
+  /**
+   * Configuration key for what the communication operations do when there is nothing to
+   * progress. spin, yield (spin then yield, the default) or block (spin then MPI_Waitsome)
+   */
+  static constexpr const char *PROGRESS_STRATEGY_CONFIG = "cylon.progress.strategy";
+
+  /**
+   * Configuration key for running the progress loop on a dedicated thread, true or false (default)
+   */
+  static constexpr const char *PROGRESS_THREAD_CONFIG = "cylon.progress.thread";
+
+  /**
+   * Configuration key for the number of idle progress passes before yielding or blocking
+   * (default 1000)
+   */
+  static constexpr const char *PROGRESS_SPINS_CONFIG = "cylon.progress.spins";
+
   /**
    * Constructor
    * @param distributed <bool>
@@ -55,6 +121,17 @@ class CylonContext {
    */
   static std::shared_ptr<CylonContext> InitDistributed(const std::shared_ptr<cylon::net::CommConfig> &config);
 
+  /**
+   * Split the workers in to groups by the color, this is a collective of all the workers of this
+   * context. The context of a group has the configurations and the memory pool of this context
+   * and its own communicator and sequence numbers, so that the operations of the groups run
+   * concurrently without interfering. The context of a group should be finalized before this one
+   * @param color group of this worker, a negative color does not join a group
+   * @param key the workers of a group are ranked by the key and then by their rank
+   * @return context of the group of this worker, nullptr for a negative color
+   */
+  std::shared_ptr<CylonContext> Split(int color, int key = 0);
+
   /**
    * Completes and closes all operations under the context
    */
@@ -126,6 +203,20 @@ class CylonContext {
    */
   void SetMemoryPool(cylon::MemoryPool *mem_pool);
 
+  /**
+   * Returns the thread pool of this context. The pool is created on first use with the number
+   * of threads given by the THREADS_CONFIG configuration (default 1)
+   * @return <cylon::util::ThreadPool>
+   */
+  std::shared_ptr<cylon::util::ThreadPool> GetThreadPool();
+
+  /**
+   * Returns the progress engine that drives the communication operations of this context. The
+   * engine is created on first use from the PROGRESS_* configurations
+   * @return <cylon::net::ProgressEngine>
+   */
+  std::shared_ptr<cylon::net::ProgressEngine> GetProgressEngine();
+
   /**
    * Returns the next sequence number
    * @return <int>
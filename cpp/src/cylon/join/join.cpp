@@ -15,7 +15,10 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <chrono>
+#include <numeric>
+#include <utility>
 #include <vector>
 #include <memory>
 #include <string>
@@ -23,6 +26,9 @@
 #include "arrow/compute/api.h"
 #include "join_utils.hpp"
 #include "../util/arrow_utils.hpp"
+#include "../util/flat_hash_multimap.hpp"
+#include "../arrow/arrow_comparator.hpp"
+#include "../arrow/arrow_partition_kernels.hpp"
 
 namespace cylon {
 namespace join {
@@ -80,7 +86,8 @@ arrow::Status do_inplace_sorted_join(const std::shared_ptr<arrow::Table> &left_t
                                      int64_t right_join_column_idx,
                                      cylon::join::config::JoinType join_type,
                                      std::shared_ptr<arrow::Table> *joined_table,
-                                     arrow::MemoryPool *memory_pool) {
+                                     arrow::MemoryPool *memory_pool,
+                                     cylon::util::ThreadPool *thread_pool) {
   // combine chunks if multiple chunks are available
   std::shared_ptr<arrow::Table> left_tab_comb, right_tab_comb;
   arrow::Status lstatus, rstatus;
@@ -106,7 +113,8 @@ arrow::Status do_inplace_sorted_join(const std::shared_ptr<arrow::Table> &left_t
 
   auto t1 = std::chrono::high_resolution_clock::now();
   std::shared_ptr<arrow::UInt64Array> left_index_sorted_column;
-  auto status = SortIndicesInPlace(memory_pool, left_join_column, &left_index_sorted_column);
+  auto status = SortIndicesInPlace(memory_pool, left_join_column, &left_index_sorted_column,
+                                   thread_pool);
   if (status != arrow::Status::OK()) {
     LOG(FATAL) << "Failed when sorting left table to indices. " << status.ToString();
     return status;
@@ -117,7 +125,8 @@ arrow::Status do_inplace_sorted_join(const std::shared_ptr<arrow::Table> &left_t
 
   t1 = std::chrono::high_resolution_clock::now();
   std::shared_ptr<arrow::UInt64Array> right_index_sorted_column;
-  status = SortIndicesInPlace(memory_pool, right_join_column, &right_index_sorted_column);
+  status = SortIndicesInPlace(memory_pool, right_join_column, &right_index_sorted_column,
+                              thread_pool);
   if (status != arrow::Status::OK()) {
     LOG(FATAL) << "Failed when sorting right table to indices. " << status.ToString();
     return status;
@@ -263,7 +272,8 @@ arrow::Status do_sorted_join(const std::shared_ptr<arrow::Table> &left_tab,
                              int64_t right_join_column_idx,
                              cylon::join::config::JoinType join_type,
                              std::shared_ptr<arrow::Table> *joined_table,
-                             arrow::MemoryPool *memory_pool) {
+                             arrow::MemoryPool *memory_pool,
+                             cylon::util::ThreadPool *thread_pool) {
   // combine chunks if multiple chunks are available
   std::shared_ptr<arrow::Table> left_tab_comb, right_tab_comb;
   arrow::Status lstatus, rstatus;
@@ -290,7 +300,8 @@ arrow::Status do_sorted_join(const std::shared_ptr<arrow::Table> &left_tab,
 
   auto t1 = std::chrono::high_resolution_clock::now();
   std::shared_ptr<arrow::Array> left_index_sorted_column;
-  auto status = SortIndices(memory_pool, left_join_column, &left_index_sorted_column);
+  auto status = SortIndices(memory_pool, left_join_column, &left_index_sorted_column,
+                            thread_pool);
   if (status != arrow::Status::OK()) {
     LOG(FATAL) << "Failed when sorting left table to indices. " << status.ToString();
     return status;
@@ -301,7 +312,8 @@ arrow::Status do_sorted_join(const std::shared_ptr<arrow::Table> &left_tab,
 
   t1 = std::chrono::high_resolution_clock::now();
   std::shared_ptr<arrow::Array> right_index_sorted_column;
-  status = SortIndices(memory_pool, right_join_column, &right_index_sorted_column);
+  status = SortIndices(memory_pool, right_join_column, &right_index_sorted_column,
+                       thread_pool);
   if (status != arrow::Status::OK()) {
     LOG(FATAL) << "Failed when sorting right table to indices. " << status.ToString();
     return status;
@@ -455,8 +467,10 @@ arrow::Status do_sorted_join(const std::shared_ptr<arrow::Table> &left_tab,
  * @param left_join_column_idx
  * @param right_join_column_idx
  * @param join_typeas
+ * @param join_algorithm HASH or RADIX_HASH
  * @param joined_table
  * @param memory_pool
+ * @param thread_pool thread pool for the probe phase, can be nullptr
  * @return arrow status
  */
 template<typename ARROW_ARRAY_TYPE, typename CPP_KEY_TYPE>
@@ -465,8 +479,10 @@ arrow::Status do_hash_join(const std::shared_ptr<arrow::Table> &left_tab,
                            int64_t left_join_column_idx,
                            int64_t right_join_column_idx,
                            cylon::join::config::JoinType join_type,
+                           cylon::join::config::JoinAlgorithm join_algorithm,
                            std::shared_ptr<arrow::Table> *joined_table,
-                           arrow::MemoryPool *memory_pool) {
+                           arrow::MemoryPool *memory_pool,
+                           cylon::util::ThreadPool *thread_pool) {
   // combine chunks if multiple chunks are available
   std::shared_ptr<arrow::Table> left_tab_comb, right_tab_comb;
   arrow::Status lstatus, rstatus;
@@ -502,8 +518,14 @@ arrow::Status do_hash_join(const std::shared_ptr<arrow::Table> &left_tab,
 
   auto t1 = std::chrono::high_resolution_clock::now();
 
-  auto result = ArrowArrayIdxHashJoinKernel<ARROW_ARRAY_TYPE, CPP_KEY_TYPE>()
-      .IdxHashJoin(left_idx_column, right_idx_column, join_type, left_indices, right_indices);
+  int result;
+  if (join_algorithm == cylon::join::config::RADIX_HASH) {
+    result = ArrowArrayRadixHashJoinKernel<ARROW_ARRAY_TYPE, CPP_KEY_TYPE>(thread_pool)
+        .IdxHashJoin(left_idx_column, right_idx_column, join_type, left_indices, right_indices);
+  } else {
+    result = ArrowArrayIdxHashJoinKernel<ARROW_ARRAY_TYPE, CPP_KEY_TYPE>(thread_pool)
+        .IdxHashJoin(left_idx_column, right_idx_column, join_type, left_indices, right_indices);
+  }
 //  left_indices->shrink_to_fit();
 //  right_indices->shrink_to_fit();
   auto t2 = std::chrono::high_resolution_clock::now();
@@ -546,8 +568,9 @@ arrow::Status do_join(const std::shared_ptr<arrow::Table> &left_tab,
                       cylon::join::config::JoinType join_type,
                       cylon::join::config::JoinAlgorithm join_algorithm,
                       std::shared_ptr<arrow::Table> *joined_table,
-                      arrow::MemoryPool *memory_pool) {
-  arrow::Type::type kType = left_tab->column(left_join_column_idx)->chunk(0)->type()->id();
+                      arrow::MemoryPool *memory_pool,
+                      cylon::util::ThreadPool *thread_pool) {
+  arrow::Type::type kType = left_tab->column(left_join_column_idx)->type()->id();
   switch (join_algorithm) {
     case cylon::join::config::SORT:
       if (kType == arrow::Type::UINT8 || kType == arrow::Type::INT8 ||
@@ -560,31 +583,333 @@ arrow::Status do_join(const std::shared_ptr<arrow::Table> &left_tab,
                                                                       left_join_column_idx,
                                                                       right_join_column_idx,
                                                                       join_type,
-                                                                      joined_table, memory_pool);
+                                                                      joined_table, memory_pool,
+                                                                      thread_pool);
       } else {
         return do_sorted_join<ARROW_ARRAY_TYPE, CPP_KEY_TYPE>(left_tab,
                                                               right_tab,
                                                               left_join_column_idx,
                                                               right_join_column_idx,
                                                               join_type,
-                                                              joined_table, memory_pool);
+                                                              joined_table, memory_pool,
+                                                              thread_pool);
       }
     case cylon::join::config::HASH:
+    case cylon::join::config::RADIX_HASH:
       return do_hash_join<ARROW_ARRAY_TYPE, CPP_KEY_TYPE>(left_tab,
                                                           right_tab,
                                                           left_join_column_idx,
                                                           right_join_column_idx,
                                                           join_type,
-                                                          joined_table, memory_pool);
+                                                          join_algorithm,
+                                                          joined_table, memory_pool,
+                                                          thread_pool);
   }
   return arrow::Status::OK();
 }
 
+/**
+ * Identifies a row of the key tables of a multi column join. first is 0 for the build table and
+ * 1 for the probe table, second is the row index
+ */
+using KeyRow = std::pair<int8_t, int64_t>;
+
+// returns the precomputed row hashes of the key tables
+class KeyRowHash {
+ public:
+  explicit KeyRowHash(const std::vector<int32_t> *hashes) : hashes(hashes) {}
+
+  size_t operator()(const KeyRow &row) const {
+    return static_cast<uint32_t>(hashes[row.first][row.second]);
+  }
+
+ private:
+  const std::vector<int32_t> *hashes;
+};
+
+// compares the hashes first and then the key columns
+class KeyRowEqual {
+ public:
+  KeyRowEqual(const std::vector<int32_t> *hashes,
+              const std::shared_ptr<arrow::Table> *keys,
+              const std::shared_ptr<cylon::TableRowComparator> &comparator)
+      : hashes(hashes), keys(keys), comparator(comparator) {}
+
+  bool operator()(const KeyRow &row1, const KeyRow &row2) const {
+    return hashes[row1.first][row1.second] == hashes[row2.first][row2.second]
+        && comparator->compare(keys[row1.first], row1.second,
+                               keys[row2.first], row2.second) == 0;
+  }
+
+ private:
+  const std::vector<int32_t> *hashes;
+  const std::shared_ptr<arrow::Table> *keys;
+  std::shared_ptr<cylon::TableRowComparator> comparator;
+};
+
+/**
+ * Create a table with only the key columns, without copying the column data
+ */
+std::shared_ptr<arrow::Table> make_key_table(const std::shared_ptr<arrow::Table> &table,
+                                             const std::vector<int> &key_columns) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (int c : key_columns) {
+    fields.push_back(table->schema()->field(c));
+    columns.push_back(table->column(c));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+/**
+ * Hash join on the key tables. The build table is loaded in to a hash map keyed by the row,
+ * using the row hashes of RowHashingKernel and the row equality of TableRowComparator
+ * @param fill_probe add the unmatched probe rows with -1
+ * @param fill_build add the unmatched build rows with -1
+ */
+void multi_column_hash_join(const std::shared_ptr<arrow::Table> &build_keys,
+                            const std::shared_ptr<arrow::Table> &probe_keys,
+                            bool fill_probe,
+                            bool fill_build,
+                            const std::shared_ptr<std::vector<int64_t>> &build_indices,
+                            const std::shared_ptr<std::vector<int64_t>> &probe_indices,
+                            arrow::MemoryPool *memory_pool) {
+  const std::shared_ptr<arrow::Table> keys[2] = {build_keys, probe_keys};
+  std::vector<int32_t> hashes[2];
+  cylon::RowHashingKernel row_hashing_kernel(build_keys->schema()->fields(), memory_pool);
+  for (int t = 0; t < 2; t++) {
+    hashes[t].resize(keys[t]->num_rows());
+    for (int64_t i = 0; i < keys[t]->num_rows(); i++) {
+      hashes[t][i] = row_hashing_kernel.Hash(keys[t], i);
+    }
+  }
+  auto comparator = std::make_shared<cylon::TableRowComparator>(build_keys->schema()->fields());
+
+  const int64_t build_rows = build_keys->num_rows();
+  cylon::util::FlatHashMultiMap<KeyRow, KeyRowHash, KeyRowEqual>
+      idx_map(build_rows, KeyRowHash(hashes), KeyRowEqual(hashes, keys, comparator));
+  for (int64_t i = build_rows - 1; i >= 0; i--) {
+    idx_map.Insert(KeyRow(0, i), i);
+  }
+
+  std::vector<bool> matched(fill_build ? build_rows : 0, false);
+  for (int64_t i = 0; i < probe_keys->num_rows(); i++) {
+    int64_t row = idx_map.Find(KeyRow(1, i));
+    if (row < 0) {
+      if (fill_probe) {
+        build_indices->push_back(-1);
+        probe_indices->push_back(i);
+      }
+      continue;
+    }
+    for (; row >= 0; row = idx_map.Next(row)) {
+      if (fill_build) {
+        matched[row] = true;
+      }
+      build_indices->push_back(row);
+      probe_indices->push_back(i);
+    }
+  }
+
+  if (fill_build) {
+    for (int64_t row = 0; row < build_rows; row++) {
+      if (!matched[row]) {
+        build_indices->push_back(row);
+        probe_indices->push_back(-1);
+      }
+    }
+  }
+}
+
+/**
+ * Sort merge join on the key tables, the rows are ordered with TableRowComparator
+ */
+void multi_column_sorted_join(const std::shared_ptr<arrow::Table> &left_keys,
+                              const std::shared_ptr<arrow::Table> &right_keys,
+                              cylon::join::config::JoinType join_type,
+                              const std::shared_ptr<std::vector<int64_t>> &left_indices,
+                              const std::shared_ptr<std::vector<int64_t>> &right_indices) {
+  cylon::TableRowComparator comparator(left_keys->schema()->fields());
+
+  auto sort_rows = [&comparator](const std::shared_ptr<arrow::Table> &keys,
+                                 std::vector<int64_t> &order) {
+    order.resize(keys->num_rows());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+      return comparator.compare(keys, a, keys, b) < 0;
+    });
+  };
+  std::vector<int64_t> left_order, right_order;
+  sort_rows(left_keys, left_order);
+  sort_rows(right_keys, right_order);
+
+  const bool fill_left = join_type == cylon::join::config::LEFT
+      || join_type == cylon::join::config::FULL_OUTER;
+  const bool fill_right = join_type == cylon::join::config::RIGHT
+      || join_type == cylon::join::config::FULL_OUTER;
+
+  // end of the group of equal keys starting at start
+  auto group_end = [&comparator](const std::shared_ptr<arrow::Table> &keys,
+                                 const std::vector<int64_t> &order, size_t start) {
+    size_t end = start + 1;
+    while (end < order.size() && comparator.compare(keys, order[start], keys, order[end]) == 0) {
+      end++;
+    }
+    return end;
+  };
+
+  size_t left_current = 0, right_current = 0;
+  size_t left_end = left_order.empty() ? 0 : group_end(left_keys, left_order, 0);
+  size_t right_end = right_order.empty() ? 0 : group_end(right_keys, right_order, 0);
+  while (left_current < left_order.size() && right_current < right_order.size()) {
+    int cmp = comparator.compare(left_keys, left_order[left_current],
+                                 right_keys, right_order[right_current]);
+    if (cmp == 0) {
+      for (size_t l = left_current; l < left_end; l++) {
+        for (size_t r = right_current; r < right_end; r++) {
+          left_indices->push_back(left_order[l]);
+          right_indices->push_back(right_order[r]);
+        }
+      }
+    } else if (cmp < 0) {
+      for (size_t l = left_current; fill_left && l < left_end; l++) {
+        left_indices->push_back(left_order[l]);
+        right_indices->push_back(-1);
+      }
+    } else {
+      for (size_t r = right_current; fill_right && r < right_end; r++) {
+        left_indices->push_back(-1);
+        right_indices->push_back(right_order[r]);
+      }
+    }
+    // advance the groups with the smaller key, or both of them if they are equal
+    if (cmp <= 0) {
+      left_current = left_end;
+      if (left_current < left_order.size()) {
+        left_end = group_end(left_keys, left_order, left_current);
+      }
+    }
+    if (cmp >= 0) {
+      right_current = right_end;
+      if (right_current < right_order.size()) {
+        right_end = group_end(right_keys, right_order, right_current);
+      }
+    }
+  }
+
+  for (size_t l = left_current; fill_left && l < left_order.size(); l++) {
+    left_indices->push_back(left_order[l]);
+    right_indices->push_back(-1);
+  }
+  for (size_t r = right_current; fill_right && r < right_order.size(); r++) {
+    left_indices->push_back(-1);
+    right_indices->push_back(right_order[r]);
+  }
+}
+
+/**
+ * Join on multiple key columns
+ * @param left_tab
+ * @param right_tab
+ * @param join_config
+ * @param joined_table
+ * @param memory_pool
+ * @return arrow status
+ */
+arrow::Status do_multi_column_join(const std::shared_ptr<arrow::Table> &left_tab,
+                                   const std::shared_ptr<arrow::Table> &right_tab,
+                                   const cylon::join::config::JoinConfig &join_config,
+                                   std::shared_ptr<arrow::Table> *joined_table,
+                                   arrow::MemoryPool *memory_pool) {
+  const std::vector<int> &left_columns = join_config.GetLeftColumnIndices();
+  const std::vector<int> &right_columns = join_config.GetRightColumnIndices();
+  if (left_columns.size() != right_columns.size()) {
+    LOG(FATAL) << "The number of join columns of two tables mismatches.";
+    return arrow::Status::Invalid("The number of join columns of two tables mismatches.");
+  }
+  for (size_t c = 0; c < left_columns.size(); c++) {
+    if (!left_tab->column(left_columns[c])->type()->Equals(
+        right_tab->column(right_columns[c])->type())) {
+      LOG(FATAL) << "The join column types of two tables mismatches.";
+      return arrow::Status::Invalid("The join column types of two tables mismatches.");
+    }
+  }
+
+  // combine chunks if multiple chunks are available
+  auto t1 = std::chrono::high_resolution_clock::now();
+  std::shared_ptr<arrow::Table> left_tab_comb, right_tab_comb;
+  arrow::Status status = left_tab->CombineChunks(memory_pool, &left_tab_comb);
+  if (!status.ok()) {
+    LOG(ERROR) << "Combining chunks failed!";
+    return status;
+  }
+  status = right_tab->CombineChunks(memory_pool, &right_tab_comb);
+  if (!status.ok()) {
+    LOG(ERROR) << "Combining chunks failed!";
+    return status;
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+  LOG(INFO) << "Combine chunks time : "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+  std::shared_ptr<arrow::Table> left_keys = make_key_table(left_tab_comb, left_columns);
+  std::shared_ptr<arrow::Table> right_keys = make_key_table(right_tab_comb, right_columns);
+
+  std::shared_ptr<std::vector<int64_t>> left_indices = std::make_shared<std::vector<int64_t>>();
+  std::shared_ptr<std::vector<int64_t>> right_indices = std::make_shared<std::vector<int64_t>>();
+
+  t1 = std::chrono::high_resolution_clock::now();
+  if (join_config.GetAlgorithm() == cylon::join::config::SORT) {
+    multi_column_sorted_join(left_keys, right_keys, join_config.GetType(),
+                             left_indices, right_indices);
+  } else {
+    switch (join_config.GetType()) {
+      case cylon::join::config::RIGHT:
+        multi_column_hash_join(left_keys, right_keys, true, false,
+                               left_indices, right_indices, memory_pool);
+        break;
+      case cylon::join::config::LEFT:
+        multi_column_hash_join(right_keys, left_keys, true, false,
+                               right_indices, left_indices, memory_pool);
+        break;
+      case cylon::join::config::INNER:
+      case cylon::join::config::FULL_OUTER: {
+        bool outer = join_config.GetType() == cylon::join::config::FULL_OUTER;
+        if (left_keys->num_rows() < right_keys->num_rows()) {
+          multi_column_hash_join(left_keys, right_keys, outer, outer,
+                                 left_indices, right_indices, memory_pool);
+        } else {
+          multi_column_hash_join(right_keys, left_keys, outer, outer,
+                                 right_indices, left_indices, memory_pool);
+        }
+        break;
+      }
+    }
+  }
+  t2 = std::chrono::high_resolution_clock::now();
+  LOG(INFO) << "Index join time : "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+  LOG(INFO) << "Building final table with number of tuples - " << left_indices->size();
+
+  t1 = std::chrono::high_resolution_clock::now();
+  status = cylon::join::util::build_final_table(
+      left_indices, right_indices,
+      left_tab_comb,
+      right_tab_comb,
+      joined_table,
+      memory_pool);
+  t2 = std::chrono::high_resolution_clock::now();
+  LOG(INFO) << "Built final table in : "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+  return status;
+}
+
 arrow::Status joinTables(const std::vector<std::shared_ptr<arrow::Table>> &left_tabs,
                          const std::vector<std::shared_ptr<arrow::Table>> &right_tabs,
                          cylon::join::config::JoinConfig join_config,
                          std::shared_ptr<arrow::Table> *joined_table,
-                         arrow::MemoryPool *memory_pool) {
+                         arrow::MemoryPool *memory_pool,
+                         cylon::util::ThreadPool *thread_pool) {
   std::shared_ptr<arrow::Table> left_tab = arrow::ConcatenateTables(left_tabs,
       arrow::ConcatenateTablesOptions::Defaults(),
       memory_pool).ValueOrDie();
@@ -629,14 +954,23 @@ arrow::Status joinTables(const std::vector<std::shared_ptr<arrow::Table>> &left_
                                  right_tab_combined,
                                  join_config,
                                  joined_table,
-                                 memory_pool);
+                                 memory_pool,
+                                 thread_pool);
 }
 
 arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                          const std::shared_ptr<arrow::Table> &right_tab,
                          cylon::join::config::JoinConfig join_config,
                          std::shared_ptr<arrow::Table> *joined_table,
-                         arrow::MemoryPool *memory_pool) {
+                         arrow::MemoryPool *memory_pool,
+                         cylon::util::ThreadPool *thread_pool) {
+  if (!join_config.IsValid()) {
+    return arrow::Status::Invalid("The join needs the same number of left and right key columns");
+  }
+  if (join_config.IsMultiColumn()) {
+    return do_multi_column_join(left_tab, right_tab, join_config, joined_table, memory_pool);
+  }
+
   auto left_type = left_tab->column(join_config.GetLeftColumnIdx())->type()->id();
   auto right_type = right_tab->column(join_config.GetRightColumnIdx())->type()->id();
 
@@ -656,7 +990,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::INT8:
       return do_join<arrow::NumericArray<arrow::Int8Type>, int8_t>(left_tab,
                                                                    right_tab,
@@ -665,7 +1000,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::UINT16:
       return do_join<arrow::NumericArray<arrow::UInt16Type>, uint16_t>(left_tab,
                                                                    right_tab,
@@ -674,7 +1010,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::INT16:
       return do_join<arrow::NumericArray<arrow::Int16Type>, int16_t>(left_tab,
                                                                    right_tab,
@@ -683,7 +1020,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::UINT32:
       return do_join<arrow::NumericArray<arrow::UInt32Type>, uint32_t>(left_tab,
                                                                    right_tab,
@@ -692,7 +1030,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::INT32:
       return do_join<arrow::NumericArray<arrow::Int32Type>, int32_t>(left_tab,
                                                                    right_tab,
@@ -701,7 +1040,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::UINT64:
       return do_join<arrow::NumericArray<arrow::UInt64Type>, uint64_t>(left_tab,
                                                                    right_tab,
@@ -710,7 +1050,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::INT64:
       return do_join<arrow::NumericArray<arrow::Int64Type>, int64_t>(left_tab,
                                                                    right_tab,
@@ -719,7 +1060,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);;
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::HALF_FLOAT:
       return do_join<arrow::NumericArray<arrow::HalfFloatType>, float_t>(left_tab,
                                                                    right_tab,
@@ -728,7 +1070,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::FLOAT:
       return do_join<arrow::NumericArray<arrow::FloatType>, float_t>(left_tab,
                                                                    right_tab,
@@ -737,7 +1080,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::DOUBLE:
       return do_join<arrow::NumericArray<arrow::DoubleType>, double_t>(left_tab,
                                                                    right_tab,
@@ -746,7 +1090,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::STRING:
       return do_join<arrow::StringArray, arrow::util::string_view>(left_tab,
                                                                    right_tab,
@@ -755,7 +1100,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::BINARY:
       return do_join<arrow::BinaryArray, arrow::util::string_view>(left_tab,
                                                                    right_tab,
@@ -764,7 +1110,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::FIXED_SIZE_BINARY:
       return do_join<arrow::FixedSizeBinaryArray, arrow::util::string_view>(left_tab,
                                                                    right_tab,
@@ -773,7 +1120,8 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                                                                    join_config.GetType(),
                                                                    join_config.GetAlgorithm(),
                                                                    joined_table,
-                                                                   memory_pool);
+                                                                   memory_pool,
+                                                                   thread_pool);
     case arrow::Type::DATE32:break;
     case arrow::Type::DATE64:break;
     case arrow::Type::TIMESTAMP:break;
@@ -19,6 +19,7 @@
 #include "../arrow/arrow_kernels.hpp"
 #include "../arrow/arrow_hash_kernels.hpp"
 #include "join_config.hpp"
+#include "../util/thread_pool.hpp"
 
 namespace cylon {
 namespace join {
@@ -27,13 +28,15 @@ arrow::Status joinTables(const std::shared_ptr<arrow::Table> &left_tab,
                          const std::shared_ptr<arrow::Table> &right_tab,
                          cylon::join::config::JoinConfig join_config,
                          std::shared_ptr<arrow::Table> *joined_table,
-                         arrow::MemoryPool *memory_pool = arrow::default_memory_pool());
+                         arrow::MemoryPool *memory_pool = arrow::default_memory_pool(),
+                         cylon::util::ThreadPool *thread_pool = nullptr);
 
 arrow::Status joinTables(const std::vector<std::shared_ptr<arrow::Table>> &left_tabs,
                          const std::vector<std::shared_ptr<arrow::Table>> &right_tabs,
                          cylon::join::config::JoinConfig join_config,
                          std::shared_ptr<arrow::Table> *joined_table,
-                         arrow::MemoryPool *memory_pool = arrow::default_memory_pool());
+                         arrow::MemoryPool *memory_pool = arrow::default_memory_pool(),
+                         cylon::util::ThreadPool *thread_pool = nullptr);
 
 }
 }
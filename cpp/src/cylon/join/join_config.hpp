@@ -15,6 +15,9 @@
 #ifndef CYLON_SRC_CYLON_JOIN_JOIN_CONFIG_HPP_
 #define CYLON_SRC_CYLON_JOIN_JOIN_CONFIG_HPP_
 
+#include <cstdint>
+#include <vector>
+
 namespace cylon {
 namespace join {
 namespace config {
@@ -23,7 +26,15 @@ enum JoinType {
   INNER, LEFT, RIGHT, FULL_OUTER
 };
 enum JoinAlgorithm {
-  SORT, HASH
+  SORT, HASH, RADIX_HASH
+};
+
+/**
+ * How a distributed join moves the tables. AUTO broadcasts a table if it is small enough and
+ * shuffles both tables otherwise
+ */
+enum JoinStrategy {
+  AUTO, SHUFFLE, BROADCAST
 };
 
 class JoinConfig {
@@ -31,6 +42,13 @@ class JoinConfig {
   JoinType type;
   JoinAlgorithm algorithm;
   int left_column_idx, right_column_idx;
+  std::vector<int> left_column_indices, right_column_indices;
+  bool bloom_filter = false;
+  JoinStrategy strategy = AUTO;
+  // 64MB
+  int64_t broadcast_limit = 64 * 1024 * 1024;
+  bool skew_handling = false;
+  double skew_threshold = 0.5;
 
  public:
   JoinConfig() = delete;
@@ -40,7 +58,22 @@ class JoinConfig {
   }
 
   JoinConfig(JoinType type, int left_column_idx, int right_column_idx, JoinAlgorithm algorithm)
-	  : type(type), algorithm(algorithm), left_column_idx(left_column_idx), right_column_idx(right_column_idx) {}
+	  : type(type), algorithm(algorithm), left_column_idx(left_column_idx), right_column_idx(right_column_idx),
+		left_column_indices({left_column_idx}), right_column_indices({right_column_idx}) {}
+
+  /**
+   * Join on multiple key columns. The i'th left column is matched with the i'th right column
+   * @param type join type
+   * @param left_column_indices key columns of the left table
+   * @param right_column_indices key columns of the right table
+   * @param algorithm join algorithm
+   */
+  JoinConfig(JoinType type, const std::vector<int> &left_column_indices,
+			 const std::vector<int> &right_column_indices, JoinAlgorithm algorithm = SORT)
+	  : type(type), algorithm(algorithm),
+		left_column_idx(left_column_indices.empty() ? -1 : left_column_indices[0]),
+		right_column_idx(right_column_indices.empty() ? -1 : right_column_indices[0]),
+		left_column_indices(left_column_indices), right_column_indices(right_column_indices) {}
 
   static JoinConfig InnerJoin(int left_column_idx, int right_column_idx) {
 	return {INNER, left_column_idx, right_column_idx};
@@ -74,6 +107,30 @@ class JoinConfig {
 	return {FULL_OUTER, left_column_idx, right_column_idx, algorithm};
   }
 
+  static JoinConfig InnerJoin(const std::vector<int> &left_column_indices,
+							  const std::vector<int> &right_column_indices,
+							  JoinAlgorithm algorithm = SORT) {
+	return {INNER, left_column_indices, right_column_indices, algorithm};
+  }
+
+  static JoinConfig LeftJoin(const std::vector<int> &left_column_indices,
+							 const std::vector<int> &right_column_indices,
+							 JoinAlgorithm algorithm = SORT) {
+	return {LEFT, left_column_indices, right_column_indices, algorithm};
+  }
+
+  static JoinConfig RightJoin(const std::vector<int> &left_column_indices,
+							  const std::vector<int> &right_column_indices,
+							  JoinAlgorithm algorithm = SORT) {
+	return {RIGHT, left_column_indices, right_column_indices, algorithm};
+  }
+
+  static JoinConfig FullOuterJoin(const std::vector<int> &left_column_indices,
+								  const std::vector<int> &right_column_indices,
+								  JoinAlgorithm algorithm = SORT) {
+	return {FULL_OUTER, left_column_indices, right_column_indices, algorithm};
+  }
+
   JoinType GetType() const {
 	return type;
   }
@@ -86,8 +143,86 @@ class JoinConfig {
   int GetRightColumnIdx() const {
 	return right_column_idx;
   }
+  const std::vector<int> &GetLeftColumnIndices() const {
+	return left_column_indices;
+  }
+  const std::vector<int> &GetRightColumnIndices() const {
+	return right_column_indices;
+  }
+  bool IsMultiColumn() const {
+	return left_column_indices.size() > 1;
+  }
+
+  /**
+   * The joins reject a config without key columns, or with a different number of left and right
+   * key columns
+   * @return true if the key columns can be joined
+   */
+  bool IsValid() const {
+	return !left_column_indices.empty()
+		&& left_column_indices.size() == right_column_indices.size();
+  }
+
+  /**
+   * Filter one of the tables with a bloom filter of the keys of the other table before the
+   * distributed join shuffles them. This reduces the shuffled data of selective joins.
+   * Full outer joins are not filtered.
+   * @param use_bloom_filter
+   */
+  void SetUseBloomFilter(bool use_bloom_filter) {
+	bloom_filter = use_bloom_filter;
+  }
+  bool UseBloomFilter() const {
+	return bloom_filter;
+  }
+
+  /**
+   * Override the strategy of the distributed join
+   * @param join_strategy
+   */
+  void SetStrategy(JoinStrategy join_strategy) {
+	strategy = join_strategy;
+  }
+  JoinStrategy GetStrategy() const {
+	return strategy;
+  }
+
+  /**
+   * Largest table, in bytes summed over all the workers, that is broadcast by the AUTO strategy
+   * @param bytes
+   */
+  void SetBroadcastLimit(int64_t bytes) {
+	broadcast_limit = bytes;
+  }
+  int64_t GetBroadcastLimit() const {
+	return broadcast_limit;
+  }
+
+  /**
+   * Detect heavy hitter keys by sampling before the distributed join shuffles the tables. The rows
+   * of a heavy key are spread over several workers on one table and replicated to the same
+   * workers on the other table. Full outer joins are not handled.
+   * @param handle_skew
+   */
+  void SetSkewHandling(bool handle_skew) {
+	skew_handling = handle_skew;
+  }
+  bool HandleSkew() const {
+	return skew_handling;
+  }
+
+  /**
+   * A key is a heavy hitter if its estimated rows exceed threshold * (rows / world size)
+   * @param threshold
+   */
+  void SetSkewThreshold(double threshold) {
+	skew_threshold = threshold;
+  }
+  double GetSkewThreshold() const {
+	return skew_threshold;
+  }
 };
-}  // namespace util
+}  // namespace config
 }  // namespace join
 }  // namespace cylon
 
@@ -199,13 +199,15 @@ arrow::Status CombineChunks(const std::shared_ptr<arrow::Table> &table,
                             int64_t col_index,
                             std::shared_ptr<arrow::Table> &output_table,
                             arrow::MemoryPool *memory_pool) {
-  if (table->column(col_index)->num_chunks() > 1) {
-    LOG(INFO) << "Combining chunks " << table->column(col_index)->num_chunks();
-    return table->CombineChunks(memory_pool, &output_table);
-  } else {
-    output_table = table;
-    return arrow::Status::OK();
+  // the final table is built from the first chunk of every column, not only the key column
+  for (const auto &column : table->columns()) {
+    if (column->num_chunks() > 1) {
+      LOG(INFO) << "Combining chunks " << column->num_chunks();
+      return table->CombineChunks(memory_pool, &output_table);
+    }
   }
+  output_table = table;
+  return arrow::Status::OK();
 }
 
 }  // namespace util
@@ -34,6 +34,15 @@ namespace cylon {
   class Allocator {
   public:
     virtual Status Allocate(int64_t length, std::shared_ptr<Buffer> *buffer) = 0;
+
+    /**
+     * Allocate a buffer to receive a message from the source. Allocators can use this to keep
+     * the messages of a source together
+     */
+    virtual Status AllocateForSource(int /*source*/, int64_t length,
+                                     std::shared_ptr<Buffer> *buffer) {
+      return Allocate(length, buffer);
+    }
   };
 
   class DefaultBuffer : public Buffer {
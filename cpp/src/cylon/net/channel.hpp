@@ -15,6 +15,7 @@
 #ifndef CYLON_CHANNEL_H
 #define CYLON_CHANNEL_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <cstring>
@@ -81,6 +82,20 @@ class Channel {
    */
   virtual void progressReceives() = 0;
 
+  /**
+   * @return number of sends and receives posted or completed by the channel so far. A progress
+   * call that leaves this unchanged did not make any progress
+   */
+  virtual uint64_t events() {
+    return 0;
+  }
+
+  /**
+   * Block until one of the posted sends or receives completes. The completed requests are
+   * handled by the next progressSends and progressReceives. Returns right away by default
+   */
+  virtual void waitForEvents() {}
+
   /**
    * Close the channel and clear any allocated memory by the channel
    */
@@ -0,0 +1,91 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "comm_operations.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace cylon {
+namespace net {
+
+int64_t ElementBytes(const std::shared_ptr<DataType> &data_type) {
+  switch (data_type->getType()) {
+    case Type::BOOL: return sizeof(bool);
+    case Type::UINT8:
+    case Type::INT8: return 1;
+    case Type::UINT16:
+    case Type::INT16: return 2;
+    case Type::UINT32:
+    case Type::INT32:
+    case Type::FLOAT: return 4;
+    case Type::UINT64:
+    case Type::INT64:
+    case Type::DOUBLE: return 8;
+    case Type::STRING:
+    case Type::BINARY:
+    case Type::FIXED_SIZE_BINARY: return 1;
+    default: return -1;
+  }
+}
+
+template<typename T>
+static Status ReduceNumeric(const void *in, void *inout, int count, ReduceOp reduce_op) {
+  const T *a = static_cast<const T *>(in);
+  T *b = static_cast<T *>(inout);
+  switch (reduce_op) {
+    case SUM:
+      for (int i = 0; i < count; i++) b[i] = b[i] + a[i];
+      return Status::OK();
+    case MIN:
+      for (int i = 0; i < count; i++) b[i] = std::min(a[i], b[i]);
+      return Status::OK();
+    case MAX:
+      for (int i = 0; i < count; i++) b[i] = std::max(a[i], b[i]);
+      return Status::OK();
+    default:
+      return Status(Code::NotImplemented, "Unknown reduce operation for the type");
+  }
+}
+
+template<typename T>
+static Status ReduceInteger(const void *in, void *inout, int count, ReduceOp reduce_op) {
+  if (reduce_op == BOR) {
+    const T *a = static_cast<const T *>(in);
+    T *b = static_cast<T *>(inout);
+    for (int i = 0; i < count; i++) b[i] = b[i] | a[i];
+    return Status::OK();
+  }
+  return ReduceNumeric<T>(in, inout, count, reduce_op);
+}
+
+Status Reduce(const void *in, void *inout, int count, const std::shared_ptr<DataType> &data_type,
+              ReduceOp reduce_op) {
+  switch (data_type->getType()) {
+    case Type::BOOL: return ReduceInteger<bool>(in, inout, count, reduce_op);
+    case Type::UINT8: return ReduceInteger<uint8_t>(in, inout, count, reduce_op);
+    case Type::INT8: return ReduceInteger<int8_t>(in, inout, count, reduce_op);
+    case Type::UINT16: return ReduceInteger<uint16_t>(in, inout, count, reduce_op);
+    case Type::INT16: return ReduceInteger<int16_t>(in, inout, count, reduce_op);
+    case Type::UINT32: return ReduceInteger<uint32_t>(in, inout, count, reduce_op);
+    case Type::INT32: return ReduceInteger<int32_t>(in, inout, count, reduce_op);
+    case Type::UINT64: return ReduceInteger<uint64_t>(in, inout, count, reduce_op);
+    case Type::INT64: return ReduceInteger<int64_t>(in, inout, count, reduce_op);
+    case Type::FLOAT: return ReduceNumeric<float>(in, inout, count, reduce_op);
+    case Type::DOUBLE: return ReduceNumeric<double>(in, inout, count, reduce_op);
+    default: return Status(Code::NotImplemented, "Unknown data type for the reduction");
+  }
+}
+}  // namespace net
+}  // namespace cylon
@@ -14,8 +14,8 @@
 
 #ifndef CYLON_CPP_SRC_CYLON_NET_COMM_OPERATIONS_HPP_
 #define CYLON_CPP_SRC_CYLON_NET_COMM_OPERATIONS_HPP_
-#include <mpi.h>
 #include <data_types.hpp>
+#include <status.hpp>
 
 namespace cylon {
 namespace net {
@@ -26,9 +26,28 @@ namespace net {
 enum ReduceOp {
   SUM,
   MIN,
-  MAX
+  MAX,
+  BOR
 };
 
+/**
+ * @return bytes of an element of the type in the collectives, -1 if the type is not supported.
+ * Variable width types are exchanged as bytes
+ */
+int64_t ElementBytes(const std::shared_ptr<DataType> &data_type);
+
+/**
+ * Reduce count elements of in to inout, for the communicators without native reductions
+ * @param in
+ * @param inout
+ * @param count
+ * @param data_type
+ * @param reduce_op
+ * @return
+ */
+Status Reduce(const void *in, void *inout, int count, const std::shared_ptr<DataType> &data_type,
+              ReduceOp reduce_op);
+
 }
 }
 #endif //CYLON_CPP_SRC_CYLON_NET_COMM_OPERATIONS_HPP_
@@ -18,8 +18,16 @@
 namespace cylon {
 namespace net {
 enum CommType {
-  LOCAL = 0, MPI, TCP, UCX
+  LOCAL = 0, MPI, TCP, UCX, SHM
 };
+
+/**
+ * @return true if the communicator of this type initializes MPI, so that the threads that use it
+ * depend on the thread support of MPI
+ */
+inline bool IsMPIBased(CommType type) {
+  return type == MPI || type == SHM;
+}
 }  // namespace net
 }  // namespace cylon
 #endif //CYLON_SRC_CYLON_NET_COMM_TYPE_HPP_
@@ -0,0 +1,262 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "communicator.hpp"
+
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+
+#include <climits>
+
+namespace cylon {
+namespace net {
+
+static Status FromArrow(const arrow::Status &status) {
+  return Status(static_cast<int>(status.code()), status.message());
+}
+
+/**
+ * Lay out the buffers of the workers one after the other
+ * @return false if the buffers do not fit in the int counts of the collectives
+ */
+static bool Displacements(const std::vector<int> &sizes, std::vector<int> *displacements,
+                          int64_t *total) {
+  displacements->assign(sizes.size(), 0);
+  *total = 0;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    // a worker with a buffer too large to gather sends -1
+    if (*total > INT_MAX || sizes[i] < 0) {
+      return false;
+    }
+    (*displacements)[i] = static_cast<int>(*total);
+    *total += sizes[i];
+  }
+  return *total <= INT_MAX;
+}
+
+static void SliceReceived(const std::shared_ptr<arrow::Buffer> &received,
+                          const std::vector<int> &sizes, const std::vector<int> &displacements,
+                          std::vector<std::shared_ptr<arrow::Buffer>> *buffers_out) {
+  buffers_out->clear();
+  for (size_t i = 0; i < sizes.size(); i++) {
+    buffers_out->push_back(arrow::SliceBuffer(received, displacements[i], sizes[i]));
+  }
+}
+
+static Status WriteTable(const std::shared_ptr<arrow::Table> &table, arrow::MemoryPool *pool,
+                         std::shared_ptr<arrow::Buffer> *buffer) {
+  auto stream_result = arrow::io::BufferOutputStream::Create(4096, pool);
+  if (!stream_result.ok()) {
+    return FromArrow(stream_result.status());
+  }
+  auto stream = stream_result.ValueOrDie();
+  auto writer_result = arrow::ipc::RecordBatchStreamWriter::Open(stream.get(), table->schema());
+  if (!writer_result.ok()) {
+    return FromArrow(writer_result.status());
+  }
+  auto writer = writer_result.ValueOrDie();
+  arrow::Status arrow_status = writer->WriteTable(*table);
+  if (arrow_status.ok()) {
+    arrow_status = writer->Close();
+  }
+  if (!arrow_status.ok()) {
+    return FromArrow(arrow_status);
+  }
+  auto buffer_result = stream->Finish();
+  if (!buffer_result.ok()) {
+    return FromArrow(buffer_result.status());
+  }
+  *buffer = buffer_result.ValueOrDie();
+  return Status::OK();
+}
+
+static Status ReadTable(const std::shared_ptr<arrow::Buffer> &buffer,
+                        std::shared_ptr<arrow::Table> *table) {
+  auto input = std::make_shared<arrow::io::BufferReader>(buffer);
+  auto reader_result = arrow::ipc::RecordBatchStreamReader::Open(input);
+  if (!reader_result.ok()) {
+    return FromArrow(reader_result.status());
+  }
+  return FromArrow(reader_result.ValueOrDie()->ReadAll(table));
+}
+
+Status Communicator::AllgatherBuffer(const std::shared_ptr<arrow::Buffer> &buffer,
+                                     arrow::MemoryPool *pool,
+                                     std::vector<std::shared_ptr<arrow::Buffer>> *buffers_out) {
+  // every worker takes part in the exchange of the sizes, so that all of them fail together
+  int size = buffer->size() > INT_MAX ? -1 : static_cast<int>(buffer->size());
+  std::vector<int> sizes(GetWorldSize(), 0);
+  auto status = Allgather(&size, 1, sizes.data(), Int32());
+  if (!status.is_ok()) {
+    return status;
+  }
+  std::vector<int> displacements;
+  int64_t total;
+  if (!Displacements(sizes, &displacements, &total)) {
+    return Status(Code::Invalid, "Buffers are too large to gather");
+  }
+  std::shared_ptr<arrow::Buffer> received;
+  arrow::Status arrow_status = arrow::AllocateBuffer(pool, total, &received);
+  if (!arrow_status.ok()) {
+    return FromArrow(arrow_status);
+  }
+  status = Allgatherv(buffer->data(), size, received->mutable_data(), sizes.data(),
+                      displacements.data(), UInt8());
+  if (!status.is_ok()) {
+    return status;
+  }
+  SliceReceived(received, sizes, displacements, buffers_out);
+  return Status::OK();
+}
+
+Status Communicator::GatherBuffer(const std::shared_ptr<arrow::Buffer> &buffer, int root,
+                                  arrow::MemoryPool *pool,
+                                  std::vector<std::shared_ptr<arrow::Buffer>> *buffers_out) {
+  // the sizes go to all the workers, so that all of them fail together if the root can't gather
+  int size = buffer->size() > INT_MAX ? -1 : static_cast<int>(buffer->size());
+  std::vector<int> sizes(GetWorldSize(), 0);
+  auto status = Allgather(&size, 1, sizes.data(), Int32());
+  if (!status.is_ok()) {
+    return status;
+  }
+  std::vector<int> displacements;
+  int64_t total = 0;
+  if (!Displacements(sizes, &displacements, &total)) {
+    return Status(Code::Invalid, "Buffers are too large to gather");
+  }
+  std::shared_ptr<arrow::Buffer> received;
+  if (GetRank() == root) {
+    arrow::Status arrow_status = arrow::AllocateBuffer(pool, total, &received);
+    if (!arrow_status.ok()) {
+      return FromArrow(arrow_status);
+    }
+  }
+  status = Gatherv(buffer->data(), size, received ? received->mutable_data() : nullptr,
+                   sizes.data(), displacements.data(), UInt8(), root);
+  if (!status.is_ok()) {
+    return status;
+  }
+  if (GetRank() == root) {
+    SliceReceived(received, sizes, displacements, buffers_out);
+  } else {
+    buffers_out->clear();
+  }
+  return Status::OK();
+}
+
+Status Communicator::BcastBuffer(std::shared_ptr<arrow::Buffer> *buffer, int root,
+                                 arrow::MemoryPool *pool) {
+  int64_t size = GetRank() == root ? (*buffer)->size() : 0;
+  auto status = Bcast(&size, 1, Int64(), root);
+  if (!status.is_ok()) {
+    return status;
+  }
+  if (size > INT_MAX) {
+    return Status(Code::Invalid, "Buffer is too large to broadcast");
+  }
+  if (GetRank() == root) {
+    // the data is not changed at the root
+    return Bcast(const_cast<uint8_t *>((*buffer)->data()), static_cast<int>(size), UInt8(),
+                 root);
+  }
+  std::shared_ptr<arrow::Buffer> received;
+  arrow::Status arrow_status = arrow::AllocateBuffer(pool, size, &received);
+  if (!arrow_status.ok()) {
+    return FromArrow(arrow_status);
+  }
+  status = Bcast(received->mutable_data(), static_cast<int>(size), UInt8(), root);
+  if (status.is_ok()) {
+    *buffer = received;
+  }
+  return status;
+}
+
+Status Communicator::AllgatherTable(const std::shared_ptr<arrow::Table> &table,
+                                    arrow::MemoryPool *pool,
+                                    std::vector<std::shared_ptr<arrow::Table>> *tables_out) {
+  std::shared_ptr<arrow::Buffer> buffer;
+  auto status = WriteTable(table, pool, &buffer);
+  if (!status.is_ok()) {
+    return status;
+  }
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+  status = AllgatherBuffer(buffer, pool, &buffers);
+  if (!status.is_ok()) {
+    return status;
+  }
+  buffer.reset();
+  tables_out->clear();
+  for (int i = 0; i < GetWorldSize(); i++) {
+    // the local table is not read back
+    if (i == GetRank()) {
+      tables_out->push_back(table);
+      continue;
+    }
+    std::shared_ptr<arrow::Table> received;
+    status = ReadTable(buffers[i], &received);
+    if (!status.is_ok()) {
+      return status;
+    }
+    tables_out->push_back(received);
+  }
+  return Status::OK();
+}
+
+Status Communicator::GatherTable(const std::shared_ptr<arrow::Table> &table, int root,
+                                 arrow::MemoryPool *pool,
+                                 std::vector<std::shared_ptr<arrow::Table>> *tables_out) {
+  std::shared_ptr<arrow::Buffer> buffer;
+  auto status = WriteTable(table, pool, &buffer);
+  if (!status.is_ok()) {
+    return status;
+  }
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+  status = GatherBuffer(buffer, root, pool, &buffers);
+  if (!status.is_ok()) {
+    return status;
+  }
+  tables_out->clear();
+  for (size_t i = 0; i < buffers.size(); i++) {
+    if (static_cast<int>(i) == GetRank()) {
+      tables_out->push_back(table);
+      continue;
+    }
+    std::shared_ptr<arrow::Table> received;
+    status = ReadTable(buffers[i], &received);
+    if (!status.is_ok()) {
+      return status;
+    }
+    tables_out->push_back(received);
+  }
+  return Status::OK();
+}
+
+Status Communicator::BcastTable(std::shared_ptr<arrow::Table> *table, int root,
+                                arrow::MemoryPool *pool) {
+  std::shared_ptr<arrow::Buffer> buffer;
+  if (GetRank() == root) {
+    auto status = WriteTable(*table, pool, &buffer);
+    if (!status.is_ok()) {
+      return status;
+    }
+  }
+  auto status = BcastBuffer(&buffer, root, pool);
+  if (!status.is_ok() || GetRank() == root) {
+    return status;
+  }
+  return ReadTable(buffer, table);
+}
+}  // namespace net
+}  // namespace cylon
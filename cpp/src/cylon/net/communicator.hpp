@@ -15,7 +15,15 @@
 #ifndef CYLON_SRC_CYLON_COMM_COMMUNICATOR_H_
 #define CYLON_SRC_CYLON_COMM_COMMUNICATOR_H_
 
+#include <arrow/buffer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/table.h>
+
+#include <memory>
+#include <vector>
+
 #include "comm_config.hpp"
+#include "comm_operations.hpp"
 #include "channel.hpp"
 
 namespace cylon {
@@ -34,6 +42,171 @@ class Communicator {
   virtual void Finalize() = 0;
   virtual void Barrier() = 0;
   virtual CommType GetCommType() = 0;
+
+  /**
+   * Split the workers in to groups by the color, this is a collective of all the workers. The
+   * workers of a group are ranked by the key and then by their rank in this communicator. The
+   * operations of a group do not interfere with the operations of this communicator or the other
+   * groups, and Finalize of a group only releases the group
+   * @param color group of this worker, a negative color does not join a group
+   * @param key
+   * @return communicator of the group of this worker, nullptr for a negative color
+   */
+  virtual std::shared_ptr<Communicator> Split(int color, int key) = 0;
+
+  /**
+   * Reduce count elements of every worker and give the result to all the workers
+   * @param send_buf
+   * @param rcv_buf
+   * @param count
+   * @param data_type
+   * @param reduce_op
+   * @return
+   */
+  virtual Status AllReduce(const void *send_buf, void *rcv_buf, int count,
+                           const std::shared_ptr<DataType> &data_type, ReduceOp reduce_op) = 0;
+
+  /**
+   * Gather count elements from every worker to all the workers, ordered by the rank
+   * @param send_buf
+   * @param count number of elements sent by each worker
+   * @param rcv_buf should hold count * world size elements
+   * @param data_type
+   * @return
+   */
+  virtual Status Allgather(const void *send_buf, int count, void *rcv_buf,
+                           const std::shared_ptr<DataType> &data_type) = 0;
+
+  /**
+   * Gather a variable number of elements from every worker to all the workers
+   * @param send_buf
+   * @param count number of elements sent by this worker
+   * @param rcv_buf
+   * @param rcv_counts number of elements received from each worker
+   * @param displacements offset of the elements of each worker in the rcv_buf
+   * @param data_type
+   * @return
+   */
+  virtual Status Allgatherv(const void *send_buf, int count, void *rcv_buf, const int *rcv_counts,
+                            const int *displacements,
+                            const std::shared_ptr<DataType> &data_type) = 0;
+
+  /**
+   * Gather count elements from every worker to the root, ordered by the rank
+   * @param send_buf
+   * @param count
+   * @param rcv_buf only used at the root, should hold count * world size elements
+   * @param data_type
+   * @param root
+   * @return
+   */
+  virtual Status Gather(const void *send_buf, int count, void *rcv_buf,
+                        const std::shared_ptr<DataType> &data_type, int root) = 0;
+
+  /**
+   * Gather a variable number of elements from every worker to the root
+   * @param send_buf
+   * @param count
+   * @param rcv_buf only used at the root
+   * @param rcv_counts only used at the root
+   * @param displacements only used at the root
+   * @param data_type
+   * @param root
+   * @return
+   */
+  virtual Status Gatherv(const void *send_buf, int count, void *rcv_buf, const int *rcv_counts,
+                         const int *displacements, const std::shared_ptr<DataType> &data_type,
+                         int root) = 0;
+
+  /**
+   * Send count elements of the root to all the workers
+   * @param buf
+   * @param count
+   * @param data_type
+   * @param root
+   * @return
+   */
+  virtual Status Bcast(void *buf, int count, const std::shared_ptr<DataType> &data_type,
+                       int root) = 0;
+
+  /**
+   * Send a variable number of elements to every worker and receive from every worker
+   * @param send_buf
+   * @param send_counts number of elements sent to each worker
+   * @param send_displacements offset of the elements of each worker in the send_buf
+   * @param rcv_buf
+   * @param rcv_counts number of elements received from each worker
+   * @param rcv_displacements offset of the elements of each worker in the rcv_buf
+   * @param data_type
+   * @return
+   */
+  virtual Status Alltoallv(const void *send_buf, const int *send_counts,
+                           const int *send_displacements, void *rcv_buf, const int *rcv_counts,
+                           const int *rcv_displacements,
+                           const std::shared_ptr<DataType> &data_type) = 0;
+
+  /**
+   * Gather the buffer of every worker to all the workers
+   * @param buffer
+   * @param pool
+   * @param buffers_out buffer of every worker, ordered by the rank
+   * @return Invalid on every worker if a buffer, or all of them together, are larger than an int
+   */
+  Status AllgatherBuffer(const std::shared_ptr<arrow::Buffer> &buffer, arrow::MemoryPool *pool,
+                         std::vector<std::shared_ptr<arrow::Buffer>> *buffers_out);
+
+  /**
+   * Gather the buffer of every worker to the root
+   * @param buffer
+   * @param root
+   * @param pool
+   * @param buffers_out buffer of every worker at the root, ordered by the rank
+   * @return Invalid on every worker if a buffer, or all of them together, are larger than an int
+   */
+  Status GatherBuffer(const std::shared_ptr<arrow::Buffer> &buffer, int root,
+                      arrow::MemoryPool *pool,
+                      std::vector<std::shared_ptr<arrow::Buffer>> *buffers_out);
+
+  /**
+   * Send the buffer of the root to all the workers
+   * @param buffer the buffer at the root, replaced by the received buffer at the others
+   * @param root
+   * @param pool
+   * @return
+   */
+  Status BcastBuffer(std::shared_ptr<arrow::Buffer> *buffer, int root, arrow::MemoryPool *pool);
+
+  /**
+   * Gather the table of every worker to all the workers. The tables are exchanged as Arrow IPC
+   * streams, and the received tables point to the received buffers
+   * @param table
+   * @param pool
+   * @param tables_out table of every worker, ordered by the rank
+   * @return
+   */
+  Status AllgatherTable(const std::shared_ptr<arrow::Table> &table, arrow::MemoryPool *pool,
+                        std::vector<std::shared_ptr<arrow::Table>> *tables_out);
+
+  /**
+   * Gather the table of every worker to the root
+   * @param table
+   * @param root
+   * @param pool
+   * @param tables_out table of every worker at the root, ordered by the rank
+   * @return
+   */
+  Status GatherTable(const std::shared_ptr<arrow::Table> &table, int root,
+                     arrow::MemoryPool *pool,
+                     std::vector<std::shared_ptr<arrow::Table>> *tables_out);
+
+  /**
+   * Send the table of the root to all the workers
+   * @param table the table at the root, replaced by the received table at the others
+   * @param root
+   * @param pool
+   * @return
+   */
+  Status BcastTable(std::shared_ptr<arrow::Table> *table, int root, arrow::MemoryPool *pool);
 };
 }
 }
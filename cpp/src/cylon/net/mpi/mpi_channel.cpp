@@ -27,6 +27,28 @@
 
 namespace cylon {
 
+/**
+ * Test the request of a pending send or receive, taking the status of a request that was already
+ * completed by waitForEvents
+ * @return non zero if the request is complete
+ */
+template<typename PENDING>
+static int TestPending(PENDING *pending, MPI_Status *status) {
+  if (pending->completed) {
+    pending->completed = false;
+    *status = pending->completedStatus;
+    return 1;
+  }
+  int flag = 0;
+  MPI_Test(&pending->request, &flag, status);
+  return flag;
+}
+
+MPIChannel::MPIChannel(MPI_Comm comm) : comm(comm), creditComm(comm) {}
+
+MPIChannel::MPIChannel(MPI_Comm comm, int64_t max_in_flight_bytes, MPI_Comm credit_comm)
+    : comm(comm), maxInFlightBytes(max_in_flight_bytes), creditComm(credit_comm) {}
+
 void MPIChannel::init(int ed, const std::vector<int> &receives, const std::vector<int> &sendIds,
                       ChannelReceiveCallback *rcv, ChannelSendCallback *send_fn,
                       Allocator *alloc) {
@@ -40,16 +62,18 @@ void MPIChannel::init(int ed, const std::vector<int> &receives, const std::vecto
     buf->receiveId = source;
     pendingReceives.insert(std::pair<int, PendingReceive *>(source, buf));
     MPI_Irecv(buf->headerBuf, CYLON_CHANNEL_HEADER_SIZE, MPI_INT,
-        source, edge, MPI_COMM_WORLD, &buf->request);
+        source, edge, comm, &buf->request);
     // set the flag to true so we can identify later which buffers are posted
     buf->status = RECEIVE_LENGTH_POSTED;
   }
 
   for (int target : sendIds) {
-    sends[target] = new PendingSend();
+    auto *ps = new PendingSend();
+    ps->credit = maxInFlightBytes;
+    sends[target] = ps;
   }
   // get the rank
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_rank(comm, &rank);
 }
 
 int MPIChannel::send(std::shared_ptr<TxRequest> request) {
@@ -57,7 +81,13 @@ int MPIChannel::send(std::shared_ptr<TxRequest> request) {
   if (ps->pendingData.size() > 1000) {
     return -1;
   }
+  // the queue of a target holds up to the credit, or a single larger message
+  if (maxInFlightBytes > 0 && !ps->pendingData.empty()
+      && ps->queuedBytes + request->length > maxInFlightBytes) {
+    return -1;
+  }
   ps->pendingData.push(request);
+  ps->queuedBytes += request->length;
   return 1;
 }
 
@@ -76,8 +106,9 @@ void MPIChannel::progressReceives() {
     int flag = 0;
     status = {};
     if (x.second->status == RECEIVE_LENGTH_POSTED) {
-      MPI_Test(&(x.second->request), &flag, &status);
+      flag = TestPending(x.second, &status);
       if (flag) {
+        events_++;
         x.second->request = {};
         int count = 0;
         MPI_Get_count(&status, MPI_INT, &count);
@@ -91,13 +122,14 @@ void MPIChannel::progressReceives() {
                        << " received: " << count;
           }
           // malloc a buffer
-          Status stat = allocator->Allocate(length, &x.second->data);
+          Status stat = allocator->AllocateForSource(x.second->receiveId, length,
+                                                     &x.second->data);
           if (!stat.is_ok()) {
             LOG(FATAL) << "Failed to allocate buffer with length " << length;
           }
           x.second->length = length;
           MPI_Irecv(x.second->data->GetByteBuffer(), length, MPI_BYTE, x.second->receiveId, edge,
-              MPI_COMM_WORLD, &(x.second->request));
+              comm, &(x.second->request));
           x.second->status = RECEIVE_POSTED;
           // copy the count - 2 to the buffer
           int *header = nullptr;
@@ -111,15 +143,15 @@ void MPIChannel::progressReceives() {
           if (count != 2) {
             LOG(FATAL) << "Un-expected number of bytes expected: 2 " << " received: " << count;
           }
-          // we are not expecting to receive any more
+          // we are not expecting to receive any more, the receiver is notified once the
+          // credits of the source are returned
           x.second->status = RECEIVED_FIN;
-          // notify the receiver
-          rcv_fn->receivedHeader(x.first, finFlag, nullptr, 0);
         }
       }
     } else if (x.second->status == RECEIVE_POSTED) {
-      MPI_Test(&x.second->request, &flag, &status);
+      flag = TestPending(x.second, &status);
       if (flag) {
+        events_++;
         int count = 0;
         MPI_Get_count(&status, MPI_BYTE, &count);
         if (count != x.second->length) {
@@ -131,14 +163,74 @@ void MPIChannel::progressReceives() {
         // clear the array
         std::fill_n(x.second->headerBuf, CYLON_CHANNEL_HEADER_SIZE, 0);
         MPI_Irecv(x.second->headerBuf, CYLON_CHANNEL_HEADER_SIZE, MPI_INT,
-                  x.second->receiveId, edge, MPI_COMM_WORLD, &(x.second->request));
+                  x.second->receiveId, edge, comm, &(x.second->request));
         x.second->status = RECEIVE_LENGTH_POSTED;
+        if (countCredit(&x.second->unreturned, x.second->length)) {
+          x.second->credits.push(x.second->unreturned);
+          x.second->unreturned = 0;
+        }
         // call the back end
         rcv_fn->receivedData(x.first, x.second->data, x.second->length);
       }
     } else if (x.second->status != RECEIVED_FIN) {
       LOG(FATAL) << "At an un-expected state " << x.second->status;
     }
+    progressCredits(x.second, x.first);
+  }
+}
+
+bool MPIChannel::hasCredit(const PendingSend *ps) const {
+  if (maxInFlightBytes <= 0) {
+    return true;
+  }
+  // with at most half of the credit in use the target returns credits only after this message,
+  // so a message larger than the credit is sent anyway
+  return ps->credit >= ps->pendingData.front()->length
+      || ps->credit >= maxInFlightBytes / 2;
+}
+
+bool MPIChannel::countCredit(int64_t *uncredited, int64_t length) const {
+  if (maxInFlightBytes <= 0) {
+    return false;
+  }
+  *uncredited += length;
+  return *uncredited >= maxInFlightBytes - maxInFlightBytes / 2;
+}
+
+void MPIChannel::progressCredits(PendingSend *ps, int target) {
+  PendingCredit &credit = ps->creditReceive;
+  MPI_Status status;
+  if (credit.posted && TestPending(&credit, &status)) {
+    events_++;
+    credit.posted = false;
+    credit.request = {};
+    ps->credit += credit.bytes;
+    ps->creditsReceived++;
+  }
+  if (!credit.posted && ps->creditsReceived < ps->creditsExpected) {
+    MPI_Irecv(&credit.bytes, 1, MPI_INT64_T, target, edge, creditComm, &credit.request);
+    credit.posted = true;
+  }
+}
+
+void MPIChannel::progressCredits(PendingReceive *pr, int source) {
+  PendingCredit &credit = pr->creditSend;
+  MPI_Status status;
+  if (credit.posted && TestPending(&credit, &status)) {
+    events_++;
+    credit.posted = false;
+    credit.request = {};
+  }
+  if (!credit.posted && !pr->credits.empty()) {
+    credit.bytes = pr->credits.front();
+    pr->credits.pop();
+    MPI_Isend(&credit.bytes, 1, MPI_INT64_T, source, edge, creditComm, &credit.request);
+    credit.posted = true;
+  }
+  // the source is finished once it has its credits, so they never outlive the channel
+  if (pr->status == RECEIVED_FIN && !pr->finNotified && !credit.posted) {
+    pr->finNotified = true;
+    rcv_fn->receivedHeader(source, CYLON_MSG_FIN, nullptr, 0);
   }
 }
 
@@ -147,17 +239,20 @@ void MPIChannel::progressSends() {
   for (auto x : sends) {
     int flag = 0;
     MPI_Status status;
+    progressCredits(x.second, x.first);
     // if we are in the length posted
     if (x.second->status == SEND_LENGTH_POSTED) {
-      MPI_Test(&x.second->request, &flag, &status);
+      flag = TestPending(x.second, &status);
       if (flag) {
+        events_++;
         x.second->request = {};
         // now post the actual send
         std::shared_ptr<TxRequest> r = x.second->pendingData.front();
         MPI_Isend(r->buffer, r->length, MPI_BYTE,
-                  r->target, edge, MPI_COMM_WORLD, &(x.second->request));
+                  r->target, edge, comm, &(x.second->request));
         x.second->status = SEND_POSTED;
         x.second->pendingData.pop();
+        x.second->queuedBytes -= r->length;
         // we set to the current send and pop it
         x.second->currentSend = r;
       }
@@ -165,18 +260,28 @@ void MPIChannel::progressSends() {
       x.second->request = {};
       // now post the actual send
       if (!x.second->pendingData.empty()) {
-        sendHeader(x);
+        // wait for the credits of the target
+        if (hasCredit(x.second)) {
+          sendHeader(x);
+          events_++;
+        }
       } else if (finishRequests.find(x.first) != finishRequests.end()) {
         // if there are finish requests lets send them
         sendFinishHeader(x);
+        events_++;
       }
     } else if (x.second->status == SEND_POSTED) {
-      MPI_Test(&(x.second->request), &flag, &status);
+      flag = TestPending(x.second, &status);
       if (flag) {
+        events_++;
         x.second->request = {};
         // if there are more data to post, post the length buffer now
         if (!x.second->pendingData.empty()) {
-          sendHeader(x);
+          if (hasCredit(x.second)) {
+            sendHeader(x);
+          } else {
+            x.second->status = SEND_INIT;
+          }
           // we need to notify about the send completion
           send_comp_fn->sendComplete(x.second->currentSend);
           x.second->currentSend = {};
@@ -193,23 +298,35 @@ void MPIChannel::progressSends() {
         }
       }
     } else if (x.second->status == SEND_FINISH) {
-      MPI_Test(&(x.second->request), &flag, &status);
+      flag = TestPending(x.second, &status);
       if (flag) {
-        // LOG(INFO) << rank << " FINISHED send " << x.first;
-        // we are going to send complete
-        std::shared_ptr<TxRequest> finReq = finishRequests[x.first];
-        send_comp_fn->sendFinishComplete(finReq);
-        x.second->status = SEND_DONE;
+        events_++;
+        x.second->status = SEND_CREDITS;
       }
-    } else if (x.second->status != SEND_DONE) {
+    } else if (x.second->status != SEND_DONE && x.second->status != SEND_CREDITS) {
       // throw an exception and log
       LOG(FATAL) << "At an un-expected state " << x.second->status;
     }
+
+    // the target is finished once all its credits are received
+    if (x.second->status == SEND_CREDITS
+        && x.second->creditsReceived == x.second->creditsExpected) {
+      // LOG(INFO) << rank << " FINISHED send " << x.first;
+      // we are going to send complete
+      std::shared_ptr<TxRequest> finReq = finishRequests[x.first];
+      send_comp_fn->sendFinishComplete(finReq);
+      x.second->status = SEND_DONE;
+    }
   }
 }
 
 void MPIChannel::sendHeader(const std::pair<const int, PendingSend *> &x) const {
   std::shared_ptr<TxRequest> r = x.second->pendingData.front();
+  x.second->credit -= r->length;
+  if (countCredit(&x.second->uncredited, r->length)) {
+    x.second->creditsExpected++;
+    x.second->uncredited = 0;
+  }
   // put the length to the buffer
   x.second->headerBuf[0] = r->length;
   x.second->headerBuf[1] = 0;
@@ -220,7 +337,7 @@ void MPIChannel::sendHeader(const std::pair<const int, PendingSend *> &x) const
   }
   // we have to add 2 to the header length
   MPI_Isend(&(x.second->headerBuf[0]), 2 + r->headerLength, MPI_INT,
-            x.first, edge, MPI_COMM_WORLD, &(x.second->request));
+            x.first, edge, comm, &(x.second->request));
   x.second->status = SEND_LENGTH_POSTED;
 }
 
@@ -229,10 +346,100 @@ void MPIChannel::sendFinishHeader(const std::pair<const int, PendingSend *> &x)
   x.second->headerBuf[0] = 0;
   x.second->headerBuf[1] = CYLON_MSG_FIN;
   MPI_Isend(&(x.second->headerBuf[0]), 2, MPI_INT,
-            x.first, edge, MPI_COMM_WORLD, &(x.second->request));
+            x.first, edge, comm, &(x.second->request));
   x.second->status = SEND_FINISH;
 }
 
+uint64_t MPIChannel::events() {
+  return events_;
+}
+
+/**
+ * A posted request and where to keep its status once MPI_Waitsome completes it
+ */
+struct WaitOwner {
+  MPI_Request *request;
+  bool *completed;
+  MPI_Status *completedStatus;
+};
+
+template<typename PENDING>
+static WaitOwner MakeWaitOwner(PENDING *pending) {
+  return WaitOwner{&pending->request, &pending->completed, &pending->completedStatus};
+}
+
+void MPIChannel::waitForEvents() {
+  std::vector<MPI_Request> requests;
+  std::vector<WaitOwner> owners;
+  for (auto x : sends) {
+    PendingSend *ps = x.second;
+    if (ps->status == SEND_INIT) {
+      // the next progress posts this without waiting for the network, unless it waits for credits
+      if (!ps->pendingData.empty() ? hasCredit(ps)
+                                   : finishRequests.find(x.first) != finishRequests.end()) {
+        return;
+      }
+    } else if (ps->status == SEND_CREDITS) {
+      if (ps->creditsReceived == ps->creditsExpected) {
+        return;
+      }
+    } else if (ps->status != SEND_DONE) {
+      if (ps->completed) {
+        return;
+      }
+      requests.push_back(ps->request);
+      owners.push_back(MakeWaitOwner(ps));
+    }
+    if (ps->creditReceive.posted) {
+      if (ps->creditReceive.completed) {
+        return;
+      }
+      requests.push_back(ps->creditReceive.request);
+      owners.push_back(MakeWaitOwner(&ps->creditReceive));
+    } else if (ps->creditsReceived < ps->creditsExpected) {
+      return;
+    }
+  }
+  for (auto x : pendingReceives) {
+    PendingReceive *pr = x.second;
+    if (pr->status == RECEIVE_LENGTH_POSTED || pr->status == RECEIVE_POSTED) {
+      if (pr->completed) {
+        return;
+      }
+      requests.push_back(pr->request);
+      owners.push_back(MakeWaitOwner(pr));
+    }
+    if (pr->creditSend.posted) {
+      if (pr->creditSend.completed) {
+        return;
+      }
+      requests.push_back(pr->creditSend.request);
+      owners.push_back(MakeWaitOwner(&pr->creditSend));
+    } else if (!pr->credits.empty() || (pr->status == RECEIVED_FIN && !pr->finNotified)) {
+      return;
+    }
+  }
+  if (requests.empty()) {
+    return;
+  }
+
+  int count = 0;
+  std::vector<int> indices(requests.size());
+  std::vector<MPI_Status> statuses(requests.size());
+  MPI_Waitsome(static_cast<int>(requests.size()), requests.data(), &count, indices.data(),
+               statuses.data());
+  if (count == MPI_UNDEFINED) {
+    return;
+  }
+  // MPI_Waitsome frees the completed requests, keep their status for the next progress
+  for (int i = 0; i < count; i++) {
+    WaitOwner &owner = owners[indices[i]];
+    *owner.request = requests[indices[i]];
+    *owner.completed = true;
+    *owner.completedStatus = statuses[i];
+  }
+}
+
 void MPIChannel::close() {
   for (auto &pendingReceive : pendingReceives) {
     delete (pendingReceive.second);
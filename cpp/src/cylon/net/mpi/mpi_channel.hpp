@@ -34,7 +34,9 @@ enum SendStatus {
   SEND_LENGTH_POSTED = 1,
   SEND_POSTED = 2,
   SEND_FINISH = 3,
-  SEND_DONE = 4
+  SEND_DONE = 4,
+  // the finish is sent, waiting for the last credits of the target
+  SEND_CREDITS = 5
 };
 
 enum ReceiveStatus {
@@ -44,6 +46,18 @@ enum ReceiveStatus {
   RECEIVED_FIN = 3
 };
 
+/**
+ * A credit message, the bytes a receiver returns to a sender
+ */
+struct PendingCredit {
+  int64_t bytes = 0;
+  bool posted = false;
+  MPI_Request request{};
+  // the request was completed by waitForEvents, with this status
+  bool completed = false;
+  MPI_Status completedStatus{};
+};
+
 /**
  * Keep track about the length buffer to receive the length first
  */
@@ -55,6 +69,19 @@ struct PendingSend {
   MPI_Request request{};
   // the current send, if it is a actual send
   std::shared_ptr<TxRequest> currentSend{};
+  // the request was completed by waitForEvents, with this status
+  bool completed = false;
+  MPI_Status completedStatus{};
+  // bytes of the pending data
+  int64_t queuedBytes = 0;
+  // bytes that can be sent before the target returns credits, negative after a large message
+  int64_t credit = 0;
+  // bytes sent since the last credit the target returns, the same count the target keeps
+  int64_t uncredited = 0;
+  // credits the target returns for the messages sent so far, and the ones received
+  int64_t creditsExpected = 0;
+  int64_t creditsReceived = 0;
+  PendingCredit creditReceive;
 };
 
 struct PendingReceive {
@@ -65,15 +92,45 @@ struct PendingReceive {
   int length{};
   ReceiveStatus status = RECEIVE_INIT;
   MPI_Request request{};
+  // the request was completed by waitForEvents, with this status
+  bool completed = false;
+  MPI_Status completedStatus{};
+  // bytes received since the last credit returned to the source
+  int64_t unreturned = 0;
+  // credits waiting to be returned, they are sent one at a time
+  std::queue<int64_t> credits;
+  PendingCredit creditSend;
+  // the finish is given to the receiver once the credits are returned
+  bool finNotified = false;
 };
 
 /**
  * This class implements a MPI channel, when there is a message to be sent,
  * this channel sends a small message with the size of the next message. This allows the other side
- * to post the network buffer to receive the message
+ * to post the network buffer to receive the message.
+ *
+ * The bytes sent to a target are limited by credits. A sender starts with max_in_flight_bytes of
+ * credit for every target, and a receiver returns the bytes of a source once it has received half
+ * of that from the source. A message that does not fit in the credit waits for the credits, unless
+ * at most half of the credit is in use, so that messages larger than the limit still go out one at
+ * a time. The credits are sent on a separate communicator, and the receiver keeps the same count of
+ * the bytes as the sender so that both know how many credits are sent.
  */
 class MPIChannel : public Channel {
  public:
+  /**
+   * @param comm communicator of the ranks of the channel
+   */
+  explicit MPIChannel(MPI_Comm comm = MPI_COMM_WORLD);
+
+  /**
+   * @param comm communicator of the ranks of the channel
+   * @param max_in_flight_bytes bytes sent to a target without credits, 0 disables the flow
+   * control. It should be the same at all the ranks
+   * @param credit_comm duplicate of comm to send the credits
+   */
+  MPIChannel(MPI_Comm comm, int64_t max_in_flight_bytes, MPI_Comm credit_comm);
+
   /**
    * Initialize the channel
    *
@@ -86,7 +143,7 @@ class MPIChannel : public Channel {
   * Send the message to the target.
   *
   * @param request the request
-  * @return true if accepted
+  * @return 1 if accepted, -1 if the queue of the target is full
   */
   int send(std::shared_ptr<TxRequest> request) override;
 
@@ -108,6 +165,13 @@ class MPIChannel : public Channel {
    */
   void progressReceives() override;
 
+  uint64_t events() override;
+
+  /**
+   * Wait for the posted requests with MPI_Waitsome
+   */
+  void waitForEvents() override;
+
   void close() override;
 
  private:
@@ -126,6 +190,33 @@ class MPIChannel : public Channel {
   Allocator *allocator;
   // mpi rank
   int rank;
+  MPI_Comm comm;
+  // flow control, see the class comment
+  int64_t maxInFlightBytes = 0;
+  MPI_Comm creditComm;
+  // number of requests posted and completed
+  uint64_t events_ = 0;
+
+  /**
+   * @return true if the next message to the target fits in the credit
+   */
+  bool hasCredit(const PendingSend *ps) const;
+
+  /**
+   * Count the bytes of a message towards a credit, on both sides
+   * @return true if the bytes make a credit
+   */
+  bool countCredit(int64_t *uncredited, int64_t length) const;
+
+  /**
+   * Receive the credits of the target
+   */
+  void progressCredits(PendingSend *ps, int target);
+
+  /**
+   * Return the credits of the source, and give the finish to the receiver once they are sent
+   */
+  void progressCredits(PendingReceive *pr, int source);
 
   /**
    * Send finish request
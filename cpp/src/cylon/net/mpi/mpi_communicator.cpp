@@ -23,6 +23,18 @@
 
 namespace cylon {
 namespace net {
+
+static Status FromMPI(int code) {
+  if (code == MPI_SUCCESS) {
+    return Status::OK();
+  }
+  return Status(Code::ExecutionError, "MPI operation failed!");
+}
+
+static Status UnknownType() {
+  return Status(Code::NotImplemented, "Unknown data type for MPI");
+}
+
 // configs
 void MPIConfig::DummyConfig(int dummy) {
   this->AddConfig("Dummy", &dummy);
@@ -34,12 +46,27 @@ int MPIConfig::GetDummyConfig() {
 CommType MPIConfig::Type() {
   return CommType::MPI;
 }
-std::shared_ptr<MPIConfig> MPIConfig::Make() {
-  return std::make_shared<MPIConfig>();
+constexpr int64_t MPIConfig::DEFAULT_MAX_IN_FLIGHT_BYTES;
+
+MPIConfig::MPIConfig(int64_t max_in_flight_bytes) : max_in_flight_bytes_(max_in_flight_bytes) {}
+
+int64_t MPIConfig::GetMaxInFlightBytes() const {
+  return max_in_flight_bytes_;
+}
+
+std::shared_ptr<MPIConfig> MPIConfig::Make(int64_t max_in_flight_bytes) {
+  return std::make_shared<MPIConfig>(max_in_flight_bytes);
+}
+
+MPICommunicator::MPICommunicator(MPI_Comm comm, int64_t max_in_flight_bytes)
+    : comm_(comm), max_in_flight_bytes_(max_in_flight_bytes) {
+  MPI_Comm_rank(comm_, &this->rank);
+  MPI_Comm_size(comm_, &this->world_size);
+  MPI_Comm_dup(comm_, &credit_comm_);
 }
 
 Channel *MPICommunicator::CreateChannel() {
-  return new MPIChannel();
+  return new MPIChannel(comm_, max_in_flight_bytes_, credit_comm_);
 }
 
 int MPICommunicator::GetRank() {
@@ -52,21 +79,119 @@ void MPICommunicator::Init(const std::shared_ptr<CommConfig> &config) {
   int initialized;
   MPI_Initialized(&initialized);
   if (!initialized) {
-    MPI_Init(nullptr, nullptr);
+    // the progress engine can run the channels on its own thread
+    int provided;
+    MPI_Init_thread(nullptr, nullptr, MPI_THREAD_SERIALIZED, &provided);
   }
 
-  MPI_Comm_rank(MPI_COMM_WORLD, &this->rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &this->world_size);
+  MPI_Comm_rank(comm_, &this->rank);
+  MPI_Comm_size(comm_, &this->world_size);
+  if (config->Type() == CommType::MPI) {
+    max_in_flight_bytes_ = std::static_pointer_cast<MPIConfig>(config)->GetMaxInFlightBytes();
+  }
+  MPI_Comm_dup(comm_, &credit_comm_);
 }
 void MPICommunicator::Finalize() {
-  MPI_Finalize();
+  if (credit_comm_ != MPI_COMM_NULL) {
+    MPI_Comm_free(&credit_comm_);
+  }
+  if (comm_ == MPI_COMM_WORLD) {
+    MPI_Finalize();
+  } else if (comm_ != MPI_COMM_NULL) {
+    // a group only releases its own communicator, MPI_Comm_free sets it to MPI_COMM_NULL
+    MPI_Comm_free(&comm_);
+  }
 }
 void MPICommunicator::Barrier() {
-  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Barrier(comm_);
 }
 
 CommType MPICommunicator::GetCommType() {
   return MPI;
 }
+
+std::shared_ptr<Communicator> MPICommunicator::Split(int color, int key) {
+  MPI_Comm group;
+  MPI_Comm_split(comm_, color < 0 ? MPI_UNDEFINED : color, key, &group);
+  if (group == MPI_COMM_NULL) {
+    return nullptr;
+  }
+  return std::make_shared<MPICommunicator>(group, max_in_flight_bytes_);
+}
+
+Status MPICommunicator::AllReduce(const void *send_buf, void *rcv_buf, int count,
+                                  const std::shared_ptr<DataType> &data_type,
+                                  ReduceOp reduce_op) {
+  MPI_Datatype mpi_data_type = cylon::mpi::GetMPIDataType(data_type);
+  MPI_Op mpi_op = cylon::mpi::GetMPIOp(reduce_op);
+  if (mpi_data_type == nullptr || mpi_op == nullptr) {
+    return Status(Code::NotImplemented, "Unknown data type or operation for MPI");
+  }
+  return FromMPI(MPI_Allreduce(send_buf, rcv_buf, count, mpi_data_type, mpi_op,
+                               comm_));
+}
+
+Status MPICommunicator::Allgather(const void *send_buf, int count, void *rcv_buf,
+                                  const std::shared_ptr<DataType> &data_type) {
+  MPI_Datatype mpi_data_type = cylon::mpi::GetMPIDataType(data_type);
+  if (mpi_data_type == nullptr) {
+    return UnknownType();
+  }
+  return FromMPI(MPI_Allgather(send_buf, count, mpi_data_type, rcv_buf, count, mpi_data_type,
+                               comm_));
+}
+
+Status MPICommunicator::Allgatherv(const void *send_buf, int count, void *rcv_buf,
+                                   const int *rcv_counts, const int *displacements,
+                                   const std::shared_ptr<DataType> &data_type) {
+  MPI_Datatype mpi_data_type = cylon::mpi::GetMPIDataType(data_type);
+  if (mpi_data_type == nullptr) {
+    return UnknownType();
+  }
+  return FromMPI(MPI_Allgatherv(send_buf, count, mpi_data_type, rcv_buf, rcv_counts,
+                                displacements, mpi_data_type, comm_));
+}
+
+Status MPICommunicator::Gather(const void *send_buf, int count, void *rcv_buf,
+                               const std::shared_ptr<DataType> &data_type, int root) {
+  MPI_Datatype mpi_data_type = cylon::mpi::GetMPIDataType(data_type);
+  if (mpi_data_type == nullptr) {
+    return UnknownType();
+  }
+  return FromMPI(MPI_Gather(send_buf, count, mpi_data_type, rcv_buf, count, mpi_data_type, root,
+                            comm_));
+}
+
+Status MPICommunicator::Gatherv(const void *send_buf, int count, void *rcv_buf,
+                                const int *rcv_counts, const int *displacements,
+                                const std::shared_ptr<DataType> &data_type, int root) {
+  MPI_Datatype mpi_data_type = cylon::mpi::GetMPIDataType(data_type);
+  if (mpi_data_type == nullptr) {
+    return UnknownType();
+  }
+  return FromMPI(MPI_Gatherv(send_buf, count, mpi_data_type, rcv_buf, rcv_counts, displacements,
+                             mpi_data_type, root, comm_));
+}
+
+Status MPICommunicator::Bcast(void *buf, int count, const std::shared_ptr<DataType> &data_type,
+                              int root) {
+  MPI_Datatype mpi_data_type = cylon::mpi::GetMPIDataType(data_type);
+  if (mpi_data_type == nullptr) {
+    return UnknownType();
+  }
+  return FromMPI(MPI_Bcast(buf, count, mpi_data_type, root, comm_));
+}
+
+Status MPICommunicator::Alltoallv(const void *send_buf, const int *send_counts,
+                                  const int *send_displacements, void *rcv_buf,
+                                  const int *rcv_counts, const int *rcv_displacements,
+                                  const std::shared_ptr<DataType> &data_type) {
+  MPI_Datatype mpi_data_type = cylon::mpi::GetMPIDataType(data_type);
+  if (mpi_data_type == nullptr) {
+    return UnknownType();
+  }
+  return FromMPI(MPI_Alltoallv(send_buf, send_counts, send_displacements, mpi_data_type, rcv_buf,
+                               rcv_counts, rcv_displacements, mpi_data_type, comm_));
+}
 }  // namespace net
 }  // namespace cylon
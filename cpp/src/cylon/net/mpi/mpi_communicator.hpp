@@ -15,6 +15,8 @@
 #ifndef CYLON_SRC_CYLON_COMM_MPICOMMUNICATOR_H_
 #define CYLON_SRC_CYLON_COMM_MPICOMMUNICATOR_H_
 
+#include <mpi.h>
+
 #include "../comm_config.hpp"
 #include "../communicator.hpp"
 
@@ -30,11 +32,37 @@ class MPIConfig : public CommConfig {
   CommType Type() override;
 
  public:
-  static std::shared_ptr<MPIConfig> Make();
+  /**
+   * Default bytes a channel sends to a worker before the worker returns credits
+   */
+  static constexpr int64_t DEFAULT_MAX_IN_FLIGHT_BYTES = 64LL << 20;
+
+  /**
+   * @param max_in_flight_bytes bytes a channel sends to a worker before the worker returns
+   * credits for them, 0 disables the flow control. It should be the same at all the workers
+   */
+  explicit MPIConfig(int64_t max_in_flight_bytes = DEFAULT_MAX_IN_FLIGHT_BYTES);
+
+  int64_t GetMaxInFlightBytes() const;
+
+  static std::shared_ptr<MPIConfig> Make(
+      int64_t max_in_flight_bytes = DEFAULT_MAX_IN_FLIGHT_BYTES);
+
+ private:
+  int64_t max_in_flight_bytes_;
 };
 
 class MPICommunicator : public Communicator {
  public:
+  MPICommunicator() = default;
+
+  /**
+   * Communicator of a group of the workers, see Split
+   * @param comm
+   * @param max_in_flight_bytes
+   */
+  MPICommunicator(MPI_Comm comm, int64_t max_in_flight_bytes);
+
   void Init(const std::shared_ptr<CommConfig> &config) override;
   Channel *CreateChannel() override;
   int GetRank() override;
@@ -42,6 +70,32 @@ class MPICommunicator : public Communicator {
   void Finalize() override;
   void Barrier() override;
   CommType GetCommType() override;
+  std::shared_ptr<Communicator> Split(int color, int key) override;
+
+  Status AllReduce(const void *send_buf, void *rcv_buf, int count,
+                   const std::shared_ptr<DataType> &data_type, ReduceOp reduce_op) override;
+  Status Allgather(const void *send_buf, int count, void *rcv_buf,
+                   const std::shared_ptr<DataType> &data_type) override;
+  Status Allgatherv(const void *send_buf, int count, void *rcv_buf, const int *rcv_counts,
+                    const int *displacements,
+                    const std::shared_ptr<DataType> &data_type) override;
+  Status Gather(const void *send_buf, int count, void *rcv_buf,
+                const std::shared_ptr<DataType> &data_type, int root) override;
+  Status Gatherv(const void *send_buf, int count, void *rcv_buf, const int *rcv_counts,
+                 const int *displacements, const std::shared_ptr<DataType> &data_type,
+                 int root) override;
+  Status Bcast(void *buf, int count, const std::shared_ptr<DataType> &data_type,
+               int root) override;
+  Status Alltoallv(const void *send_buf, const int *send_counts, const int *send_displacements,
+                   void *rcv_buf, const int *rcv_counts, const int *rcv_displacements,
+                   const std::shared_ptr<DataType> &data_type) override;
+
+ protected:
+  // MPI_COMM_WORLD, or the communicator of a group
+  MPI_Comm comm_ = MPI_COMM_WORLD;
+  // flow control of the channels, the credits are sent on a duplicate of comm_
+  int64_t max_in_flight_bytes_ = MPIConfig::DEFAULT_MAX_IN_FLIGHT_BYTES;
+  MPI_Comm credit_comm_ = MPI_COMM_NULL;
 };
 }
 }
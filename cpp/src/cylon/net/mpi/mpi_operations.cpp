@@ -20,6 +20,7 @@ MPI_Op cylon::mpi::GetMPIOp(cylon::net::ReduceOp reduce_op) {
     case cylon::net::SUM: return MPI_SUM;
     case cylon::net::MIN: return MPI_MIN;
     case cylon::net::MAX: return MPI_MAX;
+    case cylon::net::BOR: return MPI_BOR;
 //    case cylon::PROD: return MPI_PROD;
     default: return nullptr;
   }
@@ -34,7 +35,7 @@ MPI_Datatype cylon::mpi::GetMPIDataType(const std::shared_ptr<DataType> &data_ty
     case Type::INT16:return MPI_INT16_T;
     case Type::UINT32:return MPI_UINT32_T;
     case Type::INT32:return MPI_INT32_T;
-    case Type::UINT64:return MPI_UINT32_T;
+    case Type::UINT64:return MPI_UINT64_T;
     case Type::INT64:return MPI_INT64_T;
     case Type::FLOAT:return MPI_FLOAT;
     case Type::DOUBLE:return MPI_DOUBLE;
@@ -57,23 +58,3 @@ MPI_Datatype cylon::mpi::GetMPIDataType(const std::shared_ptr<DataType> &data_ty
   }
   return nullptr;
 }
-
-cylon::Status cylon::mpi::AllReduce(const void *send_buf,
-                                    void *rcv_buf,
-                                    const int count,
-                                    const std::shared_ptr<cylon::DataType> &data_type,
-                                    const cylon::net::ReduceOp reduce_op) {
-  MPI_Datatype mpi_data_type = cylon::mpi::GetMPIDataType(data_type);
-  MPI_Op mpi_op = cylon::mpi::GetMPIOp(reduce_op);
-
-  if (mpi_data_type == nullptr || mpi_op == nullptr) {
-    return cylon::Status(cylon::Code::NotImplemented, "Unknown data type or operation for MPI");
-  }
-
-  if (MPI_Allreduce(send_buf, rcv_buf, count, mpi_data_type, mpi_op, MPI_COMM_WORLD) == MPI_SUCCESS) {
-    return cylon::Status::OK();
-  } else {
-    return cylon::Status(cylon::Code::ExecutionError, "MPI operation failed!");
-  }
-}
-
@@ -25,12 +25,6 @@ MPI_Op GetMPIOp(cylon::net::ReduceOp reduce_op);
 
 MPI_Datatype GetMPIDataType(const std::shared_ptr<DataType> &data_type);
 
-cylon::Status AllReduce(const void *send_buf,
-                        void *rcv_buf,
-                        int count,
-                        const std::shared_ptr<DataType> &data_type,
-                        cylon::net::ReduceOp reduce_op);
-
 }
 }
 #endif //CYLON_CPP_SRC_CYLON_NET_MPI_MPI_OPERATIONS_HPP_
@@ -106,10 +106,13 @@ bool AllToAll::isComplete() {
 
 	  std::shared_ptr<TxRequest> request = w->requestQueue.front();
 	  // if the request is accepted to be set, pop
-	  if (channel->send(request)) {
+	  if (channel->send(request) > 0) {
 		w->requestQueue.pop();
 		// we add to the pending queue
 		w->pendingQueue.push(request);
+	  } else {
+		// the channel does not take more for this target, try again in the next call
+		break;
 	  }
 	}
 
@@ -141,6 +144,14 @@ void AllToAll::finish() {
   finishFlag = true;
 }
 
+uint64_t AllToAll::events() {
+  return channel->events();
+}
+
+void AllToAll::waitForEvents() {
+  channel->waitForEvents();
+}
+
 void AllToAll::receivedData(int receiveId, std::shared_ptr<Buffer> buffer, int length) {
   // we just call the callback function of this
   callback->onReceive(receiveId, buffer, length);
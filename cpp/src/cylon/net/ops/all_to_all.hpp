@@ -120,6 +120,16 @@ class AllToAll : public ChannelReceiveCallback, ChannelSendCallback {
    */
   void finish();
 
+  /**
+   * @return number of sends and receives posted or completed by the channel so far
+   */
+  uint64_t events();
+
+  /**
+   * Block until one of the posted sends or receives of the channel completes
+   */
+  void waitForEvents();
+
   /**
    * We implement the receive complete callback from channel
    * @param receiveId
@@ -0,0 +1,124 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "progress_engine.hpp"
+
+#include <chrono>
+
+namespace cylon {
+namespace net {
+
+ProgressEngine::ProgressEngine(ProgressStrategy strategy, bool progress_thread, int spins)
+    : strategy_(strategy), spins_(spins), progress_thread_(progress_thread) {
+  if (progress_thread_) {
+    thread_ = std::thread(&ProgressEngine::ThreadMain, this);
+  }
+}
+
+ProgressEngine::~ProgressEngine() {
+  if (progress_thread_) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+}
+
+void ProgressEngine::Run(const std::function<bool()> &progress,
+                         const std::function<uint64_t()> &events,
+                         const std::function<void()> &wait) {
+  if (!progress_thread_) {
+    Loop(progress, events, wait);
+    return;
+  }
+  Start(progress, events, wait).get();
+}
+
+std::future<void> ProgressEngine::Start(std::function<bool()> progress,
+                                        std::function<uint64_t()> events,
+                                        std::function<void()> wait) {
+  auto loop = [this, progress, events, wait]() { Loop(progress, events, wait); };
+  if (!progress_thread_) {
+    return std::async(std::launch::deferred, loop);
+  }
+  std::packaged_task<void()> job(loop);
+  std::future<void> done = job.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(job));
+  }
+  cv_.notify_all();
+  return done;
+}
+
+void ProgressEngine::Loop(const std::function<bool()> &progress,
+                          const std::function<uint64_t()> &events,
+                          const std::function<void()> &wait) {
+  int idle_passes = 0;
+  uint64_t last_events = events();
+  auto start = std::chrono::steady_clock::now();
+  while (!progress()) {
+    uint64_t now_events = events();
+    if (now_events != last_events) {
+      last_events = now_events;
+      idle_passes = 0;
+      start = std::chrono::steady_clock::now();
+      continue;
+    }
+
+    if (++idle_passes > spins_) {
+      if (strategy_ == ProgressStrategy::SPIN_YIELD) {
+        std::this_thread::yield();
+      } else if (strategy_ == ProgressStrategy::BLOCKING) {
+        wait();
+      }
+    }
+    auto end = std::chrono::steady_clock::now();
+    idle_nanos_ += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    start = end;
+  }
+}
+
+void ProgressEngine::ThreadMain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+    if (jobs_.empty()) {
+      return;
+    }
+    std::packaged_task<void()> job = std::move(jobs_.front());
+    jobs_.pop_front();
+    lock.unlock();
+    // the exceptions of the loop go to its future
+    job();
+    lock.lock();
+  }
+}
+
+int64_t ProgressEngine::IdleTimeNanos() const {
+  return idle_nanos_.load();
+}
+
+ProgressStrategy ProgressEngine::GetStrategy() const {
+  return strategy_;
+}
+
+bool ProgressEngine::HasProgressThread() const {
+  return progress_thread_;
+}
+
+}  // namespace net
+}  // namespace cylon
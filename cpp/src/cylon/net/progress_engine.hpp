@@ -0,0 +1,165 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_NET_PROGRESS_ENGINE_HPP_
+#define CYLON_CPP_SRC_CYLON_NET_PROGRESS_ENGINE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace cylon {
+namespace net {
+
+/**
+ * What the progress engine does when a progress pass does not post or complete any request
+ */
+enum class ProgressStrategy {
+  // keep calling progress
+  SPIN,
+  // yield the core after a number of idle passes
+  SPIN_YIELD,
+  // block on the channel (MPI_Waitsome) after a number of idle passes
+  BLOCKING
+};
+
+/**
+ * Drives the progress of a communication operation (AllToAll, ArrowAllToAll) until it
+ * completes, instead of busy waiting on isComplete(). A pass that does not change the event count
+ * of the operation is idle, and after spins idle passes in a row the engine yields or blocks
+ * according to the strategy. The time spent in idle passes is measured and exposed.
+ *
+ * The loop runs on the calling thread, or on a dedicated progress thread. Start returns a future
+ * so that the caller can do other work while the progress thread drives the operation, without
+ * the progress thread the loop runs when the future is waited on. The caller must not touch the
+ * operation until the future is ready. With MPI the progress thread needs at least
+ * MPI_THREAD_SERIALIZED.
+ */
+class ProgressEngine {
+ public:
+  /**
+   * @param strategy what to do when there is no progress
+   * @param progress_thread run the progress loop on a dedicated thread
+   * @param spins number of idle passes before yielding or blocking
+   */
+  ProgressEngine(ProgressStrategy strategy, bool progress_thread, int spins);
+
+  virtual ~ProgressEngine();
+
+  /**
+   * Progress the operation until isComplete() returns true
+   * @tparam OP operation with isComplete(), events() and waitForEvents()
+   */
+  template<typename OP>
+  void Progress(OP &op) {
+    Run([&op]() { return op.isComplete(); }, [&op]() { return op.events(); },
+        [&op]() { op.waitForEvents(); });
+  }
+
+  /**
+   * Progress the operation until done() returns true
+   * @tparam OP operation with isComplete(), events() and waitForEvents()
+   * @tparam DONE bool()
+   */
+  template<typename OP, typename DONE>
+  void ProgressUntil(OP &op, const DONE &done) {
+    Run([&op, &done]() {
+          op.isComplete();
+          return done();
+        }, [&op]() { return op.events(); },
+        [&op]() { op.waitForEvents(); });
+  }
+
+  /**
+   * Start progressing the operation until isComplete() returns true
+   * @tparam OP operation with isComplete(), events() and waitForEvents()
+   * @return ready when the operation is complete, the operation must outlive it
+   */
+  template<typename OP>
+  std::future<void> StartProgress(OP &op) {
+    return Start([&op]() { return op.isComplete(); }, [&op]() { return op.events(); },
+                 [&op]() { op.waitForEvents(); });
+  }
+
+  /**
+   * Start progressing the operation until done() returns true
+   * @tparam OP operation with isComplete(), events() and waitForEvents()
+   * @tparam DONE bool(), called from the progress thread
+   * @return ready when done() returns true, the operation must outlive it
+   */
+  template<typename OP, typename DONE>
+  std::future<void> StartProgressUntil(OP &op, DONE done) {
+    return Start([&op, done]() {
+                   op.isComplete();
+                   return done();
+                 }, [&op]() { return op.events(); },
+                 [&op]() { op.waitForEvents(); });
+  }
+
+  /**
+   * Call progress until it returns true
+   * @param progress a progress pass, returns true when the operation is complete
+   * @param events number of events so far, a pass without new events is idle
+   * @param wait block until there is an event, used by the BLOCKING strategy
+   */
+  void Run(const std::function<bool()> &progress, const std::function<uint64_t()> &events,
+           const std::function<void()> &wait);
+
+  /**
+   * Queue the loop on the progress thread, or defer it to the first wait on the future without it
+   * @param progress a progress pass, returns true when the operation is complete
+   * @param events number of events so far, a pass without new events is idle
+   * @param wait block until there is an event, used by the BLOCKING strategy
+   * @return ready when progress returns true, holds the exception if the loop throws
+   */
+  std::future<void> Start(std::function<bool()> progress, std::function<uint64_t()> events,
+                          std::function<void()> wait);
+
+  /**
+   * @return total time spent in idle passes, yielding and blocking, in nano seconds
+   */
+  int64_t IdleTimeNanos() const;
+
+  ProgressStrategy GetStrategy() const;
+
+  bool HasProgressThread() const;
+
+ private:
+  void Loop(const std::function<bool()> &progress, const std::function<uint64_t()> &events,
+            const std::function<void()> &wait);
+
+  void ThreadMain();
+
+  ProgressStrategy strategy_;
+  int spins_;
+  std::atomic<int64_t> idle_nanos_{0};
+
+  // the dedicated progress thread and the loops queued for it, run in order
+  bool progress_thread_;
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::packaged_task<void()>> jobs_;
+  bool stop_ = false;
+};
+
+}  // namespace net
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_NET_PROGRESS_ENGINE_HPP_
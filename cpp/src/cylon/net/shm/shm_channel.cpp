@@ -0,0 +1,538 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shm_channel.hpp"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+#include "../TxRequest.hpp"
+
+namespace cylon {
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "the rings need lock free 64 bit atomics");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "the doorbells are futexes");
+
+// messages from this size are read directly from the source. A process_vm_readv costs a few
+// microseconds, about as much as copying such a message through the ring a second time
+static const int32_t kDirectBytes = 32 * 1024;
+
+// a co-located target reads this from the memory of the source to test direct reads
+static const uint64_t kProbe = 0x63796c6f6e73686dULL;
+
+/**
+ * Tell a co-located rank there is something new for it, waking it if it waits on its doorbell
+ */
+static void Ring(SHMDoorbell *doorbell) {
+  if (doorbell == nullptr) {
+    return;
+  }
+  doorbell->sequence.fetch_add(1);
+  if (doorbell->waiters.load() > 0) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&doorbell->sequence), FUTEX_WAKE, INT_MAX,
+            nullptr, nullptr, 0);
+  }
+}
+
+/**
+ * Copy n bytes from the address in the memory of the process pid
+ */
+static bool ReadDirect(pid_t pid, uint64_t address, void *dst, int64_t n) {
+  int64_t done = 0;
+  while (done < n) {
+    struct iovec local{static_cast<uint8_t *>(dst) + done, static_cast<size_t>(n - done)};
+    struct iovec remote{reinterpret_cast<void *>(address + done), static_cast<size_t>(n - done)};
+    ssize_t read = process_vm_readv(pid, &local, 1, &remote, 1, 0);
+    if (read <= 0) {
+      return false;
+    }
+    done += read;
+  }
+  return true;
+}
+
+/**
+ * Copy n bytes in to the ring at the position pos, wrapping around the end of the ring
+ */
+static void RingWrite(uint8_t *data, uint64_t capacity, uint64_t pos, const void *src,
+                      uint64_t n) {
+  const uint64_t start = pos & (capacity - 1);
+  const uint64_t first = std::min(n, capacity - start);
+  std::memcpy(data + start, src, first);
+  std::memcpy(data, static_cast<const uint8_t *>(src) + first, n - first);
+}
+
+/**
+ * Copy n bytes out of the ring at the position pos, wrapping around the end of the ring
+ */
+static void RingRead(const uint8_t *data, uint64_t capacity, uint64_t pos, void *dst,
+                     uint64_t n) {
+  const uint64_t start = pos & (capacity - 1);
+  const uint64_t first = std::min(n, capacity - start);
+  std::memcpy(dst, data + start, first);
+  std::memcpy(static_cast<uint8_t *>(dst) + first, data, n - first);
+}
+
+static std::string SegmentName(const std::string &name, int rank) {
+  return name + "_" + std::to_string(rank);
+}
+
+SHMChannel::SHMChannel(std::string name, std::vector<int> node_ranks, int64_t ring_bytes,
+                       MPI_Comm comm, int64_t max_in_flight_bytes, MPI_Comm credit_comm)
+    : name(std::move(name)), nodeRanks(std::move(node_ranks)), ringBytes(ring_bytes), comm(comm),
+      mpiChannel(comm, max_in_flight_bytes, credit_comm) {
+  const int64_t page = sysconf(_SC_PAGESIZE);
+  // a segment starts with a page for the doorbell, a ring is a page for its header followed by
+  // the data
+  slotBytes = page + ringBytes;
+  segmentBytes = page + static_cast<int64_t>(nodeRanks.size()) * slotBytes;
+}
+
+void SHMChannel::init(int ed, const std::vector<int> &receives, const std::vector<int> &sendIds,
+                      ChannelReceiveCallback *rcv, ChannelSendCallback *send_fn,
+                      Allocator *alloc) {
+  rcv_fn = rcv;
+  send_comp_fn = send_fn;
+  allocator = alloc;
+  MPI_Comm_rank(comm, &rank);
+
+  auto isLocal = [this](int r) {
+    return std::find(nodeRanks.begin(), nodeRanks.end(), r) != nodeRanks.end();
+  };
+  std::vector<int> remoteReceives, remoteSends;
+  for (int source : receives) {
+    if (isLocal(source)) {
+      pendingReceives[source] = new SHMPendingReceive();
+    } else {
+      remoteReceives.push_back(source);
+    }
+  }
+  for (int target : sendIds) {
+    if (isLocal(target)) {
+      sends[target] = new SHMPendingSend();
+    } else {
+      remoteSends.push_back(target);
+    }
+  }
+  mpiChannel.init(ed, remoteReceives, remoteSends, rcv, send_fn, alloc);
+  hasRemote = !remoteReceives.empty() || !remoteSends.empty();
+
+  if (pendingReceives.empty() && sends.empty()) {
+    return;
+  }
+  if (!sends.empty()) {
+    // let the co-located targets read the messages directly under the Yama ptrace restrictions,
+    // like the shared memory transports of MPI do. If this fails they probe it and copy instead
+    prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY, 0, 0, 0);
+  }
+  // the co-located sources map their rings from this segment once it has its full size, and the
+  // co-located ranks ring its doorbell
+  const std::string segmentName = SegmentName(name, rank);
+  // a segment left behind by a failed run with the same name
+  shm_unlink(segmentName.c_str());
+  int fd = shm_open(segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    LOG(FATAL) << "Failed to create shared memory " << segmentName << ": " << strerror(errno);
+  }
+  if (ftruncate(fd, segmentBytes) != 0) {
+    LOG(FATAL) << "Failed to size shared memory " << segmentName << ": " << strerror(errno);
+  }
+  segment = mmap(nullptr, segmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (segment == MAP_FAILED) {
+    LOG(FATAL) << "Failed to map shared memory " << segmentName << ": " << strerror(errno);
+  }
+  doorbell = static_cast<SHMDoorbell *>(segment);
+  const int64_t page = slotBytes - ringBytes;
+  for (auto &x : pendingReceives) {
+    int64_t index = std::find(nodeRanks.begin(), nodeRanks.end(), x.first) - nodeRanks.begin();
+    uint8_t *slot = static_cast<uint8_t *>(segment) + page + index * slotBytes;
+    x.second->ring = reinterpret_cast<SHMRing *>(slot);
+    x.second->data = slot + page;
+  }
+}
+
+bool SHMChannel::mapSendRing(int target, SHMPendingSend *ps) {
+  const std::string segmentName = SegmentName(name, target);
+  int fd = shm_open(segmentName.c_str(), O_RDWR, 0600);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st{};
+  if (fstat(fd, &st) != 0 || st.st_size < segmentBytes) {
+    ::close(fd);
+    return false;
+  }
+  const int64_t page = slotBytes - ringBytes;
+  int64_t index = std::find(nodeRanks.begin(), nodeRanks.end(), rank) - nodeRanks.begin();
+  void *mapping = mmap(nullptr, slotBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                       page + index * slotBytes);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    LOG(FATAL) << "Failed to map shared memory " << segmentName << ": " << strerror(errno);
+  }
+  ps->doorbell = mapDoorbell(target);
+  if (ps->doorbell == nullptr) {
+    munmap(mapping, slotBytes);
+    return false;
+  }
+  ps->mapping = mapping;
+  ps->ring = static_cast<SHMRing *>(mapping);
+  ps->data = static_cast<uint8_t *>(mapping) + page;
+  // offer the target to read the messages directly, it probes this before the first large one
+  ps->ring->pid = getpid();
+  ps->ring->probe = reinterpret_cast<uint64_t>(&kProbe);
+  ps->ring->offered.store(1, std::memory_order_release);
+  events_++;
+  return true;
+}
+
+SHMDoorbell *SHMChannel::mapDoorbell(int peer) {
+  int fd = shm_open(SegmentName(name, peer).c_str(), O_RDWR, 0600);
+  if (fd < 0) {
+    return nullptr;
+  }
+  void *mapping = mmap(nullptr, slotBytes - ringBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  return mapping == MAP_FAILED ? nullptr : static_cast<SHMDoorbell *>(mapping);
+}
+
+int SHMChannel::send(std::shared_ptr<TxRequest> request) {
+  auto ps = sends.find(request->target);
+  if (ps == sends.end()) {
+    return mpiChannel.send(request);
+  }
+  if (ps->second->pendingData.size() > 1000) {
+    return -1;
+  }
+  ps->second->pendingData.push(request);
+  return 1;
+}
+
+int SHMChannel::sendFin(std::shared_ptr<TxRequest> request) {
+  if (sends.find(request->target) == sends.end()) {
+    return mpiChannel.sendFin(request);
+  }
+  if (finishRequests.find(request->target) != finishRequests.end()) {
+    return -1;
+  }
+  finishRequests.insert(std::pair<int, std::shared_ptr<TxRequest>>(request->target, request));
+  return 1;
+}
+
+void SHMChannel::progressSends() {
+  mpiChannel.progressSends();
+  for (auto x : sends) {
+    const uint64_t before = events_;
+    if (x.second->ring != nullptr || mapSendRing(x.first, x.second)) {
+      progressSend(x.first, x.second);
+    }
+    if (events_ != before) {
+      Ring(x.second->doorbell);
+    }
+  }
+}
+
+void SHMChannel::progressSend(int target, SHMPendingSend *ps) {
+  const auto capacity = static_cast<uint64_t>(ringBytes);
+  // the target has read the direct messages up to these, their buffers can be released
+  const uint64_t copied = ps->ring->copied.load(std::memory_order_acquire);
+  while (!ps->awaitingCopy.empty() && ps->awaitingCopy.front().first <= copied) {
+    std::shared_ptr<TxRequest> sent = std::move(ps->awaitingCopy.front().second);
+    ps->awaitingCopy.pop();
+    events_++;
+    send_comp_fn->sendComplete(sent);
+  }
+
+  while (!ps->finSent) {
+    if (ps->currentSend == nullptr) {
+      if (!ps->pendingData.empty()) {
+        ps->currentSend = ps->pendingData.front();
+        ps->pendingData.pop();
+        ps->offset = -1;
+      } else if (finishRequests.find(target) == finishRequests.end()
+          || !ps->awaitingCopy.empty()) {
+        return;
+      }
+    }
+
+    // we are the only writer of the head
+    uint64_t head = ps->ring->head.load(std::memory_order_relaxed);
+    uint64_t space = capacity - (head - ps->ring->tail.load(std::memory_order_acquire));
+    if (ps->currentSend == nullptr) {
+      // all the messages are out, send the finish
+      if (space < sizeof(SHMFrame)) {
+        return;
+      }
+      SHMFrame frame{};
+      frame.fin = CYLON_MSG_FIN;
+      RingWrite(ps->data, capacity, head, &frame, sizeof(SHMFrame));
+      ps->ring->head.store(head + sizeof(SHMFrame), std::memory_order_release);
+      ps->finSent = true;
+      events_++;
+      send_comp_fn->sendFinishComplete(finishRequests[target]);
+      return;
+    }
+
+    const std::shared_ptr<TxRequest> &r = ps->currentSend;
+    if (ps->offset < 0) {
+      // a large message waits for the target to probe whether it can read it directly
+      const int32_t cma = r->length >= kDirectBytes
+                          ? ps->ring->cma.load(std::memory_order_acquire) : 2;
+      if (cma == 0 || space < sizeof(SHMFrame)) {
+        return;
+      }
+      SHMFrame frame{};
+      frame.length = r->length;
+      frame.headerLength = r->headerLength;
+      if (r->headerLength > 0) {
+        std::memcpy(frame.header, &(r->header[0]), r->headerLength * sizeof(int));
+      }
+      frame.direct = cma == 1;
+      frame.address = reinterpret_cast<uint64_t>(r->buffer);
+      RingWrite(ps->data, capacity, head, &frame, sizeof(SHMFrame));
+      if (frame.direct) {
+        // only the frame goes through the ring, the buffer is released once the target copied it
+        ps->ring->head.store(head + sizeof(SHMFrame), std::memory_order_release);
+        events_++;
+        ps->awaitingCopy.emplace(++ps->direct, std::move(ps->currentSend));
+        ps->currentSend = nullptr;
+        continue;
+      }
+      head += sizeof(SHMFrame);
+      space -= sizeof(SHMFrame);
+      ps->offset = 0;
+      ps->ring->head.store(head, std::memory_order_release);
+      events_++;
+    }
+
+    const auto n = std::min<uint64_t>(space, r->length - ps->offset);
+    if (n > 0) {
+      RingWrite(ps->data, capacity, head, static_cast<uint8_t *>(r->buffer) + ps->offset, n);
+      ps->offset += n;
+      ps->ring->head.store(head + n, std::memory_order_release);
+      events_++;
+    }
+    if (ps->offset < r->length) {
+      return;
+    }
+    // the message is in the ring, the buffer can be released. The callers expect the requests
+    // of a target to complete in order, so it waits for the direct messages before it
+    std::shared_ptr<TxRequest> sent = std::move(ps->currentSend);
+    ps->currentSend = nullptr;
+    if (ps->awaitingCopy.empty()) {
+      send_comp_fn->sendComplete(sent);
+    } else {
+      ps->awaitingCopy.emplace(ps->direct, std::move(sent));
+    }
+  }
+}
+
+void SHMChannel::progressReceives() {
+  mpiChannel.progressReceives();
+  for (auto x : pendingReceives) {
+    const uint64_t before = events_;
+    progressReceive(x.first, x.second);
+    if (events_ != before) {
+      Ring(x.second->doorbell);
+    }
+  }
+}
+
+void SHMChannel::progressReceive(int source, SHMPendingReceive *pr) {
+  const auto capacity = static_cast<uint64_t>(ringBytes);
+  if (!pr->probed && pr->ring->offered.load(std::memory_order_acquire) != 0) {
+    // the source has created its segment by now, unless it is done and removed it
+    pr->doorbell = mapDoorbell(source);
+    uint64_t probe = 0;
+    bool direct = ReadDirect(pr->ring->pid, pr->ring->probe, &probe, sizeof(probe))
+        && probe == kProbe;
+    pr->ring->cma.store(direct ? 1 : 2, std::memory_order_release);
+    pr->probed = true;
+    events_++;
+  }
+
+  while (!pr->finished) {
+    // we are the only writer of the tail
+    uint64_t tail = pr->ring->tail.load(std::memory_order_relaxed);
+    uint64_t available = pr->ring->head.load(std::memory_order_acquire) - tail;
+    if (pr->buffer == nullptr) {
+      if (available < sizeof(SHMFrame)) {
+        return;
+      }
+      SHMFrame frame{};
+      RingRead(pr->data, capacity, tail, &frame, sizeof(SHMFrame));
+      tail += sizeof(SHMFrame);
+      available -= sizeof(SHMFrame);
+      pr->ring->tail.store(tail, std::memory_order_release);
+      events_++;
+      if (frame.fin == CYLON_MSG_FIN) {
+        pr->finished = true;
+        rcv_fn->receivedHeader(source, CYLON_MSG_FIN, nullptr, 0);
+        return;
+      }
+
+      Status stat = allocator->AllocateForSource(source, frame.length, &pr->buffer);
+      if (!stat.is_ok()) {
+        LOG(FATAL) << "Failed to allocate buffer with length " << frame.length;
+      }
+      pr->length = frame.length;
+      pr->received = 0;
+      int *header = nullptr;
+      if (frame.headerLength > 0) {
+        header = new int[frame.headerLength];
+        std::memcpy(header, frame.header, frame.headerLength * sizeof(int));
+      }
+      rcv_fn->receivedHeader(source, 0, header, frame.headerLength);
+      if (frame.direct) {
+        if (!ReadDirect(pr->ring->pid, frame.address, pr->buffer->GetByteBuffer(), pr->length)) {
+          LOG(FATAL) << "Failed to read " << pr->length << " bytes from " << source << ": "
+                     << strerror(errno);
+        }
+        pr->received = pr->length;
+        pr->ring->copied.fetch_add(1, std::memory_order_release);
+        events_++;
+      }
+    }
+
+    const auto n = std::min<uint64_t>(available, pr->length - pr->received);
+    if (n > 0) {
+      RingRead(pr->data, capacity, tail, pr->buffer->GetByteBuffer() + pr->received, n);
+      pr->received += n;
+      pr->ring->tail.store(tail + n, std::memory_order_release);
+      events_++;
+    }
+    if (pr->received < pr->length) {
+      return;
+    }
+    std::shared_ptr<Buffer> buffer = std::move(pr->buffer);
+    pr->buffer = nullptr;
+    rcv_fn->receivedData(source, buffer, pr->length);
+  }
+}
+
+uint64_t SHMChannel::events() {
+  return events_ + mpiChannel.events();
+}
+
+bool SHMChannel::ringsReady() {
+  const auto capacity = static_cast<uint64_t>(ringBytes);
+  for (auto &x : pendingReceives) {
+    SHMPendingReceive *pr = x.second;
+    if (pr->finished) {
+      continue;
+    }
+    if (pr->ring->head.load(std::memory_order_acquire)
+        != pr->ring->tail.load(std::memory_order_relaxed)
+        || (!pr->probed && pr->ring->offered.load(std::memory_order_acquire) != 0)) {
+      return true;
+    }
+  }
+  for (auto &x : sends) {
+    SHMPendingSend *ps = x.second;
+    if (ps->finSent || ps->ring == nullptr) {
+      continue;
+    }
+    if (!ps->awaitingCopy.empty()
+        && ps->awaitingCopy.front().first <= ps->ring->copied.load(std::memory_order_acquire)) {
+      return true;
+    }
+    const TxRequest *next = ps->currentSend != nullptr ? ps->currentSend.get()
+        : !ps->pendingData.empty() ? ps->pendingData.front().get() : nullptr;
+    if (next == nullptr && (finishRequests.find(x.first) == finishRequests.end()
+        || !ps->awaitingCopy.empty())) {
+      continue;
+    }
+    const uint64_t space = capacity - (ps->ring->head.load(std::memory_order_relaxed)
+        - ps->ring->tail.load(std::memory_order_acquire));
+    if (ps->currentSend != nullptr && ps->offset >= 0) {
+      if (space > 0) {
+        return true;
+      }
+    } else if ((next == nullptr || next->length < kDirectBytes
+        || ps->ring->cma.load(std::memory_order_acquire) != 0) && space >= sizeof(SHMFrame)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void SHMChannel::waitForEvents() {
+  bool done = true;
+  for (auto &x : pendingReceives) {
+    done = done && x.second->finished;
+  }
+  for (auto &x : sends) {
+    done = done && x.second->finSent;
+  }
+  if (done) {
+    mpiChannel.waitForEvents();
+    return;
+  }
+
+  // a co-located rank that changes something for this rank after the sequence is read here,
+  // sees the waiter and wakes it
+  doorbell->waiters.fetch_add(1);
+  const uint32_t sequence = doorbell->sequence.load();
+  if (!ringsReady()) {
+    // the MPI requests and the targets without a segment yet do not ring, poll them
+    bool poll = hasRemote;
+    for (auto &x : sends) {
+      poll = poll || x.second->ring == nullptr;
+    }
+    struct timespec timeout{0, poll ? 100000 : 10000000};
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&doorbell->sequence), FUTEX_WAIT, sequence,
+            &timeout, nullptr, 0);
+  }
+  doorbell->waiters.fetch_sub(1);
+}
+
+void SHMChannel::close() {
+  for (auto &s : sends) {
+    if (s.second->mapping != nullptr) {
+      munmap(s.second->mapping, slotBytes);
+      munmap(s.second->doorbell, slotBytes - ringBytes);
+    }
+    delete s.second;
+  }
+  sends.clear();
+  for (auto &r : pendingReceives) {
+    if (r.second->doorbell != nullptr) {
+      munmap(r.second->doorbell, slotBytes - ringBytes);
+    }
+    delete r.second;
+  }
+  pendingReceives.clear();
+  if (segment != nullptr) {
+    munmap(segment, segmentBytes);
+    shm_unlink(SegmentName(name, rank).c_str());
+    segment = nullptr;
+    doorbell = nullptr;
+  }
+  mpiChannel.close();
+}
+}  // namespace cylon
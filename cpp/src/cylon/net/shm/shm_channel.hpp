@@ -0,0 +1,212 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_NET_SHM_SHM_CHANNEL_HPP_
+#define CYLON_CPP_SRC_CYLON_NET_SHM_SHM_CHANNEL_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../channel.hpp"
+#include "../mpi/mpi_channel.hpp"
+
+namespace cylon {
+
+/**
+ * Single producer single consumer byte ring in shared memory. head is the total number of bytes
+ * written by the producer and tail the total number of bytes read by the consumer. The data of the
+ * ring follows this header, at the next page.
+ *
+ * The producer offers to let the consumer read its memory directly (cross memory attach), by
+ * publishing its pid and the address of a probe word. The consumer reads the probe and sets cma to
+ * 1 if that works, 2 otherwise. copied counts the messages the consumer has read directly
+ */
+struct SHMRing {
+  alignas(64) std::atomic<uint64_t> head;
+  alignas(64) std::atomic<uint64_t> tail;
+  // written by the consumer
+  alignas(64) std::atomic<uint64_t> copied;
+  std::atomic<int32_t> cma;
+  // written by the producer
+  alignas(64) std::atomic<int32_t> offered;
+  int32_t pid;
+  uint64_t probe;
+};
+
+/**
+ * The first page of the segment of a rank. The peers of the rank increment sequence when there is
+ * something new for it, data in its rings, space in the rings it writes to or copied messages, and
+ * wake it with a futex on sequence if it is waiting
+ */
+struct SHMDoorbell {
+  alignas(64) std::atomic<uint32_t> sequence;
+  alignas(64) std::atomic<uint32_t> waiters;
+};
+
+/**
+ * A message in a ring starts with this frame. It is followed by length bytes of data, unless the
+ * data is read directly from address in the memory of the producer
+ */
+struct SHMFrame {
+  int32_t length;
+  int32_t fin;
+  int32_t headerLength;
+  int32_t header[CYLON_CHANNEL_HEADER_SIZE - 2];
+  int32_t direct;
+  uint64_t address;
+};
+
+/**
+ * Send side of a ring to a co-located target
+ */
+struct SHMPendingSend {
+  std::queue<std::shared_ptr<TxRequest>> pendingData;
+  // the request being copied in to the ring
+  std::shared_ptr<TxRequest> currentSend{};
+  // bytes of the current request copied in to the ring, -1 if its frame is not written yet
+  int64_t offset = -1;
+  // the requests from the first one the target reads directly, with the number of direct
+  // messages it has to copy before they complete, so they complete in the order of the sends
+  std::queue<std::pair<uint64_t, std::shared_ptr<TxRequest>>> awaitingCopy;
+  // direct messages sent to the target
+  uint64_t direct = 0;
+  bool finSent = false;
+  // the ring and the doorbell in the shared memory of the target, mapped on first use
+  SHMRing *ring = nullptr;
+  uint8_t *data = nullptr;
+  void *mapping = nullptr;
+  SHMDoorbell *doorbell = nullptr;
+};
+
+/**
+ * Receive side of a ring from a co-located source
+ */
+struct SHMPendingReceive {
+  SHMRing *ring = nullptr;
+  uint8_t *data = nullptr;
+  // the message being copied out of the ring, nullptr while waiting for a frame
+  std::shared_ptr<Buffer> buffer{};
+  int length = 0;
+  int received = 0;
+  bool finished = false;
+  // the doorbell of the source, mapped when probing its offer of direct reads
+  SHMDoorbell *doorbell = nullptr;
+  bool probed = false;
+};
+
+/**
+ * A channel that sends the messages to co-located ranks through shared memory rings and the rest
+ * through MPI. Every rank creates a shared memory segment per channel with a doorbell and a ring
+ * for each rank of its node.
+ *
+ * Messages of at least 32KB are copied once: the ring carries only their frame and the
+ * receiver reads the data with process_vm_readv from the buffer of the sender, straight in to the
+ * buffer of its allocator. Smaller messages, and all the messages when the kernel does not allow
+ * the ranks to read each other's memory (ptrace restrictions, seccomp), are copied twice, in to
+ * the ring and out of it. This costs a second memcpy of the message, but no system call
+ */
+class SHMChannel : public Channel {
+ public:
+  /**
+   * @param name name of the shared memory segments of this channel, the rank is appended to it
+   * @param node_ranks ranks on this node, in the order of their rings in a segment
+   * @param ring_bytes capacity of a ring, a power of 2 and a multiple of the page size
+   * @param comm communicator the ranks belong to
+   * @param max_in_flight_bytes flow control of the ranks on other nodes, see MPIChannel
+   * @param credit_comm duplicate of comm for the credits
+   */
+  SHMChannel(std::string name, std::vector<int> node_ranks, int64_t ring_bytes,
+             MPI_Comm comm = MPI_COMM_WORLD, int64_t max_in_flight_bytes = 0,
+             MPI_Comm credit_comm = MPI_COMM_WORLD);
+
+  void init(int edge, const std::vector<int> &receives, const std::vector<int> &sendIds,
+            ChannelReceiveCallback *rcv, ChannelSendCallback *send, Allocator *alloc) override;
+
+  int send(std::shared_ptr<TxRequest> request) override;
+
+  int sendFin(std::shared_ptr<TxRequest> request) override;
+
+  void progressSends() override;
+
+  void progressReceives() override;
+
+  uint64_t events() override;
+
+  /**
+   * Block on the doorbell of this rank until a co-located rank rings it, with a short timeout if
+   * there are ranks on other nodes. Once the co-located ranks are done, block on the MPI requests
+   */
+  void waitForEvents() override;
+
+  void close() override;
+
+ private:
+  /**
+   * Map the ring of this rank in the segment of a co-located target
+   * @return false if the target has not created its segment yet
+   */
+  bool mapSendRing(int target, SHMPendingSend *ps);
+
+  /**
+   * Copy messages of a co-located target in to its ring, as far as the ring has space
+   */
+  void progressSend(int target, SHMPendingSend *ps);
+
+  /**
+   * Copy messages of a co-located source out of its ring
+   */
+  void progressReceive(int source, SHMPendingReceive *pr);
+
+  /**
+   * @return the doorbell of a co-located rank, nullptr if its segment is not there
+   */
+  SHMDoorbell *mapDoorbell(int peer);
+
+  /**
+   * @return true if the next progress of the rings has something to do
+   */
+  bool ringsReady();
+
+  std::string name;
+  std::vector<int> nodeRanks;
+  int64_t ringBytes;
+  int64_t slotBytes;
+  int64_t segmentBytes;
+  int rank = -1;
+  MPI_Comm comm;
+
+  // the channel of the ranks on other nodes
+  MPIChannel mpiChannel;
+  std::unordered_map<int, SHMPendingSend *> sends;
+  std::unordered_map<int, SHMPendingReceive *> pendingReceives;
+  std::unordered_map<int, std::shared_ptr<TxRequest>> finishRequests;
+  ChannelReceiveCallback *rcv_fn = nullptr;
+  ChannelSendCallback *send_comp_fn = nullptr;
+  Allocator *allocator = nullptr;
+  // the segment of this rank, the co-located sources write to it
+  void *segment = nullptr;
+  SHMDoorbell *doorbell = nullptr;
+  // MPI requests do not ring the doorbell, poll them while waiting on it
+  bool hasRemote = false;
+  uint64_t events_ = 0;
+};
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_NET_SHM_SHM_CHANNEL_HPP_
@@ -0,0 +1,101 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shm_communicator.hpp"
+
+#include <mpi.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include "shm_channel.hpp"
+
+namespace cylon {
+namespace net {
+
+SHMConfig::SHMConfig(int64_t ring_bytes) : ring_bytes_(ring_bytes) {}
+
+CommType SHMConfig::Type() {
+  return CommType::SHM;
+}
+
+int64_t SHMConfig::GetRingBytes() const {
+  return ring_bytes_;
+}
+
+std::shared_ptr<SHMConfig> SHMConfig::Make(int64_t ring_bytes) {
+  return std::make_shared<SHMConfig>(ring_bytes);
+}
+
+// number of communicators created by this process, tells apart the segments of the groups
+static int sessions = 0;
+
+SHMCommunicator::SHMCommunicator(MPI_Comm comm, int64_t ring_bytes,
+                                 int64_t max_in_flight_bytes)
+    : MPICommunicator(comm, max_in_flight_bytes), ring_bytes_(ring_bytes) {
+  InitNode();
+}
+
+void SHMCommunicator::Init(const std::shared_ptr<CommConfig> &config) {
+  MPICommunicator::Init(config);
+
+  // the rings are indexed with a mask, and mapped at page boundaries
+  const int64_t requested = std::static_pointer_cast<SHMConfig>(config)->GetRingBytes();
+  ring_bytes_ = sysconf(_SC_PAGESIZE);
+  while (ring_bytes_ < requested) {
+    ring_bytes_ <<= 1;
+  }
+  InitNode();
+}
+
+void SHMCommunicator::InitNode() {
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(comm_, MPI_COMM_TYPE_SHARED, this->rank, MPI_INFO_NULL, &node_comm);
+  int node_size;
+  MPI_Comm_size(node_comm, &node_size);
+  node_ranks_.resize(node_size);
+  MPI_Allgather(&this->rank, 1, MPI_INT, node_ranks_.data(), 1, MPI_INT, node_comm);
+
+  // the pid of the first rank of the node is unique on the node while the run lasts, and its
+  // count of communicators is unique to the group
+  int session[2] = {getpid(), sessions++};
+  MPI_Bcast(session, 2, MPI_INT, 0, node_comm);
+  session_ = "/cylon_" + std::to_string(session[0]) + "_" + std::to_string(session[1]);
+  MPI_Comm_free(&node_comm);
+}
+
+Channel *SHMCommunicator::CreateChannel() {
+  return new SHMChannel(session_ + "_" + std::to_string(channels_++), node_ranks_, ring_bytes_,
+                        comm_, max_in_flight_bytes_, credit_comm_);
+}
+
+CommType SHMCommunicator::GetCommType() {
+  return SHM;
+}
+
+std::shared_ptr<Communicator> SHMCommunicator::Split(int color, int key) {
+  MPI_Comm group;
+  MPI_Comm_split(comm_, color < 0 ? MPI_UNDEFINED : color, key, &group);
+  if (group == MPI_COMM_NULL) {
+    return nullptr;
+  }
+  return std::make_shared<SHMCommunicator>(group, ring_bytes_, max_in_flight_bytes_);
+}
+
+const std::vector<int> &SHMCommunicator::GetNodeRanks() const {
+  return node_ranks_;
+}
+}  // namespace net
+}  // namespace cylon
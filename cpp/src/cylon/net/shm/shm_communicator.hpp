@@ -0,0 +1,90 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_NET_SHM_SHM_COMMUNICATOR_HPP_
+#define CYLON_CPP_SRC_CYLON_NET_SHM_SHM_COMMUNICATOR_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../comm_config.hpp"
+#include "../communicator.hpp"
+#include "../mpi/mpi_communicator.hpp"
+
+namespace cylon {
+namespace net {
+
+class SHMConfig : public CommConfig {
+ public:
+  /**
+   * @param ring_bytes capacity of the ring between a pair of co-located ranks, rounded up to a
+   * power of 2 and a multiple of the page size
+   */
+  explicit SHMConfig(int64_t ring_bytes);
+
+  CommType Type() override;
+
+  int64_t GetRingBytes() const;
+
+  static std::shared_ptr<SHMConfig> Make(int64_t ring_bytes = 1 << 18);
+
+ private:
+  int64_t ring_bytes_;
+};
+
+/**
+ * Communicator for ranks that share nodes. MPI is used to start the ranks, for the collectives and
+ * to send to ranks on other nodes, and the channels send to the ranks on the same node through
+ * POSIX shared memory rings
+ */
+class SHMCommunicator : public MPICommunicator {
+ public:
+  SHMCommunicator() = default;
+
+  /**
+   * Communicator of a group of the workers, see Split
+   * @param comm
+   * @param ring_bytes
+   * @param max_in_flight_bytes flow control of the messages to the other nodes
+   */
+  SHMCommunicator(MPI_Comm comm, int64_t ring_bytes, int64_t max_in_flight_bytes);
+
+  void Init(const std::shared_ptr<CommConfig> &config) override;
+  Channel *CreateChannel() override;
+  CommType GetCommType() override;
+  std::shared_ptr<Communicator> Split(int color, int key) override;
+
+  /**
+   * @return ranks on the node of this rank, including it
+   */
+  const std::vector<int> &GetNodeRanks() const;
+
+ private:
+  /**
+   * Find the ranks on the node of this rank and name the segments of the communicator
+   */
+  void InitNode();
+
+  std::vector<int> node_ranks_;
+  // prefix of the shared memory segments, unique to the node and the run
+  std::string session_;
+  int64_t ring_bytes_ = 0;
+  // channels are created in the same order by all the ranks, this numbers their segments
+  int64_t channels_ = 0;
+};
+}  // namespace net
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_NET_SHM_SHM_COMMUNICATOR_HPP_
@@ -0,0 +1,113 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tcp_channel.hpp"
+
+#include <glog/logging.h>
+
+#include <cstring>
+
+namespace cylon {
+
+constexpr int64_t TCPChannel::DEFAULT_MAX_QUEUED_BYTES;
+
+TCPChannel::TCPChannel(net::TCPCommunicator *communicator, int64_t max_queued_bytes)
+    : communicator(communicator), maxQueuedBytes(max_queued_bytes) {}
+
+void TCPChannel::init(int ed, const std::vector<int> &receives, const std::vector<int> &sendIds,
+                      ChannelReceiveCallback *rcv, ChannelSendCallback *send_fn,
+                      Allocator *alloc) {
+  edge = ed;
+  rcv_fn = rcv;
+  send_comp_fn = send_fn;
+  allocator = alloc;
+  communicator->Register(edge, this);
+}
+
+int TCPChannel::send(std::shared_ptr<TxRequest> request) {
+  std::pair<size_t, int64_t> &q = queued[request->target];
+  if (q.first > 1000) {
+    return -1;
+  }
+  // the queue of a target holds up to the limit, or a single larger message
+  if (maxQueuedBytes > 0 && q.first > 0 && q.second + request->length > maxQueuedBytes) {
+    return -1;
+  }
+  q.first++;
+  q.second += request->length;
+  communicator->Send(this, edge, request, false);
+  return 1;
+}
+
+int TCPChannel::sendFin(std::shared_ptr<TxRequest> request) {
+  communicator->Send(this, edge, request, true);
+  return 1;
+}
+
+void TCPChannel::progressSends() {
+  communicator->Progress();
+}
+
+void TCPChannel::progressReceives() {
+  // the connections are shared with the sends, progressSends did the reads as well
+}
+
+uint64_t TCPChannel::events() {
+  return communicator->Events();
+}
+
+void TCPChannel::waitForEvents() {
+  communicator->Wait(100);
+}
+
+void TCPChannel::close() {
+  communicator->Unregister(edge);
+}
+
+std::shared_ptr<Buffer> TCPChannel::receivedFrame(int source, const net::TCPFrame &frame) {
+  if (frame.fin) {
+    rcv_fn->receivedHeader(source, frame.fin, nullptr, 0);
+    return nullptr;
+  }
+
+  std::shared_ptr<Buffer> buffer;
+  Status stat = allocator->AllocateForSource(source, frame.length, &buffer);
+  if (!stat.is_ok()) {
+    LOG(FATAL) << "Failed to allocate buffer with length " << frame.length;
+  }
+  int *header = nullptr;
+  if (frame.headerLength > 0) {
+    header = new int[frame.headerLength];
+    std::memcpy(header, frame.header, frame.headerLength * sizeof(int));
+  }
+  rcv_fn->receivedHeader(source, 0, header, frame.headerLength);
+  return buffer;
+}
+
+void TCPChannel::receivedFrameData(int source, const std::shared_ptr<Buffer> &buffer,
+                                   int length) {
+  rcv_fn->receivedData(source, buffer, length);
+}
+
+void TCPChannel::sent(const std::shared_ptr<TxRequest> &request, bool fin) {
+  if (fin) {
+    send_comp_fn->sendFinishComplete(request);
+  } else {
+    std::pair<size_t, int64_t> &q = queued[request->target];
+    q.first--;
+    q.second -= request->length;
+    send_comp_fn->sendComplete(request);
+  }
+}
+}  // namespace cylon
@@ -0,0 +1,95 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_NET_TCP_TCP_CHANNEL_HPP_
+#define CYLON_CPP_SRC_CYLON_NET_TCP_TCP_CHANNEL_HPP_
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../channel.hpp"
+#include "tcp_communicator.hpp"
+
+namespace cylon {
+
+/**
+ * Channel of an operation over the connections of a TCPCommunicator. The messages go out in the
+ * order they are sent, and are received straight in to the buffers of the allocator.
+ *
+ * The messages wait in the communicator until the connection takes them, so like the MPIChannel
+ * the channel rejects a send while a target has too many messages or bytes queued
+ */
+class TCPChannel : public Channel {
+ public:
+  static constexpr int64_t DEFAULT_MAX_QUEUED_BYTES = 64LL << 20;
+
+  /**
+   * @param communicator
+   * @param max_queued_bytes bytes queued to a target before the sends are rejected, a single
+   * larger message is always accepted. 0 limits the number of messages only
+   */
+  explicit TCPChannel(net::TCPCommunicator *communicator,
+                      int64_t max_queued_bytes = DEFAULT_MAX_QUEUED_BYTES);
+
+  void init(int edge, const std::vector<int> &receives, const std::vector<int> &sendIds,
+            ChannelReceiveCallback *rcv, ChannelSendCallback *send, Allocator *alloc) override;
+
+  int send(std::shared_ptr<TxRequest> request) override;
+
+  int sendFin(std::shared_ptr<TxRequest> request) override;
+
+  void progressSends() override;
+
+  void progressReceives() override;
+
+  uint64_t events() override;
+
+  /**
+   * Wait in epoll for the connections
+   */
+  void waitForEvents() override;
+
+  void close() override;
+
+  /**
+   * A frame of this channel is received, allocate the buffer for its data
+   * @return the buffer, nullptr for a finish frame
+   */
+  std::shared_ptr<Buffer> receivedFrame(int source, const net::TCPFrame &frame);
+
+  /**
+   * The data of a frame is received in to the buffer
+   */
+  void receivedFrameData(int source, const std::shared_ptr<Buffer> &buffer, int length);
+
+  /**
+   * A message of this channel is written to the connection
+   */
+  void sent(const std::shared_ptr<TxRequest> &request, bool fin);
+
+ private:
+  net::TCPCommunicator *communicator;
+  int edge = -1;
+  ChannelReceiveCallback *rcv_fn = nullptr;
+  ChannelSendCallback *send_comp_fn = nullptr;
+  Allocator *allocator = nullptr;
+  int64_t maxQueuedBytes;
+  // messages and bytes of each target not written to the connection yet
+  std::unordered_map<int, std::pair<size_t, int64_t>> queued;
+};
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_NET_TCP_TCP_CHANNEL_HPP_
@@ -0,0 +1,960 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tcp_communicator.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "tcp_channel.hpp"
+
+namespace cylon {
+namespace net {
+
+// edges of the barrier tokens and the collectives, the edges of the channels are never negative
+static constexpr int TCP_BARRIER_EDGE = -1;
+static constexpr int TCP_COLLECTIVE_EDGE = -2;
+// how long the ranks wait for each other while connecting
+static constexpr int TCP_CONNECT_TIMEOUT_SECONDS = 120;
+
+static int EnvInt(const char *name, int default_value) {
+  const char *value = std::getenv(name);
+  return value == nullptr ? default_value : std::atoi(value);
+}
+
+static std::string EnvString(const char *name) {
+  const char *value = std::getenv(name);
+  return value == nullptr ? "" : value;
+}
+
+/**
+ * @return the id of the job from the launcher, usable as a file name. Empty if there is none
+ */
+static std::string JobId() {
+  std::string id = EnvString("CYLON_JOB_ID");
+  if (id.empty() && !EnvString("SLURM_JOB_ID").empty()) {
+    id = EnvString("SLURM_JOB_ID") + "_" + EnvString("SLURM_STEP_ID");
+  }
+  for (const char *name : {"PMIX_NAMESPACE", "OMPI_MCA_ess_base_jobid"}) {
+    if (id.empty()) {
+      id = EnvString(name);
+    }
+  }
+  std::replace_if(id.begin(), id.end(), [](char c) {
+    return !std::isalnum(static_cast<unsigned char>(c)) && c != '-';
+  }, '_');
+  return id;
+}
+
+static std::pair<std::string, int> ParseAddress(const std::string &address) {
+  size_t colon = address.rfind(':');
+  if (colon == std::string::npos) {
+    LOG(FATAL) << "Address should be host:port " << address;
+  }
+  return {address.substr(0, colon), std::stoi(address.substr(colon + 1))};
+}
+
+static void WriteFully(int fd, const void *buf, size_t length) {
+  auto *p = static_cast<const uint8_t *>(buf);
+  while (length > 0) {
+    ssize_t n = send(fd, p, length, MSG_NOSIGNAL);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      LOG(FATAL) << "Failed to write to the connection: " << std::strerror(errno);
+    }
+    p += n;
+    length -= n;
+  }
+}
+
+static void ReadFully(int fd, void *buf, size_t length) {
+  auto *p = static_cast<uint8_t *>(buf);
+  while (length > 0) {
+    ssize_t n = recv(fd, p, length, 0);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      LOG(FATAL) << "Failed to read from the connection: "
+                 << (n == 0 ? "closed" : std::strerror(errno));
+    }
+    p += n;
+    length -= n;
+  }
+}
+
+/**
+ * Message of a collective, owned by the communicator
+ */
+class TCPCollectiveBuffer : public Buffer {
+ public:
+  explicit TCPCollectiveBuffer(int64_t length) : data_(length) {}
+
+  int64_t GetLength() override {
+    return data_.size();
+  }
+
+  uint8_t *GetByteBuffer() override {
+    return data_.data();
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+/**
+ * Connect to the address, retrying while the other rank is not listening yet
+ */
+static int ConnectTo(const std::string &host, int port) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  auto deadline = std::chrono::steady_clock::now()
+      + std::chrono::seconds(TCP_CONNECT_TIMEOUT_SECONDS);
+  while (true) {
+    addrinfo *result = nullptr;
+    int err = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result);
+    if (err != 0) {
+      LOG(FATAL) << "Failed to resolve " << host << ": " << gai_strerror(err);
+    }
+    for (addrinfo *a = result; a != nullptr; a = a->ai_next) {
+      int fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+      if (fd < 0) continue;
+      if (connect(fd, a->ai_addr, a->ai_addrlen) == 0) {
+        freeaddrinfo(result);
+        return fd;
+      }
+      close(fd);
+    }
+    freeaddrinfo(result);
+    if (std::chrono::steady_clock::now() > deadline) {
+      LOG(FATAL) << "Failed to connect to " << host << ":" << port;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+TCPConfig::TCPConfig(int rank, int world_size, std::string rendezvous, std::string host)
+    : rank_(rank), world_size_(world_size), rendezvous_(std::move(rendezvous)),
+      host_(std::move(host)) {}
+
+TCPConfig::TCPConfig(int rank, std::vector<std::string> addresses)
+    : rank_(rank), world_size_(static_cast<int>(addresses.size())),
+      addresses_(std::move(addresses)) {}
+
+CommType TCPConfig::Type() {
+  return CommType::TCP;
+}
+
+int TCPConfig::GetRank() const {
+  return rank_;
+}
+
+int TCPConfig::GetWorldSize() const {
+  return world_size_;
+}
+
+const std::string &TCPConfig::GetRendezvous() const {
+  return rendezvous_;
+}
+
+const std::string &TCPConfig::GetHost() const {
+  return host_;
+}
+
+const std::vector<std::string> &TCPConfig::GetAddresses() const {
+  return addresses_;
+}
+
+std::shared_ptr<TCPConfig> TCPConfig::Make(int rank, int world_size,
+                                           const std::string &rendezvous,
+                                           const std::string &host) {
+  return std::make_shared<TCPConfig>(rank, world_size, rendezvous, host);
+}
+
+std::shared_ptr<TCPConfig> TCPConfig::FromEnv() {
+  int rank = EnvInt("CYLON_RANK", EnvInt("OMPI_COMM_WORLD_RANK", EnvInt("PMI_RANK", 0)));
+  int world_size = EnvInt("CYLON_WORLD_SIZE",
+                          EnvInt("OMPI_COMM_WORLD_SIZE", EnvInt("PMI_SIZE", 1)));
+
+  std::string addresses = EnvString("CYLON_TCP_ADDRESSES");
+  if (!addresses.empty()) {
+    std::vector<std::string> list;
+    std::stringstream stream(addresses);
+    std::string address;
+    while (std::getline(stream, address, ',')) {
+      list.push_back(address);
+    }
+    return std::make_shared<TCPConfig>(rank, list);
+  }
+
+  std::string rendezvous = EnvString("CYLON_TCP_RENDEZVOUS");
+  if (rendezvous.empty()) {
+    // the ranks of the job meet in a directory of their own, this only works on a single host
+    std::string job = JobId();
+    if (job.empty()) {
+      LOG(FATAL) << "Set CYLON_TCP_RENDEZVOUS to a directory shared by the ranks, or "
+                 << "CYLON_TCP_ADDRESSES, the launcher did not set a job id";
+    }
+    rendezvous = "/tmp/cylon_" + job;
+    if (mkdir(rendezvous.c_str(), 0700) != 0 && errno != EEXIST) {
+      LOG(FATAL) << "Failed to create " << rendezvous << ": " << std::strerror(errno);
+    }
+    struct stat st{};
+    if (lstat(rendezvous.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != getuid()) {
+      LOG(FATAL) << rendezvous << " is not a directory of this user, set CYLON_TCP_RENDEZVOUS";
+    }
+  }
+  return Make(rank, world_size, rendezvous, EnvString("CYLON_TCP_HOST"));
+}
+
+TCPCommunicator::TCPCommunicator(std::shared_ptr<TCPCommunicator> world, int32_t comm_id,
+                                 std::vector<int> ranks, int rank)
+    : world_(std::move(world)), comm_id_(comm_id), ranks_(std::move(ranks)) {
+  this->rank = rank;
+  this->world_size = static_cast<int>(ranks_.size());
+  local_.assign(world_->world_size, -1);
+  for (int i = 0; i < this->world_size; i++) {
+    local_[ranks_[i]] = i;
+  }
+}
+
+void TCPCommunicator::Init(const std::shared_ptr<CommConfig> &config) {
+  auto tcp_config = std::static_pointer_cast<TCPConfig>(config);
+  this->rank = tcp_config->GetRank();
+  this->world_size = tcp_config->GetWorldSize();
+  if (this->world_size <= 0 || this->rank < 0 || this->rank >= this->world_size) {
+    LOG(FATAL) << "Invalid rank " << this->rank << " of " << this->world_size;
+  }
+
+  int port = 0;
+  std::vector<std::pair<std::string, int>> addresses(this->world_size);
+  const std::vector<std::string> &given = tcp_config->GetAddresses();
+  if (!given.empty()) {
+    for (int i = 0; i < this->world_size; i++) {
+      addresses[i] = ParseAddress(given[i]);
+    }
+    port = addresses[this->rank].second;
+  }
+
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(port);
+  if (bind(listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+      || listen(listen_fd, this->world_size) != 0) {
+    LOG(FATAL) << "Failed to listen on port " << port << ": " << std::strerror(errno);
+  }
+
+  if (given.empty()) {
+    socklen_t length = sizeof(address);
+    getsockname(listen_fd, reinterpret_cast<sockaddr *>(&address), &length);
+    port = ntohs(address.sin_port);
+
+    std::string host = tcp_config->GetHost();
+    if (host.empty()) {
+      char name[256] = {};
+      gethostname(name, sizeof(name) - 1);
+      host = name;
+    }
+
+    // publish the address with a rename, so that the others never read a partial file
+    const std::string &dir = tcp_config->GetRendezvous();
+    rendezvous_file_ = dir + "/" + std::to_string(this->rank);
+    // the ranks may start before anyone made the directory, e.g. after the tests cleared it
+    if (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) {
+      LOG(FATAL) << "Failed to create " << dir << ": " << std::strerror(errno);
+    }
+    // the files are removed once the ranks are connected, so this one is left by a failed run
+    // and the others could read its address before ours
+    if (access(rendezvous_file_.c_str(), F_OK) == 0) {
+      LOG(FATAL) << "Stale address file " << rendezvous_file_ << " of an earlier run, remove "
+                 << "the files in " << dir << " or use another rendezvous directory";
+    }
+    std::string tmp = rendezvous_file_ + ".tmp";
+    {
+      std::ofstream out(tmp);
+      out << host << " " << port << std::endl;
+    }
+    if (std::rename(tmp.c_str(), rendezvous_file_.c_str()) != 0) {
+      LOG(FATAL) << "Failed to publish the address to " << rendezvous_file_;
+    }
+
+    // only the lower ranks are connected to, so only their addresses are needed
+    auto deadline = std::chrono::steady_clock::now()
+        + std::chrono::seconds(TCP_CONNECT_TIMEOUT_SECONDS);
+    for (int i = 0; i < this->rank; i++) {
+      while (true) {
+        std::ifstream in(dir + "/" + std::to_string(i));
+        if (in >> addresses[i].first >> addresses[i].second) {
+          break;
+        }
+        if (std::chrono::steady_clock::now() > deadline) {
+          LOG(FATAL) << "Rank " << i << " did not publish its address in " << dir;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+  }
+
+  Connect(addresses, listen_fd);
+  close(listen_fd);
+
+  // every rank that needs the address is connected
+  if (!rendezvous_file_.empty()) {
+    std::remove(rendezvous_file_.c_str());
+    rendezvous_file_.clear();
+  }
+}
+
+void TCPCommunicator::Connect(const std::vector<std::pair<std::string, int>> &addresses,
+                              int listen_fd) {
+  peers_.resize(this->world_size);
+  ranks_.resize(this->world_size);
+  local_.resize(this->world_size);
+  for (int i = 0; i < this->world_size; i++) {
+    ranks_[i] = i;
+    local_[i] = i;
+  }
+
+  // each rank connects to the lower ranks and accepts the higher ranks, so every pair has one
+  // connection
+  for (int i = 0; i < this->rank; i++) {
+    int fd = ConnectTo(addresses[i].first, addresses[i].second);
+    int32_t me = this->rank;
+    WriteFully(fd, &me, sizeof(me));
+    peers_[i].fd = fd;
+  }
+  for (int i = this->rank + 1; i < this->world_size; i++) {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR) {
+        i--;
+        continue;
+      }
+      LOG(FATAL) << "Failed to accept a connection: " << std::strerror(errno);
+    }
+    int32_t other;
+    ReadFully(fd, &other, sizeof(other));
+    if (other <= this->rank || other >= this->world_size || peers_[other].fd >= 0) {
+      LOG(FATAL) << "Unexpected connection from rank " << other;
+    }
+    peers_[other].fd = fd;
+  }
+
+  epoll_fd_ = epoll_create1(0);
+  for (int i = 0; i < this->world_size; i++) {
+    if (i == this->rank) continue;
+    int fd = peers_[i].fd;
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u32 = static_cast<uint32_t>(i);
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+    peers_[i].interest = EPOLLIN;
+  }
+}
+
+Channel *TCPCommunicator::CreateChannel() {
+  return new TCPChannel(this);
+}
+
+int TCPCommunicator::GetRank() {
+  return this->rank;
+}
+
+int TCPCommunicator::GetWorldSize() {
+  return this->world_size;
+}
+
+CommType TCPCommunicator::GetCommType() {
+  return TCP;
+}
+
+TCPCommunicator *TCPCommunicator::World() {
+  return world_ == nullptr ? this : world_.get();
+}
+
+std::shared_ptr<Communicator> TCPCommunicator::Split(int color, int key) {
+  TCPCommunicator *world = World();
+  // a new id is above every id known to the workers of this communicator, so none of them has two
+  // communicators with the same id
+  int32_t next = world->next_comm_id_, base = 0;
+  int32_t mine[2] = {color, key};
+  std::vector<int32_t> all(2 * this->world_size);
+  auto status = AllReduce(&next, &base, 1, Int32(), ReduceOp::MAX);
+  if (status.is_ok()) {
+    status = Allgather(mine, 2, all.data(), Int32());
+  }
+  if (!status.is_ok()) {
+    LOG(FATAL) << "Failed to split the communicator: " << status.get_msg();
+  }
+
+  // every color gets an id in the order of the colors
+  std::vector<int32_t> colors;
+  std::vector<int> members;
+  for (int i = 0; i < this->world_size; i++) {
+    if (all[2 * i] >= 0) {
+      colors.push_back(all[2 * i]);
+    }
+    if (color >= 0 && all[2 * i] == color) {
+      members.push_back(i);
+    }
+  }
+  std::sort(colors.begin(), colors.end());
+  colors.erase(std::unique(colors.begin(), colors.end()), colors.end());
+  world->next_comm_id_ = base + static_cast<int32_t>(colors.size());
+  if (color < 0) {
+    return nullptr;
+  }
+
+  // the members are in the order of the rank, which breaks the ties of the keys
+  std::stable_sort(members.begin(), members.end(), [&all](int a, int b) {
+    return all[2 * a + 1] < all[2 * b + 1];
+  });
+  std::vector<int> ranks;
+  int group_rank = -1;
+  for (size_t i = 0; i < members.size(); i++) {
+    ranks.push_back(ranks_[members[i]]);
+    if (members[i] == this->rank) {
+      group_rank = static_cast<int>(i);
+    }
+  }
+  auto id = static_cast<int32_t>(std::lower_bound(colors.begin(), colors.end(), color)
+      - colors.begin());
+  return std::make_shared<TCPCommunicator>(world_ == nullptr ? shared_from_this() : world_,
+                                           base + id, ranks, group_rank);
+}
+
+void TCPCommunicator::Finalize() {
+  if (world_ != nullptr) {
+    // the connections are closed by the world
+    Barrier();
+    return;
+  }
+  if (epoll_fd_ < 0) {
+    return;
+  }
+  Barrier();
+  // the release of the barrier may still be queued
+  bool pending = true;
+  while (pending) {
+    pending = false;
+    for (int i = 0; i < this->world_size; i++) {
+      if (i != this->rank && !peers_[i].sends.empty() && !peers_[i].closed) {
+        Flush(i);
+        pending = pending || !peers_[i].sends.empty();
+      }
+    }
+    if (pending) {
+      Wait(100);
+    }
+  }
+  for (auto &peer : peers_) {
+    if (peer.fd >= 0) {
+      close(peer.fd);
+      peer.fd = -1;
+    }
+  }
+  close(epoll_fd_);
+  epoll_fd_ = -1;
+}
+
+void TCPCommunicator::Barrier() {
+  if (this->world_size == 1) {
+    return;
+  }
+  // the first rank collects a token from every other rank and then releases them
+  TCPCommunicator *world = World();
+  auto send_token = [this, world](int target) {
+    Outgoing outgoing{nullptr, nullptr, TCPFrame{}, false, nullptr, this->rank};
+    outgoing.frame.comm = comm_id_;
+    outgoing.frame.edge = TCP_BARRIER_EDGE;
+    world->peers_[ranks_[target]].sends.push_back(outgoing);
+  };
+  auto wait_tokens = [this, world](int64_t count) {
+    int64_t &tokens = world->barrier_tokens_[comm_id_];
+    Progress();
+    while (tokens < count) {
+      Wait(100);
+      Progress();
+    }
+    tokens -= count;
+  };
+
+  if (this->rank == 0) {
+    wait_tokens(this->world_size - 1);
+    for (int i = 1; i < this->world_size; i++) {
+      send_token(i);
+    }
+    Progress();
+  } else {
+    send_token(0);
+    wait_tokens(1);
+  }
+}
+
+void TCPCommunicator::Register(int edge, TCPChannel *channel) {
+  World()->channels_[std::make_pair(comm_id_, edge)] = Registration{channel, this};
+}
+
+void TCPCommunicator::Unregister(int edge) {
+  World()->channels_.erase(std::make_pair(comm_id_, edge));
+}
+
+void TCPCommunicator::Send(TCPChannel *channel, int edge,
+                           const std::shared_ptr<TxRequest> &request, bool fin) {
+  Outgoing outgoing{channel, request, TCPFrame{}, fin, nullptr, this->rank};
+  outgoing.frame.comm = comm_id_;
+  outgoing.frame.edge = edge;
+  outgoing.frame.fin = fin ? 1 : 0;
+  if (!fin) {
+    outgoing.frame.length = request->length;
+    outgoing.frame.headerLength = request->headerLength;
+    std::memcpy(outgoing.frame.header, request->header, sizeof(outgoing.frame.header));
+  }
+
+  // the messages are written in the next progress, so the callbacks never run inside a send
+  TCPCommunicator *world = World();
+  int target = ranks_[request->target];
+  if (target == world->rank) {
+    world->self_.push_back(outgoing);
+  } else {
+    world->peers_[target].sends.push_back(outgoing);
+  }
+}
+
+void TCPCommunicator::Progress() {
+  if (world_ != nullptr) {
+    world_->Progress();
+    return;
+  }
+  // the callbacks may queue more messages to this rank, they are delivered in the next progress
+  size_t local = self_.size();
+  for (size_t i = 0; i < local; i++) {
+    Outgoing outgoing = self_.front();
+    self_.pop_front();
+    std::shared_ptr<Buffer> buffer = outgoing.channel->receivedFrame(outgoing.source,
+                                                                     outgoing.frame);
+    if (!outgoing.fin) {
+      if (outgoing.frame.length > 0) {
+        std::memcpy(buffer->GetByteBuffer(), outgoing.request->buffer, outgoing.frame.length);
+      }
+      outgoing.channel->receivedFrameData(outgoing.source, buffer, outgoing.frame.length);
+    }
+    events_++;
+    Sent(outgoing);
+  }
+
+  for (int i = 0; i < this->world_size; i++) {
+    if (i == this->rank || peers_[i].closed) continue;
+    Flush(i);
+    Read(i);
+    UpdateInterest(i);
+  }
+}
+
+void TCPCommunicator::Wait(int timeout_ms) {
+  if (world_ != nullptr) {
+    world_->Wait(timeout_ms);
+    return;
+  }
+  if (!self_.empty()) {
+    return;
+  }
+  epoll_event events[64];
+  int n = epoll_wait(epoll_fd_, events, 64, timeout_ms);
+  if (n < 0 && errno != EINTR) {
+    LOG(FATAL) << "Failed to wait for the connections: " << std::strerror(errno);
+  }
+}
+
+uint64_t TCPCommunicator::Events() const {
+  if (world_ != nullptr) {
+    return world_->Events();
+  }
+  return events_;
+}
+
+void TCPCommunicator::Flush(int p) {
+  Peer &peer = peers_[p];
+  while (!peer.sends.empty()) {
+    Outgoing &front = peer.sends.front();
+    const int64_t frame_bytes = sizeof(TCPFrame);
+    const int64_t total = frame_bytes + front.frame.length;
+
+    // the frame and the data go out in one call, the data is not copied
+    iovec iov[2];
+    int count = 0;
+    if (peer.sent < frame_bytes) {
+      iov[count].iov_base = reinterpret_cast<uint8_t *>(&front.frame) + peer.sent;
+      iov[count].iov_len = frame_bytes - peer.sent;
+      count++;
+      if (front.frame.length > 0) {
+        iov[count].iov_base = front.request->buffer;
+        iov[count].iov_len = front.frame.length;
+        count++;
+      }
+    } else {
+      iov[count].iov_base = static_cast<uint8_t *>(front.request->buffer)
+          + (peer.sent - frame_bytes);
+      iov[count].iov_len = total - peer.sent;
+      count++;
+    }
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    ssize_t n = sendmsg(peer.fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      LOG(FATAL) << "Failed to send to rank " << p << ": " << std::strerror(errno);
+    }
+    peer.sent += n;
+    if (peer.sent < total) {
+      break;
+    }
+    Outgoing done = front;
+    peer.sends.pop_front();
+    peer.sent = 0;
+    events_++;
+    Sent(done);
+  }
+}
+
+void TCPCommunicator::Read(int p) {
+  Peer &peer = peers_[p];
+  const int64_t frame_bytes = sizeof(TCPFrame);
+  while (true) {
+    if (peer.frameRead < frame_bytes) {
+      ssize_t n = recv(peer.fd, reinterpret_cast<uint8_t *>(&peer.frame) + peer.frameRead,
+                       frame_bytes - peer.frameRead, MSG_DONTWAIT);
+      if (n == 0) {
+        if (peer.frameRead > 0) {
+          LOG(FATAL) << "Rank " << p << " closed the connection in the middle of a message";
+        }
+        peer.closed = true;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, peer.fd, nullptr);
+        return;
+      }
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+        LOG(FATAL) << "Failed to receive from rank " << p << ": " << std::strerror(errno);
+      }
+      peer.frameRead += n;
+      if (peer.frameRead < frame_bytes) {
+        return;
+      }
+    }
+
+    if (!peer.inData && !Dispatch(p)) {
+      // stop reading the connection until the channel of the message is created
+      return;
+    }
+    if (!peer.inData) {
+      continue;
+    }
+
+    const int64_t length = peer.frame.length;
+    while (peer.dataRead < length) {
+      ssize_t n = recv(peer.fd, peer.buffer->GetByteBuffer() + peer.dataRead,
+                       length - peer.dataRead, MSG_DONTWAIT);
+      if (n == 0) {
+        LOG(FATAL) << "Rank " << p << " closed the connection in the middle of a message";
+      }
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return;
+        LOG(FATAL) << "Failed to receive from rank " << p << ": " << std::strerror(errno);
+      }
+      peer.dataRead += n;
+    }
+
+    TCPChannel *channel = peer.channel;
+    std::shared_ptr<Buffer> buffer = std::move(peer.buffer);
+    const int32_t comm = peer.frame.comm;
+    peer.channel = nullptr;
+    peer.inData = false;
+    peer.frameRead = 0;
+    peer.dataRead = 0;
+    events_++;
+    if (channel == nullptr) {
+      collectives_[std::make_pair(comm, p)].push_back(buffer);
+    } else {
+      channel->receivedFrameData(peer.source, buffer, static_cast<int>(length));
+    }
+  }
+}
+
+bool TCPCommunicator::Dispatch(int p) {
+  Peer &peer = peers_[p];
+  if (peer.frame.edge == TCP_BARRIER_EDGE) {
+    barrier_tokens_[peer.frame.comm]++;
+    peer.frameRead = 0;
+    return true;
+  }
+  if (peer.frame.edge == TCP_COLLECTIVE_EDGE) {
+    peer.channel = nullptr;
+    peer.buffer = std::make_shared<TCPCollectiveBuffer>(peer.frame.length);
+    peer.dataRead = 0;
+    peer.inData = true;
+    return true;
+  }
+
+  auto it = channels_.find(std::make_pair(peer.frame.comm, peer.frame.edge));
+  if (it == channels_.end()) {
+    return false;
+  }
+  events_++;
+  const int source = it->second.owner->local_[p];
+  std::shared_ptr<Buffer> buffer = it->second.channel->receivedFrame(source, peer.frame);
+  if (peer.frame.fin) {
+    peer.frameRead = 0;
+  } else {
+    peer.channel = it->second.channel;
+    peer.source = source;
+    peer.buffer = std::move(buffer);
+    peer.dataRead = 0;
+    peer.inData = true;
+  }
+  return true;
+}
+
+void TCPCommunicator::Sent(const Outgoing &outgoing) {
+  if (outgoing.channel != nullptr) {
+    outgoing.channel->sent(outgoing.request, outgoing.fin);
+  }
+}
+
+void TCPCommunicator::UpdateInterest(int p) {
+  Peer &peer = peers_[p];
+  if (peer.closed) {
+    return;
+  }
+  // a connection waiting for its channel to be created is not read, so it is not polled either
+  bool parked = peer.frameRead == static_cast<int64_t>(sizeof(TCPFrame)) && !peer.inData;
+  uint32_t interest = (parked ? 0u : static_cast<uint32_t>(EPOLLIN))
+      | (peer.sends.empty() ? 0u : static_cast<uint32_t>(EPOLLOUT));
+  if (interest != peer.interest) {
+    epoll_event event{};
+    event.events = interest;
+    event.data.u32 = static_cast<uint32_t>(p);
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, peer.fd, &event);
+    peer.interest = interest;
+  }
+}
+void TCPCommunicator::SendBytes(int target, const void *data, int64_t length) {
+  if (length > INT_MAX) {
+    LOG(FATAL) << "Collective message is too large " << length;
+  }
+  TCPCommunicator *world = World();
+  const int peer = ranks_[target];
+  if (peer == world->rank) {
+    auto buffer = std::make_shared<TCPCollectiveBuffer>(length);
+    if (length > 0) {
+      std::memcpy(buffer->GetByteBuffer(), data, length);
+    }
+    world->collectives_[std::make_pair(comm_id_, peer)].push_back(buffer);
+    return;
+  }
+  // the data is copied, so that the collective returns before the data is written
+  auto owned = std::make_shared<std::vector<uint8_t>>(static_cast<const uint8_t *>(data),
+                                                      static_cast<const uint8_t *>(data) + length);
+  auto request = std::make_shared<TxRequest>(target, owned->data(), static_cast<int>(length));
+  Outgoing outgoing{nullptr, request, TCPFrame{}, false, owned, this->rank};
+  outgoing.frame.comm = comm_id_;
+  outgoing.frame.edge = TCP_COLLECTIVE_EDGE;
+  outgoing.frame.length = static_cast<int32_t>(length);
+  world->peers_[peer].sends.push_back(outgoing);
+}
+
+std::shared_ptr<Buffer> TCPCommunicator::ReceiveBytes(int source) {
+  auto &received = World()->collectives_[std::make_pair(comm_id_, ranks_[source])];
+  Progress();
+  while (received.empty()) {
+    Wait(100);
+    Progress();
+  }
+  std::shared_ptr<Buffer> buffer = received.front();
+  received.pop_front();
+  return buffer;
+}
+
+Status TCPCommunicator::ReceiveInto(int source, void *data, int64_t length) {
+  std::shared_ptr<Buffer> buffer = ReceiveBytes(source);
+  if (buffer->GetLength() != length) {
+    return Status(Code::ExecutionError, "Expected " + std::to_string(length) + " bytes from rank "
+        + std::to_string(source) + " but received " + std::to_string(buffer->GetLength()));
+  }
+  if (length > 0) {
+    std::memcpy(data, buffer->GetByteBuffer(), length);
+  }
+  return Status::OK();
+}
+
+Status TCPCommunicator::AllReduce(const void *send_buf, void *rcv_buf, int count,
+                                  const std::shared_ptr<DataType> &data_type,
+                                  ReduceOp reduce_op) {
+  int64_t element = ElementBytes(data_type);
+  if (element < 0) {
+    return Status(Code::NotImplemented, "Unknown data type for the reduction");
+  }
+  // reduce at the first rank in the order of the ranks, so that every run gives the same result
+  const int64_t bytes = element * count;
+  std::vector<uint8_t> gathered(this->rank == 0 ? bytes * this->world_size : 0);
+  auto status = Gather(send_buf, count, gathered.data(), data_type, 0);
+  if (!status.is_ok()) {
+    return status;
+  }
+  if (this->rank == 0 && bytes > 0) {
+    std::memcpy(rcv_buf, gathered.data(), bytes);
+    for (int i = 1; i < this->world_size; i++) {
+      status = Reduce(gathered.data() + i * bytes, rcv_buf, count, data_type, reduce_op);
+      if (!status.is_ok()) {
+        return status;
+      }
+    }
+  }
+  return Bcast(rcv_buf, count, data_type, 0);
+}
+
+Status TCPCommunicator::Allgather(const void *send_buf, int count, void *rcv_buf,
+                                  const std::shared_ptr<DataType> &data_type) {
+  auto status = Gather(send_buf, count, rcv_buf, data_type, 0);
+  if (!status.is_ok()) {
+    return status;
+  }
+  return Bcast(rcv_buf, count * this->world_size, data_type, 0);
+}
+
+Status TCPCommunicator::Allgatherv(const void *send_buf, int count, void *rcv_buf,
+                                   const int *rcv_counts, const int *displacements,
+                                   const std::shared_ptr<DataType> &data_type) {
+  auto status = Gatherv(send_buf, count, rcv_buf, rcv_counts, displacements, data_type, 0);
+  if (!status.is_ok()) {
+    return status;
+  }
+  int extent = 0;
+  for (int i = 0; i < this->world_size; i++) {
+    extent = std::max(extent, displacements[i] + rcv_counts[i]);
+  }
+  return Bcast(rcv_buf, extent, data_type, 0);
+}
+
+Status TCPCommunicator::Gather(const void *send_buf, int count, void *rcv_buf,
+                               const std::shared_ptr<DataType> &data_type, int root) {
+  std::vector<int> counts(this->world_size, count);
+  std::vector<int> displacements(this->world_size, 0);
+  for (int i = 0; i < this->world_size; i++) {
+    displacements[i] = i * count;
+  }
+  return Gatherv(send_buf, count, rcv_buf, counts.data(), displacements.data(), data_type, root);
+}
+
+Status TCPCommunicator::Gatherv(const void *send_buf, int count, void *rcv_buf,
+                                const int *rcv_counts, const int *displacements,
+                                const std::shared_ptr<DataType> &data_type, int root) {
+  int64_t element = ElementBytes(data_type);
+  if (element < 0) {
+    return Status(Code::NotImplemented, "Unknown data type for the collective");
+  }
+  if (this->rank != root) {
+    SendBytes(root, send_buf, element * count);
+    Progress();
+    return Status::OK();
+  }
+  auto *rcv = static_cast<uint8_t *>(rcv_buf);
+  for (int i = 0; i < this->world_size; i++) {
+    if (i == root) {
+      if (rcv_counts[i] != count) {
+        return Status(Code::Invalid, "Receive count of the root does not match its count");
+      }
+      if (count > 0) {
+        std::memcpy(rcv + element * displacements[i], send_buf, element * count);
+      }
+      continue;
+    }
+    auto status = ReceiveInto(i, rcv + element * displacements[i], element * rcv_counts[i]);
+    if (!status.is_ok()) {
+      return status;
+    }
+  }
+  return Status::OK();
+}
+
+Status TCPCommunicator::Bcast(void *buf, int count, const std::shared_ptr<DataType> &data_type,
+                              int root) {
+  int64_t element = ElementBytes(data_type);
+  if (element < 0) {
+    return Status(Code::NotImplemented, "Unknown data type for the collective");
+  }
+  if (this->rank != root) {
+    return ReceiveInto(root, buf, element * count);
+  }
+  for (int i = 0; i < this->world_size; i++) {
+    if (i != root) {
+      SendBytes(i, buf, element * count);
+    }
+  }
+  Progress();
+  return Status::OK();
+}
+
+Status TCPCommunicator::Alltoallv(const void *send_buf, const int *send_counts,
+                                  const int *send_displacements, void *rcv_buf,
+                                  const int *rcv_counts, const int *rcv_displacements,
+                                  const std::shared_ptr<DataType> &data_type) {
+  int64_t element = ElementBytes(data_type);
+  if (element < 0) {
+    return Status(Code::NotImplemented, "Unknown data type for the collective");
+  }
+  auto *send = static_cast<const uint8_t *>(send_buf);
+  auto *rcv = static_cast<uint8_t *>(rcv_buf);
+  for (int i = 0; i < this->world_size; i++) {
+    SendBytes(i, send + element * send_displacements[i], element * send_counts[i]);
+  }
+  for (int i = 0; i < this->world_size; i++) {
+    auto status = ReceiveInto(i, rcv + element * rcv_displacements[i], element * rcv_counts[i]);
+    if (!status.is_ok()) {
+      return status;
+    }
+  }
+  return Status::OK();
+}
+}  // namespace net
+}  // namespace cylon
@@ -0,0 +1,282 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_NET_TCP_TCP_COMMUNICATOR_HPP_
+#define CYLON_CPP_SRC_CYLON_NET_TCP_TCP_COMMUNICATOR_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../comm_config.hpp"
+#include "../communicator.hpp"
+#include "../TxRequest.hpp"
+#include "../buffer.hpp"
+
+namespace cylon {
+
+class TCPChannel;
+
+namespace net {
+
+class TCPConfig : public CommConfig {
+ public:
+  /**
+   * @param rank
+   * @param world_size
+   * @param rendezvous a directory shared by the ranks. Every rank publishes its address in a file
+   * named by its rank and removes it once connected. Init fails if the file of the rank is left
+   * by an earlier run
+   * @param host host name or address the other ranks connect to, the host name if empty
+   */
+  TCPConfig(int rank, int world_size, std::string rendezvous, std::string host);
+
+  /**
+   * @param rank
+   * @param addresses host:port of every rank, no rendezvous is needed
+   */
+  TCPConfig(int rank, std::vector<std::string> addresses);
+
+  CommType Type() override;
+
+  int GetRank() const;
+
+  int GetWorldSize() const;
+
+  const std::string &GetRendezvous() const;
+
+  const std::string &GetHost() const;
+
+  const std::vector<std::string> &GetAddresses() const;
+
+  static std::shared_ptr<TCPConfig> Make(int rank, int world_size, const std::string &rendezvous,
+                                         const std::string &host = "");
+
+  /**
+   * Create the config from the environment. The rank and the world size are read from CYLON_RANK
+   * and CYLON_WORLD_SIZE, or the variables set by mpirun (OMPI_COMM_WORLD_RANK/SIZE, PMI_RANK/SIZE)
+   * so that a launcher can start the ranks without initializing MPI. The addresses are read from
+   * CYLON_TCP_ADDRESSES (host:port,host:port,...), otherwise the ranks meet at the directory
+   * CYLON_TCP_RENDEZVOUS, publishing CYLON_TCP_HOST or their host name. Without
+   * CYLON_TCP_RENDEZVOUS, ranks on a single host meet at /tmp/cylon_<job id>, the job id taken
+   * from CYLON_JOB_ID, SLURM_JOB_ID/SLURM_STEP_ID or the variables of mpirun. It is an error if
+   * there is no job id
+   */
+  static std::shared_ptr<TCPConfig> FromEnv();
+
+ private:
+  int rank_;
+  int world_size_;
+  std::string rendezvous_;
+  std::string host_;
+  std::vector<std::string> addresses_;
+};
+
+/**
+ * Every message on a connection starts with this frame. The communicator and the edge identify
+ * the channel of the message, so the channels of all the operations and all the groups share the
+ * connections
+ */
+struct TCPFrame {
+  // 0 for the world, otherwise the id of a group given by Split
+  int32_t comm;
+  int32_t edge;
+  int32_t length;
+  int32_t fin;
+  int32_t headerLength;
+  int32_t header[6];
+};
+
+/**
+ * Communicator over a full mesh of non blocking TCP connections, without MPI. The connections
+ * are polled with epoll by the channels. The groups created by Split send over the connections
+ * of the world communicator, which should be finalized after them
+ */
+class TCPCommunicator : public Communicator,
+                        public std::enable_shared_from_this<TCPCommunicator> {
+ public:
+  TCPCommunicator() = default;
+
+  /**
+   * Communicator of a group, see Split
+   * @param world the communicator that owns the connections
+   * @param comm_id id of the group in the frames, the same at all its workers
+   * @param ranks rank in the world of every worker of the group
+   * @param rank rank of this worker in the group
+   */
+  TCPCommunicator(std::shared_ptr<TCPCommunicator> world, int32_t comm_id,
+                  std::vector<int> ranks, int rank);
+
+  void Init(const std::shared_ptr<CommConfig> &config) override;
+  Channel *CreateChannel() override;
+  int GetRank() override;
+  int GetWorldSize() override;
+  void Finalize() override;
+  void Barrier() override;
+  CommType GetCommType() override;
+  std::shared_ptr<Communicator> Split(int color, int key) override;
+
+  /**
+   * The collectives are sent over the connections as messages of a reserved edge, gathered and
+   * reduced at the root and then sent to the others
+   */
+  Status AllReduce(const void *send_buf, void *rcv_buf, int count,
+                   const std::shared_ptr<DataType> &data_type, ReduceOp reduce_op) override;
+  Status Allgather(const void *send_buf, int count, void *rcv_buf,
+                   const std::shared_ptr<DataType> &data_type) override;
+  Status Allgatherv(const void *send_buf, int count, void *rcv_buf, const int *rcv_counts,
+                    const int *displacements,
+                    const std::shared_ptr<DataType> &data_type) override;
+  Status Gather(const void *send_buf, int count, void *rcv_buf,
+                const std::shared_ptr<DataType> &data_type, int root) override;
+  Status Gatherv(const void *send_buf, int count, void *rcv_buf, const int *rcv_counts,
+                 const int *displacements, const std::shared_ptr<DataType> &data_type,
+                 int root) override;
+  Status Bcast(void *buf, int count, const std::shared_ptr<DataType> &data_type,
+               int root) override;
+  Status Alltoallv(const void *send_buf, const int *send_counts, const int *send_displacements,
+                   void *rcv_buf, const int *rcv_counts, const int *rcv_displacements,
+                   const std::shared_ptr<DataType> &data_type) override;
+
+  /**
+   * Deliver the messages of the edge to the channel
+   */
+  void Register(int edge, TCPChannel *channel);
+
+  void Unregister(int edge);
+
+  /**
+   * Queue a message of a channel, the channel is notified once the message is sent
+   * @param fin send the finish of the channel instead of the request data
+   */
+  void Send(TCPChannel *channel, int edge, const std::shared_ptr<TxRequest> &request, bool fin);
+
+  /**
+   * Write and read as much as the connections allow without blocking
+   */
+  void Progress();
+
+  /**
+   * Wait for a connection to be readable, or writable if it has messages to send
+   * @param timeout_ms
+   */
+  void Wait(int timeout_ms);
+
+  /**
+   * @return number of frames and data chunks sent or received so far
+   */
+  uint64_t Events() const;
+
+ private:
+  struct Outgoing {
+    TCPChannel *channel;
+    std::shared_ptr<TxRequest> request;
+    TCPFrame frame;
+    bool fin;
+    // data of a collective, kept until it is written
+    std::shared_ptr<std::vector<uint8_t>> owned;
+    // rank of the sender in the communicator of the message, for the messages to this worker
+    int source;
+  };
+
+  struct Peer {
+    int fd = -1;
+    std::deque<Outgoing> sends;
+    // bytes of the front message (frame and data) written
+    int64_t sent = 0;
+    // events the connection is polled for
+    uint32_t interest = 0;
+    // the message being read, its frame first and then its data
+    TCPFrame frame{};
+    int64_t frameRead = 0;
+    // the frame is dispatched and its data is being read, to the channel or to the collectives
+    bool inData = false;
+    TCPChannel *channel = nullptr;
+    // rank of the peer in the communicator of the channel
+    int source = -1;
+    std::shared_ptr<Buffer> buffer;
+    int64_t dataRead = 0;
+    bool closed = false;
+  };
+
+  struct Registration {
+    TCPChannel *channel;
+    // the world or the group the channel belongs to, translates the ranks of the messages
+    TCPCommunicator *owner;
+  };
+
+  /**
+   * @return the communicator that owns the connections, this one unless it is a group
+   */
+  TCPCommunicator *World();
+
+  void Connect(const std::vector<std::pair<std::string, int>> &addresses, int listen_fd);
+
+  void Flush(int peer);
+
+  void Read(int peer);
+
+  /**
+   * Hand a complete frame to its channel
+   * @return false if the channel of the edge is not created yet
+   */
+  bool Dispatch(int peer);
+
+  void Sent(const Outgoing &outgoing);
+
+  void UpdateInterest(int peer);
+
+  /**
+   * Send a message of a collective, the messages from a rank are received in the order they
+   * are sent
+   */
+  void SendBytes(int target, const void *data, int64_t length);
+
+  /**
+   * Wait for the next message of a collective from the source
+   */
+  std::shared_ptr<Buffer> ReceiveBytes(int source);
+
+  Status ReceiveInto(int source, void *data, int64_t length);
+
+  // the state of the connections is only used in the world communicator
+  std::vector<Peer> peers_;
+  // messages to this rank, delivered without a connection
+  std::deque<Outgoing> self_;
+  // received messages of the collectives by the communicator and the world rank of the sender
+  std::map<std::pair<int32_t, int>, std::deque<std::shared_ptr<Buffer>>> collectives_;
+  std::map<std::pair<int32_t, int32_t>, Registration> channels_;
+  int epoll_fd_ = -1;
+  uint64_t events_ = 0;
+  std::unordered_map<int32_t, int64_t> barrier_tokens_;
+  std::string rendezvous_file_;
+  // the ids of the groups are above every id in use at their workers
+  int32_t next_comm_id_ = 1;
+
+  // the world of a group, nullptr for the world itself
+  std::shared_ptr<TCPCommunicator> world_;
+  int32_t comm_id_ = 0;
+  // world rank of each rank of this communicator and the other way around, -1 if not a member
+  std::vector<int> ranks_;
+  std::vector<int> local_;
+};
+}  // namespace net
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_NET_TCP_TCP_COMMUNICATOR_HPP_
@@ -18,7 +18,11 @@
 #include <memory>
 #include <unordered_map>
 #include <arrow/compute/api.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <future>
+#include <random>
 
 #include "table_api_extended.hpp"
 #include "io/arrow_io.hpp"
@@ -32,44 +36,33 @@
 #include "arrow/arrow_comparator.hpp"
 #include "ctx/arrow_memory_pool_utils.hpp"
 #include "arrow/arrow_types.hpp"
+#include "net/comm_operations.hpp"
+#include "util/bloom_filter.hpp"
+#include "util/flat_hash_multimap.hpp"
+#include "util/row_hash_set.hpp"
 
 namespace cylon {
 
-class RowComparator {
- private:
-  const std::shared_ptr<arrow::Table> *tables;
-  std::shared_ptr<cylon::TableRowComparator> comparator;
-  std::shared_ptr<cylon::RowHashingKernel> row_hashing_kernel;
-  int64_t *eq, *hs;
-
- public:
-  RowComparator(std::shared_ptr<cylon::CylonContext> &ctx,
-                const std::shared_ptr<arrow::Table> *tables,
-                int64_t *eq,
-                int64_t *hs) {
-    this->tables = tables;
-    this->comparator = std::make_shared<cylon::TableRowComparator>(tables[0]->fields());
-    this->row_hashing_kernel = std::make_shared<cylon::RowHashingKernel>(tables[0]->fields(),
-                                                                         cylon::ToArrowPool(ctx));
-    this->eq = eq;
-    this->hs = hs;
-  }
-
-  // equality
-  bool operator()(const std::pair<int8_t, int64_t> &record1,
-				  const std::pair<int8_t, int64_t> &record2) const {
-	(*this->eq)++;
-	return this->comparator->compare(this->tables[record1.first], record1.second,
-									 this->tables[record2.first], record2.second) == 0;
-  }
-
-  // hashing
-  size_t operator()(const std::pair<int8_t, int64_t> &record) const {
-	(*this->hs)++;
-	size_t hash = this->row_hashing_kernel->Hash(this->tables[record.first], record.second);
-	return hash;
+/**
+ * Combine the chunks of a table that has more than one chunk in a column, like the output of a
+ * shuffle that keeps the received tables as chunks. The kernels work on the first chunk
+ * @param ctx
+ * @param table
+ * @param table_out the combined table, or the table itself if it doesn't have to be combined
+ * @return
+ */
+static Status CombineTableChunks(std::shared_ptr<cylon::CylonContext> &ctx,
+								 const std::shared_ptr<arrow::Table> &table,
+								 std::shared_ptr<arrow::Table> *table_out) {
+  for (const auto &column : table->columns()) {
+	if (column->num_chunks() > 1) {
+	  auto status = table->CombineChunks(cylon::ToArrowPool(ctx), table_out);
+	  return Status(static_cast<int>(status.code()), status.message());
+	}
   }
-};
+  *table_out = table;
+  return Status::OK();
+}
 
 /**
  * creates an Arrow array based on col_idx, filtered by row_indices
@@ -98,121 +91,63 @@ Status PrepareArray(std::shared_ptr<cylon::CylonContext> &ctx,
   return Status::OK();
 }
 
-Status HashPartitionTable(std::shared_ptr<cylon::CylonContext> &ctx, const std::shared_ptr<arrow::Table> &table,
-						  int hash_column, int no_of_partitions,
-						  std::unordered_map<int, std::shared_ptr<cylon::Table>> *out) {
-  // keep arrays for each target, these arrays are used for creating the table
-  std::unordered_map<int, std::shared_ptr<std::vector<std::shared_ptr<arrow::Array>>>> data_arrays;
-  std::vector<int> partitions;
-  for (int t = 0; t < no_of_partitions; t++) {
-	partitions.push_back(t);
-	data_arrays.insert(
-		std::pair<int, std::shared_ptr<std::vector<std::shared_ptr<arrow::Array>>>>(
-			t, std::make_shared<std::vector<std::shared_ptr<arrow::Array>>>()));
-  }
-  std::shared_ptr<arrow::Array> arr = table->column(hash_column)->chunk(0);
-  int64_t length = arr->length();
-
-  auto t1 = std::chrono::high_resolution_clock::now();
-  // first we partition the table
-  std::vector<int64_t> outPartitions;
-  outPartitions.reserve(length);
-  std::vector<uint32_t> counts(no_of_partitions, 0);
-  Status status = HashPartitionArray(cylon::ToArrowPool(ctx), arr,
-									 partitions, &outPartitions, counts);
-  if (!status.is_ok()) {
-	LOG(FATAL) << "Failed to create the hash partition";
-	return status;
-  }
-  auto t2 = std::chrono::high_resolution_clock::now();
-  LOG(INFO) << "Calculating hash time : "
-			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
-
-  for (int i = 0; i < table->num_columns(); i++) {
-	std::shared_ptr<arrow::DataType> type = table->column(i)->chunk(0)->type();
-	std::shared_ptr<arrow::Array> array = table->column(i)->chunk(0);
-
-	std::shared_ptr<ArrowArraySplitKernel> splitKernel;
-	status = CreateSplitter(type, cylon::ToArrowPool(ctx), &splitKernel);
-	if (!status.is_ok()) {
-	  LOG(FATAL) << "Failed to create the splitter";
-	  return status;
-	}
-	// this one outputs arrays for each target as a map
-	std::unordered_map<int, std::shared_ptr<arrow::Array>> splited_arrays;
-	splitKernel->Split(array, outPartitions, partitions, splited_arrays, counts);
-	for (const auto &x : splited_arrays) {
-	  std::shared_ptr<std::vector<std::shared_ptr<arrow::Array>>> cols = data_arrays[x.first];
-	  cols->push_back(x.second);
-	}
+/**
+ * Insert a table to the all to all. While the all to all rejects the table, because the tables
+ * queued for the target are above its limit, the all to all is progressed to send them
+ * @param ctx
+ * @param all_to_all
+ * @param table
+ * @param target
+ * @return CapacityError if the arrays of the table are too large to send
+ */
+static Status InsertTable(std::shared_ptr<cylon::CylonContext> &ctx,
+						  cylon::ArrowAllToAll &all_to_all,
+						  const std::shared_ptr<arrow::Table> &table,
+						  int target) {
+  int accepted = all_to_all.insert(table, target);
+  if (accepted < 0) {
+	auto insert = [&all_to_all, &table, target, &accepted]() {
+	  accepted = all_to_all.insert(table, target);
+	  return accepted >= 0;
+	};
+	ctx->GetProgressEngine()->ProgressUntil(all_to_all, insert);
   }
-  auto t3 = std::chrono::high_resolution_clock::now();
-  LOG(INFO) << "Building hashed tables time : "
-			<< std::chrono::duration_cast<std::chrono::milliseconds>(t3 - t2).count();
-  // now insert these array to
-  for (const auto &x : data_arrays) {
-	std::shared_ptr<arrow::Table> t = arrow::Table::Make(table->schema(), *x.second);
-	std::shared_ptr<cylon::Table> kY = std::make_shared<cylon::Table>(t, ctx);
-	out->insert(std::pair<int, std::shared_ptr<cylon::Table>>(x.first, kY));
+  if (accepted == 0) {
+	return Status(Code::CapacityError, "The arrays of the table are too large to send");
   }
   return Status::OK();
 }
 
-cylon::Status Shuffle(std::shared_ptr<cylon::CylonContext> &ctx,
-					  std::shared_ptr<cylon::Table> &table,
-					  int hash_column,
-					  int edge_id,
-					  std::shared_ptr<arrow::Table> *table_out) {
-  std::unordered_map<int, std::shared_ptr<cylon::Table>> partitioned_tables{};
-  // partition the tables locally
-  HashPartitionTable(ctx, table->get_table(), hash_column, ctx->GetWorldSize(),
-					 &partitioned_tables);
-  std::shared_ptr<arrow::Schema> schema = table->get_table()->schema();
-  // we are going to free if retain is set to false
-  if (!table->IsRetain()) {
-	table.reset();
-  }
-  auto neighbours = ctx->GetNeighbours(true);
-  std::vector<std::shared_ptr<arrow::Table>> received_tables;
-  // define call back to catch the receiving tables
-  class AllToAllListener : public cylon::ArrowCallback {
-	std::vector<std::shared_ptr<arrow::Table>> *tabs;
-	int workerId;
-
-   public:
-	explicit AllToAllListener(std::vector<std::shared_ptr<arrow::Table>> *tabs, int workerId) {
-	  this->tabs = tabs;
-	  this->workerId = workerId;
-	}
-
-	bool onReceive(int source, const std::shared_ptr<arrow::Table> &table, int reference) override {
-	  this->tabs->push_back(table);
-	  return true;
-	};
-  };
-
-  // doing all to all communication to exchange tables
-  cylon::ArrowAllToAll all_to_all(ctx, neighbours, neighbours, edge_id,
-								  std::make_shared<AllToAllListener>(&received_tables,
-																	 ctx->GetRank()), schema);
+/**
+ * Collects the tables received by an all to all
+ */
+class ReceivedTablesCollector : public cylon::ArrowCallback {
+ public:
+  explicit ReceivedTablesCollector(std::vector<std::shared_ptr<arrow::Table>> *tables)
+	  : tables_(tables) {}
 
-  for (auto &partitioned_table : partitioned_tables) {
-	if (partitioned_table.first != ctx->GetRank()) {
-	  all_to_all.insert(partitioned_table.second->get_table(), partitioned_table.first);
-	} else {
-	  received_tables.push_back(partitioned_table.second->get_table());
-	}
+  bool onReceive(int source, const std::shared_ptr<arrow::Table> &table, int reference) override {
+	tables_->push_back(table);
+	return true;
   }
 
-  // now complete the communication
-  all_to_all.finish();
-  while (!all_to_all.isComplete()) {}
-  all_to_all.close();
-
-  // now clear locally partitioned tables
-  partitioned_tables.clear();
+ private:
+  std::vector<std::shared_ptr<arrow::Table>> *tables_;
+};
 
-  // now we have the final set of tables
+/**
+ * Concatenate the received tables in to a single table
+ * @param ctx
+ * @param received_tables
+ * @param combine_chunks combine the chunks in to a single chunk, otherwise the table keeps the
+ * chunks of the received tables without copying them
+ * @param table_out
+ * @return
+ */
+cylon::Status CombineReceivedTables(std::shared_ptr<cylon::CylonContext> &ctx,
+									const std::vector<std::shared_ptr<arrow::Table>> &received_tables,
+									bool combine_chunks,
+									std::shared_ptr<arrow::Table> *table_out) {
   LOG(INFO) << "Concatenating tables, Num of tables :  " << received_tables.size();
   arrow::Result<std::shared_ptr<arrow::Table>> concat_tables =
 	  arrow::ConcatenateTables(received_tables);
@@ -220,6 +155,10 @@ cylon::Status Shuffle(std::shared_ptr<cylon::CylonContext> &ctx,
   if (concat_tables.ok()) {
 	auto final_table = concat_tables.ValueOrDie();
 	LOG(INFO) << "Done concatenating tables, rows :  " << final_table->num_rows();
+	if (!combine_chunks) {
+	  *table_out = final_table;
+	  return Status::OK();
+	}
 	auto status = final_table->CombineChunks(cylon::ToArrowPool(ctx), table_out);
 	return Status(static_cast<int>(status.code()), status.message());
   } else {
@@ -228,98 +167,260 @@ cylon::Status Shuffle(std::shared_ptr<cylon::CylonContext> &ctx,
   }
 }
 
-cylon::Status Shuffle(std::shared_ptr<cylon::CylonContext> &ctx,
-					  std::shared_ptr<cylon::Table> &table,
-					  const std::vector<int> &hash_columns,
-					  int edge_id,
-					  std::shared_ptr<arrow::Table> *table_out) {
-  std::unordered_map<int, std::shared_ptr<cylon::Table>> partitioned_tables{};
-  // partition the tables locally
-  table->HashPartition(hash_columns, ctx->GetWorldSize(), &partitioned_tables);
-  std::shared_ptr<arrow::Schema> schema = table->get_table()->schema();
-  // we are going to free if retain is set to false
-  if (!table->IsRetain()) {
-	table.reset();
-  }
+/**
+ * Exchange partitioned tables with all the workers
+ * @param ctx
+ * @param partitioned_tables target worker and the table sent to it, a worker can have several
+ * tables. This is cleared once the tables are sent
+ * @param schema
+ * @param edge_id
+ * @param combine_chunks combine the received tables in to a single chunk
+ * @param table_out tables received from all the workers
+ * @return
+ */
+cylon::Status AllToAllTables(std::shared_ptr<cylon::CylonContext> &ctx,
+							 std::vector<std::pair<int,
+												   std::shared_ptr<arrow::Table>>> &partitioned_tables,
+							 const std::shared_ptr<arrow::Schema> &schema,
+							 int edge_id,
+							 bool combine_chunks,
+							 std::shared_ptr<arrow::Table> *table_out) {
   auto neighbours = ctx->GetNeighbours(true);
   std::vector<std::shared_ptr<arrow::Table>> received_tables;
-  // define call back to catch the receiving tables
-  class AllToAllListener : public cylon::ArrowCallback {
-	std::vector<std::shared_ptr<arrow::Table>> *tabs;
-	int workerId;
-
-   public:
-	explicit AllToAllListener(std::vector<std::shared_ptr<arrow::Table>> *tabs, int workerId) {
-	  this->tabs = tabs;
-	  this->workerId = workerId;
-	}
-
-	bool onReceive(int source, const std::shared_ptr<arrow::Table> &table, int reference) override {
-	  this->tabs->push_back(table);
-	  return true;
-	};
-  };
 
   // doing all to all communication to exchange tables
   cylon::ArrowAllToAll all_to_all(ctx, neighbours, neighbours, edge_id,
-								  std::make_shared<AllToAllListener>(&received_tables,
-																	 ctx->GetRank()), schema);
+								  std::make_shared<ReceivedTablesCollector>(&received_tables),
+								  schema);
 
   for (auto &partitioned_table : partitioned_tables) {
 	if (partitioned_table.first != ctx->GetRank()) {
-	  all_to_all.insert(partitioned_table.second->get_table(), partitioned_table.first);
+	  auto status = InsertTable(ctx, all_to_all, partitioned_table.second,
+								partitioned_table.first);
+	  if (!status.is_ok()) {
+		return status;
+	  }
 	} else {
-	  received_tables.push_back(partitioned_table.second->get_table());
+	  received_tables.push_back(partitioned_table.second);
 	}
   }
 
   // now complete the communication
   all_to_all.finish();
-  while (!all_to_all.isComplete()) {}
+  ctx->GetProgressEngine()->Progress(all_to_all);
   all_to_all.close();
 
   // now clear locally partitioned tables
   partitioned_tables.clear();
 
   // now we have the final set of tables
-  LOG(INFO) << "Concatenating tables, Num of tables :  " << received_tables.size();
-  arrow::Result<std::shared_ptr<arrow::Table>> concat_tables =
-	  arrow::ConcatenateTables(received_tables);
+  return CombineReceivedTables(ctx, received_tables, combine_chunks, table_out);
+}
 
-  if (concat_tables.ok()) {
-	auto final_table = concat_tables.ValueOrDie();
-	LOG(INFO) << "Done concatenating tables, rows :  " << final_table->num_rows();
-	auto status = final_table->CombineChunks(cylon::ToArrowPool(ctx), table_out);
-	return Status(static_cast<int>(status.code()), status.message());
-  } else {
-	return Status(static_cast<int>(concat_tables.status().code()),
-				  concat_tables.status().message());
+/**
+ * Shuffle a table slice by slice. Every slice is hash partitioned and its partitions are handed
+ * to the all to all right away, so that partitioning the next slice overlaps with sending the
+ * previous ones. The partitions of a slice are handed over only when the bytes in flight are
+ * below max_in_flight.
+ * @param ctx
+ * @param table single chunk table
+ * @param hash_columns
+ * @param edge_id
+ * @param slice_rows rows of a slice
+ * @param max_in_flight bytes of the partitions that can be waiting to be sent
+ * @param combine_chunks combine the received tables in to a single chunk
+ * @param table_out tables received from all the workers
+ * @return
+ */
+cylon::Status StreamingShuffle(std::shared_ptr<cylon::CylonContext> &ctx,
+							   const std::shared_ptr<cylon::Table> &table,
+							   const std::vector<int> &hash_columns,
+							   int edge_id,
+							   int64_t slice_rows,
+							   int64_t max_in_flight,
+							   bool combine_chunks,
+							   std::shared_ptr<arrow::Table> *table_out) {
+  auto neighbours = ctx->GetNeighbours(true);
+  std::shared_ptr<arrow::Table> arrow_table = table->get_table();
+  std::vector<std::shared_ptr<arrow::Table>> received_tables;
+  cylon::ArrowAllToAll all_to_all(ctx, neighbours, neighbours, edge_id,
+								  std::make_shared<ReceivedTablesCollector>(&received_tables),
+								  arrow_table->schema());
+
+  // slices reuse the hashes of the table if they are already computed
+  std::shared_ptr<std::vector<uint64_t>> hashes;
+  if (table->HasRowHashes(hash_columns)) {
+	auto status = table->GetRowHashes(hash_columns, &hashes);
+	if (!status.is_ok()) {
+	  return status;
+	}
+  }
+
+  // the previous slices are sent while the next one is partitioned, on the progress thread if
+  // there is one. The all to all is not touched until the sending is done
+  auto progress_engine = ctx->GetProgressEngine();
+  std::atomic<bool> partitioned(false);
+  std::future<void> sending;
+  auto wait_for_sending = [&partitioned, &sending]() {
+	if (sending.valid()) {
+	  partitioned = true;
+	  sending.get();
+	}
+  };
+
+  const int64_t rows = arrow_table->num_rows();
+  for (int64_t offset = 0; offset < rows; offset += slice_rows) {
+	const int64_t length = std::min(slice_rows, rows - offset);
+	std::shared_ptr<arrow::Table> slice_table = arrow_table->Slice(offset, length);
+	auto slice = std::make_shared<cylon::Table>(slice_table, ctx);
+	if (hashes != nullptr) {
+	  slice->SetRowHashes(hash_columns, std::make_shared<std::vector<uint64_t>>(
+		  hashes->begin() + offset, hashes->begin() + offset + length));
+	}
+	std::unordered_map<int, std::shared_ptr<cylon::Table>> partitioned_tables;
+	auto status = slice->HashPartition(hash_columns, ctx->GetWorldSize(), &partitioned_tables);
+	// wait for the previous slices to go out
+	wait_for_sending();
+	if (!status.is_ok()) {
+	  return status;
+	}
+	for (auto &partitioned_table : partitioned_tables) {
+	  if (partitioned_table.first == ctx->GetRank()) {
+		received_tables.push_back(partitioned_table.second->get_table());
+	  } else if (partitioned_table.second->Rows() > 0) {
+		status = InsertTable(ctx, all_to_all, partitioned_table.second->get_table(),
+							 partitioned_table.first);
+		if (!status.is_ok()) {
+		  return status;
+		}
+	  }
+	}
+	// push the partitions out, and keep sending until the next slice is partitioned and the bytes
+	// in flight are below max_in_flight
+	all_to_all.isComplete();
+	partitioned = false;
+	sending = progress_engine->StartProgressUntil(
+		all_to_all, [&all_to_all, &partitioned, max_in_flight]() {
+		  const int64_t in_flight = all_to_all.inFlightBytes();
+		  return in_flight == 0 || (partitioned && in_flight <= max_in_flight);
+		});
   }
+  wait_for_sending();
+
+  all_to_all.finish();
+  ctx->GetProgressEngine()->Progress(all_to_all);
+  all_to_all.close();
+  return CombineReceivedTables(ctx, received_tables, combine_chunks, table_out);
 }
 
-Status ShuffleTwoTables(std::shared_ptr<cylon::CylonContext> &ctx,
-						std::shared_ptr<cylon::Table> &left_table,
-						int left_hash_column,
-						std::shared_ptr<cylon::Table> &right_table,
-						int right_hash_column,
-						std::shared_ptr<arrow::Table> *left_table_out,
-						std::shared_ptr<arrow::Table> *right_table_out) {
-  LOG(INFO) << "Shuffling two tables with total rows : "
-			<< left_table->Rows() + right_table->Rows();
-  auto t1 = std::chrono::high_resolution_clock::now();
-  auto status = Shuffle(ctx, left_table, left_hash_column,
-						ctx->GetNextSequence(), left_table_out);
-  if (status.is_ok()) {
-	auto t2 = std::chrono::high_resolution_clock::now();
-	LOG(INFO) << "Left shuffle time : "
-			  << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
-	status = Shuffle(ctx, right_table, right_hash_column,
-					 ctx->GetNextSequence(), right_table_out);
-	if (status.is_ok()) {
-	  auto t3 = std::chrono::high_resolution_clock::now();
-	  LOG(INFO) << "Right shuffle time : "
-				<< std::chrono::duration_cast<std::chrono::milliseconds>(t3 - t2).count();
+/**
+ * Add the row hashes to the table as the last column, so that they travel with the rows
+ * @param table
+ * @param hash_columns
+ * @param table_out
+ * @return
+ */
+cylon::Status AddRowHashColumn(std::shared_ptr<cylon::Table> &table,
+							   const std::vector<int> &hash_columns,
+							   std::shared_ptr<cylon::Table> *table_out) {
+  std::shared_ptr<std::vector<uint64_t>> hashes;
+  auto status = table->GetRowHashes(hash_columns, &hashes);
+  if (!status.is_ok()) {
+	return status;
+  }
+  std::shared_ptr<arrow::Table> arrow_table = table->get_table();
+  std::vector<std::shared_ptr<arrow::Field>> fields = arrow_table->schema()->fields();
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns = arrow_table->columns();
+  fields.push_back(arrow::field("cylon_row_hash", arrow::uint64()));
+  // the array shares the memory of the cached hashes, which are kept alive by the new table
+  columns.push_back(std::make_shared<arrow::ChunkedArray>(std::make_shared<arrow::UInt64Array>(
+	  hashes->size(), arrow::Buffer::Wrap(*hashes))));
+  std::shared_ptr<arrow::Table> with_hashes = arrow::Table::Make(arrow::schema(fields), columns);
+  auto ctx = table->GetContext();
+  *table_out = std::make_shared<cylon::Table>(with_hashes, ctx);
+  (*table_out)->SetRowHashes(hash_columns, hashes);
+  return Status::OK();
+}
+
+/**
+ * Remove the row hash column added by AddRowHashColumn
+ * @param table
+ * @param table_out table without the hash column
+ * @param hashes the row hashes
+ */
+void RemoveRowHashColumn(const std::shared_ptr<arrow::Table> &table,
+						 std::shared_ptr<arrow::Table> *table_out,
+						 std::shared_ptr<std::vector<uint64_t>> *hashes) {
+  const int hash_column = table->num_columns() - 1;
+  *hashes = std::make_shared<std::vector<uint64_t>>();
+  (*hashes)->reserve(table->num_rows());
+  for (const auto &chunk : table->column(hash_column)->chunks()) {
+	auto array = std::static_pointer_cast<arrow::UInt64Array>(chunk);
+	(*hashes)->insert((*hashes)->end(), array->raw_values(), array->raw_values() + array->length());
+  }
+  std::vector<std::shared_ptr<arrow::Field>> fields = table->schema()->fields();
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns = table->columns();
+  fields.pop_back();
+  columns.pop_back();
+  *table_out = arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+cylon::Status Shuffle(std::shared_ptr<cylon::CylonContext> &ctx,
+					  std::shared_ptr<cylon::Table> &table,
+					  const std::vector<int> &hash_columns,
+					  int edge_id,
+					  std::shared_ptr<arrow::Table> *table_out,
+					  std::shared_ptr<std::vector<uint64_t>> *hashes_out = nullptr,
+					  bool combine_chunks = true) {
+  std::shared_ptr<cylon::Table> partition_table = table;
+  if (hashes_out != nullptr) {
+	auto status = AddRowHashColumn(table, hash_columns, &partition_table);
+	if (!status.is_ok()) {
+	  return status;
+	}
+  }
+  std::shared_ptr<arrow::Table> received;
+  Status status;
+  const int64_t slice_rows = std::stoll(
+	  ctx->GetConfig(CylonContext::SHUFFLE_SLICE_ROWS_CONFIG, std::to_string(1 << 20)));
+  if (slice_rows > 0 && partition_table->Rows() > slice_rows) {
+	// large tables are partitioned and sent slice by slice
+	const int64_t max_in_flight = std::stoll(ctx->GetConfig(
+		CylonContext::SHUFFLE_MAX_IN_FLIGHT_BYTES_CONFIG, std::to_string(256LL << 20)));
+	status = StreamingShuffle(ctx, partition_table, hash_columns, edge_id, slice_rows,
+							  max_in_flight, combine_chunks, &received);
+	partition_table.reset();
+	if (!table->IsRetain()) {
+	  table.reset();
 	}
+  } else {
+	std::unordered_map<int, std::shared_ptr<cylon::Table>> partitioned_tables{};
+	// partition the tables locally
+	status = partition_table->HashPartition(hash_columns, ctx->GetWorldSize(),
+											&partitioned_tables);
+	if (!status.is_ok()) {
+	  return status;
+	}
+	std::shared_ptr<arrow::Schema> schema = partition_table->get_table()->schema();
+	partition_table.reset();
+	// we are going to free if retain is set to false
+	if (!table->IsRetain()) {
+	  table.reset();
+	}
+	std::vector<std::pair<int, std::shared_ptr<arrow::Table>>> partitions;
+	for (auto &partitioned_table : partitioned_tables) {
+	  partitions.emplace_back(partitioned_table.first, partitioned_table.second->get_table());
+	}
+	partitioned_tables.clear();
+	status = AllToAllTables(ctx, partitions, schema, edge_id, combine_chunks, &received);
+  }
+  if (!status.is_ok()) {
+	return status;
+  }
+  if (hashes_out == nullptr) {
+	*table_out = received;
+  } else {
+	RemoveRowHashColumn(received, table_out, hashes_out);
   }
   return status;
 }
@@ -471,7 +572,8 @@ Status Table::Sort(int sort_column, std::shared_ptr<cylon::Table> &out) {
   std::shared_ptr<arrow::Table> sorted_table;
 
   arrow::Status status = cylon::util::SortTable(this->table_, sort_column, &sorted_table,
-                                                cylon::ToArrowPool(this->ctx));
+                                                cylon::ToArrowPool(this->ctx),
+                                                this->ctx->GetThreadPool().get());
   if (status.ok()) {
     return Table::FromArrowTable(this->ctx, sorted_table, &out);
   } else {
@@ -479,6 +581,19 @@ Status Table::Sort(int sort_column, std::shared_ptr<cylon::Table> &out) {
   }
 }
 
+Status Table::Sort(const std::vector<SortKey> &sort_keys, std::shared_ptr<cylon::Table> &out) {
+  std::shared_ptr<arrow::Table> sorted_table;
+
+  arrow::Status status = cylon::util::SortTable(this->table_, sort_keys, &sorted_table,
+												cylon::ToArrowPool(this->ctx),
+												this->ctx->GetThreadPool().get());
+  if (status.ok()) {
+	return Table::FromArrowTable(this->ctx, sorted_table, &out);
+  } else {
+	return Status(static_cast<int>(status.code()), status.message());
+  }
+}
+
 Status Table::HashPartition(const std::vector<int> &hash_columns, int no_of_partitions,
 							std::unordered_map<int, std::shared_ptr<cylon::Table>> *out) {
   // keep arrays for each target, these arrays are used for creating the table
@@ -491,38 +606,34 @@ Status Table::HashPartition(const std::vector<int> &hash_columns, int no_of_part
 			t, std::make_shared<std::vector<std::shared_ptr<arrow::Array>>>()));
   }
 
-  std::vector<std::shared_ptr<arrow::Array>> arrays;
-  int64_t length = 0;
-  for (auto col_index : hash_columns) {
-	auto column = table_->column(col_index);
-	std::shared_ptr<arrow::Array> array = column->chunk(0);
-	arrays.push_back(array);
-
-	if (!(length == 0 || length == column->length())) {
-	  return Status(cylon::IndexError,
-					"Column lengths doesnt match " + std::to_string(length));
-	}
-	length = column->length();
-  }
-
   auto t1 = std::chrono::high_resolution_clock::now();
-  // first we partition the table
-  std::vector<int64_t> outPartitions;
-  outPartitions.reserve(length);
-  std::vector<uint32_t> counts(no_of_partitions, 0);
-  Status status = HashPartitionArrays(cylon::ToArrowPool(ctx), arrays, length,
-									  partitions, &outPartitions, counts);
+  // first we partition the table, reusing the row hashes if they are already computed
+  std::shared_ptr<std::vector<uint64_t>> hashes;
+  Status status = GetRowHashes(hash_columns, &hashes);
   if (!status.is_ok()) {
-	LOG(FATAL) << "Failed to create the hash partition";
+	LOG(ERROR) << "Failed to create the hash partition: " << status.get_msg();
 	return status;
   }
+  std::vector<int64_t> outPartitions;
+  outPartitions.reserve(hashes->size());
+  std::vector<uint32_t> counts(no_of_partitions, 0);
+  for (auto hash : *hashes) {
+	int target = partitions[hash % partitions.size()];
+	outPartitions.push_back(target);
+	counts[target]++;
+  }
   auto t2 = std::chrono::high_resolution_clock::now();
   LOG(INFO) << "Calculating hash time : "
 			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
 
-  for (int i = 0; i < table_->num_columns(); i++) {
-	std::shared_ptr<arrow::DataType> type = table_->column(i)->chunk(0)->type();
-	std::shared_ptr<arrow::Array> array = table_->column(i)->chunk(0);
+  std::shared_ptr<arrow::Table> combined;
+  status = CombineTableChunks(ctx, table_, &combined);
+  if (!status.is_ok()) {
+	return status;
+  }
+  for (int i = 0; i < combined->num_columns(); i++) {
+	std::shared_ptr<arrow::DataType> type = combined->column(i)->type();
+	std::shared_ptr<arrow::Array> array = combined->column(i)->chunk(0);
 
 	std::shared_ptr<ArrowArraySplitKernel> splitKernel;
 	status = CreateSplitter(type, cylon::ToArrowPool(ctx), &splitKernel);
@@ -571,7 +682,8 @@ Status Table::Join(std::shared_ptr<cylon::Table> &left, std::shared_ptr<cylon::T
 		right_table,
 		join_config,
 		&table,
-		cylon::ToArrowPool(left->ctx));
+		cylon::ToArrowPool(left->ctx),
+		left->ctx->GetThreadPool().get());
 	if (status == arrow::Status::OK()) {
 	  *out = std::make_shared<cylon::Table>(table, left->ctx);
 	}
@@ -584,53 +696,874 @@ Status Table::ToArrowTable(std::shared_ptr<arrow::Table> &out) {
   return Status::OK();
 }
 
-Status Table::DistributedJoin(std::shared_ptr<cylon::Table> &left,
-							  std::shared_ptr<cylon::Table> &right,
-							  cylon::join::config::JoinConfig join_config,
-							  std::shared_ptr<cylon::Table> *out) {
-  // check whether the world size is 1
-  std::shared_ptr<cylon::CylonContext> ctx = left->ctx;
-  if (ctx->GetWorldSize() == 1) {
-	cylon::Status status = Table::Join(
-		left,
-		right,
-		join_config,
-		out);
-	return status;
+/**
+ * Hash the key columns of every row of the table. The columns are combined the same way as the
+ * row hash used for partitioning, so hash % world size is the worker of the row
+ * @param ctx
+ * @param table
+ * @param hash_columns key columns
+ * @param hashes hash of each row
+ * @return
+ */
+Status HashKeyRows(std::shared_ptr<cylon::CylonContext> &ctx,
+				   const std::shared_ptr<arrow::Table> &table,
+				   const std::vector<int> &hash_columns,
+				   std::vector<uint64_t> *hashes) {
+  // a single key column hashes to the hash of its value, the way the rows of a join key were
+  // always partitioned. Multiple columns are combined starting from 1
+  hashes->assign(table->num_rows(), hash_columns.size() == 1 ? 0 : 1);
+  for (auto col_index : hash_columns) {
+	auto column = table->column(col_index);
+	auto kernel = GetPartitionKernel(cylon::ToArrowPool(ctx), column->type());
+	if (kernel == nullptr) {
+	  return Status(cylon::NotImplemented, "Not implemented or unsupported data type.");
+	}
+	int64_t row = 0;
+	for (const auto &chunk : column->chunks()) {
+	  kernel->UpdateHash(chunk, hashes->data() + row);
+	  row += chunk->length();
+	}
   }
+  return Status::OK();
+}
 
-  std::vector<int> right_hash_columns;
-  right_hash_columns.push_back(join_config.GetRightColumnIdx());
-  std::shared_ptr<arrow::Table> left_final_table;
-  std::shared_ptr<arrow::Table> right_final_table;
-  auto shuffle_status = ShuffleTwoTables(ctx,
-										 left,
-										 join_config.GetLeftColumnIdx(),
-										 right,
-										 join_config.GetRightColumnIdx(),
-										 &left_final_table,
-										 &right_final_table);
-  if (shuffle_status.is_ok()) {
-	// now do the local join
-	std::shared_ptr<arrow::Table> table;
-	arrow::Status status = join::joinTables(
-		left_final_table,
-		right_final_table,
-		join_config,
-		&table,
-		cylon::ToArrowPool(ctx));
-	*out = std::make_shared<cylon::Table>(table, ctx);
-	return Status(static_cast<int>(status.code()), status.message());
-  } else {
-	return shuffle_status;
+Status Table::GetRowHashes(const std::vector<int> &hash_columns,
+						   std::shared_ptr<std::vector<uint64_t>> *hashes) {
+  if (!HasRowHashes(hash_columns)) {
+	auto row_hashes = std::make_shared<std::vector<uint64_t>>();
+	auto status = HashKeyRows(ctx, table_, hash_columns, row_hashes.get());
+	if (!status.is_ok()) {
+	  return status;
+	}
+	SetRowHashes(hash_columns, row_hashes);
+  }
+  *hashes = row_hashes_;
+  return Status::OK();
+}
+
+void Table::SetRowHashes(const std::vector<int> &hash_columns,
+						 const std::shared_ptr<std::vector<uint64_t>> &hashes) {
+  hash_columns_ = hash_columns;
+  row_hashes_ = hashes;
+}
+
+bool Table::HasRowHashes(const std::vector<int> &hash_columns) const {
+  return row_hashes_ != nullptr && hash_columns_ == hash_columns;
+}
+
+void Table::ClearRowHashes() {
+  hash_columns_.clear();
+  row_hashes_.reset();
+}
+
+/**
+ * Semi join pre-phase of the distributed join. Every worker builds a bloom filter of the keys of
+ * one table, the filters are OR-ed across the workers, and the rows of the other table that
+ * cannot find a match are dropped before the tables are shuffled.
+ *
+ * Inner joins filter the globally larger table, left joins filter the right table and right joins
+ * filter the left table. Full outer joins are not filtered.
+ * @param ctx
+ * @param left left table, replaced with the filtered table if it is filtered
+ * @param right right table, replaced with the filtered table if it is filtered
+ * @param join_config
+ * @param filter_stats
+ * @return
+ */
+Status BloomFilterJoinTables(std::shared_ptr<cylon::CylonContext> &ctx,
+							 std::shared_ptr<cylon::Table> &left,
+							 std::shared_ptr<cylon::Table> &right,
+							 const cylon::join::config::JoinConfig &join_config,
+							 JoinFilterStats *filter_stats) {
+  if (join_config.GetType() == cylon::join::config::FULL_OUTER) {
+	return Status::OK();
+  }
+  auto t1 = std::chrono::high_resolution_clock::now();
+  // global number of rows of each table
+  int64_t local_rows[2] = {left->Rows(), right->Rows()};
+  int64_t global_rows[2] = {0, 0};
+  auto status = ctx->GetCommunicator()->AllReduce(local_rows, global_rows, 2, cylon::Int64(),
+												  cylon::net::ReduceOp::SUM);
+  if (!status.is_ok()) {
+	return status;
+  }
+
+  bool filter_left;
+  switch (join_config.GetType()) {
+	case cylon::join::config::LEFT: filter_left = false;
+	  break;
+	case cylon::join::config::RIGHT: filter_left = true;
+	  break;
+	default: filter_left = global_rows[0] > global_rows[1];
+  }
+  std::shared_ptr<cylon::Table> &build = filter_left ? right : left;
+  std::shared_ptr<cylon::Table> &probe = filter_left ? left : right;
+  const std::vector<int> &build_columns = filter_left ? join_config.GetRightColumnIndices()
+													  : join_config.GetLeftColumnIndices();
+  const std::vector<int> &probe_columns = filter_left ? join_config.GetLeftColumnIndices()
+													  : join_config.GetRightColumnIndices();
+
+  // every worker creates a filter of the same size, so the filters can be OR-ed
+  util::BlockedBloomFilter filter(global_rows[filter_left ? 1 : 0]);
+  // the hashes are cached in the tables and reused by the shuffle
+  std::shared_ptr<std::vector<uint64_t>> hashes;
+  status = build->GetRowHashes(build_columns, &hashes);
+  if (!status.is_ok()) {
+	return status;
+  }
+  for (auto hash : *hashes) {
+	filter.Insert(util::MixHash(hash));
+  }
+  std::vector<uint64_t> &words = filter.Words();
+  std::vector<uint64_t> global_words(words.size());
+  // words are reduced as int64 because only the bits matter
+  status = ctx->GetCommunicator()->AllReduce(words.data(), global_words.data(), words.size(),
+											 cylon::Int64(), cylon::net::ReduceOp::BOR);
+  if (!status.is_ok()) {
+	return status;
+  }
+  words.swap(global_words);
+  auto t2 = std::chrono::high_resolution_clock::now();
+  LOG(INFO) << "Bloom filter build time : "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+  // mask the rows of the probe table that can find a match
+  status = probe->GetRowHashes(probe_columns, &hashes);
+  if (!status.is_ok()) {
+	return status;
+  }
+  arrow::BooleanBuilder boolean_builder(cylon::ToArrowPool(ctx));
+  arrow::Status arrow_status = boolean_builder.Reserve(hashes->size());
+  if (!arrow_status.ok()) {
+	return Status(static_cast<int>(arrow_status.code()), arrow_status.message());
+  }
+  auto filtered_hashes = std::make_shared<std::vector<uint64_t>>();
+  for (auto hash : *hashes) {
+	bool keep = filter.MayContain(util::MixHash(hash));
+	boolean_builder.UnsafeAppend(keep);
+	if (keep) {
+	  filtered_hashes->push_back(hash);
+	}
+  }
+  std::shared_ptr<arrow::Array> mask;
+  arrow_status = boolean_builder.Finish(&mask);
+  if (!arrow_status.ok()) {
+	return Status(static_cast<int>(arrow_status.code()), arrow_status.message());
+  }
+  std::shared_ptr<arrow::Table> filtered_table, combined_table;
+  arrow::compute::FunctionContext func_ctx(cylon::ToArrowPool(ctx));
+  arrow_status = arrow::compute::Filter(&func_ctx, *probe->get_table(), *mask, &filtered_table);
+  if (!arrow_status.ok()) {
+	return Status(static_cast<int>(arrow_status.code()), arrow_status.message());
+  }
+  // partitioning works on the first chunk
+  arrow_status = filtered_table->CombineChunks(cylon::ToArrowPool(ctx), &combined_table);
+  if (!arrow_status.ok()) {
+	return Status(static_cast<int>(arrow_status.code()), arrow_status.message());
+  }
+  auto t3 = std::chrono::high_resolution_clock::now();
+  LOG(INFO) << "Bloom filter removed " << probe->Rows() - combined_table->num_rows() << " of "
+			<< probe->Rows() << " rows, filter time : "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(t3 - t2).count();
+  filter_stats->probe_rows = probe->Rows();
+  filter_stats->filtered_rows = probe->Rows() - combined_table->num_rows();
+  probe = std::make_shared<cylon::Table>(combined_table, ctx);
+  probe->SetRowHashes(probe_columns, filtered_hashes);
+  // the filtered table is only used by the shuffle
+  probe->retainMemory(false);
+  return Status::OK();
+}
+
+/**
+ * Number of key hashes sampled by each worker to find the heavy hitters
+ */
+static constexpr int kSkewSampleRows = 1024;
+
+/**
+ * Find the heavy hitter keys of a table. Every worker samples the key hashes of its rows and
+ * the samples are gathered to all the workers, so all the workers find the same heavy hitters.
+ * A sample of a worker represents local rows / samples rows of that worker.
+ * @param ctx
+ * @param hashes key hashes of the local rows
+ * @param threshold a key is heavy if it has more than threshold * (rows / world size) rows
+ * @param heavy_keys heavy key hash -> number of workers its rows are spread over
+ * @param skew_stats
+ * @return
+ */
+Status FindHeavyHitters(std::shared_ptr<cylon::CylonContext> &ctx,
+						const std::vector<uint64_t> &hashes,
+						double threshold,
+						std::unordered_map<uint64_t, int> *heavy_keys,
+						JoinSkewStats *skew_stats) {
+  int world_size = ctx->GetWorldSize();
+  int64_t local_rows = hashes.size();
+  int samples = static_cast<int>(std::min<int64_t>(local_rows, kSkewSampleRows));
+  std::vector<uint64_t> local_samples(samples);
+  std::mt19937_64 gen(ctx->GetRank());
+  std::uniform_int_distribution<int64_t> distrib(0, std::max<int64_t>(local_rows - 1, 0));
+  for (int i = 0; i < samples; i++) {
+	local_samples[i] = samples == local_rows ? hashes[i] : hashes[distrib(gen)];
+  }
+
+  std::vector<int64_t> rows(world_size, 0);
+  std::vector<int> sample_counts(world_size, 0);
+  auto status = ctx->GetCommunicator()->Allgather(&local_rows, 1, rows.data(), cylon::Int64());
+  if (!status.is_ok()) {
+	return status;
+  }
+  status = ctx->GetCommunicator()->Allgather(&samples, 1, sample_counts.data(), cylon::Int32());
+  if (!status.is_ok()) {
+	return status;
+  }
+  std::vector<int> displacements(world_size, 0);
+  for (int i = 1; i < world_size; i++) {
+	displacements[i] = displacements[i - 1] + sample_counts[i - 1];
+  }
+  // hashes are gathered as int64 because only the bits matter
+  std::vector<uint64_t> all_samples(displacements.back() + sample_counts.back());
+  status = ctx->GetCommunicator()->Allgatherv(local_samples.data(), samples, all_samples.data(),
+											  sample_counts.data(), displacements.data(),
+											  cylon::Int64());
+  if (!status.is_ok()) {
+	return status;
+  }
+
+  // estimate the global rows of the sampled keys
+  int64_t global_rows = 0;
+  std::unordered_map<uint64_t, double> estimates;
+  for (int i = 0; i < world_size; i++) {
+	global_rows += rows[i];
+	for (int j = 0; j < sample_counts[i]; j++) {
+	  estimates[all_samples[displacements[i] + j]] += (double) rows[i] / sample_counts[i];
+	}
+  }
+  if (global_rows == 0) {
+	return Status::OK();
+  }
+  double limit = threshold * global_rows / world_size;
+  for (const auto &estimate : estimates) {
+	if (estimate.second > limit) {
+	  // spread the key so that each worker gets at most limit rows of it
+	  int workers = static_cast<int>(std::min<double>(world_size,
+													  std::ceil(estimate.second / limit)));
+	  heavy_keys->insert(std::make_pair(estimate.first, std::max(workers, 2)));
+	}
+	skew_stats->max_key_share = std::max(skew_stats->max_key_share, estimate.second / global_rows);
+  }
+  skew_stats->heavy_keys = heavy_keys->size();
+  return Status::OK();
+}
+
+/**
+ * Split a single chunk table to the workers
+ * @param ctx
+ * @param table
+ * @param targets target worker of each row
+ * @param counts number of rows of each worker
+ * @param partitioned_tables target worker and its table. Workers without rows are skipped
+ * @return
+ */
+Status SplitTable(std::shared_ptr<cylon::CylonContext> &ctx,
+				  const std::shared_ptr<arrow::Table> &table,
+				  const std::vector<int64_t> &targets,
+				  std::vector<uint32_t> &counts,
+				  std::vector<std::pair<int,
+										std::shared_ptr<arrow::Table>>> *partitioned_tables) {
+  const int world_size = static_cast<int>(counts.size());
+  std::vector<int> partitions;
+  for (int t = 0; t < world_size; t++) {
+	partitions.push_back(t);
+  }
+  std::shared_ptr<arrow::Table> combined;
+  auto combine_status = CombineTableChunks(ctx, table, &combined);
+  if (!combine_status.is_ok()) {
+	return combine_status;
+  }
+  std::vector<std::vector<std::shared_ptr<arrow::Array>>> data_arrays(world_size);
+  for (int i = 0; i < combined->num_columns(); i++) {
+	std::shared_ptr<arrow::Array> array = combined->column(i)->chunk(0);
+	std::shared_ptr<ArrowArraySplitKernel> split_kernel;
+	auto status = CreateSplitter(array->type(), cylon::ToArrowPool(ctx), &split_kernel);
+	if (!status.is_ok()) {
+	  return status;
+	}
+	std::unordered_map<int, std::shared_ptr<arrow::Array>> split_arrays;
+	split_kernel->Split(array, targets, partitions, split_arrays, counts);
+	for (const auto &x : split_arrays) {
+	  data_arrays[x.first].push_back(x.second);
+	}
+  }
+  for (int t = 0; t < world_size; t++) {
+	if (counts[t] > 0) {
+	  partitioned_tables->emplace_back(t, arrow::Table::Make(table->schema(), data_arrays[t]));
+	}
+  }
+  return Status::OK();
+}
+
+/**
+ * Hash partition a table to the workers, handling the heavy hitter keys. The rows of a heavy key
+ * are either spread round robin over the workers assigned to the key, or replicated to all of them
+ * @param ctx
+ * @param table single chunk table
+ * @param hashes key hashes of the rows
+ * @param heavy_keys heavy key hash -> number of workers
+ * @param replicate true to replicate the heavy keys, false to spread them
+ * @param skew_stats
+ * @param partitioned_tables target worker and the table sent to it
+ * @return
+ */
+Status SkewPartitionTable(std::shared_ptr<cylon::CylonContext> &ctx,
+						  const std::shared_ptr<arrow::Table> &table,
+						  const std::vector<uint64_t> &hashes,
+						  const std::unordered_map<uint64_t, int> &heavy_keys,
+						  bool replicate,
+						  JoinSkewStats *skew_stats,
+						  std::vector<std::pair<int,
+												std::shared_ptr<arrow::Table>>> *partitioned_tables) {
+  int world_size = ctx->GetWorldSize();
+  std::vector<int64_t> targets;
+  targets.reserve(hashes.size());
+  std::vector<uint32_t> counts(world_size, 0);
+  // heavy rows replicated to the other workers of their key
+  auto extra_rows = std::make_shared<std::vector<int64_t>>();
+  std::vector<int64_t> extra_targets;
+  std::vector<uint32_t> extra_counts(world_size, 0);
+  // next worker of each spread key
+  std::unordered_map<uint64_t, int> next_worker;
+
+  for (size_t row = 0; row < hashes.size(); row++) {
+	int target = static_cast<int>(hashes[row] % world_size);
+	if (!heavy_keys.empty()) {
+	  auto heavy = heavy_keys.find(hashes[row]);
+	  if (heavy != heavy_keys.end()) {
+		if (replicate) {
+		  for (int i = 1; i < heavy->second; i++) {
+			int extra_target = (target + i) % world_size;
+			extra_rows->push_back(row);
+			extra_targets.push_back(extra_target);
+			extra_counts[extra_target]++;
+		  }
+		} else {
+		  int &next = next_worker[hashes[row]];
+		  target = (target + next) % world_size;
+		  next = (next + 1) % heavy->second;
+		  skew_stats->split_rows++;
+		}
+	  }
+	}
+	targets.push_back(target);
+	counts[target]++;
+  }
+  skew_stats->replicated_rows += extra_rows->size();
+
+  auto status = SplitTable(ctx, table, targets, counts, partitioned_tables);
+  if (!status.is_ok() || extra_rows->empty()) {
+	return status;
+  }
+  // copy the replicated rows and partition them to the other workers of their keys
+  std::vector<std::shared_ptr<arrow::Array>> extra_arrays;
+  for (int i = 0; i < table->num_columns(); i++) {
+	std::shared_ptr<arrow::Array> array;
+	auto arrow_status = cylon::util::copy_array_by_indices(extra_rows, table->column(i)->chunk(0),
+														   &array, cylon::ToArrowPool(ctx));
+	if (!arrow_status.ok()) {
+	  return Status(static_cast<int>(arrow_status.code()), arrow_status.message());
+	}
+	extra_arrays.push_back(array);
+  }
+  return SplitTable(ctx, arrow::Table::Make(table->schema(), extra_arrays), extra_targets,
+					extra_counts, partitioned_tables);
+}
+
+/**
+ * Shuffle the two tables of a join, spreading the heavy hitter keys over several workers.
+ *
+ * The heavy hitters are found by sampling the table whose rows are spread. The rows of a heavy key
+ * of that table are sent round robin to the workers of the key and the rows of the same key of the
+ * other table are replicated to all of them. Inner joins spread the globally larger table, left
+ * joins spread the left table and right joins spread the right table.
+ * @param ctx
+ * @param left_table
+ * @param right_table
+ * @param join_config
+ * @param skew_stats
+ * @param left_table_out
+ * @param right_table_out
+ * @return
+ */
+Status SkewShuffleTwoTables(std::shared_ptr<cylon::CylonContext> &ctx,
+							std::shared_ptr<cylon::Table> &left_table,
+							std::shared_ptr<cylon::Table> &right_table,
+							const cylon::join::config::JoinConfig &join_config,
+							JoinSkewStats *skew_stats,
+							std::shared_ptr<arrow::Table> *left_table_out,
+							std::shared_ptr<arrow::Table> *right_table_out) {
+  auto t1 = std::chrono::high_resolution_clock::now();
+  int64_t local_rows[2] = {left_table->Rows(), right_table->Rows()};
+  int64_t global_rows[2] = {0, 0};
+  auto status = ctx->GetCommunicator()->AllReduce(local_rows, global_rows, 2, cylon::Int64(),
+												  cylon::net::ReduceOp::SUM);
+  if (!status.is_ok()) {
+	return status;
+  }
+  bool split_left;
+  switch (join_config.GetType()) {
+	case cylon::join::config::LEFT: split_left = true;
+	  break;
+	case cylon::join::config::RIGHT: split_left = false;
+	  break;
+	default: split_left = global_rows[0] >= global_rows[1];
+  }
+
+  // partitioning works on the first chunk
+  std::shared_ptr<arrow::Table> tables[2];
+  std::shared_ptr<std::vector<uint64_t>> hashes[2];
+  std::shared_ptr<cylon::Table> *inputs[2] = {&left_table, &right_table};
+  const std::vector<int> *columns[2] = {&join_config.GetLeftColumnIndices(),
+										&join_config.GetRightColumnIndices()};
+  for (int i = 0; i < 2; i++) {
+	auto arrow_status = (*inputs[i])->get_table()->CombineChunks(cylon::ToArrowPool(ctx),
+																 &tables[i]);
+	if (!arrow_status.ok()) {
+	  return Status(static_cast<int>(arrow_status.code()), arrow_status.message());
+	}
+	status = (*inputs[i])->GetRowHashes(*columns[i], &hashes[i]);
+	if (!status.is_ok()) {
+	  return status;
+	}
+	// we are going to free if retain is set to false
+	if (!(*inputs[i])->IsRetain()) {
+	  inputs[i]->reset();
+	}
+  }
+
+  int split = split_left ? 0 : 1;
+  std::unordered_map<uint64_t, int> heavy_keys;
+  status = FindHeavyHitters(ctx, *hashes[split], join_config.GetSkewThreshold(), &heavy_keys,
+							skew_stats);
+  if (!status.is_ok()) {
+	return status;
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+  LOG(INFO) << "Heavy hitter keys : " << skew_stats->heavy_keys << ", max key share : "
+			<< skew_stats->max_key_share << ", sampling time : "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+  std::shared_ptr<arrow::Table> *outputs[2] = {left_table_out, right_table_out};
+  for (int i = 0; i < 2; i++) {
+	std::vector<std::pair<int, std::shared_ptr<arrow::Table>>> partitioned_tables;
+	status = SkewPartitionTable(ctx, tables[i], *hashes[i], heavy_keys, i != split, skew_stats,
+								&partitioned_tables);
+	if (!status.is_ok()) {
+	  return status;
+	}
+	std::shared_ptr<arrow::Schema> schema = tables[i]->schema();
+	tables[i].reset();
+	hashes[i].reset();
+	status = AllToAllTables(ctx, partitioned_tables, schema, ctx->GetNextSequence(), true,
+								outputs[i]);
+	if (!status.is_ok()) {
+	  return status;
+	}
+  }
+  auto t3 = std::chrono::high_resolution_clock::now();
+  LOG(INFO) << "Split rows : " << skew_stats->split_rows << ", replicated rows : "
+			<< skew_stats->replicated_rows << ", shuffle time : "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(t3 - t2).count();
+  return Status::OK();
+}
+
+/**
+ * Approximate size of a table, the sum of the sizes of the buffers of its arrays
+ * @param table
+ * @return size in bytes
+ */
+int64_t TableBytes(const std::shared_ptr<arrow::Table> &table) {
+  int64_t bytes = 0;
+  for (const auto &column : table->columns()) {
+	for (const auto &chunk : column->chunks()) {
+	  for (const auto &buffer : chunk->data()->buffers) {
+		if (buffer != nullptr) {
+		  bytes += buffer->size();
+		}
+	  }
+	}
+  }
+  return bytes;
+}
+
+/**
+ * Decide whether the distributed join broadcasts one of the tables instead of shuffling both.
+ *
+ * Only the table whose rows are not all retained by the join can be broadcast, i.e. either table
+ * of an inner join, the right table of a left join and the left table of a right join. The AUTO
+ * strategy broadcasts it if its global size is within the broadcast limit and broadcasting it
+ * moves fewer bytes than shuffling both tables, i.e. small * (world - 1) < large.
+ * @param ctx
+ * @param left
+ * @param right
+ * @param join_config
+ * @param broadcast true if a table should be broadcast
+ * @param broadcast_left true if the left table should be broadcast, false for the right table
+ * @return
+ */
+Status SelectBroadcastTable(std::shared_ptr<cylon::CylonContext> &ctx,
+							const std::shared_ptr<cylon::Table> &left,
+							const std::shared_ptr<cylon::Table> &right,
+							const cylon::join::config::JoinConfig &join_config,
+							bool *broadcast,
+							bool *broadcast_left) {
+  *broadcast = false;
+  auto strategy = join_config.GetStrategy();
+  if (strategy == cylon::join::config::SHUFFLE) {
+	return Status::OK();
+  }
+  bool forced = strategy == cylon::join::config::BROADCAST;
+  if (join_config.GetType() == cylon::join::config::FULL_OUTER) {
+	return forced ? Status(cylon::Invalid, "Full outer joins can not broadcast a table")
+				  : Status::OK();
+  }
+  // global bytes of each table
+  int64_t local_bytes[2] = {TableBytes(left->get_table()), TableBytes(right->get_table())};
+  int64_t global_bytes[2] = {0, 0};
+  auto status = ctx->GetCommunicator()->AllReduce(local_bytes, global_bytes, 2, cylon::Int64(),
+												  cylon::net::ReduceOp::SUM);
+  if (!status.is_ok()) {
+	return status;
+  }
+
+  switch (join_config.GetType()) {
+	case cylon::join::config::LEFT: *broadcast_left = false;
+	  break;
+	case cylon::join::config::RIGHT: *broadcast_left = true;
+	  break;
+	default: *broadcast_left = global_bytes[0] < global_bytes[1];
+  }
+  int64_t small = global_bytes[*broadcast_left ? 0 : 1];
+  int64_t large = global_bytes[*broadcast_left ? 1 : 0];
+  *broadcast = forced || (small <= join_config.GetBroadcastLimit()
+	  && small * (ctx->GetWorldSize() - 1) < large);
+  LOG(INFO) << "Join table bytes left : " << global_bytes[0] << " right : " << global_bytes[1]
+			<< (*broadcast ? (*broadcast_left ? ", broadcasting left" : ", broadcasting right")
+						   : ", shuffling");
+  return Status::OK();
+}
+
+/**
+ * Gather the table of every worker to all the workers. The tables are exchanged as Arrow IPC
+ * streams and concatenated in the order of the ranks
+ * @param ctx
+ * @param table local table
+ * @param table_out gathered table
+ * @return
+ */
+Status AllGatherTable(std::shared_ptr<cylon::CylonContext> &ctx,
+					  const std::shared_ptr<arrow::Table> &table,
+					  std::shared_ptr<arrow::Table> *table_out) {
+  auto t1 = std::chrono::high_resolution_clock::now();
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  auto status = ctx->GetCommunicator()->AllgatherTable(table, cylon::ToArrowPool(ctx), &tables);
+  if (!status.is_ok()) {
+	return status;
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+  LOG(INFO) << "Table all gather time : "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+  arrow::Result<std::shared_ptr<arrow::Table>> concat_tables = arrow::ConcatenateTables(tables);
+  if (!concat_tables.ok()) {
+	return Status(static_cast<int>(concat_tables.status().code()),
+				  concat_tables.status().message());
+  }
+  arrow::Status arrow_status = concat_tables.ValueOrDie()->CombineChunks(cylon::ToArrowPool(ctx),
+																		  table_out);
+  return Status(static_cast<int>(arrow_status.code()), arrow_status.message());
+}
+
+Status Table::DistributedJoin(std::shared_ptr<cylon::Table> &left,
+							  std::shared_ptr<cylon::Table> &right,
+							  cylon::join::config::JoinConfig join_config,
+							  std::shared_ptr<cylon::Table> *out,
+							  JoinSkewStats *skew_stats,
+							  JoinFilterStats *filter_stats) {
+  if (!join_config.IsValid()) {
+	return Status(Code::Invalid, "The join needs the same number of left and right key columns");
+  }
+  // check whether the world size is 1
+  std::shared_ptr<cylon::CylonContext> ctx = left->ctx;
+  if (ctx->GetWorldSize() == 1) {
+	cylon::Status status = Table::Join(
+		left,
+		right,
+		join_config,
+		out);
+	return status;
+  }
+
+  bool broadcast = false, broadcast_left = false;
+  auto strategy_status = SelectBroadcastTable(ctx, left, right, join_config, &broadcast,
+											  &broadcast_left);
+  if (!strategy_status.is_ok()) {
+	return strategy_status;
+  }
+
+  std::shared_ptr<arrow::Table> left_final_table;
+  std::shared_ptr<arrow::Table> right_final_table;
+  if (broadcast) {
+	// gather the small table to all the workers, the other table stays where it is
+	auto gather_status = broadcast_left
+		? AllGatherTable(ctx, left->get_table(), &left_final_table)
+		: AllGatherTable(ctx, right->get_table(), &right_final_table);
+	if (!gather_status.is_ok()) {
+	  return gather_status;
+	}
+	if (broadcast_left) {
+	  right_final_table = right->get_table();
+	} else {
+	  left_final_table = left->get_table();
+	}
+  } else {
+	std::shared_ptr<cylon::Table> left_table = left;
+	std::shared_ptr<cylon::Table> right_table = right;
+	if (join_config.UseBloomFilter()) {
+	  JoinFilterStats stats;
+	  auto filter_status = BloomFilterJoinTables(ctx, left_table, right_table, join_config,
+												 filter_stats != nullptr ? filter_stats : &stats);
+	  if (!filter_status.is_ok()) {
+		return filter_status;
+	  }
+	}
+	// the tables are released by the shuffle if they are not retained
+	if (!left->IsRetain()) {
+	  left.reset();
+	}
+	if (!right->IsRetain()) {
+	  right.reset();
+	}
+
+	// partition on all the key columns
+	Status shuffle_status;
+	if (join_config.HandleSkew() && join_config.GetType() != cylon::join::config::FULL_OUTER) {
+	  JoinSkewStats stats;
+	  shuffle_status = SkewShuffleTwoTables(ctx, left_table, right_table, join_config,
+											skew_stats != nullptr ? skew_stats : &stats,
+											&left_final_table, &right_final_table);
+	} else {
+	  shuffle_status = ShuffleTwoTables(ctx,
+										left_table,
+										join_config.GetLeftColumnIndices(),
+										right_table,
+										join_config.GetRightColumnIndices(),
+										&left_final_table,
+										&right_final_table);
+	}
+	if (!shuffle_status.is_ok()) {
+	  return shuffle_status;
+	}
   }
+
+  // now do the local join
+  std::shared_ptr<arrow::Table> table;
+  arrow::Status status = join::joinTables(
+	  left_final_table,
+	  right_final_table,
+	  join_config,
+	  &table,
+	  cylon::ToArrowPool(ctx),
+	  ctx->GetThreadPool().get());
+  *out = std::make_shared<cylon::Table>(table, ctx);
+  return Status(static_cast<int>(status.code()), status.message());
+}
+
+/**
+ * Number of splitter samples taken by each worker per worker of the distributed sort
+ */
+static constexpr int64_t kSortSamplesPerWorker = 32;
+
+Status Table::DistributedSort(int sort_column, std::shared_ptr<Table> &output) {
+  if (ctx->GetWorldSize() == 1) {
+	return Sort(sort_column, output);
+  }
+  auto t1 = std::chrono::high_resolution_clock::now();
+  // sort locally, the local order gives the rows unique (value, rank, position) keys so that
+  // duplicate values can be split between the workers
+  std::shared_ptr<Table> local_sorted;
+  auto status = Sort(sort_column, local_sorted);
+  if (!status.is_ok()) {
+	return status;
+  }
+  std::shared_ptr<arrow::Table> table = local_sorted->get_table();
+  local_sorted.reset();
+  std::shared_ptr<arrow::Array> column = table->column(sort_column)->chunk(0);
+  const int world_size = ctx->GetWorldSize();
+  const int rank = ctx->GetRank();
+  const int64_t rows = table->num_rows();
+
+  // regular samples of the local sorted column
+  int64_t samples = std::min<int64_t>(rows, kSortSamplesPerWorker * world_size);
+  auto sample_positions = std::make_shared<std::vector<int64_t>>();
+  arrow::Int32Builder rank_builder(cylon::ToArrowPool(ctx));
+  arrow::Int64Builder position_builder(cylon::ToArrowPool(ctx));
+  for (int64_t i = 0; i < samples; i++) {
+	int64_t position = (i * rows) / samples;
+	sample_positions->push_back(position);
+	arrow::Status arrow_status = rank_builder.Append(rank);
+	if (arrow_status.ok()) {
+	  arrow_status = position_builder.Append(position);
+	}
+	if (!arrow_status.ok()) {
+	  return Status(static_cast<int>(arrow_status.code()), arrow_status.message());
+	}
+  }
+  std::shared_ptr<arrow::Array> sample_values, sample_ranks, sample_rank_positions;
+  arrow::Status arrow_status = cylon::util::copy_array_by_indices(sample_positions, column,
+																  &sample_values,
+																  cylon::ToArrowPool(ctx));
+  if (arrow_status.ok()) {
+	arrow_status = rank_builder.Finish(&sample_ranks);
+  }
+  if (arrow_status.ok()) {
+	arrow_status = position_builder.Finish(&sample_rank_positions);
+  }
+  if (!arrow_status.ok()) {
+	return Status(static_cast<int>(arrow_status.code()), arrow_status.message());
+  }
+  auto sample_table = arrow::Table::Make(
+	  arrow::schema({arrow::field("value", column->type()), arrow::field("rank", arrow::int32()),
+					 arrow::field("position", arrow::int64())}),
+	  {sample_values, sample_ranks, sample_rank_positions});
+
+  // gather the samples of all the workers and pick the splitters
+  std::shared_ptr<arrow::Table> all_samples;
+  status = AllGatherTable(ctx, sample_table, &all_samples);
+  if (!status.is_ok()) {
+	return status;
+  }
+  auto values = all_samples->column(0)->chunk(0);
+  auto ranks = std::static_pointer_cast<arrow::Int32Array>(all_samples->column(1)->chunk(0));
+  auto positions = std::static_pointer_cast<arrow::Int64Array>(all_samples->column(2)->chunk(0));
+  std::shared_ptr<ArrowComparator> comparator = GetComparator(column->type());
+  if (comparator == nullptr) {
+	return Status(cylon::NotImplemented, "Un-supported type for the distributed sort");
+  }
+  // compare the key of a local row with the key of a sample
+  auto compare = [&](int64_t row, int64_t sample) {
+	int result = comparator->compare(column, row, values, sample);
+	if (result == 0) {
+	  result = rank < ranks->Value(sample) ? -1 : (rank > ranks->Value(sample) ? 1 : 0);
+	}
+	if (result == 0) {
+	  result = row < positions->Value(sample) ? -1 : (row > positions->Value(sample) ? 1 : 0);
+	}
+	return result;
+  };
+  std::vector<int64_t> sorted_samples(all_samples->num_rows());
+  for (size_t i = 0; i < sorted_samples.size(); i++) {
+	sorted_samples[i] = i;
+  }
+  std::sort(sorted_samples.begin(), sorted_samples.end(), [&](int64_t a, int64_t b) {
+	int result = comparator->compare(values, a, values, b);
+	if (result != 0) {
+	  return result < 0;
+	}
+	if (ranks->Value(a) != ranks->Value(b)) {
+	  return ranks->Value(a) < ranks->Value(b);
+	}
+	return positions->Value(a) < positions->Value(b);
+  });
+
+  // worker t gets the rows with keys in (splitter t - 1, splitter t], which is a contiguous range
+  // of the local sorted table
+  std::vector<int64_t> targets(rows);
+  std::vector<uint32_t> counts(world_size, 0);
+  int64_t start = 0;
+  for (int t = 0; t < world_size; t++) {
+	int64_t end = rows;
+	if (t < world_size - 1 && !sorted_samples.empty()) {
+	  int64_t splitter = sorted_samples[(t + 1) * sorted_samples.size() / world_size];
+	  // first row after the splitter
+	  int64_t low = start, high = rows;
+	  while (low < high) {
+		int64_t mid = low + (high - low) / 2;
+		if (compare(mid, splitter) <= 0) {
+		  low = mid + 1;
+		} else {
+		  high = mid;
+		}
+	  }
+	  end = low;
+	}
+	std::fill(targets.begin() + start, targets.begin() + end, t);
+	counts[t] = static_cast<uint32_t>(end - start);
+	start = end;
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+  LOG(INFO) << "Sample sort splitter time : "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+
+  // exchange the ranges and sort the received rows
+  std::vector<std::pair<int, std::shared_ptr<arrow::Table>>> partitioned_tables;
+  status = SplitTable(ctx, table, targets, counts, &partitioned_tables);
+  if (!status.is_ok()) {
+	return status;
+  }
+  std::shared_ptr<arrow::Schema> schema = table->schema();
+  table.reset();
+  std::shared_ptr<arrow::Table> received;
+  status = AllToAllTables(ctx, partitioned_tables, schema, ctx->GetNextSequence(), true,
+						  &received);
+  if (!status.is_ok()) {
+	return status;
+  }
+  auto t3 = std::chrono::high_resolution_clock::now();
+  LOG(INFO) << "Sample sort shuffle time : "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(t3 - t2).count();
+  std::shared_ptr<Table> received_table = std::make_shared<Table>(received, ctx);
+  return received_table->Sort(sort_column, output);
+}
+
+Status Table::TopK(int column, int64_t k, bool ascending, std::shared_ptr<Table> &output) {
+  std::shared_ptr<arrow::Table> top_k_table;
+  arrow::Status status = cylon::util::TopKTable(this->table_, column, k, ascending, &top_k_table,
+												cylon::ToArrowPool(this->ctx));
+  if (!status.ok()) {
+	return Status(static_cast<int>(status.code()), status.message());
+  }
+  return Table::FromArrowTable(this->ctx, top_k_table, &output);
+}
+
+Status Table::DistributedTopK(int column, int64_t k, bool ascending,
+							  std::shared_ptr<Table> &output) {
+  if (ctx->GetWorldSize() == 1) {
+	return TopK(column, k, ascending, output);
+  }
+  // the global top k rows are in the union of the local top k rows
+  std::shared_ptr<Table> local_top_k;
+  auto status = TopK(column, k, ascending, local_top_k);
+  if (!status.is_ok()) {
+	return status;
+  }
+  std::shared_ptr<arrow::Table> candidates;
+  status = AllGatherTable(ctx, local_top_k->get_table(), &candidates);
+  if (!status.is_ok()) {
+	return status;
+  }
+  std::shared_ptr<Table> candidate_table = std::make_shared<Table>(candidates, ctx);
+  return candidate_table->TopK(column, k, ascending, output);
 }
 
 Status Table::Select(const std::function<bool(cylon::Row)> &selector, std::shared_ptr<Table> &out) {
+  // the rows read the first chunk of the columns
+  std::shared_ptr<arrow::Table> table;
+  Status combine_status = CombineTableChunks(ctx, table_, &table);
+  if (!combine_status.is_ok()) {
+	return combine_status;
+  }
   // boolean builder to hold the mask
   arrow::BooleanBuilder boolean_builder(cylon::ToArrowPool(ctx));
   for (int64_t row_index = 0; row_index < Rows(); row_index++) {
-	auto row = cylon::Row(table_, row_index);
+	auto row = cylon::Row(table, row_index);
 	arrow::Status status = boolean_builder.Append(selector(row));
 	if (!status.ok()) {
 	  return Status(UnknownError, status.message());
@@ -644,7 +1577,7 @@ Status Table::Select(const std::function<bool(cylon::Row)> &selector, std::share
   }
   std::shared_ptr<arrow::Table> out_table;
   arrow::compute::FunctionContext func_ctx;
-  status = arrow::compute::Filter(&func_ctx, *table_, *mask, &out_table);
+  status = arrow::compute::Filter(&func_ctx, *table, *mask, &out_table);
   if (!status.ok()) {
     return Status(UnknownError, status.message());
   }
@@ -652,217 +1585,260 @@ Status Table::Select(const std::function<bool(cylon::Row)> &selector, std::share
   return Status::OK();;
 }
 
-Status Table::Union(std::shared_ptr<Table> &first, std::shared_ptr<Table> &second,
-					std::shared_ptr<Table> &out) {
-  std::shared_ptr<arrow::Table> ltab = first->get_table();
-  std::shared_ptr<arrow::Table> rtab = second->get_table();
-  Status status = VerifyTableSchema(ltab, second->get_table());
-  if (!status.is_ok()) return status;
-  std::shared_ptr<arrow::Table> tables[2] = {ltab, second->get_table()};
-  int64_t eq_calls = 0, hash_calls = 0;
-
-  auto row_comp = RowComparator(first->ctx, tables, &eq_calls, &hash_calls);
-  auto buckets_pre_alloc = (ltab->num_rows() + rtab->num_rows());
-  LOG(INFO) << "Buckets : " << buckets_pre_alloc;
-  std::unordered_set<std::pair<int8_t, int64_t>, RowComparator, RowComparator>
-	  rows_set(buckets_pre_alloc, row_comp, row_comp);
-  const int64_t max = std::max(ltab->num_rows(), rtab->num_rows());
-  const int8_t table0 = 0;
-  const int8_t table1 = 1;
-  const int64_t print_threshold = max / 10;
-  for (int64_t row = 0; row < max; ++row) {
-	if (row < ltab->num_rows()) {
-	  rows_set.insert(std::pair<int8_t, int64_t>(table0, row));
+/**
+ * Rows of the two tables of a set operation. The rows are hashed once, column by column, and two
+ * rows are compared column by column only when their hashes are equal.
+ */
+class SetOperationRows {
+ public:
+  explicit SetOperationRows(const std::shared_ptr<arrow::Table> *tables) : tables_(tables) {}
+
+  /**
+   * @param inputs the tables, the cached row hashes of all the columns are reused
+   */
+  Status Init(std::shared_ptr<cylon::Table> *inputs) {
+	std::vector<int> columns;
+	for (int c = 0; c < tables_[0]->num_columns(); c++) {
+	  columns.push_back(c);
+	  auto comparator = GetComparator(tables_[0]->column(c)->type());
+	  if (comparator == nullptr) {
+		return Status(cylon::NotImplemented, "Not implemented or unsupported data type.");
+	  }
+	  comparators_.push_back(comparator);
+	  for (int t = 0; t < 2; t++) {
+		arrays_[t].push_back(tables_[t]->column(c)->chunk(0));
+	  }
 	}
-
-	if (row < rtab->num_rows()) {
-	  rows_set.insert(std::pair<int8_t, int64_t>(table1, row));
+	for (int t = 0; t < 2; t++) {
+	  auto status = inputs[t]->GetRowHashes(columns, &hashes_[t]);
+	  if (!status.is_ok()) {
+		return status;
+	  }
 	}
+	return Status::OK();
+  }
+
+  inline uint64_t Hash(int8_t table, int64_t row) const {
+	return (*hashes_[table])[row];
+  }
 
-	if (row % print_threshold == 0) {
-	  LOG(INFO) << "Done " << (row + 1) * 100 / max << "%" << " N : "
-				<< row << ", Eq : " << eq_calls << ", Hs : "
-				<< hash_calls;
+  inline bool Equal(int8_t table1, int64_t row1, int8_t table2, int64_t row2) const {
+	for (size_t c = 0; c < comparators_.size(); c++) {
+	  const std::shared_ptr<arrow::Array> &array1 = arrays_[table1][c];
+	  const std::shared_ptr<arrow::Array> &array2 = arrays_[table2][c];
+	  // the comparators read the values under the nulls, nulls are equal to each other only
+	  const bool null1 = array1->IsNull(row1);
+	  if (null1 != array2->IsNull(row2)) {
+		return false;
+	  }
+	  if (!null1 && comparators_[c]->compare(array1, row1, array2, row2) != 0) {
+		return false;
+	  }
 	}
+	return true;
   }
 
-  std::shared_ptr<std::vector<int64_t>> indices_from_tabs[2] = {
-	  std::make_shared<std::vector<int64_t>>(),
-	  std::make_shared<std::vector<int64_t>>()
-  };
+ private:
+  const std::shared_ptr<arrow::Table> *tables_;
+  std::vector<std::shared_ptr<ArrowComparator>> comparators_;
+  std::vector<std::shared_ptr<arrow::Array>> arrays_[2];
+  std::shared_ptr<std::vector<uint64_t>> hashes_[2];
+};
 
-  for (auto const &pr : rows_set) {
-	indices_from_tabs[pr.first]->push_back(pr.second);
+/**
+ * Insert the distinct rows of a table to the set
+ */
+void InsertDistinctRows(const SetOperationRows &rows, int8_t table, int64_t num_rows,
+						util::RowHashSet *rows_set) {
+  for (int64_t row = 0; row < num_rows; ++row) {
+	rows_set->Insert(rows.Hash(table, row), table, row,
+					 [&rows, table, row](const util::RowHashSet::Row &existing) {
+					   return rows.Equal(existing.table, existing.row, table, row);
+					 });
+  }
+}
+
+/**
+ * Mark the rows of the set that have an equal row in the table
+ */
+void MarkMatchingRows(const SetOperationRows &rows, int8_t table, int64_t num_rows,
+					  util::RowHashSet *rows_set) {
+  for (int64_t row = 0; row < num_rows; ++row) {
+	util::RowHashSet::Row *match = rows_set->Find(
+		rows.Hash(table, row), [&rows, table, row](const util::RowHashSet::Row &existing) {
+		  return rows.Equal(existing.table, existing.row, table, row);
+		});
+	if (match != nullptr) {
+	  match->marked = true;
+	}
   }
+}
+
+/**
+ * Create the result table of a set operation from the selected rows of the tables
+ */
+Status MakeSetOperationTable(std::shared_ptr<cylon::CylonContext> &ctx,
+							 const std::shared_ptr<arrow::Table> *tables, int num_tables,
+							 std::shared_ptr<std::vector<int64_t>> *indices_from_tabs,
+							 const SetOperationRows &rows,
+							 std::shared_ptr<Table> &out) {
+  auto t1 = std::chrono::steady_clock::now();
   std::vector<std::shared_ptr<arrow::ChunkedArray>> final_data_arrays;
   // prepare final arrays
-  for (int32_t col_idx = 0; col_idx < ltab->num_columns(); col_idx++) {
+  for (int32_t col_idx = 0; col_idx < tables[0]->num_columns(); col_idx++) {
 	arrow::ArrayVector array_vector;
-	for (int tab_idx = 0; tab_idx < 2; tab_idx++) {
-	  status = PrepareArray(first->ctx,
-							tables[tab_idx],
-							col_idx,
-							indices_from_tabs[tab_idx],
-							array_vector);
-
+	for (int tab_idx = 0; tab_idx < num_tables; tab_idx++) {
+	  Status status = PrepareArray(ctx, tables[tab_idx], col_idx, indices_from_tabs[tab_idx],
+								   array_vector);
 	  if (!status.is_ok()) return status;
 	}
 	final_data_arrays.push_back(std::make_shared<arrow::ChunkedArray>(array_vector));
   }
   // create final table
-  std::shared_ptr<arrow::Table> table = arrow::Table::Make(ltab->schema(), final_data_arrays);
-  auto merge_status = table->CombineChunks(cylon::ToArrowPool(first->ctx), &table);
-  if (!merge_status.ok()) {
-	return Status(static_cast<int>(merge_status.code()), merge_status.message());
+  std::shared_ptr<arrow::Table> table = arrow::Table::Make(tables[0]->schema(), final_data_arrays);
+  if (num_tables > 1) {
+	auto merge_status = table->CombineChunks(cylon::ToArrowPool(ctx), &table);
+	if (!merge_status.ok()) {
+	  return Status(static_cast<int>(merge_status.code()), merge_status.message());
+	}
   }
-  out = std::make_shared<cylon::Table>(table, first->ctx);
+  auto t2 = std::chrono::steady_clock::now();
+  LOG(INFO) << "Final array preparation took "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count()
+			<< "ms";
+  out = std::make_shared<cylon::Table>(table, ctx);
+
+  // the hashes of the selected rows, for the next operation on the result
+  auto hashes = std::make_shared<std::vector<uint64_t>>();
+  hashes->reserve(table->num_rows());
+  std::vector<int> columns;
+  for (int c = 0; c < table->num_columns(); c++) {
+	columns.push_back(c);
+  }
+  for (int8_t tab_idx = 0; tab_idx < num_tables; tab_idx++) {
+	for (auto row : *indices_from_tabs[tab_idx]) {
+	  hashes->push_back(rows.Hash(tab_idx, row));
+	}
+  }
+  out->SetRowHashes(columns, hashes);
   return Status::OK();
 }
 
-Status Table::Subtract(std::shared_ptr<Table> &first,
-					   std::shared_ptr<Table> &second, std::shared_ptr<Table> &out) {
-  std::shared_ptr<arrow::Table> ltab = first->get_table();
-  std::shared_ptr<arrow::Table> rtab = second->get_table();
-  Status status = VerifyTableSchema(ltab, rtab);
+Status Table::Union(std::shared_ptr<Table> &first, std::shared_ptr<Table> &second,
+					std::shared_ptr<Table> &out) {
+  std::shared_ptr<arrow::Table> ltab, rtab;
+  Status status = CombineTableChunks(first->ctx, first->get_table(), &ltab);
+  if (status.is_ok()) {
+	status = CombineTableChunks(first->ctx, second->get_table(), &rtab);
+  }
   if (!status.is_ok()) {
 	return status;
   }
+  status = VerifyTableSchema(ltab, rtab);
+  if (!status.is_ok()) return status;
   std::shared_ptr<arrow::Table> tables[2] = {ltab, rtab};
-  int64_t eq_calls = 0, hash_calls = 0;
-  auto row_comp = RowComparator(first->ctx, tables, &eq_calls, &hash_calls);
-  auto buckets_pre_alloc = ltab->num_rows();
-  LOG(INFO) << "Buckets : " << buckets_pre_alloc;
-  std::unordered_set<std::pair<int8_t, int64_t>, RowComparator, RowComparator>
-	  left_row_set(buckets_pre_alloc, row_comp, row_comp);
+
   auto t1 = std::chrono::steady_clock::now();
-  // first populate left table in the hash set
-  int64_t print_offset = ltab->num_rows() / 4, next_print = print_offset;
-  for (int64_t row = 0; row < ltab->num_rows(); ++row) {
-	left_row_set.insert(std::pair<int8_t, int64_t>(0, row));
+  std::shared_ptr<Table> inputs[2] = {first, second};
+  SetOperationRows rows(tables);
+  status = rows.Init(inputs);
+  if (!status.is_ok()) return status;
+  util::RowHashSet rows_set(ltab->num_rows() + rtab->num_rows());
+  InsertDistinctRows(rows, 0, ltab->num_rows(), &rows_set);
+  InsertDistinctRows(rows, 1, rtab->num_rows(), &rows_set);
+  auto t2 = std::chrono::steady_clock::now();
+  LOG(INFO) << "Adding to Set took "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << "ms";
 
-	if (row == next_print) {
-	  LOG(INFO) << "Done " << (row + 1) * 100 / ltab->num_rows() << "%"
-				<< " N : " << row << ", Eq : " << eq_calls
-				<< ", Hs : " << hash_calls;
-	  next_print += print_offset;
-	}
+  std::shared_ptr<std::vector<int64_t>> indices_from_tabs[2] = {
+	  std::make_shared<std::vector<int64_t>>(),
+	  std::make_shared<std::vector<int64_t>>()
+  };
+  for (auto const &row : rows_set.Rows()) {
+	indices_from_tabs[row.table]->push_back(row.row);
   }
-  // then remove matching rows using hash map comparator
-  print_offset = rtab->num_rows() / 4;
-  next_print = print_offset;
-  for (int64_t row = 0; row < rtab->num_rows(); ++row) {
-	// finds a matching row from left and erase it
-	left_row_set.erase(std::pair<int8_t, int64_t>(1, row));
-	if (row == next_print) {
-	  LOG(INFO) << "Done " << (row + 1) * 100 / rtab->num_rows() << "%" << " N : "
-				<< row << ", Eq : " << eq_calls
-				<< ", Hs : " << hash_calls;
-	  next_print += print_offset;
-	}
+  return MakeSetOperationTable(first->ctx, tables, 2, indices_from_tabs, rows, out);
+}
+
+Status Table::Subtract(std::shared_ptr<Table> &first,
+					   std::shared_ptr<Table> &second, std::shared_ptr<Table> &out) {
+  std::shared_ptr<arrow::Table> ltab, rtab;
+  Status status = CombineTableChunks(first->ctx, first->get_table(), &ltab);
+  if (status.is_ok()) {
+	status = CombineTableChunks(first->ctx, second->get_table(), &rtab);
+  }
+  if (!status.is_ok()) {
+	return status;
   }
+  status = VerifyTableSchema(ltab, rtab);
+  if (!status.is_ok()) {
+	return status;
+  }
+  std::shared_ptr<arrow::Table> tables[2] = {ltab, rtab};
 
+  auto t1 = std::chrono::steady_clock::now();
+  std::shared_ptr<Table> inputs[2] = {first, second};
+  SetOperationRows rows(tables);
+  status = rows.Init(inputs);
+  if (!status.is_ok()) {
+	return status;
+  }
+  // the distinct rows of the left table, marking the ones found in the right table
+  util::RowHashSet left_row_set(ltab->num_rows());
+  InsertDistinctRows(rows, 0, ltab->num_rows(), &left_row_set);
+  MarkMatchingRows(rows, 1, rtab->num_rows(), &left_row_set);
   auto t2 = std::chrono::steady_clock::now();
   LOG(INFO) << "Adding to Set took "
 			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << "ms";
+
   std::shared_ptr<std::vector<int64_t>> left_indices = std::make_shared<std::vector<int64_t>>();
-  left_indices->reserve(left_row_set.size());  // reserve space for vec
-  for (auto const &pr : left_row_set) {
-	left_indices->push_back(pr.second);
-  }
-  std::vector<std::shared_ptr<arrow::ChunkedArray>> final_data_arrays;
-  t1 = std::chrono::steady_clock::now();
-  // prepare final arrays
-  for (int32_t col_idx = 0; col_idx < ltab->num_columns(); col_idx++) {
-	arrow::ArrayVector array_vector;
-	status = PrepareArray(first->ctx, ltab, col_idx, left_indices, array_vector);
-	if (!status.is_ok()) {
-	  return status;
+  left_indices->reserve(left_row_set.Rows().size());
+  for (auto const &row : left_row_set.Rows()) {
+	if (!row.marked) {
+	  left_indices->push_back(row.row);
 	}
-	final_data_arrays.push_back(std::make_shared<arrow::ChunkedArray>(array_vector));
   }
-  t2 = std::chrono::steady_clock::now();
-  LOG(INFO) << "Final array preparation took "
-			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count()
-			<< "ms";
-  // create final table
-  std::shared_ptr<arrow::Table> table = arrow::Table::Make(ltab->schema(), final_data_arrays);
-  out = std::make_shared<cylon::Table>(table, first->ctx);
-  return Status::OK();
+  return MakeSetOperationTable(first->ctx, tables, 1, &left_indices, rows, out);
 }
 
 Status Table::Intersect(std::shared_ptr<Table> &first,
 						std::shared_ptr<Table> &second, std::shared_ptr<Table> &out) {
-  std::shared_ptr<arrow::Table> ltab = first->get_table();
-  std::shared_ptr<arrow::Table> rtab = second->get_table();
-  Status status = VerifyTableSchema(ltab, rtab);
+  std::shared_ptr<arrow::Table> ltab, rtab;
+  Status status = CombineTableChunks(first->ctx, first->get_table(), &ltab);
+  if (status.is_ok()) {
+	status = CombineTableChunks(first->ctx, second->get_table(), &rtab);
+  }
+  if (!status.is_ok()) {
+	return status;
+  }
+  status = VerifyTableSchema(ltab, rtab);
   if (!status.is_ok()) {
 	return status;
   }
   std::shared_ptr<arrow::Table> tables[2] = {ltab, rtab};
-  int64_t eq_calls = 0, hash_calls = 0;
-  auto row_comp = RowComparator(first->ctx, tables, &eq_calls, &hash_calls);
-  auto buckets_pre_alloc = (ltab->num_rows() + rtab->num_rows());
-  LOG(INFO) << "Buckets : " << buckets_pre_alloc;
-  std::unordered_set<std::pair<int8_t, int64_t>, RowComparator, RowComparator>
-	  rows_set(buckets_pre_alloc, row_comp, row_comp);
+
   auto t1 = std::chrono::steady_clock::now();
-  // first populate left table in the hash set
-  int64_t print_offset = ltab->num_rows() / 4, next_print = print_offset;
-  for (int64_t row = 0; row < ltab->num_rows(); ++row) {
-	rows_set.insert(std::pair<int8_t, int64_t>(0, row));
-	if (row == next_print) {
-	  LOG(INFO) << "left done " << (row + 1) * 100 / ltab->num_rows() << "%" << " N : "
-				<< row << ", Eq : " << eq_calls
-				<< ", Hs : " << hash_calls;
-	  next_print += print_offset;
-	}
-  }
-
-  std::unordered_set<int64_t> left_indices_set(ltab->num_rows());
-  // then add matching rows to the indices_from_tabs vector
-  print_offset = rtab->num_rows() / 4;
-  next_print = print_offset;
-  for (int64_t row = 0; row < rtab->num_rows(); ++row) {
-	auto matching_row_it = rows_set.find(std::pair<int8_t, int64_t>(1, row));
-	if (matching_row_it != rows_set.end()) {
-	  std::pair<int8_t, int64_t> matching_row = *matching_row_it;
-	  left_indices_set.insert(matching_row.second);
-	}
-	if (row == next_print) {
-	  LOG(INFO) << "right done " << (row + 1) * 100 / rtab->num_rows()
-				<< "%" << " N : " << row << ", Eq : " << eq_calls
-				<< ", Hs : " << hash_calls;
-	  next_print += print_offset;
-	}
-  }
-  // convert set to vector todo: find a better way to do this inplace!
-  std::shared_ptr<std::vector<int64_t>> left_indices = std::make_shared<std::vector<int64_t>>();;
-  left_indices->reserve(left_indices_set.size() / 2);
-  left_indices->assign(left_indices_set.begin(), left_indices_set.end());
-  left_indices->shrink_to_fit();
+  std::shared_ptr<Table> inputs[2] = {first, second};
+  SetOperationRows rows(tables);
+  status = rows.Init(inputs);
+  if (!status.is_ok()) {
+	return status;
+  }
+  // the distinct rows of the left table, marking the ones found in the right table
+  util::RowHashSet left_row_set(ltab->num_rows());
+  InsertDistinctRows(rows, 0, ltab->num_rows(), &left_row_set);
+  MarkMatchingRows(rows, 1, rtab->num_rows(), &left_row_set);
   auto t2 = std::chrono::steady_clock::now();
   LOG(INFO) << "Adding to Set took "
 			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << "ms";
-  std::vector<std::shared_ptr<arrow::ChunkedArray>> final_data_arrays;
-  t1 = std::chrono::steady_clock::now();
-  // prepare final arrays
-  for (int32_t col_idx = 0; col_idx < ltab->num_columns(); col_idx++) {
-	arrow::ArrayVector array_vector;
-	status = PrepareArray(first->ctx, ltab, col_idx, left_indices, array_vector);
-
-	if (!status.is_ok()) return status;
 
-	final_data_arrays.push_back(std::make_shared<arrow::ChunkedArray>(array_vector));
+  std::shared_ptr<std::vector<int64_t>> left_indices = std::make_shared<std::vector<int64_t>>();
+  for (auto const &row : left_row_set.Rows()) {
+	if (row.marked) {
+	  left_indices->push_back(row.row);
+	}
   }
-
-  t2 = std::chrono::steady_clock::now();
-  LOG(INFO) << "Final array preparation took "
-			<< std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count()
-			<< "ms";
-  // create final table
-  std::shared_ptr<arrow::Table> table = arrow::Table::Make(ltab->schema(), final_data_arrays);
-  out = std::make_shared<cylon::Table>(table, first->ctx);
-  return Status::OK();
+  return MakeSetOperationTable(first->ctx, tables, 1, &left_indices, rows, out);
 }
 
 typedef Status
@@ -893,19 +1869,22 @@ Status DoDistributedSetOperation(std::shared_ptr<cylon::CylonContext> &ctx,
 	hash_columns.push_back(kI);
   }
 
+  // the row hashes are sent with the rows, so the local operation does not hash them again
   std::shared_ptr<arrow::Table> left_final_table;
   std::shared_ptr<arrow::Table> right_final_table;
-  auto shuffle_status = ShuffleTwoTables(ctx,
-										 table_left,
-										 hash_columns,
-										 table_right,
-										 hash_columns,
-										 &left_final_table,
-										 &right_final_table);
+  std::shared_ptr<std::vector<uint64_t>> left_hashes, right_hashes;
+  auto shuffle_status = Shuffle(ctx, table_left, hash_columns, ctx->GetNextSequence(),
+								&left_final_table, &left_hashes);
+  if (shuffle_status.is_ok()) {
+	shuffle_status = Shuffle(ctx, table_right, hash_columns, ctx->GetNextSequence(),
+							 &right_final_table, &right_hashes);
+  }
   if (shuffle_status.is_ok()) {
 	std::shared_ptr<cylon::Table> left_tab = std::make_shared<cylon::Table>(left_final_table, ctx);
 	std::shared_ptr<cylon::Table> right_tab = std::make_shared<cylon::Table>(
 		right_final_table, ctx);
+	left_tab->SetRowHashes(hash_columns, left_hashes);
+	right_tab->SetRowHashes(hash_columns, right_hashes);
 	// now do the local union
 	std::shared_ptr<arrow::Table> table;
 	status = local_operation(left_tab, right_tab, out);
@@ -998,6 +1977,19 @@ Status Table::Project(const std::vector<int64_t> &project_columns, std::shared_p
   auto schema = std::make_shared<arrow::Schema>(schema_vector);
   std::shared_ptr<arrow::Table> table = arrow::Table::Make(schema, column_arrays);
   out = std::make_shared<cylon::Table>(table, this->ctx);
+
+  // the rows are the same, so the hashes are valid if all the key columns are projected
+  if (row_hashes_ != nullptr) {
+	std::vector<int> projected_hash_columns;
+	for (auto hash_column : hash_columns_) {
+	  auto it = std::find(project_columns.begin(), project_columns.end(), hash_column);
+	  if (it == project_columns.end()) {
+		return Status::OK();
+	  }
+	  projected_hash_columns.push_back(static_cast<int>(it - project_columns.begin()));
+	}
+	out->SetRowHashes(projected_hash_columns, row_hashes_);
+  }
   return Status::OK();
 }
 
@@ -1081,7 +2073,11 @@ Status Table::Shuffle(std::shared_ptr<cylon::Table> &table,
   std::shared_ptr<arrow::Table> table_out;
   cylon::Status status;
 
-  if (!(status = cylon::Shuffle(ctx_, table, hash_columns, ctx_->GetNextSequence(), &table_out)).is_ok()){
+  // the received partitions can be kept as separate chunks, without copying them
+  const bool combine_chunks =
+      ctx_->GetConfig(CylonContext::SHUFFLE_COMBINE_CHUNKS_CONFIG, "true") == "true";
+  if (!(status = cylon::Shuffle(ctx_, table, hash_columns, ctx_->GetNextSequence(), &table_out,
+                                nullptr, combine_chunks)).is_ok()){
     LOG(FATAL) << "table shuffle failed!";
     return status;
   }
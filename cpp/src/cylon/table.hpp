@@ -27,12 +27,37 @@
 #include "column.hpp"
 #include "join/join_config.hpp"
 #include "arrow/arrow_join.hpp"
+#include "arrow/arrow_normalized_keys.hpp"
 #include "join/join.hpp"
 #include "io/csv_write_config.hpp"
 #include "row.hpp"
 
 namespace cylon {
 
+/**
+ * Skew statistics of a distributed join, filled when skew handling is enabled in the JoinConfig
+ */
+struct JoinSkewStats {
+  // number of heavy hitter keys found by sampling
+  int64_t heavy_keys = 0;
+  // largest estimated fraction of the rows of the split table held by a single key
+  double max_key_share = 0;
+  // local rows of heavy keys spread over several workers
+  int64_t split_rows = 0;
+  // extra local rows sent to replicate heavy keys
+  int64_t replicated_rows = 0;
+};
+
+/**
+ * Bloom filter statistics of a distributed join, filled when the JoinConfig uses a bloom filter
+ */
+struct JoinFilterStats {
+  // local rows of the filtered table before the filter
+  int64_t probe_rows = 0;
+  // local rows the filter removed
+  int64_t filtered_rows = 0;
+};
+
 /**
  * Table provides the main API for using cylon for data processing.
  */
@@ -144,6 +169,48 @@ class Table {
    */
   Status Sort(int sort_column, std::shared_ptr<Table> &output);
 
+  /**
+   * Sort the table by multiple columns (ORDER BY), each ascending or descending with the nulls
+   * first or last. The keys of all the sort columns are sorted at once, this is a local sort.
+   * @param sort_keys sort columns in the order of precedence
+   * @param output new table sorted according to the sort keys
+   * @return
+   */
+  Status Sort(const std::vector<SortKey> &sort_keys, std::shared_ptr<Table> &output);
+
+  /**
+   * Sort the table across all the workers according to the given column. The rows are range
+   * partitioned with splitters picked from samples of the locally sorted tables, so that worker i
+   * holds sorted rows that are smaller or equal to the rows of worker i + 1. Rows with the same
+   * value may be split between adjacent workers to balance duplicate heavy keys.
+   * @param sort_column
+   * @param output the local partition of the sorted table
+   * @return
+   */
+  Status DistributedSort(int sort_column, std::shared_ptr<Table> &output);
+
+  /**
+   * Select the k rows with the smallest (or largest) values of a column, without sorting the
+   * whole table. This is a local operation.
+   * @param column
+   * @param k
+   * @param ascending select the smallest values if true, the largest otherwise
+   * @param output the selected rows in sorted order, nulls come last
+   * @return
+   */
+  Status TopK(int column, int64_t k, bool ascending, std::shared_ptr<Table> &output);
+
+  /**
+   * Select the k rows with the smallest (or largest) values of a column across all the workers.
+   * The top k candidates of each worker are gathered and merged, so every worker gets the result.
+   * @param column
+   * @param k
+   * @param ascending select the smallest values if true, the largest otherwise
+   * @param output the selected rows in sorted order, nulls come last
+   * @return
+   */
+  Status DistributedTopK(int column, int64_t k, bool ascending, std::shared_ptr<Table> &output);
+
   /**
    * Do the join with the right table
    * @param right the right table
@@ -160,11 +227,15 @@ class Table {
    * @param right
    * @param join_config
    * @param output
+   * @param skew_stats skew statistics of the shuffle, can be nullptr
+   * @param filter_stats bloom filter statistics, can be nullptr
    * @return <cylon::Status>
    */
   static Status DistributedJoin(std::shared_ptr<Table> &left, std::shared_ptr<Table> &right,
 								cylon::join::config::JoinConfig join_config,
-								std::shared_ptr<Table> *output);
+								std::shared_ptr<Table> *output,
+								JoinSkewStats *skew_stats = nullptr,
+								JoinFilterStats *filter_stats = nullptr);
 
   /**
    * Performs union with the passed table
@@ -220,6 +291,16 @@ class Table {
   static Status DistributedIntersect(std::shared_ptr<Table> &left, std::shared_ptr<Table> &right,
 									 std::shared_ptr<Table> &out);
 
+  /**
+   * Hash partition the table on the hash columns and send every partition to its worker. The
+   * output is a single chunk table, unless SHUFFLE_COMBINE_CHUNKS_CONFIG of the context is false.
+   * Then it has a chunk for every received partition, and the operations that expect a single
+   * chunk need Merge first
+   * @param table
+   * @param hash_columns
+   * @param output
+   * @return
+   */
   static Status Shuffle(std::shared_ptr<cylon::Table> &table, const std::vector<int> &hash_columns,
                         std::shared_ptr<cylon::Table> &output);
 
@@ -334,6 +415,37 @@ class Table {
    */
   std::vector<std::shared_ptr<cylon::Column>> GetColumns() const;
 
+  /**
+   * Get the hashes of the rows on the given key columns. The hashes are computed once and cached
+   * in the table, so the shuffles, the join filters and the set operations on the same key
+   * columns reuse them. hash % world size is the worker of a row in a hash partition.
+   * @param hash_columns key columns
+   * @param hashes hash of each row
+   * @return
+   */
+  Status GetRowHashes(const std::vector<int> &hash_columns,
+					  std::shared_ptr<std::vector<uint64_t>> *hashes);
+
+  /**
+   * Set the hashes of the rows on the given key columns, for an operator that creates the table
+   * from rows with known hashes
+   * @param hash_columns key columns
+   * @param hashes hash of each row
+   */
+  void SetRowHashes(const std::vector<int> &hash_columns,
+					const std::shared_ptr<std::vector<uint64_t>> &hashes);
+
+  /**
+   * @param hash_columns key columns
+   * @return true if the hashes of the rows on the key columns are cached
+   */
+  bool HasRowHashes(const std::vector<int> &hash_columns) const;
+
+  /**
+   * Drop the cached row hashes
+   */
+  void ClearRowHashes();
+
  private:
   /**
    * Every table should have an unique id
@@ -343,6 +455,9 @@ class Table {
   std::shared_ptr<arrow::Table> table_;
   bool retain_ = true;
   std::vector<std::shared_ptr<cylon::Column>> columns_;
+  // cached hashes of the rows on the hash columns
+  std::vector<int> hash_columns_;
+  std::shared_ptr<std::vector<uint64_t>> row_hashes_;
 };
 }  // namespace cylon
 
@@ -140,19 +140,27 @@ arrow::Status SortColumn(const std::shared_ptr<arrow::Array> &data_column,
 }
 
 arrow::Status SortTable(const std::shared_ptr<arrow::Table> &table, int64_t sort_column_index,
-                        std::shared_ptr<arrow::Table> *sorted_table, arrow::MemoryPool *memory_pool) {
+                        std::shared_ptr<arrow::Table> *sorted_table, arrow::MemoryPool *memory_pool,
+                        cylon::util::ThreadPool *thread_pool) {
   std::shared_ptr<arrow::Table> tab_to_process; // table referenced
-  // combine chunks if multiple chunks are available
-  if (table->column(sort_column_index)->num_chunks() > 1) {
-    arrow::Status left_combine_stat = table->CombineChunks(memory_pool, &tab_to_process);
-  } else {
-    tab_to_process = table;
+  // combine chunks if multiple chunks are available, the other columns are taken from the first
+  // chunk as well
+  tab_to_process = table;
+  for (const auto &column : table->columns()) {
+    if (column->num_chunks() > 1) {
+      arrow::Status combine_status = table->CombineChunks(memory_pool, &tab_to_process);
+      if (!combine_status.ok()) {
+        return combine_status;
+      }
+      break;
+    }
   }
   auto column_to_sort = tab_to_process->column(sort_column_index)->chunk(0);
 
   // sort to indices
   std::shared_ptr<arrow::Array> sorted_column_index;
-  arrow::Status status = cylon::SortIndices(memory_pool, column_to_sort, &sorted_column_index);
+  arrow::Status status = cylon::SortIndices(memory_pool, column_to_sort, &sorted_column_index,
+                                            thread_pool);
   if (!status.ok()) {
     LOG(FATAL) << "Failed to sort column to indices" << status.ToString();
     return status;
@@ -177,6 +185,92 @@ arrow::Status SortTable(const std::shared_ptr<arrow::Table> &table, int64_t sort
   return arrow::Status::OK();
 }
 
+/**
+ * Create a table of the rows at the indices, take keeps the nulls and supports all the column
+ * types
+ */
+static arrow::Status TakeColumns(const std::shared_ptr<arrow::Schema> &schema,
+                                 const std::vector<std::shared_ptr<arrow::Array>> &columns,
+                                 const std::shared_ptr<arrow::Array> &indices,
+                                 std::shared_ptr<arrow::Table> *table_out,
+                                 arrow::MemoryPool *memory_pool) {
+  // the indices are UInt64 arrays of non negative int64 values
+  auto index_lookup = std::make_shared<arrow::Int64Array>(indices->length(),
+                                                          indices->data()->buffers[1]);
+  arrow::compute::FunctionContext function_context(memory_pool);
+  arrow::ArrayVector taken_columns;
+  for (const auto &column : columns) {
+    std::shared_ptr<arrow::Array> taken_array;
+    arrow::Status status = arrow::compute::Take(&function_context, *column, *index_lookup,
+                                                arrow::compute::TakeOptions(), &taken_array);
+    if (!status.ok()) {
+      LOG(ERROR) << "Failed to take the column based on indices. " << status.ToString();
+      return status;
+    }
+    taken_columns.push_back(taken_array);
+  }
+  *table_out = arrow::Table::Make(schema, taken_columns);
+  return arrow::Status::OK();
+}
+
+arrow::Status SortTable(const std::shared_ptr<arrow::Table> &table,
+                        const std::vector<cylon::SortKey> &sort_keys,
+                        std::shared_ptr<arrow::Table> *sorted_table, arrow::MemoryPool *memory_pool,
+                        cylon::util::ThreadPool *thread_pool) {
+  if (table->num_rows() == 0) {
+    *sorted_table = table;
+    return arrow::Status::OK();
+  }
+  std::shared_ptr<arrow::Table> tab_to_process;
+  arrow::Status status = table->CombineChunks(memory_pool, &tab_to_process);
+  if (!status.ok()) {
+    return status;
+  }
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (int64_t col_index = 0; col_index < tab_to_process->num_columns(); ++col_index) {
+    columns.push_back(tab_to_process->column(col_index)->chunk(0));
+  }
+
+  // a single sort of the normalized keys of all the sort columns
+  std::shared_ptr<arrow::Array> sorted_indices;
+  status = cylon::SortIndicesMultiColumns(memory_pool, columns, sort_keys, &sorted_indices,
+                                          thread_pool);
+  if (!status.ok()) {
+    LOG(ERROR) << "Failed to sort the table to indices " << status.ToString();
+    return status;
+  }
+  return TakeColumns(table->schema(), columns, sorted_indices, sorted_table, memory_pool);
+}
+
+arrow::Status TopKTable(const std::shared_ptr<arrow::Table> &table, int64_t column_index,
+                        int64_t k, bool ascending, std::shared_ptr<arrow::Table> *top_k_table,
+                        arrow::MemoryPool *memory_pool) {
+  if (column_index < 0 || column_index >= table->num_columns()) {
+    return arrow::Status::IndexError("Column index out of range: ", column_index);
+  }
+  std::shared_ptr<arrow::Table> tab_to_process;
+  arrow::Status status = table->CombineChunks(memory_pool, &tab_to_process);
+  if (!status.ok()) {
+    return status;
+  }
+  if (tab_to_process->num_rows() == 0) {
+    *top_k_table = tab_to_process;
+    return arrow::Status::OK();
+  }
+  std::vector<std::shared_ptr<arrow::Array>> columns;
+  for (int64_t col_index = 0; col_index < tab_to_process->num_columns(); ++col_index) {
+    columns.push_back(tab_to_process->column(col_index)->chunk(0));
+  }
+
+  std::shared_ptr<arrow::Array> top_k_indices;
+  status = cylon::TopKIndices(memory_pool, columns[column_index], k, ascending, &top_k_indices);
+  if (!status.ok()) {
+    LOG(ERROR) << "Failed to select the top k rows " << status.ToString();
+    return status;
+  }
+  return TakeColumns(table->schema(), columns, top_k_indices, top_k_table, memory_pool);
+}
+
 arrow::Status free_table(const std::shared_ptr<arrow::Table> &table) {
   const int ncolumns = table->num_columns();
   for (int i = 0; i < ncolumns; ++i) {
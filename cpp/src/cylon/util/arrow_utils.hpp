@@ -16,6 +16,8 @@
 #define CYLON_SRC_UTIL_ARROW_UTILS_HPP_
 #include <arrow/table.h>
 #include <arrow/compute/kernel.h>
+#include "thread_pool.hpp"
+#include "../arrow/arrow_normalized_keys.hpp"
 
 namespace cylon {
 namespace util {
@@ -24,6 +26,36 @@ class FunctionContext;
 
 arrow::Status SortTable(const std::shared_ptr<arrow::Table> &table, int64_t sort_column_index,
                         std::shared_ptr<arrow::Table> *sorted_table,
+                        arrow::MemoryPool *memory_pool = arrow::default_memory_pool(),
+                        cylon::util::ThreadPool *thread_pool = nullptr);
+
+/**
+ * Sort a table by multiple columns, each ascending or descending with the nulls first or last
+ * @param table
+ * @param sort_keys sort columns in the order of precedence
+ * @param sorted_table
+ * @param memory_pool
+ * @param thread_pool
+ * @return
+ */
+arrow::Status SortTable(const std::shared_ptr<arrow::Table> &table,
+                        const std::vector<cylon::SortKey> &sort_keys,
+                        std::shared_ptr<arrow::Table> *sorted_table,
+                        arrow::MemoryPool *memory_pool = arrow::default_memory_pool(),
+                        cylon::util::ThreadPool *thread_pool = nullptr);
+
+/**
+ * Select the k rows with the smallest (or largest) values of a column without sorting the table
+ * @param table
+ * @param column_index
+ * @param k
+ * @param ascending the smallest values if true, the largest otherwise
+ * @param top_k_table the selected rows, in sorted order
+ * @param memory_pool
+ * @return
+ */
+arrow::Status TopKTable(const std::shared_ptr<arrow::Table> &table, int64_t column_index,
+                        int64_t k, bool ascending, std::shared_ptr<arrow::Table> *top_k_table,
                         arrow::MemoryPool *memory_pool = arrow::default_memory_pool());
 
 arrow::Status copy_array_by_indices(const std::shared_ptr<std::vector<int64_t>>& indices,
@@ -0,0 +1,102 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_UTIL_BLOOM_FILTER_HPP_
+#define CYLON_CPP_SRC_CYLON_UTIL_BLOOM_FILTER_HPP_
+
+#include <cstdint>
+#include <vector>
+
+namespace cylon {
+namespace util {
+
+/**
+ * Blocked (split block) bloom filter. A key only touches a single 64 byte block, setting one bit
+ * in each of the 8 words of the block, so an insert or a lookup is a single cache miss.
+ *
+ * Filters created with the same number of keys have the same size, so the filters of different
+ * workers can be merged by OR-ing the words.
+ */
+class BlockedBloomFilter {
+ public:
+  /**
+   * @param keys expected number of keys
+   * @param bits_per_key number of bits per key, 10 gives a false positive rate around 1%
+   */
+  explicit BlockedBloomFilter(int64_t keys, int bits_per_key = 10) {
+    uint64_t blocks = 1;
+    while (blocks * kBlockBits < (uint64_t) keys * bits_per_key) {
+      blocks <<= 1;
+    }
+    block_mask_ = blocks - 1;
+    words_.resize(blocks * kBlockWords, 0);
+  }
+
+  /**
+   * Insert a 64 bit hash of a key
+   * @param hash
+   */
+  inline void Insert(uint64_t hash) {
+    uint64_t *block = &words_[((hash >> 32) & block_mask_) * kBlockWords];
+    const auto key = static_cast<uint32_t>(hash);
+    for (int i = 0; i < kBlockWords; i++) {
+      block[i] |= BitMask(key, i);
+    }
+  }
+
+  /**
+   * @param hash 64 bit hash of a key
+   * @return false if the key was never inserted, true if the key was (probably) inserted
+   */
+  inline bool MayContain(uint64_t hash) const {
+    const uint64_t *block = &words_[((hash >> 32) & block_mask_) * kBlockWords];
+    const auto key = static_cast<uint32_t>(hash);
+    for (int i = 0; i < kBlockWords; i++) {
+      if ((block[i] & BitMask(key, i)) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @return the words of the filter, to be merged with the filters of the other workers
+   */
+  std::vector<uint64_t> &Words() {
+    return words_;
+  }
+
+ private:
+  static constexpr int kBlockWords = 8;
+  static constexpr uint64_t kBlockBits = kBlockWords * 64;
+
+  /**
+   * Bit of the i'th word of a block for the key. Every word uses a different odd multiplier, so a
+   * single 32 bit key selects 8 independent bits
+   */
+  static inline uint64_t BitMask(uint32_t key, int i) {
+    static constexpr uint32_t salt[kBlockWords] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU,
+                                                   0xa2b7289dU, 0x705495c7U, 0x2df1424bU,
+                                                   0x9efc4947U, 0x5c6bfb31U};
+    return 1ULL << ((key * salt[i]) >> 26);
+  }
+
+  std::vector<uint64_t> words_;
+  uint64_t block_mask_ = 0;
+};
+
+}  // namespace util
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_UTIL_BLOOM_FILTER_HPP_
@@ -0,0 +1,152 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_UTIL_FLAT_HASH_MULTIMAP_HPP_
+#define CYLON_CPP_SRC_CYLON_UTIL_FLAT_HASH_MULTIMAP_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace cylon {
+namespace util {
+
+/**
+ * Finalizer of murmur3 x64. std::hash is the identity for integers, so the bits are scrambled
+ * before they are used for slots or partitions
+ * @param h hash value
+ * @return mixed hash value
+ */
+inline uint64_t MixHash(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/**
+ * Open addressing (linear probing) multi-map from a key to row indices [0, rows).
+ *
+ * Every distinct key occupies one slot in a flat slot array. The slot holds the first row of
+ * the key and the remaining rows of the same key are chained through a row indexed `next`
+ * array, so the whole map is two allocations regardless of the number of rows.
+ *
+ * @tparam KEY key type
+ * @tparam HASH hash function for the key
+ * @tparam EQUAL key equality function
+ */
+template<typename KEY, typename HASH = std::hash<KEY>, typename EQUAL = std::equal_to<KEY>>
+class FlatHashMultiMap {
+ public:
+  /**
+   * @param rows number of rows that will be inserted. Rows should be in the range [0, rows)
+   */
+  explicit FlatHashMultiMap(int64_t rows) : FlatHashMultiMap(rows, HASH(), EQUAL()) {}
+
+  /**
+   * @param rows number of rows that will be inserted. Rows should be in the range [0, rows)
+   * @param hash hash function instance
+   * @param equal key equality function instance
+   */
+  FlatHashMultiMap(int64_t rows, const HASH &hash, const EQUAL &equal)
+      : next_(rows, -1), hash_(hash), equal_(equal) {
+    // keep the load factor below 0.5
+    uint64_t capacity = 16;
+    while (capacity < (uint64_t) rows * 2) {
+      capacity <<= 1;
+    }
+    mask_ = capacity - 1;
+    slots_.resize(capacity);
+  }
+
+  /**
+   * Insert a row for the key. If rows are inserted in descending order, the chain of a key
+   * will be traversed in ascending row order.
+   * @param key
+   * @param row
+   */
+  inline void Insert(const KEY &key, int64_t row) {
+    uint64_t idx = MixHash(hash_(key)) & mask_;
+    while (true) {
+      Slot &slot = slots_[idx];
+      if (slot.head < 0) {
+        slot.key = key;
+        slot.head = row;
+        keys_++;
+        return;
+      }
+      if (equal_(slot.key, key)) {
+        next_[row] = slot.head;
+        slot.head = row;
+        return;
+      }
+      idx = (idx + 1) & mask_;
+    }
+  }
+
+  /**
+   * Find the first row of a key
+   * @param key
+   * @return first row of the key, or -1 if the key is not present
+   */
+  inline int64_t Find(const KEY &key) const {
+    uint64_t idx = MixHash(hash_(key)) & mask_;
+    while (true) {
+      const Slot &slot = slots_[idx];
+      if (slot.head < 0) {
+        return -1;
+      }
+      if (equal_(slot.key, key)) {
+        return slot.head;
+      }
+      idx = (idx + 1) & mask_;
+    }
+  }
+
+  /**
+   * Next row with the same key
+   * @param row a row returned by Find or Next
+   * @return next row of the key, or -1 at the end of the chain
+   */
+  inline int64_t Next(int64_t row) const {
+    return next_[row];
+  }
+
+  /**
+   * @return number of distinct keys in the map
+   */
+  int64_t Keys() const {
+    return keys_;
+  }
+
+ private:
+  struct Slot {
+    KEY key{};
+    int64_t head = -1;
+  };
+
+  std::vector<Slot> slots_;
+  std::vector<int64_t> next_;
+  uint64_t mask_ = 0;
+  int64_t keys_ = 0;
+  HASH hash_;
+  EQUAL equal_;
+};
+
+}  // namespace util
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_UTIL_FLAT_HASH_MULTIMAP_HPP_
@@ -0,0 +1,363 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "murmur3_batch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "murmur3.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CYLON_MURMUR3_BATCH_X86
+#include <immintrin.h>
+#endif
+
+namespace cylon {
+namespace util {
+
+namespace {
+
+constexpr uint32_t kC1 = 0xcc9e2d51;
+constexpr uint32_t kC2 = 0x1b873593;
+constexpr uint32_t kN = 0xe6546b64;
+
+// number of hashes computed at a time when combining the hashes in to row hashes
+constexpr int64_t kCombineBlock = 1024;
+
+using BatchFunction = void (*)(const uint8_t *, int64_t, int, uint32_t, uint32_t *);
+
+inline uint32_t Rotl32(uint32_t x, int r) {
+  return (x << r) | (x >> (32 - r));
+}
+
+inline uint32_t MixK(uint32_t k) {
+  k *= kC1;
+  k = Rotl32(k, 15);
+  return k * kC2;
+}
+
+inline uint32_t MixH(uint32_t h, uint32_t k) {
+  h ^= MixK(k);
+  h = Rotl32(h, 13);
+  return h * 5 + kN;
+}
+
+inline uint32_t FMix32(uint32_t h, uint32_t len) {
+  h ^= len;
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
+/**
+ * murmur3 x86_32 of a single 1, 2, 4 or 8 byte value, unrolled for the width. The values are read
+ * in the byte order of the machine, same as the reference implementation on little endian CPUs.
+ */
+template<int WIDTH>
+inline uint32_t HashValue(const uint8_t *value, uint32_t seed) {
+  uint32_t h = seed;
+  if (WIDTH == 8) {
+    uint32_t k[2];
+    std::memcpy(k, value, 8);
+    h = MixH(MixH(h, k[0]), k[1]);
+  } else if (WIDTH == 4) {
+    uint32_t k;
+    std::memcpy(&k, value, 4);
+    h = MixH(h, k);
+  } else if (WIDTH == 2) {
+    // the whole value is the tail of the key
+    h ^= MixK(static_cast<uint32_t>(value[1]) << 8 | value[0]);
+  } else {
+    h ^= MixK(value[0]);
+  }
+  return FMix32(h, WIDTH);
+}
+
+template<int WIDTH>
+void ScalarBatch(const uint8_t *values, int64_t length, uint32_t seed, uint32_t *out) {
+  for (int64_t i = 0; i < length; i++) {
+    out[i] = HashValue<WIDTH>(values + i * WIDTH, seed);
+  }
+}
+
+void ScalarBatch(const uint8_t *values, int64_t length, int byte_width, uint32_t seed,
+                 uint32_t *out) {
+  switch (byte_width) {
+    case 1:ScalarBatch<1>(values, length, seed, out);
+      break;
+    case 2:ScalarBatch<2>(values, length, seed, out);
+      break;
+    case 4:ScalarBatch<4>(values, length, seed, out);
+      break;
+    case 8:ScalarBatch<8>(values, length, seed, out);
+      break;
+    default:
+      for (int64_t i = 0; i < length; i++) {
+        MurmurHash3_x86_32(values + i * byte_width, byte_width, seed, &out[i]);
+      }
+  }
+}
+
+#ifdef CYLON_MURMUR3_BATCH_X86
+
+// ---------------------------------------- AVX2, 8 lanes ----------------------------------------
+
+__attribute__((target("avx2")))
+inline __m256i Rotl32x8(__m256i x, int r) {
+  return _mm256_or_si256(_mm256_slli_epi32(x, r), _mm256_srli_epi32(x, 32 - r));
+}
+
+__attribute__((target("avx2")))
+inline __m256i MixKx8(__m256i k) {
+  k = _mm256_mullo_epi32(k, _mm256_set1_epi32(kC1));
+  k = Rotl32x8(k, 15);
+  return _mm256_mullo_epi32(k, _mm256_set1_epi32(kC2));
+}
+
+__attribute__((target("avx2")))
+inline __m256i MixHx8(__m256i h, __m256i k) {
+  h = _mm256_xor_si256(h, MixKx8(k));
+  h = Rotl32x8(h, 13);
+  // h * 5 + n
+  h = _mm256_add_epi32(h, _mm256_slli_epi32(h, 2));
+  return _mm256_add_epi32(h, _mm256_set1_epi32(kN));
+}
+
+__attribute__((target("avx2")))
+inline __m256i FMix32x8(__m256i h, uint32_t len) {
+  h = _mm256_xor_si256(h, _mm256_set1_epi32(len));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(0x85ebca6b));
+  h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+  h = _mm256_mullo_epi32(h, _mm256_set1_epi32(0xc2b2ae35));
+  return _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+}
+
+__attribute__((target("avx2")))
+void Avx2Batch(const uint8_t *values, int64_t length, int byte_width, uint32_t seed,
+               uint32_t *out) {
+  if (byte_width != 1 && byte_width != 2 && byte_width != 4 && byte_width != 8) {
+    ScalarBatch(values, length, byte_width, seed, out);
+    return;
+  }
+  const __m256i seeds = _mm256_set1_epi32(seed);
+  // even 32 bit words first, then the odd ones, in each 128 bit lane
+  const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  const int64_t vectorized = length - length % 8;
+  for (int64_t i = 0; i < vectorized; i += 8) {
+    const uint8_t *v = values + i * byte_width;
+    __m256i h;
+    switch (byte_width) {
+      case 1:
+        h = _mm256_xor_si256(seeds, MixKx8(_mm256_cvtepu8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i *>(v)))));
+        break;
+      case 2:
+        h = _mm256_xor_si256(seeds, MixKx8(_mm256_cvtepu16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(v)))));
+        break;
+      case 4:h = MixHx8(seeds, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(v)));
+        break;
+      default: {
+        __m256i a = _mm256_permutevar8x32_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(v)), deinterleave);
+        __m256i b = _mm256_permutevar8x32_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(v + 32)), deinterleave);
+        __m256i low = _mm256_permute2x128_si256(a, b, 0x20);
+        __m256i high = _mm256_permute2x128_si256(a, b, 0x31);
+        h = MixHx8(MixHx8(seeds, low), high);
+      }
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), FMix32x8(h, byte_width));
+  }
+  ScalarBatch(values + vectorized * byte_width, length - vectorized, byte_width, seed,
+              out + vectorized);
+}
+
+// --------------------------------------- AVX-512, 16 lanes --------------------------------------
+
+// gcc flags the undefined pass through operand of the AVX-512 intrinsics as uninitialized
+#if !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+__attribute__((target("avx512f")))
+inline __m512i MixKx16(__m512i k) {
+  k = _mm512_mullo_epi32(k, _mm512_set1_epi32(kC1));
+  k = _mm512_rol_epi32(k, 15);
+  return _mm512_mullo_epi32(k, _mm512_set1_epi32(kC2));
+}
+
+__attribute__((target("avx512f")))
+inline __m512i MixHx16(__m512i h, __m512i k) {
+  h = _mm512_xor_si512(h, MixKx16(k));
+  h = _mm512_rol_epi32(h, 13);
+  h = _mm512_add_epi32(h, _mm512_slli_epi32(h, 2));
+  return _mm512_add_epi32(h, _mm512_set1_epi32(kN));
+}
+
+__attribute__((target("avx512f")))
+inline __m512i FMix32x16(__m512i h, uint32_t len) {
+  h = _mm512_xor_si512(h, _mm512_set1_epi32(len));
+  h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 16));
+  h = _mm512_mullo_epi32(h, _mm512_set1_epi32(0x85ebca6b));
+  h = _mm512_xor_si512(h, _mm512_srli_epi32(h, 13));
+  h = _mm512_mullo_epi32(h, _mm512_set1_epi32(0xc2b2ae35));
+  return _mm512_xor_si512(h, _mm512_srli_epi32(h, 16));
+}
+
+__attribute__((target("avx512f")))
+void Avx512Batch(const uint8_t *values, int64_t length, int byte_width, uint32_t seed,
+                 uint32_t *out) {
+  if (byte_width != 1 && byte_width != 2 && byte_width != 4 && byte_width != 8) {
+    ScalarBatch(values, length, byte_width, seed, out);
+    return;
+  }
+  const __m512i seeds = _mm512_set1_epi32(seed);
+  const int64_t vectorized = length - length % 16;
+  for (int64_t i = 0; i < vectorized; i += 16) {
+    const uint8_t *v = values + i * byte_width;
+    __m512i h;
+    switch (byte_width) {
+      case 1:
+        h = _mm512_xor_si512(seeds, MixKx16(_mm512_cvtepu8_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(v)))));
+        break;
+      case 2:
+        h = _mm512_xor_si512(seeds, MixKx16(_mm512_cvtepu16_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(v)))));
+        break;
+      case 4:h = MixHx16(seeds, _mm512_loadu_si512(v));
+        break;
+      default: {
+        __m512i a = _mm512_loadu_si512(v);
+        __m512i b = _mm512_loadu_si512(v + 64);
+        // truncating the 64 bit lanes gives the low words, shifting first the high words
+        __m512i low = _mm512_inserti64x4(_mm512_castsi256_si512(_mm512_cvtepi64_epi32(a)),
+                                         _mm512_cvtepi64_epi32(b), 1);
+        __m512i high = _mm512_inserti64x4(
+            _mm512_castsi256_si512(_mm512_cvtepi64_epi32(_mm512_srli_epi64(a, 32))),
+            _mm512_cvtepi64_epi32(_mm512_srli_epi64(b, 32)), 1);
+        h = MixHx16(MixHx16(seeds, low), high);
+      }
+    }
+    _mm512_storeu_si512(out + i, FMix32x16(h, byte_width));
+  }
+  ScalarBatch(values + vectorized * byte_width, length - vectorized, byte_width, seed,
+              out + vectorized);
+}
+
+#if !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif  // CYLON_MURMUR3_BATCH_X86
+
+struct BatchImplementation {
+  BatchFunction function;
+  const char *name;
+};
+
+/**
+ * @return the implementations the CPU supports, the fastest first
+ */
+const std::vector<BatchImplementation> &SupportedBatchImplementations() {
+  static const std::vector<BatchImplementation> implementations = [] {
+    std::vector<BatchImplementation> supported;
+#ifdef CYLON_MURMUR3_BATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      supported.push_back(BatchImplementation{Avx512Batch, "avx512"});
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      supported.push_back(BatchImplementation{Avx2Batch, "avx2"});
+    }
+#endif
+    supported.push_back(BatchImplementation{
+        static_cast<void (*)(const uint8_t *, int64_t, int, uint32_t, uint32_t *)>(ScalarBatch),
+        "scalar"});
+    return supported;
+  }();
+  return implementations;
+}
+
+std::atomic<const BatchImplementation *> &CurrentBatchImplementation() {
+  static std::atomic<const BatchImplementation *> current(&SupportedBatchImplementations()[0]);
+  return current;
+}
+
+const BatchImplementation &GetBatchImplementation() {
+  return *CurrentBatchImplementation().load(std::memory_order_relaxed);
+}
+
+}  // namespace
+
+void MurmurHash3_x86_32_Batch(const uint8_t *values, int64_t length, int byte_width,
+                              uint32_t seed, uint32_t *out) {
+  GetBatchImplementation().function(values, length, byte_width, seed, out);
+}
+
+void MurmurHash3_x86_32_Combine(const uint8_t *values, int64_t length, int byte_width,
+                                const uint8_t *validity, int64_t validity_offset,
+                                uint64_t *row_hashes) {
+  const BatchFunction batch = GetBatchImplementation().function;
+  uint32_t hashes[kCombineBlock];
+  for (int64_t start = 0; start < length; start += kCombineBlock) {
+    const int64_t count = std::min(kCombineBlock, length - start);
+    batch(values + start * byte_width, count, byte_width, 0, hashes);
+    uint64_t *block = row_hashes + start;
+    if (validity == nullptr) {
+      for (int64_t i = 0; i < count; i++) {
+        block[i] = 31 * block[i] + hashes[i];
+      }
+    } else {
+      for (int64_t i = 0; i < count; i++) {
+        const int64_t bit = validity_offset + start + i;
+        const uint64_t valid = (validity[bit >> 3] >> (bit & 7)) & 1;
+        block[i] = 31 * block[i] + (hashes[i] & (0 - valid));
+      }
+    }
+  }
+}
+
+const char *MurmurHash3BatchImplementation() {
+  return GetBatchImplementation().name;
+}
+
+std::vector<std::string> MurmurHash3BatchImplementations() {
+  std::vector<std::string> names;
+  for (const auto &implementation : SupportedBatchImplementations()) {
+    names.emplace_back(implementation.name);
+  }
+  return names;
+}
+
+bool SetMurmurHash3BatchImplementation(const std::string &name) {
+  for (const auto &implementation : SupportedBatchImplementations()) {
+    if (name == implementation.name) {
+      CurrentBatchImplementation().store(&implementation, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace util
+}  // namespace cylon
@@ -0,0 +1,80 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_UTIL_MURMUR3_BATCH_HPP_
+#define CYLON_CPP_SRC_CYLON_UTIL_MURMUR3_BATCH_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cylon {
+namespace util {
+
+/**
+ * Hash a buffer of fixed width values with murmur3 x86_32. The hash of every value is the same as
+ * MurmurHash3_x86_32(value, byte_width, seed), so the batch hashes can be mixed with the hashes
+ * of single values.
+ *
+ * 1, 2, 4 and 8 byte values are hashed 8 (AVX2) or 16 (AVX-512) at a time when the CPU supports
+ * it. The implementation is chosen once at runtime, with a scalar fallback for other CPUs and
+ * other widths.
+ * @param values the values, byte_width bytes each
+ * @param length number of values
+ * @param byte_width
+ * @param seed
+ * @param out hashes, length values
+ */
+void MurmurHash3_x86_32_Batch(const uint8_t *values, int64_t length, int byte_width,
+                              uint32_t seed, uint32_t *out);
+
+/**
+ * Combine the murmur3 x86_32 hashes of a buffer of fixed width values in to row hashes,
+ * row_hashes[i] = 31 * row_hashes[i] + hash(values[i]). This is how the hashes of the key columns
+ * are combined for partitioning. Rows with a 0 bit in the validity bitmap (if given) combine 0.
+ * @param values the values, byte_width bytes each
+ * @param length number of values
+ * @param byte_width
+ * @param validity validity bitmap of the values, can be nullptr
+ * @param validity_offset bit offset of the first value in the validity bitmap
+ * @param row_hashes length row hashes to update
+ */
+void MurmurHash3_x86_32_Combine(const uint8_t *values, int64_t length, int byte_width,
+                                const uint8_t *validity, int64_t validity_offset,
+                                uint64_t *row_hashes);
+
+/**
+ * @return name of the instruction set used by the batch hash kernels, avx512, avx2 or scalar
+ */
+const char *MurmurHash3BatchImplementation();
+
+/**
+ * @return names of the implementations of the batch hash kernels this CPU supports, the fastest
+ * (the one chosen at startup) first
+ */
+std::vector<std::string> MurmurHash3BatchImplementations();
+
+/**
+ * Use the given implementation for the batch hash kernels, so the tests and the benchmarks can
+ * run every implementation the CPU supports. Calls running at the same time may still use the
+ * previous implementation.
+ * @param name one of MurmurHash3BatchImplementations()
+ * @return false if the CPU doesn't support the implementation, it is left unchanged
+ */
+bool SetMurmurHash3BatchImplementation(const std::string &name);
+
+}  // namespace util
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_UTIL_MURMUR3_BATCH_HPP_
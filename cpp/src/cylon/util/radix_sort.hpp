@@ -0,0 +1,272 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_UTIL_RADIX_SORT_HPP_
+#define CYLON_CPP_SRC_CYLON_UTIL_RADIX_SORT_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+namespace cylon {
+namespace util {
+
+/**
+ * Maps a value to an unsigned key of the same width, so that the unsigned order of the keys is
+ * the order of the values
+ */
+template<typename T, typename Enable = void>
+struct RadixKey;
+
+template<typename T>
+struct RadixKey<T, typename std::enable_if<std::is_integral<T>::value
+                                               && std::is_unsigned<T>::value>::type> {
+  using KEY = T;
+  static inline KEY Encode(T value) {
+    return value;
+  }
+  static inline T Decode(KEY key) {
+    return key;
+  }
+};
+
+/**
+ * Signed integers flip the sign bit, so negative values come before the positive values
+ */
+template<typename T>
+struct RadixKey<T, typename std::enable_if<std::is_integral<T>::value
+                                               && std::is_signed<T>::value>::type> {
+  using KEY = typename std::make_unsigned<T>::type;
+  static constexpr KEY kSignBit = static_cast<KEY>(KEY(1) << (sizeof(KEY) * 8 - 1));
+  static inline KEY Encode(T value) {
+    return static_cast<KEY>(static_cast<KEY>(value) ^ kSignBit);
+  }
+  static inline T Decode(KEY key) {
+    return static_cast<T>(static_cast<KEY>(key ^ kSignBit));
+  }
+};
+
+/**
+ * Floating point values flip the sign bit of positive values and all the bits of negative values,
+ * so larger negative magnitudes come first
+ */
+template<typename T>
+struct RadixKey<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+  using KEY = typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type;
+  static constexpr KEY kSignBit = static_cast<KEY>(KEY(1) << (sizeof(KEY) * 8 - 1));
+  static inline KEY Encode(T value) {
+    KEY bits;
+    std::memcpy(&bits, &value, sizeof(KEY));
+    return (bits & kSignBit) ? static_cast<KEY>(~bits) : static_cast<KEY>(bits ^ kSignBit);
+  }
+  static inline T Decode(KEY key) {
+    KEY bits = (key & kSignBit) ? static_cast<KEY>(key ^ kSignBit) : static_cast<KEY>(~key);
+    T value;
+    std::memcpy(&value, &bits, sizeof(KEY));
+    return value;
+  }
+};
+
+/**
+ * Stable LSD radix sort of the keys and indices in [begin, end), one byte per pass, for the bytes
+ * below max_pass. The sorted keys and indices are left in keys and indices; tmp_keys and
+ * tmp_indices are scratch space of the same range.
+ */
+template<typename KEY>
+void LsdRadixSortRange(KEY *keys, int64_t *indices, KEY *tmp_keys, int64_t *tmp_indices,
+                       int64_t begin, int64_t end, int max_pass) {
+  constexpr int kBuckets = 256;
+  const int64_t length = end - begin;
+  if (length <= 32) {
+    // insertion sort is faster for tiny ranges and is stable as well
+    for (int64_t i = begin + 1; i < end; i++) {
+      KEY key = keys[i];
+      int64_t index = indices[i];
+      int64_t j = i;
+      for (; j > begin && keys[j - 1] > key; j--) {
+        keys[j] = keys[j - 1];
+        indices[j] = indices[j - 1];
+      }
+      keys[j] = key;
+      indices[j] = index;
+    }
+    return;
+  }
+
+  // counts[pass][digit] of all the passes with a single read of the keys
+  std::vector<int64_t> counts(max_pass * kBuckets, 0);
+  for (int64_t i = begin; i < end; i++) {
+    for (int pass = 0; pass < max_pass; pass++) {
+      counts[pass * kBuckets + ((keys[i] >> (pass * 8)) & 0xFF)]++;
+    }
+  }
+
+  KEY *src_keys = keys, *dst_keys = tmp_keys;
+  int64_t *src_indices = indices, *dst_indices = tmp_indices;
+  int64_t offsets[kBuckets];
+  for (int pass = 0; pass < max_pass; pass++) {
+    const int64_t *pass_counts = &counts[pass * kBuckets];
+    // skip the pass if every key has the same digit
+    if (std::find(pass_counts, pass_counts + kBuckets, length) != pass_counts + kBuckets) {
+      continue;
+    }
+    int64_t offset = begin;
+    for (int digit = 0; digit < kBuckets; digit++) {
+      offsets[digit] = offset;
+      offset += pass_counts[digit];
+    }
+    const int shift = pass * 8;
+    for (int64_t i = begin; i < end; i++) {
+      int64_t pos = offsets[(src_keys[i] >> shift) & 0xFF]++;
+      dst_keys[pos] = src_keys[i];
+      dst_indices[pos] = src_indices[i];
+    }
+    std::swap(src_keys, dst_keys);
+    std::swap(src_indices, dst_indices);
+  }
+  if (src_keys != keys) {
+    std::copy(src_keys + begin, src_keys + end, keys + begin);
+    std::copy(src_indices + begin, src_indices + end, indices + begin);
+  }
+}
+
+/**
+ * Stable radix sort of the indices of a value array.
+ *
+ * The values are encoded to unsigned keys and a single read counts the digits of every byte. The
+ * keys are first scattered by the most significant byte that is not the same for all the keys
+ * (MSD pass), and then every bucket is sorted on the lower bytes with an LSD radix sort. The
+ * buckets are small enough to stay in the cache, and with a thread pool the MSD pass is split
+ * into blocks with a histogram each and the buckets are sorted in parallel.
+ *
+ * @tparam T integer or floating point value type
+ * @param values values to sort
+ * @param length number of values
+ * @param indices output, indices of the values in sorted order
+ * @param sorted_values output, the sorted values. Can be nullptr or values itself
+ * @param thread_pool thread pool, can be nullptr
+ */
+template<typename T>
+void RadixSortIndices(const T *values, int64_t length, int64_t *indices,
+                      T *sorted_values = nullptr, ThreadPool *thread_pool = nullptr) {
+  using KEY = typename RadixKey<T>::KEY;
+  constexpr int kPasses = sizeof(KEY);
+  constexpr int kBuckets = 256;
+  // smallest block of keys worth a task
+  constexpr int64_t kBlockRows = 1 << 16;
+
+  int64_t blocks = 1;
+  if (thread_pool != nullptr && thread_pool->GetThreads() > 1) {
+    blocks = std::max<int64_t>(1, std::min<int64_t>(thread_pool->GetThreads(),
+                                                    length / kBlockRows));
+  }
+  auto parallel_for = [&](int64_t tasks, const std::function<void(int64_t)> &fn) {
+    if (blocks > 1) {
+      thread_pool->ParallelFor(tasks, fn);
+    } else {
+      for (int64_t i = 0; i < tasks; i++) {
+        fn(i);
+      }
+    }
+  };
+  auto block_start = [&](int64_t block) {
+    return length * block / blocks;
+  };
+
+  std::vector<KEY> keys(length), tmp_keys(length);
+  std::vector<int64_t> tmp_indices(length);
+  // counts of the most significant byte, counts[block][digit]
+  std::vector<int64_t> counts(blocks * kBuckets, 0);
+  // OR and AND of the keys of each block, the bits that differ between the keys are OR ^ AND
+  std::vector<KEY> block_or(blocks, 0), block_and(blocks, static_cast<KEY>(~KEY(0)));
+
+  // the keys are encoded to the scratch space, and the MSD pass scatters them to the output
+  parallel_for(blocks, [&](int64_t block) {
+    KEY key_or = 0, key_and = static_cast<KEY>(~KEY(0));
+    for (int64_t i = block_start(block); i < block_start(block + 1); i++) {
+      KEY key = RadixKey<T>::Encode(values[i]);
+      tmp_keys[i] = key;
+      tmp_indices[i] = i;
+      key_or |= key;
+      key_and &= key;
+    }
+    block_or[block] = key_or;
+    block_and[block] = key_and;
+  });
+  KEY key_or = 0, key_and = static_cast<KEY>(~KEY(0));
+  for (int64_t block = 0; block < blocks; block++) {
+    key_or |= block_or[block];
+    key_and &= block_and[block];
+  }
+  const KEY diff = key_or ^ key_and;
+  int msd_pass = kPasses - 1;
+  while (msd_pass >= 0 && ((diff >> (msd_pass * 8)) & 0xFF) == 0) {
+    msd_pass--;
+  }
+
+  if (msd_pass >= 0) {
+    const int shift = msd_pass * 8;
+    parallel_for(blocks, [&](int64_t block) {
+      int64_t *block_counts = &counts[block * kBuckets];
+      for (int64_t i = block_start(block); i < block_start(block + 1); i++) {
+        block_counts[(tmp_keys[i] >> shift) & 0xFF]++;
+      }
+    });
+    // bucket boundaries, and the offset of each block in each bucket for a stable scatter
+    std::vector<int64_t> offsets(blocks * kBuckets);
+    std::vector<int64_t> bucket_start(kBuckets + 1, 0);
+    int64_t offset = 0;
+    for (int digit = 0; digit < kBuckets; digit++) {
+      bucket_start[digit] = offset;
+      for (int64_t block = 0; block < blocks; block++) {
+        offsets[block * kBuckets + digit] = offset;
+        offset += counts[block * kBuckets + digit];
+      }
+    }
+    bucket_start[kBuckets] = offset;
+
+    parallel_for(blocks, [&](int64_t block) {
+      int64_t *block_offsets = &offsets[block * kBuckets];
+      for (int64_t i = block_start(block); i < block_start(block + 1); i++) {
+        int64_t pos = block_offsets[(tmp_keys[i] >> shift) & 0xFF]++;
+        keys[pos] = tmp_keys[i];
+        indices[pos] = tmp_indices[i];
+      }
+    });
+
+    parallel_for(kBuckets, [&](int64_t digit) {
+      LsdRadixSortRange(keys.data(), indices, tmp_keys.data(), tmp_indices.data(),
+                        bucket_start[digit], bucket_start[digit + 1], msd_pass);
+    });
+  } else {
+    // all the keys are equal
+    std::copy(tmp_keys.begin(), tmp_keys.end(), keys.begin());
+    std::copy(tmp_indices.begin(), tmp_indices.end(), indices);
+  }
+
+  if (sorted_values != nullptr) {
+    for (int64_t i = 0; i < length; i++) {
+      sorted_values[i] = RadixKey<T>::Decode(keys[i]);
+    }
+  }
+}
+
+}  // namespace util
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_UTIL_RADIX_SORT_HPP_
@@ -0,0 +1,126 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_UTIL_ROW_HASH_SET_HPP_
+#define CYLON_CPP_SRC_CYLON_UTIL_ROW_HASH_SET_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "flat_hash_multimap.hpp"
+
+namespace cylon {
+namespace util {
+
+/**
+ * Open addressing (linear probing) set of distinct rows of one or more tables.
+ *
+ * The rows are hashed up front, and a slot keeps the hash next to the row so that probing only
+ * compares the hashes. The rows themselves are compared (by the caller supplied equality) only
+ * when two hashes are equal. The rows are kept in insertion order, each with a mark that the
+ * set operations use to flag rows found in another table.
+ */
+class RowHashSet {
+ public:
+  struct Row {
+    int64_t row;
+    int8_t table;
+    bool marked;
+  };
+
+  /**
+   * @param rows maximum number of rows that will be inserted
+   */
+  explicit RowHashSet(int64_t rows) {
+    // keep the load factor below 0.5
+    uint64_t capacity = 16;
+    while (capacity < (uint64_t) rows * 2) {
+      capacity <<= 1;
+    }
+    mask_ = capacity - 1;
+    slots_.resize(capacity);
+    rows_.reserve(rows);
+  }
+
+  /**
+   * Insert a row if an equal row is not in the set
+   * @tparam EQUAL bool(const Row &) returning true if the row in the set equals the inserted row
+   * @param hash hash of the row
+   * @param table table of the row
+   * @param row
+   * @param equal
+   * @return true if the row was inserted, false if an equal row is already in the set
+   */
+  template<typename EQUAL>
+  inline bool Insert(uint64_t hash, int8_t table, int64_t row, const EQUAL &equal) {
+    uint64_t idx = MixHash(hash) & mask_;
+    while (true) {
+      Slot &slot = slots_[idx];
+      if (slot.index < 0) {
+        slot.hash = hash;
+        slot.index = static_cast<int64_t>(rows_.size());
+        rows_.push_back(Row{row, table, false});
+        return true;
+      }
+      if (slot.hash == hash && equal(rows_[slot.index])) {
+        return false;
+      }
+      idx = (idx + 1) & mask_;
+    }
+  }
+
+  /**
+   * Find a row equal to the given row
+   * @tparam EQUAL bool(const Row &) returning true if the row in the set equals the given row
+   * @param hash hash of the row
+   * @param equal
+   * @return the equal row in the set, or nullptr
+   */
+  template<typename EQUAL>
+  inline Row *Find(uint64_t hash, const EQUAL &equal) {
+    uint64_t idx = MixHash(hash) & mask_;
+    while (true) {
+      const Slot &slot = slots_[idx];
+      if (slot.index < 0) {
+        return nullptr;
+      }
+      if (slot.hash == hash && equal(rows_[slot.index])) {
+        return &rows_[slot.index];
+      }
+      idx = (idx + 1) & mask_;
+    }
+  }
+
+  /**
+   * @return the distinct rows in insertion order
+   */
+  const std::vector<Row> &Rows() const {
+    return rows_;
+  }
+
+ private:
+  struct Slot {
+    uint64_t hash = 0;
+    int64_t index = -1;
+  };
+
+  std::vector<Slot> slots_;
+  std::vector<Row> rows_;
+  uint64_t mask_ = 0;
+};
+
+}  // namespace util
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_UTIL_ROW_HASH_SET_HPP_
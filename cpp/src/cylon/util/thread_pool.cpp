@@ -0,0 +1,121 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_pool.hpp"
+
+namespace cylon {
+namespace util {
+
+ThreadPool::ThreadPool(int threads) : threads_(threads > 1 ? threads : 1) {
+  if (threads_ <= 1) {
+    return;
+  }
+  for (int i = 0; i < threads_; i++) {
+    workers_.emplace_back(new Worker());
+  }
+  for (int i = 0; i < threads_; i++) {
+    threads_list_.emplace_back(&ThreadPool::Run, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(wait_mutex_);
+    stop_ = true;
+  }
+  wait_cv_.notify_all();
+  for (auto &t : threads_list_) {
+    t.join();
+  }
+}
+
+int ThreadPool::GetThreads() const {
+  return threads_;
+}
+
+bool ThreadPool::Pop(int worker, std::function<void()> &task) {
+  {
+    Worker &own = *workers_[worker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      queued_--;
+      return true;
+    }
+  }
+  // steal from the other workers
+  for (int i = 1; i < threads_; i++) {
+    Worker &victim = *workers_[(worker + i) % threads_];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      queued_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::Run(int worker) {
+  std::function<void()> task;
+  while (true) {
+    if (Pop(worker, task)) {
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    wait_cv_.wait(lock, [this] { return stop_ || queued_ > 0; });
+    if (stop_ && queued_ == 0) {
+      return;
+    }
+  }
+}
+
+void ThreadPool::ParallelFor(int64_t tasks, const std::function<void(int64_t)> &fn) {
+  if (threads_ <= 1 || tasks <= 1) {
+    for (int64_t i = 0; i < tasks; i++) {
+      fn(i);
+    }
+    return;
+  }
+
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+  int64_t remaining = tasks;
+
+  for (int64_t i = 0; i < tasks; i++) {
+    Worker &worker = *workers_[i % threads_];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks.emplace_back([&fn, i, &done_mutex, &done_cv, &remaining] {
+      fn(i);
+      std::lock_guard<std::mutex> done_lock(done_mutex);
+      if (--remaining == 0) {
+        done_cv.notify_one();
+      }
+    });
+  }
+  {
+    std::lock_guard<std::mutex> lock(wait_mutex_);
+    queued_ += tasks;
+  }
+  wait_cv_.notify_all();
+
+  std::unique_lock<std::mutex> lock(done_mutex);
+  done_cv.wait(lock, [&remaining] { return remaining == 0; });
+}
+
+}  // namespace util
+}  // namespace cylon
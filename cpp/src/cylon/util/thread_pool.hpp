@@ -0,0 +1,107 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CYLON_CPP_SRC_CYLON_UTIL_THREAD_POOL_HPP_
+#define CYLON_CPP_SRC_CYLON_UTIL_THREAD_POOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cylon {
+namespace util {
+
+/**
+ * Work stealing thread pool. Every worker has its own task deque; a worker pops tasks from the
+ * back of its own deque and steals from the front of the others when it runs out of work.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @param threads number of worker threads. No threads are started if this is <= 1 and the
+   * tasks are run by the calling thread
+   */
+  explicit ThreadPool(int threads);
+
+  virtual ~ThreadPool();
+
+  /**
+   * @return number of threads used to run the tasks
+   */
+  int GetThreads() const;
+
+  /**
+   * Run fn(task) for task in [0, tasks) and wait for all of them to complete. This should not be
+   * called from a task of the same pool.
+   * @param tasks number of tasks
+   * @param fn task function
+   */
+  void ParallelFor(int64_t tasks, const std::function<void(int64_t)> &fn);
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void Run(int worker);
+
+  bool Pop(int worker, std::function<void()> &task);
+
+  int threads_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_list_;
+  std::mutex wait_mutex_;
+  std::condition_variable wait_cv_;
+  std::atomic<int64_t> queued_{0};
+  bool stop_ = false;
+};
+
+/**
+ * Concatenate the parts to the end of the output vector. Every part is copied to its own range
+ * of the output, so the parts are copied in parallel without any locking.
+ * @param thread_pool thread pool, can be nullptr
+ * @param parts
+ * @param out
+ */
+template<typename T>
+void ParallelConcat(ThreadPool *thread_pool, const std::vector<std::vector<T>> &parts,
+                    std::vector<T> &out) {
+  std::vector<size_t> offsets(parts.size() + 1, out.size());
+  for (size_t i = 0; i < parts.size(); i++) {
+    offsets[i + 1] = offsets[i] + parts[i].size();
+  }
+  out.resize(offsets.back());
+  auto copy = [&](int64_t i) {
+    std::copy(parts[i].begin(), parts[i].end(), out.begin() + offsets[i]);
+  };
+  if (thread_pool == nullptr) {
+    for (size_t i = 0; i < parts.size(); i++) {
+      copy(i);
+    }
+  } else {
+    thread_pool->ParallelFor(parts.size(), copy);
+  }
+}
+
+}  // namespace util
+}  // namespace cylon
+
+#endif //CYLON_CPP_SRC_CYLON_UTIL_THREAD_POOL_HPP_
@@ -0,0 +1,98 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+#include <arrow/api.h>
+#include <chrono>
+#include <random>
+#include <iostream>
+
+#include <arrow/arrow_hash_kernels.hpp>
+#include <join/join_config.hpp>
+#include <util/thread_pool.hpp>
+
+/**
+ * Micro benchmark of the hash join kernels. Compares the open addressing kernel and the radix
+ * partitioned kernel against the std::unordered_multimap based kernel for all the join types.
+ *
+ * hash_join_kernel_benchmark_example <rows> <duplication factor> [threads]
+ */
+
+void create_int64_array(uint64_t count, double dup, std::mt19937_64 &gen,
+                        std::shared_ptr<arrow::Array> &out) {
+  arrow::Int64Builder builder(arrow::default_memory_pool());
+  std::uniform_int_distribution<int64_t> distrib(0, (int64_t) (count * dup));
+
+  arrow::Status st = builder.Reserve(count);
+  for (uint64_t i = 0; i < count; i++) {
+    builder.UnsafeAppend(distrib(gen));
+  }
+  st = builder.Finish(&out);
+}
+
+template<typename KERNEL>
+int64_t run_kernel(const std::string &name,
+                   const std::shared_ptr<arrow::Array> &left,
+                   const std::shared_ptr<arrow::Array> &right,
+                   cylon::join::config::JoinType type,
+                   KERNEL &&kernel) {
+  auto left_indices = std::make_shared<std::vector<int64_t>>();
+  auto right_indices = std::make_shared<std::vector<int64_t>>();
+
+  auto t1 = std::chrono::steady_clock::now();
+  kernel.IdxHashJoin(left, right, type, left_indices, right_indices);
+  auto t2 = std::chrono::steady_clock::now();
+
+  std::cout << name << " type " << type << " rows " << left_indices->size()
+            << " time " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count()
+            << "[ms]" << std::endl;
+  return left_indices->size();
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    LOG(ERROR) << "There should be 2 args. count, duplication factor";
+    return 1;
+  }
+
+  uint64_t count = std::stoull(argv[1]);
+  double dup = std::stod(argv[2]);
+  int threads = argc > 3 ? std::stoi(argv[3]) : 1;
+  cylon::util::ThreadPool thread_pool(threads);
+
+  std::random_device rd;
+  std::mt19937_64 gen(rd());
+  std::shared_ptr<arrow::Array> left, right;
+  create_int64_array(count, dup, gen, left);
+  create_int64_array(count, dup, gen, right);
+
+  std::cout << "#### lines " << count << " dup " << dup << " threads " << threads << std::endl;
+
+  for (auto type : {cylon::join::config::JoinType::INNER, cylon::join::config::JoinType::LEFT,
+                    cylon::join::config::JoinType::RIGHT,
+                    cylon::join::config::JoinType::FULL_OUTER}) {
+    int64_t flat = run_kernel("flat_hash", left, right, type,
+        cylon::ArrowArrayIdxHashJoinKernel<arrow::Int64Array, int64_t>(&thread_pool));
+    int64_t radix = run_kernel("radix_hash", left, right, type,
+        cylon::ArrowArrayRadixHashJoinKernel<arrow::Int64Array, int64_t>(&thread_pool));
+    int64_t multimap = run_kernel("unordered_multimap", left, right, type,
+        cylon::ArrowArrayIdxMultiMapHashJoinKernel<arrow::Int64Array, int64_t>());
+    if (flat != multimap || radix != multimap) {
+      LOG(ERROR) << "result mismatch for join type " << type << " " << flat << " " << radix
+                 << " != " << multimap;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <vector>
+
+#include <util/murmur3.hpp>
+#include <util/murmur3_batch.hpp>
+
+/**
+ * Micro benchmark of the batch murmur3 hash kernels. Hashes a buffer of 1, 2, 4 and 8 byte values
+ * on a single core, one value at a time with MurmurHash3_x86_32 and a buffer at a time with
+ * MurmurHash3_x86_32_Batch and MurmurHash3_x86_32_Combine, and prints the throughput in GB/s.
+ *
+ * hash_kernel_benchmark_example <values> [iterations]
+ */
+
+double gb_per_second(int64_t bytes, int iterations, std::chrono::steady_clock::time_point start) {
+  double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(
+      std::chrono::steady_clock::now() - start).count();
+  return bytes * static_cast<double>(iterations) / seconds / 1e9;
+}
+
+bool run(int byte_width, const std::vector<uint8_t> &buffer, int64_t count, int iterations) {
+  const uint8_t *values = buffer.data();
+  const int64_t bytes = count * byte_width;
+  std::vector<uint32_t> scalar(count), batch(count);
+  std::vector<uint64_t> row_hashes(count, 1);
+
+  auto t1 = std::chrono::steady_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    for (int64_t i = 0; i < count; i++) {
+      cylon::util::MurmurHash3_x86_32(values + i * byte_width, byte_width, 0, &scalar[i]);
+    }
+  }
+  double scalar_rate = gb_per_second(bytes, iterations, t1);
+
+  t1 = std::chrono::steady_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    cylon::util::MurmurHash3_x86_32_Batch(values, count, byte_width, 0, batch.data());
+  }
+  double batch_rate = gb_per_second(bytes, iterations, t1);
+
+  t1 = std::chrono::steady_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    cylon::util::MurmurHash3_x86_32_Combine(values, count, byte_width, nullptr, 0,
+                                            row_hashes.data());
+  }
+  double combine_rate = gb_per_second(bytes, iterations, t1);
+
+  std::cout << byte_width << " byte values scalar " << scalar_rate << " GB/s batch "
+            << batch_rate << " GB/s combine " << combine_rate << " GB/s" << std::endl;
+  for (int64_t i = 0; i < count; i++) {
+    if (scalar[i] != batch[i]) {
+      LOG(ERROR) << byte_width << " byte batch hash mismatch at " << i;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    LOG(ERROR) << "There should be at least 1 arg. count";
+    return 1;
+  }
+
+  int64_t count = std::stoll(argv[1]);
+  int iterations = argc > 2 ? std::stoi(argv[2]) : 10;
+
+  std::mt19937_64 gen(std::random_device{}());
+  std::vector<uint8_t> buffer(count * 8);
+  for (auto &b : buffer) {
+    b = static_cast<uint8_t>(gen());
+  }
+  std::cout << "#### values " << count << " iterations " << iterations << " kernel "
+            << cylon::util::MurmurHash3BatchImplementation() << std::endl;
+
+  bool ok = true;
+  for (int byte_width : {1, 2, 4, 8}) {
+    ok = ok && run(byte_width, buffer, count, iterations);
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+#include <arrow/api.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <iostream>
+
+#include <arrow/arrow_kernels.hpp>
+#include <util/sort.hpp>
+#include <util/thread_pool.hpp>
+
+/**
+ * Micro benchmark of the numeric sort kernels. Compares the radix sort used by SortIndices and
+ * SortIndicesInPlace with the comparison sorts they used before, std::sort on the indices and
+ * the in place quicksort.
+ *
+ * sort_kernel_benchmark_example <rows> [threads]
+ */
+
+template<typename BUILDER, typename DIST>
+void create_array(uint64_t count, DIST &&distrib, std::mt19937_64 &gen,
+                  std::shared_ptr<arrow::Array> &out) {
+  BUILDER builder(arrow::default_memory_pool());
+  arrow::Status st = builder.Reserve(count);
+  for (uint64_t i = 0; i < count; i++) {
+    builder.UnsafeAppend(distrib(gen));
+  }
+  st = builder.Finish(&out);
+}
+
+int64_t elapsed(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename TYPE>
+bool run(const std::string &name, const std::shared_ptr<arrow::Array> &values,
+         cylon::util::ThreadPool *thread_pool) {
+  using T = typename TYPE::c_type;
+  auto array = std::static_pointer_cast<arrow::NumericArray<TYPE>>(values);
+  const T *data = array->raw_values();
+  int64_t length = values->length();
+
+  // indices
+  auto t1 = std::chrono::steady_clock::now();
+  std::shared_ptr<arrow::Array> radix_indices;
+  arrow::Status st = cylon::SortIndices(arrow::default_memory_pool(), values, &radix_indices,
+                                        thread_pool);
+  int64_t radix_time = elapsed(t1);
+
+  t1 = std::chrono::steady_clock::now();
+  std::vector<int64_t> indices(length);
+  for (int64_t i = 0; i < length; i++) {
+    indices[i] = i;
+  }
+  std::sort(indices.begin(), indices.end(), [data](int64_t left, int64_t right) {
+    return data[left] < data[right];
+  });
+  int64_t std_sort_time = elapsed(t1);
+
+  std::cout << name << " indices radix " << radix_time << "[ms] std::sort " << std_sort_time
+            << "[ms]" << std::endl;
+  auto sorted = std::static_pointer_cast<arrow::UInt64Array>(radix_indices);
+  for (int64_t i = 0; i < length; i++) {
+    if (data[sorted->Value(i)] != data[indices[i]]) {
+      LOG(ERROR) << name << " sort indices mismatch at " << i;
+      return false;
+    }
+  }
+
+  // in place
+  std::shared_ptr<arrow::Array> radix_copy, quicksort_copy;
+  st = arrow::Concatenate({values}, arrow::default_memory_pool(), &radix_copy);
+  st = arrow::Concatenate({values}, arrow::default_memory_pool(), &quicksort_copy);
+  t1 = std::chrono::steady_clock::now();
+  std::shared_ptr<arrow::UInt64Array> inplace_indices;
+  st = cylon::SortIndicesInPlace(arrow::default_memory_pool(), radix_copy, &inplace_indices,
+                                 thread_pool);
+  radix_time = elapsed(t1);
+
+  T *quicksort_data = quicksort_copy->data()->GetMutableValues<T>(1);
+  t1 = std::chrono::steady_clock::now();
+  cylon::util::quicksort(quicksort_data, 0, length, indices.data());
+  int64_t quicksort_time = elapsed(t1);
+
+  std::cout << name << " in place radix " << radix_time << "[ms] quicksort " << quicksort_time
+            << "[ms]" << std::endl;
+  const T *radix_data = std::static_pointer_cast<arrow::NumericArray<TYPE>>(radix_copy)
+      ->raw_values();
+  for (int64_t i = 0; i < length; i++) {
+    if (radix_data[i] != quicksort_data[i]) {
+      LOG(ERROR) << name << " in place sort mismatch at " << i;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    LOG(ERROR) << "There should be at least 1 arg. count";
+    return 1;
+  }
+
+  uint64_t count = std::stoull(argv[1]);
+  int threads = argc > 2 ? std::stoi(argv[2]) : 1;
+  cylon::util::ThreadPool thread_pool(threads);
+
+  std::random_device rd;
+  std::mt19937_64 gen(rd());
+  std::cout << "#### lines " << count << " threads " << threads << std::endl;
+
+  std::shared_ptr<arrow::Array> int64_values, int32_values, double_values;
+  create_array<arrow::Int64Builder>(count, std::uniform_int_distribution<int64_t>(), gen,
+                                    int64_values);
+  create_array<arrow::Int32Builder>(count, std::uniform_int_distribution<int32_t>(), gen,
+                                    int32_values);
+  create_array<arrow::DoubleBuilder>(count, std::normal_distribution<double>(0, 1e6), gen,
+                                     double_values);
+
+  bool ok = run<arrow::Int64Type>("int64", int64_values, &thread_pool)
+      && run<arrow::Int32Type>("int32", int32_values, &thread_pool)
+      && run<arrow::DoubleType>("double", double_values, &thread_pool);
+  return ok ? 0 : 1;
+}
@@ -73,7 +73,10 @@ int main(int argc, char *argv[]) {
       table->ToArrowTable(arTable);
       for (auto p:*task_to_worker) {
         LOG(INFO) << ctx->GetRank() << " Sending a table to target " << p.first;
-        all.InsertTable(arTable, p.first);
+        // the progress thread sends the queued tables of the target, then the table is accepted
+        while (all.InsertTable(arTable, p.first) <= 0) {
+          std::this_thread::yield();
+        }
       }
     });
     tasks.push_back(t1);
@@ -0,0 +1,183 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Compares the TCP channel with the MPI channel. Start the ranks with mpirun for both, the TCP
+ * communicator takes the rank and the world size from the variables mpirun sets and meets the
+ * other ranks at CYLON_TCP_RENDEZVOUS, a directory shared by the ranks. On a single host it can be
+ * left unset, the ranks then meet at /tmp/cylon_<job id of mpirun>
+ *
+ *   mpirun -np 4 tcp_benchmark_example mpi 1000000 10
+ *   mpirun -np 4 tcp_benchmark_example tcp 1000000 10
+ */
+
+#include <glog/logging.h>
+#include <net/mpi/mpi_communicator.hpp>
+#include <net/tcp/tcp_communicator.hpp>
+#include <net/ops/all_to_all.hpp>
+#include <ctx/cylon_context.hpp>
+#include <table.hpp>
+#include <arrow/api.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+class VectorBuffer : public cylon::Buffer {
+ public:
+  explicit VectorBuffer(int64_t length) : data(length) {}
+  int64_t GetLength() override {
+    return data.size();
+  }
+  uint8_t *GetByteBuffer() override {
+    return data.data();
+  }
+ private:
+  std::vector<uint8_t> data;
+};
+
+class VectorAllocator : public cylon::Allocator {
+ public:
+  cylon::Status Allocate(int64_t length, std::shared_ptr<cylon::Buffer> *buffer) override {
+    *buffer = std::make_shared<VectorBuffer>(length);
+    return cylon::Status::OK();
+  }
+};
+
+class CountingCallback : public cylon::ReceiveCallback {
+ public:
+  bool onReceive(int source, std::shared_ptr<cylon::Buffer> buffer, int length) override {
+    bytes += length;
+    return true;
+  }
+  bool onReceiveHeader(int source, int finished, int *buffer, int length) override {
+    return true;
+  }
+  bool onSendComplete(int target, void *buffer, int length) override {
+    return true;
+  }
+  int64_t bytes = 0;
+};
+
+/**
+ * Every rank sends the messages to every rank, including itself
+ */
+double AllToAllBytes(std::shared_ptr<cylon::CylonContext> &ctx, int message_bytes,
+                     int messages) {
+  std::vector<int> all(ctx->GetWorldSize());
+  for (int i = 0; i < ctx->GetWorldSize(); i++) {
+    all[i] = i;
+  }
+  std::vector<uint8_t> message(message_bytes, 1);
+  CountingCallback callback;
+  VectorAllocator allocator;
+
+  ctx->Barrier();
+  auto start = std::chrono::steady_clock::now();
+  cylon::AllToAll all_to_all(ctx, all, all, ctx->GetNextSequence(), &callback, &allocator);
+  for (int m = 0; m < messages; m++) {
+    for (int target : all) {
+      all_to_all.insert(message.data(), message_bytes, target);
+    }
+  }
+  all_to_all.finish();
+  ctx->GetProgressEngine()->Progress(all_to_all);
+  all_to_all.close();
+  ctx->Barrier();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+}
+
+std::shared_ptr<cylon::Table> CreateTable(std::shared_ptr<cylon::CylonContext> &ctx,
+                                          int64_t rows) {
+  arrow::Int64Builder key_builder;
+  arrow::DoubleBuilder value_builder;
+  std::mt19937_64 gen(ctx->GetRank());
+  std::uniform_int_distribution<int64_t> keys(0, rows * ctx->GetWorldSize());
+  std::uniform_real_distribution<double> values;
+  arrow::Status st = key_builder.Reserve(rows);
+  st = value_builder.Reserve(rows);
+  for (int64_t i = 0; i < rows; i++) {
+    key_builder.UnsafeAppend(keys(gen));
+    value_builder.UnsafeAppend(values(gen));
+  }
+  std::shared_ptr<arrow::Array> key_array, value_array;
+  st = key_builder.Finish(&key_array);
+  st = value_builder.Finish(&value_array);
+  auto schema = arrow::schema({arrow::field("key", arrow::int64()),
+                               arrow::field("value", arrow::float64())});
+  std::shared_ptr<cylon::Table> table;
+  cylon::Table::FromArrowTable(ctx, arrow::Table::Make(schema, {key_array, value_array}), &table);
+  return table;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    LOG(ERROR) << "There should be at least 2 args. mpi|tcp, rows per worker, [iterations]";
+    return 1;
+  }
+  std::string comm = argv[1];
+  int64_t rows = std::stoll(argv[2]);
+  int iterations = argc > 3 ? std::stoi(argv[3]) : 10;
+
+  std::shared_ptr<cylon::CylonContext> ctx;
+  if (comm == "tcp") {
+    ctx = cylon::CylonContext::InitDistributed(cylon::net::TCPConfig::FromEnv());
+  } else if (comm == "mpi") {
+    ctx = cylon::CylonContext::InitDistributed(cylon::net::MPIConfig::Make());
+  } else {
+    LOG(ERROR) << "Unknown communication " << comm;
+    return 1;
+  }
+
+  // bandwidth of the channel for a range of message sizes
+  for (int message_bytes = 1 << 10; message_bytes <= 1 << 24; message_bytes <<= 2) {
+    int messages = std::max(1, (1 << 26) / message_bytes / ctx->GetWorldSize());
+    double best = 0;
+    for (int i = 0; i < iterations; i++) {
+      double ms = AllToAllBytes(ctx, message_bytes, messages);
+      best = i == 0 ? ms : std::min(best, ms);
+    }
+    double bytes = static_cast<double>(message_bytes) * messages * ctx->GetWorldSize();
+    if (ctx->GetRank() == 0) {
+      LOG(INFO) << comm << " all_to_all message_bytes " << message_bytes
+                << " time " << best << "[ms] bandwidth "
+                << bytes / best / 1000.0 << "[MB/s per worker]";
+    }
+  }
+
+  // shuffle of a table, the way the distributed operations use the channel
+  std::shared_ptr<cylon::Table> table = CreateTable(ctx, rows);
+  double total = 0;
+  for (int i = 0; i < iterations; i++) {
+    std::shared_ptr<cylon::Table> output;
+    ctx->Barrier();
+    auto start = std::chrono::steady_clock::now();
+    auto status = cylon::Table::Shuffle(table, {0}, output);
+    ctx->Barrier();
+    auto end = std::chrono::steady_clock::now();
+    if (!status.is_ok()) {
+      LOG(ERROR) << "Shuffle failed " << status.get_msg();
+      ctx->Finalize();
+      return 1;
+    }
+    total += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+  }
+  if (ctx->GetRank() == 0) {
+    LOG(INFO) << comm << " shuffle rows " << rows << " avg time " << total / iterations << "[ms]";
+  }
+
+  ctx->Finalize();
+  return 0;
+}
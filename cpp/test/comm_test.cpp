@@ -0,0 +1,144 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ctx/arrow_memory_pool_utils.hpp>
+#include "test_header.hpp"
+#include "test_utils.hpp"
+
+using namespace cylon;
+
+TEST_CASE("communicator collectives testing", "[collectives]") {
+  auto comm = ctx->GetCommunicator();
+  const int rank = ctx->GetRank();
+  const int world_size = ctx->GetWorldSize();
+
+  SECTION("testing all reduce") {
+    int64_t local[2] = {rank + 1, int64_t(1) << rank};
+    int64_t global[2] = {0, 0};
+    REQUIRE(comm->AllReduce(local, global, 2, Int64(), net::ReduceOp::SUM).is_ok());
+    REQUIRE(global[0] == world_size * (world_size + 1) / 2);
+    REQUIRE(comm->AllReduce(local + 1, global + 1, 1, Int64(), net::ReduceOp::BOR).is_ok());
+    REQUIRE(global[1] == (int64_t(1) << world_size) - 1);
+
+    // uint64 values above 32 bits
+    uint64_t big = (uint64_t(1) << 40) + rank, max = 0;
+    REQUIRE(comm->AllReduce(&big, &max, 1, UInt64(), net::ReduceOp::MAX).is_ok());
+    REQUIRE(max == (uint64_t(1) << 40) + world_size - 1);
+  }
+
+  SECTION("testing all gather") {
+    std::vector<int> counts(world_size), displacements(world_size);
+    int total = 0;
+    for (int i = 0; i < world_size; i++) {
+      counts[i] = i + 1;
+      displacements[i] = total;
+      total += i + 1;
+    }
+    std::vector<int> local(rank + 1, rank), all(total, -1);
+    REQUIRE(comm->Allgatherv(local.data(), rank + 1, all.data(), counts.data(),
+                             displacements.data(), Int32()).is_ok());
+    for (int i = 0; i < world_size; i++) {
+      for (int j = 0; j < counts[i]; j++) {
+        REQUIRE(all[displacements[i] + j] == i);
+      }
+    }
+  }
+
+  SECTION("testing gather and broadcast") {
+    const int root = world_size - 1;
+    std::vector<int> gathered(world_size, -1);
+    int value = rank * 10;
+    REQUIRE(comm->Gather(&value, 1, gathered.data(), Int32(), root).is_ok());
+    if (rank == root) {
+      for (int i = 0; i < world_size; i++) {
+        REQUIRE(gathered[i] == i * 10);
+      }
+    }
+    value = rank == root ? 77 : 0;
+    REQUIRE(comm->Bcast(&value, 1, Int32(), root).is_ok());
+    REQUIRE(value == 77);
+  }
+
+  SECTION("testing all to all") {
+    // every worker sends i + 1 values to worker i
+    std::vector<int> send_counts(world_size), send_displacements(world_size),
+        rcv_counts(world_size), rcv_displacements(world_size);
+    int send_total = 0, rcv_total = 0;
+    for (int i = 0; i < world_size; i++) {
+      send_counts[i] = i + 1;
+      send_displacements[i] = send_total;
+      send_total += i + 1;
+      rcv_counts[i] = rank + 1;
+      rcv_displacements[i] = rcv_total;
+      rcv_total += rank + 1;
+    }
+    std::vector<int> send(send_total), received(rcv_total, -1);
+    for (int i = 0; i < world_size; i++) {
+      for (int j = 0; j < send_counts[i]; j++) {
+        send[send_displacements[i] + j] = rank * 100 + i;
+      }
+    }
+    REQUIRE(comm->Alltoallv(send.data(), send_counts.data(), send_displacements.data(),
+                            received.data(), rcv_counts.data(), rcv_displacements.data(),
+                            Int32()).is_ok());
+    for (int i = 0; i < world_size; i++) {
+      for (int j = 0; j < rcv_counts[i]; j++) {
+        REQUIRE(received[rcv_displacements[i] + j] == i * 100 + rank);
+      }
+    }
+  }
+
+  SECTION("testing table collectives") {
+    std::shared_ptr<cylon::Table> table;
+    REQUIRE(cylon::test::CreateTable(ctx, 10 + rank, &table).is_ok());
+    arrow::MemoryPool *pool = cylon::ToArrowPool(ctx);
+
+    std::vector<std::shared_ptr<arrow::Table>> tables;
+    REQUIRE(comm->AllgatherTable(table->get_table(), pool, &tables).is_ok());
+    REQUIRE(tables.size() == static_cast<size_t>(world_size));
+    for (int i = 0; i < world_size; i++) {
+      REQUIRE(tables[i]->num_rows() == 10 + i);
+    }
+
+    std::shared_ptr<arrow::Table> broadcast = rank == 0 ? table->get_table() : nullptr;
+    REQUIRE(comm->BcastTable(&broadcast, 0, pool).is_ok());
+    REQUIRE(broadcast->num_rows() == 10);
+    REQUIRE(broadcast->schema()->Equals(*table->get_table()->schema()));
+  }
+
+  SECTION("testing operations of groups") {
+    // the even and the odd workers join at the same time, the later workers ranked first
+    auto group_ctx = ctx->Split(rank % 2, world_size - rank);
+    REQUIRE(group_ctx != nullptr);
+    const int group_size = (world_size + 1 - rank % 2) / 2;
+    REQUIRE(group_ctx->GetWorldSize() == group_size);
+    REQUIRE(group_ctx->GetRank() == group_size - 1 - rank / 2);
+
+    std::shared_ptr<cylon::Table> left, right, joined;
+    REQUIRE(cylon::test::CreateTable(group_ctx, 10, &left).is_ok());
+    REQUIRE(cylon::test::CreateTable(group_ctx, 10, &right).is_ok());
+    REQUIRE(cylon::Table::DistributedJoin(left, right,
+                                          cylon::join::config::JoinConfig::InnerJoin(0, 0),
+                                          &joined).is_ok());
+
+    // every key is on every worker of the group, on both sides
+    int64_t rows = joined->Rows(), total = 0;
+    REQUIRE(group_ctx->GetCommunicator()->AllReduce(&rows, &total, 1, Int64(),
+                                                    net::ReduceOp::SUM).is_ok());
+    REQUIRE(total == 10 * group_size * group_size);
+    group_ctx->Finalize();
+
+    REQUIRE(ctx->Split(-1) == nullptr);
+  }
+}
@@ -24,6 +24,10 @@
 #include <table.hpp>
 #include <chrono>
 #include <net/mpi/mpi_communicator.hpp>
+#include <net/shm/shm_communicator.hpp>
+#include <net/tcp/tcp_communicator.hpp>
+#include <cstdlib>
+#include <string>
 
 std::shared_ptr<cylon::CylonContext> ctx = nullptr;
 int RANK = 0;
@@ -33,8 +37,17 @@ using namespace cylon;
 
 int main(int argc, char *argv[]) {
   // global setup...
-  auto mpi_config = cylon::net::MPIConfig::Make();
-  ctx = cylon::CylonContext::InitDistributed(mpi_config);
+  // CYLON_TEST_COMM=shm runs the tests over the shared memory channels, and tcp over the TCP
+  // channels
+  const char *comm = std::getenv("CYLON_TEST_COMM");
+  if (comm != nullptr && std::string(comm) == "shm") {
+    ctx = cylon::CylonContext::InitDistributed(cylon::net::SHMConfig::Make());
+  } else if (comm != nullptr && std::string(comm) == "tcp") {
+    ctx = cylon::CylonContext::InitDistributed(cylon::net::TCPConfig::FromEnv());
+  } else {
+    auto mpi_config = cylon::net::MPIConfig::Make();
+    ctx = cylon::CylonContext::InitDistributed(mpi_config);
+  }
   RANK = ctx->GetRank();
   WORLD_SZ = ctx->GetWorldSize();
 
@@ -15,6 +15,8 @@
 #include "test_header.hpp"
 #include "test_utils.hpp"
 
+#include <algorithm>
+
 using namespace cylon;
 
 TEST_CASE("Join testing", "[join]") {
@@ -27,4 +29,276 @@ TEST_CASE("Join testing", "[join]") {
     const join::config::JoinConfig &join_config = join::config::JoinConfig::InnerJoin(0, 0);
     REQUIRE(test::TestJoinOperation(join_config, ctx, path1, path2, out_path) == 0);
   }
+
+  SECTION("testing inner joins - hash") {
+    const join::config::JoinConfig &join_config =
+        join::config::JoinConfig::InnerJoin(0, 0, cylon::join::config::JoinAlgorithm::HASH);
+    REQUIRE(test::TestJoinOperation(join_config, ctx, path1, path2, out_path) == 0);
+  }
+
+  SECTION("testing inner joins - radix hash") {
+    const join::config::JoinConfig &join_config =
+        join::config::JoinConfig::InnerJoin(0, 0, cylon::join::config::JoinAlgorithm::RADIX_HASH);
+    REQUIRE(test::TestJoinOperation(join_config, ctx, path1, path2, out_path) == 0);
+  }
+
+  SECTION("testing inner joins - multi-threaded hash") {
+    ctx->AddConfig(CylonContext::THREADS_CONFIG, "4");
+    const join::config::JoinConfig &join_config =
+        join::config::JoinConfig::InnerJoin(0, 0, cylon::join::config::JoinAlgorithm::HASH);
+    int result = test::TestJoinOperation(join_config, ctx, path1, path2, out_path);
+    ctx->AddConfig(CylonContext::THREADS_CONFIG, "1");
+    REQUIRE(result == 0);
+  }
+
+  SECTION("testing inner joins - bloom filter") {
+    join::config::JoinConfig join_config =
+        join::config::JoinConfig::InnerJoin(0, 0, cylon::join::config::JoinAlgorithm::HASH);
+    join_config.SetUseBloomFilter(true);
+    REQUIRE(test::TestJoinOperation(join_config, ctx, path1, path2, out_path) == 0);
+  }
+
+  SECTION("testing bloom filter selectivity") {
+    // the large table has every key in [0, 400 * world size) once. The small table has the
+    // multiples of 20 of those keys and as many negative keys without a match
+    const int64_t large_rows = 400, small_rows = 40;
+    arrow::Int64Builder large_builder, small_builder;
+    for (int64_t i = 0; i < large_rows; i++) {
+      REQUIRE(large_builder.Append(i * WORLD_SZ + RANK).ok());
+    }
+    for (int64_t i = 0; i < small_rows / 2; i++) {
+      REQUIRE(small_builder.Append(20 * (i * WORLD_SZ + RANK)).ok());
+      REQUIRE(small_builder.Append(-1 - (i * WORLD_SZ + RANK)).ok());
+    }
+    std::shared_ptr<arrow::Array> large_keys, small_keys;
+    REQUIRE(large_builder.Finish(&large_keys).ok());
+    REQUIRE(small_builder.Finish(&small_keys).ok());
+    auto schema = arrow::schema({arrow::field("col0", arrow::int64())});
+    auto large_arrow = arrow::Table::Make(schema, {large_keys});
+    auto small_arrow = arrow::Table::Make(schema, {small_keys});
+
+    // the joins filter the large table, and keep every row of the small table if it is preserved
+    const int64_t matches = small_rows / 2;
+    struct Case {
+      join::config::JoinConfig config;
+      bool large_left;
+      int64_t rows;
+    };
+    const std::vector<Case> cases = {
+        {join::config::JoinConfig::InnerJoin(0, 0, join::config::JoinAlgorithm::HASH), true,
+         matches},
+        {join::config::JoinConfig::LeftJoin(0, 0, join::config::JoinAlgorithm::HASH), false,
+         small_rows},
+        {join::config::JoinConfig::RightJoin(0, 0, join::config::JoinAlgorithm::HASH), true,
+         small_rows}};
+    for (const auto &join_case : cases) {
+      join::config::JoinConfig join_config = join_case.config;
+      join_config.SetUseBloomFilter(true);
+      join_config.SetStrategy(join::config::JoinStrategy::SHUFFLE);
+      std::shared_ptr<cylon::Table> large, small, joined;
+      REQUIRE(cylon::Table::FromArrowTable(ctx, large_arrow, &large).is_ok());
+      REQUIRE(cylon::Table::FromArrowTable(ctx, small_arrow, &small).is_ok());
+      JoinFilterStats filter_stats;
+      REQUIRE(cylon::Table::DistributedJoin(join_case.large_left ? large : small,
+                                            join_case.large_left ? small : large,
+                                            join_config, &joined, nullptr,
+                                            &filter_stats).is_ok());
+
+      int64_t local[3] = {joined->Rows(), filter_stats.probe_rows, filter_stats.filtered_rows};
+      int64_t global[3] = {0, 0, 0};
+      REQUIRE(ctx->GetCommunicator()->AllReduce(local, global, 3, Int64(),
+                                                net::ReduceOp::SUM).is_ok());
+      REQUIRE(global[0] == join_case.rows * WORLD_SZ);
+      if (WORLD_SZ > 1) {
+        // the filter keeps the matching rows, and most of the others are dropped
+        REQUIRE(global[1] == large_rows * WORLD_SZ);
+        REQUIRE(global[2] <= (large_rows - matches) * WORLD_SZ);
+        REQUIRE(global[2] >= (large_rows - matches) * WORLD_SZ * 9 / 10);
+      }
+    }
+  }
+
+  SECTION("testing inner joins - broadcast") {
+    join::config::JoinConfig join_config =
+        join::config::JoinConfig::InnerJoin(0, 0, cylon::join::config::JoinAlgorithm::HASH);
+    join_config.SetStrategy(cylon::join::config::JoinStrategy::BROADCAST);
+    // the large table is not moved, so the rows are not on the workers of the expected files
+    REQUIRE(test::TestJoinOperation(join_config, ctx, path1, path2, out_path, true) == 0);
+  }
+
+  SECTION("testing inner joins - skew handling") {
+    join::config::JoinConfig join_config =
+        join::config::JoinConfig::InnerJoin(0, 0, cylon::join::config::JoinAlgorithm::HASH);
+    join_config.SetStrategy(cylon::join::config::JoinStrategy::SHUFFLE);
+    join_config.SetSkewHandling(true);
+    REQUIRE(test::TestJoinOperation(join_config, ctx, path1, path2, out_path) == 0);
+  }
+
+  SECTION("testing inner joins - heavy hitter") {
+    // key 7 has 3/4 of the rows of the large table, the other keys are unique
+    const int64_t heavy_rows = 300, unique_rows = 100, small_unique_rows = 10;
+    arrow::Int64Builder large_builder, small_builder;
+    for (int64_t i = 0; i < heavy_rows; i++) {
+      REQUIRE(large_builder.Append(7).ok());
+    }
+    for (int64_t i = 0; i < unique_rows; i++) {
+      REQUIRE(large_builder.Append(100 + i * WORLD_SZ + RANK).ok());
+    }
+    REQUIRE(small_builder.Append(7).ok());
+    for (int64_t i = 0; i < small_unique_rows; i++) {
+      REQUIRE(small_builder.Append(100 + i * WORLD_SZ + RANK).ok());
+    }
+    std::shared_ptr<arrow::Array> large_keys, small_keys;
+    REQUIRE(large_builder.Finish(&large_keys).ok());
+    REQUIRE(small_builder.Finish(&small_keys).ok());
+    auto schema = arrow::schema({arrow::field("col0", arrow::int64())});
+    std::shared_ptr<cylon::Table> large, small, skewed, plain;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow::Table::Make(schema, {large_keys}),
+                                         &large).is_ok());
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow::Table::Make(schema, {small_keys}),
+                                         &small).is_ok());
+
+    join::config::JoinConfig join_config =
+        join::config::JoinConfig::InnerJoin(0, 0, cylon::join::config::JoinAlgorithm::HASH);
+    join_config.SetStrategy(cylon::join::config::JoinStrategy::SHUFFLE);
+    join_config.SetSkewHandling(true);
+    JoinSkewStats skew_stats;
+    REQUIRE(cylon::Table::DistributedJoin(large, small, join_config, &skewed,
+                                          &skew_stats).is_ok());
+    join_config.SetSkewHandling(false);
+    REQUIRE(cylon::Table::DistributedJoin(large, small, join_config, &plain).is_ok());
+    REQUIRE(test::VerifyGlobally(ctx, skewed, plain) == 0);
+
+    // the joined rows of the heavy key on this worker
+    int64_t local[2] = {skewed->Rows(), 0};
+    for (const auto &chunk : skewed->get_table()->column(0)->chunks()) {
+      auto keys = std::static_pointer_cast<arrow::Int64Array>(chunk);
+      for (int64_t i = 0; i < keys->length(); i++) {
+        local[1] += keys->Value(i) == 7;
+      }
+    }
+    std::vector<int64_t> all(2 * WORLD_SZ, 0);
+    REQUIRE(ctx->GetCommunicator()->Allgather(local, 2, all.data(), Int64()).is_ok());
+    int64_t total = 0, heavy_total = 0, heavy_max = 0, heavy_workers = 0;
+    for (int i = 0; i < WORLD_SZ; i++) {
+      total += all[2 * i];
+      heavy_total += all[2 * i + 1];
+      heavy_max = std::max(heavy_max, all[2 * i + 1]);
+      heavy_workers += all[2 * i + 1] > 0;
+    }
+    REQUIRE(total == heavy_rows * WORLD_SZ * WORLD_SZ + small_unique_rows * WORLD_SZ);
+    REQUIRE(heavy_total == heavy_rows * WORLD_SZ * WORLD_SZ);
+
+    if (WORLD_SZ > 1) {
+      // every row is sampled, so the key is found exactly and its rows are spread round robin
+      REQUIRE(skew_stats.heavy_keys == 1);
+      REQUIRE(skew_stats.max_key_share > 0.7);
+      REQUIRE(skew_stats.split_rows == heavy_rows);
+      REQUIRE(skew_stats.replicated_rows > 0);
+      REQUIRE(heavy_workers > 1);
+      REQUIRE(heavy_max <= heavy_total / 2);
+    }
+  }
+
+  SECTION("testing multi column joins") {
+    std::shared_ptr<cylon::Table> table, joined;
+    REQUIRE(test::CreateTable(ctx, 100, &table).is_ok());
+    for (auto algorithm : {cylon::join::config::JoinAlgorithm::SORT,
+                           cylon::join::config::JoinAlgorithm::HASH}) {
+      const join::config::JoinConfig &join_config =
+          join::config::JoinConfig::InnerJoin({0, 1}, {0, 1}, algorithm);
+      REQUIRE(cylon::Table::Join(table, table, join_config, &joined).is_ok());
+      REQUIRE(joined->Rows() == 100);
+    }
+
+    // a config without key columns is rejected
+    const join::config::JoinConfig &empty_config =
+        join::config::JoinConfig::InnerJoin(std::vector<int>{}, std::vector<int>{});
+    REQUIRE(!cylon::Table::DistributedJoin(table, table, empty_config, &joined).is_ok());
+  }
+
+  SECTION("testing string key joins") {
+    // key76424 and key215300 have the same murmur3 hash, and the long keys share a prefix
+    const std::string prefix = "a long prefix shared by many of the keys ";
+    const std::vector<std::string> keys = {"", "a", "aa", "key76424", "key215300",
+                                           prefix, prefix + "0", prefix + "1", prefix + "10"};
+    std::vector<std::string> left_keys, right_keys;
+    for (size_t i = 0; i < 60; i++) {
+      left_keys.push_back(keys[(i * 7) % keys.size()]);
+    }
+    for (size_t i = 0; i < 40; i++) {
+      right_keys.push_back(i % 8 == 0 ? prefix + "2" : keys[(i * 5 + 3) % keys.size()]);
+    }
+    int64_t expected = 0;
+    for (const auto &left_key : left_keys) {
+      expected += std::count(right_keys.begin(), right_keys.end(), left_key);
+    }
+
+    // the tables are slices, so the arrays start at a non-zero offset
+    auto make_table = [&prefix](const std::vector<std::string> &values,
+                                std::shared_ptr<arrow::Table> *table) {
+      arrow::StringBuilder builder;
+      for (const auto &value : {"skipped", "key76424", prefix.c_str()}) {
+        REQUIRE(builder.Append(value).ok());
+      }
+      for (const auto &value : values) {
+        REQUIRE(builder.Append(value).ok());
+      }
+      std::shared_ptr<arrow::Array> array;
+      REQUIRE(builder.Finish(&array).ok());
+      *table = arrow::Table::Make(arrow::schema({arrow::field("col0", arrow::utf8())}), {array})
+          ->Slice(3);
+    };
+    std::shared_ptr<arrow::Table> left_arrow, right_arrow;
+    make_table(left_keys, &left_arrow);
+    make_table(right_keys, &right_arrow);
+
+    for (auto algorithm : {cylon::join::config::JoinAlgorithm::HASH,
+                           cylon::join::config::JoinAlgorithm::RADIX_HASH}) {
+      std::shared_ptr<cylon::Table> left, right, joined;
+      REQUIRE(cylon::Table::FromArrowTable(ctx, left_arrow, &left).is_ok());
+      REQUIRE(cylon::Table::FromArrowTable(ctx, right_arrow, &right).is_ok());
+      const join::config::JoinConfig &join_config =
+          join::config::JoinConfig::InnerJoin(0, 0, algorithm);
+      REQUIRE(cylon::Table::Join(left, right, join_config, &joined).is_ok());
+      REQUIRE(joined->Rows() == expected);
+      std::shared_ptr<arrow::Table> result = joined->get_table();
+      REQUIRE(result->column(0)->Equals(result->column(1)));
+    }
+  }
+
+  SECTION("testing distributed multi column joins") {
+    // the first key repeats every 5 rows, so the rows only match on both keys
+    const int64_t rows = 50;
+    arrow::Int64Builder first_builder, second_builder;
+    for (int64_t i = 0; i < rows; i++) {
+      REQUIRE(first_builder.Append(i % 5).ok());
+      REQUIRE(second_builder.Append(i).ok());
+    }
+    std::shared_ptr<arrow::Array> first, second;
+    REQUIRE(first_builder.Finish(&first).ok());
+    REQUIRE(second_builder.Finish(&second).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64()), arrow::field("col1", arrow::int64())}),
+        {first, second});
+
+    for (auto algorithm : {cylon::join::config::JoinAlgorithm::SORT,
+                           cylon::join::config::JoinAlgorithm::HASH}) {
+      std::shared_ptr<cylon::Table> left, right, joined;
+      REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &left).is_ok());
+      REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &right).is_ok());
+      const join::config::JoinConfig &join_config =
+          join::config::JoinConfig::InnerJoin({0, 1}, {0, 1}, algorithm);
+      REQUIRE(cylon::Table::DistributedJoin(left, right, join_config, &joined).is_ok());
+
+      // a row of a worker matches the same row of every worker
+      std::shared_ptr<arrow::Table> result = joined->get_table();
+      REQUIRE(result->column(0)->Equals(result->column(2)));
+      REQUIRE(result->column(1)->Equals(result->column(3)));
+      int64_t local = joined->Rows(), total = 0;
+      REQUIRE(ctx->GetCommunicator()->AllReduce(&local, &total, 1, Int64(),
+                                                net::ReduceOp::SUM).is_ok());
+      REQUIRE(total == rows * WORLD_SZ * WORLD_SZ);
+    }
+  }
 }
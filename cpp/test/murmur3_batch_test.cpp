@@ -0,0 +1,96 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include <util/murmur3.hpp>
+#include <util/murmur3_batch.hpp>
+
+#include "test_header.hpp"
+
+using namespace cylon;
+
+/**
+ * Hash a sliced array with nulls using the batch kernels and compare every hash with the hash of
+ * the single value
+ */
+template<typename ARROW_TYPE>
+void TestBatchHashes(int64_t length, int64_t offset) {
+  using CTYPE = typename ARROW_TYPE::c_type;
+  arrow::NumericBuilder<ARROW_TYPE> builder;
+  for (int64_t i = 0; i < offset + length; i++) {
+    if (i % 7 == 3) {
+      REQUIRE(builder.AppendNull().ok());
+    } else {
+      REQUIRE(builder.Append(static_cast<CTYPE>(static_cast<uint64_t>(i) * 0x9e3779b97f4a7c15ULL
+                                                    + i)).ok());
+    }
+  }
+  std::shared_ptr<arrow::Array> array;
+  REQUIRE(builder.Finish(&array).ok());
+  auto values = std::static_pointer_cast<arrow::NumericArray<ARROW_TYPE>>(array->Slice(offset));
+  REQUIRE(values->length() == length);
+
+  const int width = sizeof(CTYPE);
+  const auto *raw = reinterpret_cast<const uint8_t *>(values->raw_values());
+  const uint32_t seed = 42;
+  std::vector<uint32_t> hashes(length);
+  util::MurmurHash3_x86_32_Batch(raw, length, width, seed, hashes.data());
+  std::vector<uint64_t> row_hashes(length, 1);
+  util::MurmurHash3_x86_32_Combine(raw, length, width, values->null_bitmap_data(),
+                                   values->offset(), row_hashes.data());
+
+  for (int64_t i = 0; i < length; i++) {
+    uint32_t expected = 0;
+    util::MurmurHash3_x86_32(raw + i * width, width, seed, &expected);
+    REQUIRE(hashes[i] == expected);
+    // the row hashes combine the hashes with seed 0, and 0 for the nulls
+    util::MurmurHash3_x86_32(raw + i * width, width, 0, &expected);
+    REQUIRE(row_hashes[i] == 31 + (values->IsNull(i) ? 0 : expected));
+  }
+}
+
+template<typename ARROW_TYPE>
+void TestBatchHashes() {
+  // lengths around the 8 and 16 lanes and the blocks of the combine
+  for (int64_t length : {0, 1, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1023, 1025, 2100}) {
+    for (int64_t offset : {0, 1, 3, 13}) {
+      TestBatchHashes<ARROW_TYPE>(length, offset);
+    }
+  }
+}
+
+TEST_CASE("murmur3 batch hashes", "[hash]") {
+  const std::vector<std::string> implementations = util::MurmurHash3BatchImplementations();
+  REQUIRE(implementations.front() == util::MurmurHash3BatchImplementation());
+  REQUIRE(std::find(implementations.begin(), implementations.end(), "scalar")
+              != implementations.end());
+  REQUIRE_FALSE(util::SetMurmurHash3BatchImplementation("unknown"));
+  REQUIRE(implementations.front() == util::MurmurHash3BatchImplementation());
+
+  // every implementation the CPU supports
+  for (const auto &implementation : implementations) {
+    SECTION("testing the " + implementation + " batch hashes") {
+      REQUIRE(util::SetMurmurHash3BatchImplementation(implementation));
+      REQUIRE(implementation == util::MurmurHash3BatchImplementation());
+      TestBatchHashes<arrow::UInt8Type>();
+      TestBatchHashes<arrow::UInt16Type>();
+      TestBatchHashes<arrow::UInt32Type>();
+      TestBatchHashes<arrow::UInt64Type>();
+      TestBatchHashes<arrow::Int64Type>();
+      TestBatchHashes<arrow::DoubleType>();
+      REQUIRE(util::SetMurmurHash3BatchImplementation(implementations.front()));
+    }
+  }
+}
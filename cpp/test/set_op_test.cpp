@@ -17,6 +17,85 @@
 
 using namespace cylon;
 
+/**
+ * Make a table of int64 and string columns. The values under the nulls are kept, so that equal
+ * null rows can have different values under them
+ */
+static std::shared_ptr<Table> MakeSetTable(const std::vector<int64_t> &keys,
+                                           const std::vector<uint8_t> &keys_valid,
+                                           const std::vector<std::string> &strings,
+                                           const std::vector<uint8_t> &strings_valid) {
+  arrow::Int64Builder key_builder;
+  arrow::StringBuilder string_builder;
+  REQUIRE(key_builder.AppendValues(keys.data(), keys.size(), keys_valid.data()).ok());
+  REQUIRE(string_builder.AppendValues(strings, strings_valid.data()).ok());
+  std::shared_ptr<arrow::Array> key_array, string_array;
+  REQUIRE(key_builder.Finish(&key_array).ok());
+  REQUIRE(string_builder.Finish(&string_array).ok());
+  auto arrow_table = arrow::Table::Make(
+      arrow::schema({arrow::field("col0", arrow::int64()), arrow::field("col1", arrow::utf8())}),
+      {key_array, string_array});
+  std::shared_ptr<Table> table;
+  REQUIRE(Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+  return table;
+}
+
+/**
+ * @return the rows of a table made by MakeSetTable as key|string, in the order of the table
+ */
+static std::vector<std::string> SetTableRows(const std::shared_ptr<Table> &table) {
+  std::shared_ptr<arrow::Table> arrow_table;
+  REQUIRE(table->get_table()->CombineChunks(arrow::default_memory_pool(), &arrow_table).ok());
+  std::vector<std::string> rows;
+  if (arrow_table->num_rows() == 0) {
+    return rows;
+  }
+  auto keys = std::static_pointer_cast<arrow::Int64Array>(arrow_table->column(0)->chunk(0));
+  auto strings = std::static_pointer_cast<arrow::StringArray>(arrow_table->column(1)->chunk(0));
+  for (int64_t i = 0; i < arrow_table->num_rows(); i++) {
+    rows.push_back((keys->IsNull(i) ? "null" : std::to_string(keys->Value(i))) + "|"
+                       + (strings->IsNull(i) ? "null" : strings->GetString(i)));
+  }
+  return rows;
+}
+
+TEST_CASE("Local set operation testing", "[set_op]") {
+  // duplicate rows, null keys with different values under them, a null key next to a 0 key and a
+  // null string next to an empty string. The empty string hashes like the null
+  auto make_left = []() {
+    return MakeSetTable({1, 1, 7, 8, 0, 2, 2, 3}, {1, 1, 0, 0, 1, 1, 1, 1},
+                        {"a", "a", "b", "b", "b", "", "", "c"}, {1, 1, 1, 1, 1, 1, 0, 1});
+  };
+  auto make_right = []() {
+    return MakeSetTable({9, 2, 4, 4, 0}, {0, 1, 1, 1, 1},
+                        {"b", "x", "d", "d", "x"}, {1, 0, 1, 1, 1});
+  };
+  std::shared_ptr<Table> left = make_left(), right = make_right(), out;
+
+  // every row hashes to the same value, so the rows are told apart by comparing them only
+  const bool collide = GENERATE(false, true);
+  if (collide) {
+    left->SetRowHashes({0, 1}, std::make_shared<std::vector<uint64_t>>(left->Rows(), 42));
+    right->SetRowHashes({0, 1}, std::make_shared<std::vector<uint64_t>>(right->Rows(), 42));
+  }
+
+  SECTION("testing local union") {
+    REQUIRE(Table::Union(left, right, out).is_ok());
+    REQUIRE(SetTableRows(out) == std::vector<std::string>{
+        "1|a", "null|b", "0|b", "2|", "2|null", "3|c", "4|d", "0|x"});
+  }
+
+  SECTION("testing local subtract") {
+    REQUIRE(Table::Subtract(left, right, out).is_ok());
+    REQUIRE(SetTableRows(out) == std::vector<std::string>{"1|a", "0|b", "2|", "3|c"});
+  }
+
+  SECTION("testing local intersect") {
+    REQUIRE(Table::Intersect(left, right, out).is_ok());
+    REQUIRE(SetTableRows(out) == std::vector<std::string>{"null|b", "2|null"});
+  }
+}
+
 TEST_CASE("Set operation testing", "[set_op]") {
   std::string path1 = "../data/input/csv1_" + std::to_string(RANK) + ".csv";
   std::string path2 = "../data/input/csv2_" + std::to_string(RANK) + ".csv";
@@ -12,11 +12,62 @@
  * limitations under the License.
  */
 
+#include <arrow/arrow_all_to_all.hpp>
+
 #include "test_header.hpp"
 #include "test_utils.hpp"
 
 using namespace cylon;
 
+/**
+ * An operation for the progress engine that completes after a number of passes, or when it is
+ * told to, without any events
+ */
+class IdleOperation {
+ public:
+  explicit IdleOperation(int passes) : complete_after_(passes) {}
+
+  bool isComplete() {
+    passes_++;
+    thread_ = std::this_thread::get_id();
+    return done_ || passes_ >= complete_after_;
+  }
+
+  uint64_t events() const {
+    return 0;
+  }
+
+  void waitForEvents() {
+    waits_++;
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+
+  void Complete() {
+    done_ = true;
+  }
+
+  int passes_ = 0;
+  int waits_ = 0;
+  std::thread::id thread_;
+
+ private:
+  int complete_after_;
+  std::atomic<bool> done_{false};
+};
+
+/**
+ * Keeps the tables received by an all to all with their sources and references
+ */
+class ReceivedTables : public cylon::ArrowCallback {
+ public:
+  bool onReceive(int source, const std::shared_ptr<arrow::Table> &table, int reference) override {
+    tables.emplace_back(source, reference, table);
+    return true;
+  }
+
+  std::vector<std::tuple<int, int, std::shared_ptr<arrow::Table>>> tables;
+};
+
 TEST_CASE("table ops testing", "[table_ops]") {
   cylon::Status status;
   const int size = 12;
@@ -34,4 +85,691 @@ TEST_CASE("table ops testing", "[table_ops]") {
 
     REQUIRE((status.is_ok() && select->Columns() == 2 && select->Rows() == size/2));
   }
+
+  SECTION("testing cached row hashes") {
+    std::shared_ptr<std::vector<uint64_t>> hashes, cached;
+    REQUIRE(input->GetRowHashes({0, 1}, &hashes).is_ok());
+    REQUIRE(hashes->size() == static_cast<size_t>(size));
+    REQUIRE(input->HasRowHashes({0, 1}));
+    REQUIRE(!input->HasRowHashes({0}));
+    REQUIRE(input->GetRowHashes({0, 1}, &cached).is_ok());
+    REQUIRE(cached == hashes);
+
+    // projecting the key columns keeps the hashes
+    std::shared_ptr<cylon::Table> projected;
+    REQUIRE(input->Project({1, 0}, projected).is_ok());
+    REQUIRE(projected->HasRowHashes({1, 0}));
+
+    // the union of a table with itself is the table, with the same hashes
+    std::shared_ptr<cylon::Table> united;
+    REQUIRE(cylon::Table::Union(input, input, united).is_ok());
+    REQUIRE(united->Rows() == size);
+    REQUIRE(united->HasRowHashes({0, 1}));
+    REQUIRE(united->GetRowHashes({0, 1}, &cached).is_ok());
+    REQUIRE(*cached == *hashes);
+  }
+
+  SECTION("testing hash partition") {
+    // int64 keys and strings derived from them, both with nulls
+    const int64_t rows = 1000;
+    const int partitions = 4;
+    arrow::Int64Builder key_builder;
+    arrow::StringBuilder string_builder;
+    for (int64_t i = 0; i < rows; i++) {
+      if (i % 13 == 0) {
+        REQUIRE(key_builder.AppendNull().ok());
+        REQUIRE(string_builder.AppendNull().ok());
+      } else {
+        REQUIRE(key_builder.Append(i % 97).ok());
+        REQUIRE(string_builder.Append("value " + std::to_string(i % 97)).ok());
+      }
+    }
+    std::shared_ptr<arrow::Array> keys, strings;
+    REQUIRE(key_builder.Finish(&keys).ok());
+    REQUIRE(string_builder.Finish(&strings).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64()), arrow::field("col1", arrow::utf8())}),
+        {keys, strings});
+    std::shared_ptr<cylon::Table> table;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+
+    std::unordered_map<int, std::shared_ptr<cylon::Table>> partitioned;
+    REQUIRE(table->HashPartition({0}, partitions, &partitioned).is_ok());
+    REQUIRE(partitioned.size() == static_cast<size_t>(partitions));
+    int64_t total_rows = 0, total_nulls = 0;
+    for (const auto &x : partitioned) {
+      std::shared_ptr<arrow::Table> part;
+      REQUIRE(x.second->ToArrowTable(part).is_ok());
+      auto c0 = std::static_pointer_cast<arrow::Int64Array>(part->column(0)->chunk(0));
+      auto c1 = std::static_pointer_cast<arrow::StringArray>(part->column(1)->chunk(0));
+      std::shared_ptr<std::vector<uint64_t>> hashes;
+      REQUIRE(x.second->GetRowHashes({0}, &hashes).is_ok());
+      for (int64_t i = 0; i < part->num_rows(); i++) {
+        REQUIRE((*hashes)[i] % partitions == static_cast<uint64_t>(x.first));
+        REQUIRE(c0->IsNull(i) == c1->IsNull(i));
+        if (c0->IsValid(i)) {
+          REQUIRE(c1->GetString(i) == "value " + std::to_string(c0->Value(i)));
+        }
+      }
+      total_rows += part->num_rows();
+      total_nulls += c0->null_count();
+    }
+    REQUIRE(total_rows == rows);
+    REQUIRE(total_nulls == keys->null_count());
+  }
+
+  SECTION("testing hash partition of an unsupported key") {
+    arrow::BooleanBuilder flag_builder;
+    arrow::Int64Builder value_builder;
+    for (int64_t i = 0; i < 10; i++) {
+      REQUIRE(flag_builder.Append(i % 2 == 0).ok());
+      REQUIRE(value_builder.Append(i).ok());
+    }
+    std::shared_ptr<arrow::Array> flags, values;
+    REQUIRE(flag_builder.Finish(&flags).ok());
+    REQUIRE(value_builder.Finish(&values).ok());
+    auto schema = arrow::schema({arrow::field("col0", arrow::boolean()),
+                                 arrow::field("col1", arrow::int64())});
+    auto arrow_table = arrow::Table::Make(schema, {flags, values});
+    std::shared_ptr<cylon::Table> table;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+
+    // the error reaches the caller, the boolean keys can't be hashed
+    std::unordered_map<int, std::shared_ptr<cylon::Table>> partitioned;
+    status = table->HashPartition({0}, 4, &partitioned);
+    REQUIRE(status.get_code() == cylon::Code::NotImplemented);
+    REQUIRE(table->HashPartition({1}, 4, &partitioned).is_ok());
+  }
+
+  SECTION("testing sort") {
+    // large enough to use the radix sort, with negative values and duplicates
+    const int64_t rows = 5000;
+    arrow::Int64Builder builder;
+    for (int64_t i = 0; i < rows; i++) {
+      REQUIRE(builder.Append((i * 7919) % 1000 - 500).ok());
+    }
+    std::shared_ptr<arrow::Array> values;
+    REQUIRE(builder.Finish(&values).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64())}), {values});
+    std::shared_ptr<cylon::Table> table, sorted;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+    REQUIRE(table->Sort(0, sorted).is_ok());
+
+    std::shared_ptr<arrow::Table> sorted_table;
+    REQUIRE(sorted->ToArrowTable(sorted_table).is_ok());
+    auto sorted_values =
+        std::static_pointer_cast<arrow::Int64Array>(sorted_table->column(0)->chunk(0));
+    REQUIRE(sorted_values->length() == rows);
+    for (int64_t i = 1; i < rows; i++) {
+      REQUIRE(sorted_values->Value(i - 1) <= sorted_values->Value(i));
+    }
+  }
+
+  SECTION("testing multi column sort") {
+    // int64 ascending, long strings descending with the nulls first, int32 ascending
+    const int64_t rows = 3000;
+    arrow::Int64Builder key_builder;
+    arrow::StringBuilder string_builder;
+    arrow::Int32Builder row_builder;
+    for (int64_t i = 0; i < rows; i++) {
+      REQUIRE(key_builder.Append(i % 7 - 3).ok());
+      if (i % 11 == 0) {
+        REQUIRE(string_builder.AppendNull().ok());
+      } else {
+        REQUIRE(string_builder.Append("a common long prefix " + std::to_string(i % 5)).ok());
+      }
+      REQUIRE(row_builder.Append(static_cast<int32_t>(rows - i)).ok());
+    }
+    std::shared_ptr<arrow::Array> keys, strings, row_ids;
+    REQUIRE(key_builder.Finish(&keys).ok());
+    REQUIRE(string_builder.Finish(&strings).ok());
+    REQUIRE(row_builder.Finish(&row_ids).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64()), arrow::field("col1", arrow::utf8()),
+                       arrow::field("col2", arrow::int32())}), {keys, strings, row_ids});
+    std::shared_ptr<cylon::Table> table, sorted;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+    REQUIRE(table->Sort({{0, true}, {1, false, true}, {2, true}}, sorted).is_ok());
+
+    std::shared_ptr<arrow::Table> sorted_table;
+    REQUIRE(sorted->ToArrowTable(sorted_table).is_ok());
+    REQUIRE(sorted_table->num_rows() == rows);
+    auto c0 = std::static_pointer_cast<arrow::Int64Array>(sorted_table->column(0)->chunk(0));
+    auto c1 = std::static_pointer_cast<arrow::StringArray>(sorted_table->column(1)->chunk(0));
+    auto c2 = std::static_pointer_cast<arrow::Int32Array>(sorted_table->column(2)->chunk(0));
+    for (int64_t i = 1; i < rows; i++) {
+      REQUIRE(c0->Value(i - 1) <= c0->Value(i));
+      if (c0->Value(i - 1) != c0->Value(i)) {
+        continue;
+      }
+      // a null is followed by nulls or values, values are never followed by nulls
+      REQUIRE(!(c1->IsValid(i - 1) && c1->IsNull(i)));
+      if (c1->IsValid(i - 1) && c1->IsValid(i)) {
+        REQUIRE(c1->GetString(i - 1) >= c1->GetString(i));
+        if (c1->GetString(i - 1) != c1->GetString(i)) {
+          continue;
+        }
+      } else if (c1->IsNull(i - 1) != c1->IsNull(i)) {
+        continue;
+      }
+      REQUIRE(c2->Value(i - 1) < c2->Value(i));
+    }
+  }
+
+  SECTION("testing top k") {
+    const int64_t rows = 5000, k = 100;
+    arrow::Int64Builder builder;
+    for (int64_t i = 0; i < rows; i++) {
+      REQUIRE(builder.Append((i * 7919) % 1000 - 500).ok());
+    }
+    std::shared_ptr<arrow::Array> values;
+    REQUIRE(builder.Finish(&values).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64())}), {values});
+    std::shared_ptr<cylon::Table> table, sorted, top_k, bottom_k, global_top_k;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+    REQUIRE(table->Sort(0, sorted).is_ok());
+    REQUIRE(table->TopK(0, k, true, top_k).is_ok());
+    REQUIRE(table->TopK(0, k, false, bottom_k).is_ok());
+    REQUIRE(table->DistributedTopK(0, k, true, global_top_k).is_ok());
+
+    std::shared_ptr<arrow::Table> sorted_table, top_k_table, bottom_k_table, global_table;
+    REQUIRE(sorted->ToArrowTable(sorted_table).is_ok());
+    REQUIRE(top_k->ToArrowTable(top_k_table).is_ok());
+    REQUIRE(bottom_k->ToArrowTable(bottom_k_table).is_ok());
+    REQUIRE(global_top_k->ToArrowTable(global_table).is_ok());
+    auto sorted_values =
+        std::static_pointer_cast<arrow::Int64Array>(sorted_table->column(0)->chunk(0));
+    auto top_values =
+        std::static_pointer_cast<arrow::Int64Array>(top_k_table->column(0)->chunk(0));
+    auto bottom_values =
+        std::static_pointer_cast<arrow::Int64Array>(bottom_k_table->column(0)->chunk(0));
+    auto global_values =
+        std::static_pointer_cast<arrow::Int64Array>(global_table->column(0)->chunk(0));
+    REQUIRE(top_values->length() == k);
+    REQUIRE(bottom_values->length() == k);
+    REQUIRE(global_values->length() == k);
+    for (int64_t i = 0; i < k; i++) {
+      REQUIRE(top_values->Value(i) == sorted_values->Value(i));
+      REQUIRE(bottom_values->Value(i) == sorted_values->Value(rows - 1 - i));
+      // every worker has the same values, so the global top k is not larger than the local one
+      REQUIRE(global_values->Value(i) <= top_values->Value(i));
+      if (i > 0) {
+        REQUIRE(global_values->Value(i - 1) <= global_values->Value(i));
+      }
+    }
+  }
+
+  SECTION("testing streaming shuffle") {
+    // small slices and a small in flight limit, so that the table goes out in many slices
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_SLICE_ROWS_CONFIG, "100");
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_MAX_IN_FLIGHT_BYTES_CONFIG, "1024");
+    const int64_t rows = 3000;
+    arrow::Int64Builder key_builder;
+    arrow::StringBuilder string_builder;
+    for (int64_t i = 0; i < rows; i++) {
+      if (i % 17 == 0) {
+        REQUIRE(key_builder.AppendNull().ok());
+      } else {
+        REQUIRE(key_builder.Append(i % 101).ok());
+      }
+      REQUIRE(string_builder.Append("value " + std::to_string(i)).ok());
+    }
+    std::shared_ptr<arrow::Array> keys, strings;
+    REQUIRE(key_builder.Finish(&keys).ok());
+    REQUIRE(string_builder.Finish(&strings).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64()), arrow::field("col1", arrow::utf8())}),
+        {keys, strings});
+    std::shared_ptr<cylon::Table> table, shuffled;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+    REQUIRE(cylon::Table::Shuffle(table, {0}, shuffled).is_ok());
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_SLICE_ROWS_CONFIG, std::to_string(1 << 20));
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_MAX_IN_FLIGHT_BYTES_CONFIG,
+                   std::to_string(256LL << 20));
+
+    // every row is at the worker of its hash, and no rows are lost
+    const int world_size = ctx->GetWorldSize();
+    std::shared_ptr<std::vector<uint64_t>> hashes;
+    REQUIRE(shuffled->GetRowHashes({0}, &hashes).is_ok());
+    for (auto hash : *hashes) {
+      REQUIRE(hash % world_size == static_cast<uint64_t>(ctx->GetRank()));
+    }
+    int64_t local = shuffled->Rows(), total = 0;
+    REQUIRE(ctx->GetCommunicator()->AllReduce(&local, &total, 1, Int64(),
+                                              net::ReduceOp::SUM).is_ok());
+    REQUIRE(total == rows * world_size);
+  }
+
+  SECTION("testing packed all to all") {
+    const int64_t rows = 2000;
+    arrow::Int64Builder key_builder;
+    arrow::StringBuilder string_builder;
+    for (int64_t i = 0; i < rows; i++) {
+      if (i % 13 == 0) {
+        REQUIRE(key_builder.AppendNull().ok());
+      } else {
+        REQUIRE(key_builder.Append(i).ok());
+      }
+      REQUIRE(string_builder.Append("value " + std::to_string(i)).ok());
+    }
+    std::shared_ptr<arrow::Array> keys, strings;
+    REQUIRE(key_builder.Finish(&keys).ok());
+    REQUIRE(string_builder.Finish(&strings).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64()), arrow::field("col1", arrow::utf8())}),
+        {keys, strings});
+    std::shared_ptr<cylon::Table> table, packed, unpacked;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+
+    // every partition fits in to a packed message, and then none of them
+    ctx->AddConfig(cylon::CylonContext::ALLTOALL_PACK_THRESHOLD_CONFIG, std::to_string(1 << 30));
+    REQUIRE(cylon::Table::Shuffle(table, {0}, packed).is_ok());
+    ctx->AddConfig(cylon::CylonContext::ALLTOALL_PACK_THRESHOLD_CONFIG, "0");
+    REQUIRE(cylon::Table::Shuffle(table, {0}, unpacked).is_ok());
+    ctx->AddConfig(cylon::CylonContext::ALLTOALL_PACK_THRESHOLD_CONFIG, std::to_string(1 << 20));
+
+    REQUIRE(packed->Rows() == unpacked->Rows());
+    std::shared_ptr<cylon::Table> difference;
+    REQUIRE(cylon::Table::Subtract(packed, unpacked, difference).is_ok());
+    REQUIRE(difference->Rows() == 0);
+    int64_t local = packed->Rows(), total = 0;
+    REQUIRE(ctx->GetCommunicator()->AllReduce(&local, &total, 1, Int64(),
+                                              net::ReduceOp::SUM).is_ok());
+    REQUIRE(total == rows * ctx->GetWorldSize());
+  }
+
+  SECTION("testing all to all of small and large buffers") {
+    // the validity and the uint8 buffers are below the size the shared memory channel reads
+    // directly from the sender, the int64 buffers above it. The tables are dropped once inserted
+    // and their memory is reused by the next ones, so a table released before all its buffers
+    // are read shows up as wrong values
+    const int64_t rows = 10000;
+    const int tables = 8;
+    auto schema = arrow::schema({arrow::field("col0", arrow::int64()),
+                                 arrow::field("col1", arrow::uint8())});
+    auto value = [](int source, int target, int k, int64_t i) -> int64_t {
+      return ((source * 16 + target) * 64 + k) * 100000 + i;
+    };
+
+    ctx->AddConfig(cylon::CylonContext::ALLTOALL_PACK_THRESHOLD_CONFIG, "0");
+    auto received = std::make_shared<ReceivedTables>();
+    auto neighbours = ctx->GetNeighbours(true);
+    cylon::ArrowAllToAll all_to_all(ctx, neighbours, neighbours, ctx->GetNextSequence(),
+                                    received, schema);
+    for (int k = 0; k < tables; k++) {
+      for (int target : neighbours) {
+        if (target == RANK) {
+          continue;
+        }
+        arrow::Int64Builder value_builder;
+        arrow::UInt8Builder byte_builder;
+        for (int64_t i = 0; i < rows; i++) {
+          if (i % 5 == 0) {
+            REQUIRE(value_builder.AppendNull().ok());
+          } else {
+            REQUIRE(value_builder.Append(value(RANK, target, k, i)).ok());
+          }
+          REQUIRE(byte_builder.Append(static_cast<uint8_t>(value(RANK, target, k, i))).ok());
+        }
+        std::shared_ptr<arrow::Array> values, bytes;
+        REQUIRE(value_builder.Finish(&values).ok());
+        REQUIRE(byte_builder.Finish(&bytes).ok());
+        REQUIRE(all_to_all.insert(arrow::Table::Make(schema, {values, bytes}), target, k) == 1);
+        all_to_all.isComplete();
+      }
+    }
+    all_to_all.finish();
+    ctx->GetProgressEngine()->Progress(all_to_all);
+    all_to_all.close();
+    ctx->AddConfig(cylon::CylonContext::ALLTOALL_PACK_THRESHOLD_CONFIG, std::to_string(1 << 20));
+
+    REQUIRE(received->tables.size() == static_cast<size_t>((WORLD_SZ - 1) * tables));
+    for (auto &t : received->tables) {
+      const int source = std::get<0>(t), k = std::get<1>(t);
+      std::shared_ptr<arrow::Table> table;
+      REQUIRE(std::get<2>(t)->CombineChunks(arrow::default_memory_pool(), &table).ok());
+      REQUIRE(table->num_rows() == rows);
+      auto values = std::static_pointer_cast<arrow::Int64Array>(table->column(0)->chunk(0));
+      auto bytes = std::static_pointer_cast<arrow::UInt8Array>(table->column(1)->chunk(0));
+      int64_t wrong = 0;
+      for (int64_t i = 0; i < rows; i++) {
+        const int64_t expected = value(source, RANK, k, i);
+        if (values->IsNull(i) != (i % 5 == 0) || (i % 5 != 0 && values->Value(i) != expected)
+            || bytes->Value(i) != static_cast<uint8_t>(expected)) {
+          wrong++;
+        }
+      }
+      REQUIRE(wrong == 0);
+    }
+  }
+
+  SECTION("testing shuffle with backpressure") {
+    const int64_t rows = 3000;
+    arrow::Int64Builder key_builder;
+    for (int64_t i = 0; i < rows; i++) {
+      REQUIRE(key_builder.Append(i).ok());
+    }
+    std::shared_ptr<arrow::Array> keys;
+    REQUIRE(key_builder.Finish(&keys).ok());
+    auto arrow_table = arrow::Table::Make(arrow::schema({arrow::field("col0", arrow::int64())}),
+                                          {keys});
+    std::shared_ptr<cylon::Table> table, limited, unlimited;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+
+    // the slices are not throttled by the shuffle, so the targets reject most of the partitions
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_SLICE_ROWS_CONFIG, "100");
+    ctx->AddConfig(cylon::CylonContext::ALLTOALL_MAX_TARGET_BYTES_CONFIG, "256");
+    REQUIRE(cylon::Table::Shuffle(table, {0}, limited).is_ok());
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_SLICE_ROWS_CONFIG, std::to_string(1 << 20));
+    ctx->AddConfig(cylon::CylonContext::ALLTOALL_MAX_TARGET_BYTES_CONFIG, "0");
+    REQUIRE(cylon::Table::Shuffle(table, {0}, unlimited).is_ok());
+    ctx->AddConfig(cylon::CylonContext::ALLTOALL_MAX_TARGET_BYTES_CONFIG,
+                   std::to_string(64LL << 20));
+
+    REQUIRE(limited->Rows() == unlimited->Rows());
+    std::shared_ptr<cylon::Table> difference;
+    REQUIRE(cylon::Table::Subtract(limited, unlimited, difference).is_ok());
+    REQUIRE(difference->Rows() == 0);
+    int64_t local = limited->Rows(), total = 0;
+    REQUIRE(ctx->GetCommunicator()->AllReduce(&local, &total, 1, Int64(),
+                                              net::ReduceOp::SUM).is_ok());
+    REQUIRE(total == rows * ctx->GetWorldSize());
+  }
+
+  SECTION("testing chunked shuffle") {
+    const int64_t rows = 2000;
+    arrow::Int64Builder key_builder;
+    for (int64_t i = 0; i < rows; i++) {
+      REQUIRE(key_builder.Append(i).ok());
+    }
+    std::shared_ptr<arrow::Array> keys;
+    REQUIRE(key_builder.Finish(&keys).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64())}), {keys});
+    std::shared_ptr<cylon::Table> table, shuffled;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+
+    // small receive regions, so that the partitions are spread over several of them
+    ctx->AddConfig(cylon::CylonContext::ALLTOALL_RECEIVE_REGION_BYTES_CONFIG, "4096");
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_COMBINE_CHUNKS_CONFIG, "false");
+    REQUIRE(cylon::Table::Shuffle(table, {0}, shuffled).is_ok());
+    ctx->AddConfig(cylon::CylonContext::ALLTOALL_RECEIVE_REGION_BYTES_CONFIG,
+                   std::to_string(8 << 20));
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_COMBINE_CHUNKS_CONFIG, "true");
+
+    std::shared_ptr<arrow::Table> chunked;
+    REQUIRE(shuffled->ToArrowTable(chunked).is_ok());
+    int64_t local = 0, total = 0;
+    for (const auto &chunk : chunked->column(0)->chunks()) {
+      auto values = std::static_pointer_cast<arrow::Int64Array>(chunk);
+      for (int64_t i = 0; i < values->length(); i++) {
+        REQUIRE(values->Value(i) >= 0);
+        REQUIRE(values->Value(i) < rows);
+      }
+      local += values->length();
+    }
+    REQUIRE(local == shuffled->Rows());
+    REQUIRE(ctx->GetCommunicator()->AllReduce(&local, &total, 1, Int64(),
+                                              net::ReduceOp::SUM).is_ok());
+    REQUIRE(total == rows * ctx->GetWorldSize());
+  }
+
+  SECTION("testing operations on chunked shuffle output") {
+    // keys and key * 10, every worker has the same keys
+    const int64_t rows = 2000;
+    arrow::Int64Builder key_builder, value_builder;
+    for (int64_t i = 0; i < rows; i++) {
+      REQUIRE(key_builder.Append(i).ok());
+      REQUIRE(value_builder.Append(i * 10).ok());
+    }
+    std::shared_ptr<arrow::Array> keys, values;
+    REQUIRE(key_builder.Finish(&keys).ok());
+    REQUIRE(value_builder.Finish(&values).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64()), arrow::field("col1", arrow::int64())}),
+        {keys, values});
+    std::shared_ptr<cylon::Table> left, right, left_shuffled, right_shuffled;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &left).is_ok());
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &right).is_ok());
+
+    // every slice of the shuffle is a chunk of the output, even with a single worker
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_SLICE_ROWS_CONFIG, "100");
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_COMBINE_CHUNKS_CONFIG, "false");
+    REQUIRE(cylon::Table::Shuffle(left, {0}, left_shuffled).is_ok());
+    REQUIRE(cylon::Table::Shuffle(right, {0}, right_shuffled).is_ok());
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_SLICE_ROWS_CONFIG, std::to_string(1 << 20));
+    ctx->AddConfig(cylon::CylonContext::SHUFFLE_COMBINE_CHUNKS_CONFIG, "true");
+    REQUIRE(left_shuffled->get_table()->column(0)->num_chunks() > 1);
+    REQUIRE(right_shuffled->get_table()->column(1)->num_chunks() > 1);
+    const int64_t world_size = ctx->GetWorldSize();
+
+    // the shuffle puts the same keys on the same worker, so the local joins give all the pairs
+    for (auto algorithm : {cylon::join::config::JoinAlgorithm::SORT,
+                           cylon::join::config::JoinAlgorithm::HASH}) {
+      std::shared_ptr<cylon::Table> joined;
+      REQUIRE(cylon::Table::Join(left_shuffled, right_shuffled,
+                                 join::config::JoinConfig::InnerJoin(0, 0, algorithm),
+                                 &joined).is_ok());
+      std::shared_ptr<arrow::Table> joined_table;
+      REQUIRE(joined->ToArrowTable(joined_table).is_ok());
+      REQUIRE(joined_table->CombineChunks(arrow::default_memory_pool(), &joined_table).ok());
+      int64_t local = joined_table->num_rows(), total = 0;
+      if (local > 0) {
+        std::shared_ptr<arrow::Int64Array> columns[4];
+        for (int c = 0; c < 4; c++) {
+          columns[c] = std::static_pointer_cast<arrow::Int64Array>(
+              joined_table->column(c)->chunk(0));
+        }
+        for (int64_t i = 0; i < local; i++) {
+          REQUIRE(columns[0]->Value(i) == columns[2]->Value(i));
+          REQUIRE(columns[1]->Value(i) == columns[0]->Value(i) * 10);
+          REQUIRE(columns[3]->Value(i) == columns[2]->Value(i) * 10);
+        }
+      }
+      REQUIRE(ctx->GetCommunicator()->AllReduce(&local, &total, 1, Int64(),
+                                                net::ReduceOp::SUM).is_ok());
+      REQUIRE(total == rows * world_size * world_size);
+    }
+
+    // the distributed join partitions the chunked tables again
+    std::shared_ptr<cylon::Table> joined;
+    REQUIRE(cylon::Table::DistributedJoin(
+        left_shuffled, right_shuffled,
+        join::config::JoinConfig::InnerJoin(0, 0, cylon::join::config::JoinAlgorithm::HASH),
+        &joined).is_ok());
+    int64_t local = joined->Rows(), total = 0;
+    REQUIRE(ctx->GetCommunicator()->AllReduce(&local, &total, 1, Int64(),
+                                              net::ReduceOp::SUM).is_ok());
+    REQUIRE(total == rows * world_size * world_size);
+
+    // the sort and the set operations read all the chunks
+    std::shared_ptr<cylon::Table> sorted;
+    REQUIRE(left_shuffled->Sort(0, sorted).is_ok());
+    REQUIRE(sorted->Rows() == left_shuffled->Rows());
+    std::shared_ptr<cylon::Table> difference;
+    REQUIRE(cylon::Table::Subtract(left_shuffled, right_shuffled, difference).is_ok());
+    REQUIRE(difference->Rows() == 0);
+    std::shared_ptr<cylon::Table> selected;
+    REQUIRE(left_shuffled->Select([](cylon::Row row) {
+      return row.GetInt64(1) == row.GetInt64(0) * 10;
+    }, selected).is_ok());
+    REQUIRE(selected->Rows() == left_shuffled->Rows());
+  }
+
+  SECTION("testing progress strategies") {
+    const int64_t rows = 1000;
+    arrow::Int64Builder key_builder;
+    for (int64_t i = 0; i < rows; i++) {
+      REQUIRE(key_builder.Append(i).ok());
+    }
+    std::shared_ptr<arrow::Array> keys;
+    REQUIRE(key_builder.Finish(&keys).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64())}), {keys});
+    std::shared_ptr<cylon::Table> table;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+
+    ctx->AddConfig(cylon::CylonContext::PROGRESS_SPINS_CONFIG, "10");
+    for (const std::string strategy : {"spin", "yield", "block"}) {
+      for (const std::string thread : {"false", "true"}) {
+        ctx->AddConfig(cylon::CylonContext::PROGRESS_STRATEGY_CONFIG, strategy);
+        ctx->AddConfig(cylon::CylonContext::PROGRESS_THREAD_CONFIG, thread);
+        std::shared_ptr<cylon::Table> shuffled;
+        REQUIRE(cylon::Table::Shuffle(table, {0}, shuffled).is_ok());
+        int64_t local = shuffled->Rows(), total = 0;
+        REQUIRE(ctx->GetCommunicator()->AllReduce(&local, &total, 1, Int64(),
+                                                  net::ReduceOp::SUM).is_ok());
+        REQUIRE(total == rows * ctx->GetWorldSize());
+      }
+    }
+    ctx->AddConfig(cylon::CylonContext::PROGRESS_STRATEGY_CONFIG, "yield");
+    ctx->AddConfig(cylon::CylonContext::PROGRESS_THREAD_CONFIG, "false");
+    ctx->AddConfig(cylon::CylonContext::PROGRESS_SPINS_CONFIG, "1000");
+  }
+
+  SECTION("testing progress engine") {
+    // only the blocking strategy waits for events, after the spins
+    for (bool thread : {false, true}) {
+      for (auto strategy : {net::ProgressStrategy::SPIN, net::ProgressStrategy::SPIN_YIELD,
+                            net::ProgressStrategy::BLOCKING}) {
+        net::ProgressEngine engine(strategy, thread, 10);
+        IdleOperation operation(100);
+        engine.Progress(operation);
+        REQUIRE(operation.passes_ == 100);
+        if (strategy == net::ProgressStrategy::BLOCKING) {
+          REQUIRE(operation.waits_ == 89);
+          REQUIRE(engine.IdleTimeNanos() >= 89 * 100000);
+        } else {
+          REQUIRE(operation.waits_ == 0);
+          REQUIRE(engine.IdleTimeNanos() > 0);
+        }
+      }
+    }
+
+    // the progress thread drives the operation while the caller keeps working
+    {
+      net::ProgressEngine engine(net::ProgressStrategy::SPIN_YIELD, true, 10);
+      IdleOperation operation(INT32_MAX);
+      std::future<void> progress = engine.StartProgress(operation);
+      REQUIRE(progress.wait_for(std::chrono::milliseconds(10)) == std::future_status::timeout);
+      operation.Complete();
+      progress.get();
+      REQUIRE(operation.passes_ > 0);
+      REQUIRE(operation.thread_ != std::this_thread::get_id());
+    }
+
+    // without the progress thread the loop runs on the caller when it waits
+    {
+      net::ProgressEngine engine(net::ProgressStrategy::SPIN, false, 10);
+      IdleOperation operation(3);
+      std::future<void> progress = engine.StartProgress(operation);
+      REQUIRE(operation.passes_ == 0);
+      progress.get();
+      REQUIRE(operation.passes_ == 3);
+      REQUIRE(operation.thread_ == std::this_thread::get_id());
+    }
+  }
+
+  SECTION("testing distributed sort") {
+    // heavy duplicates, every worker has the same values
+    const int64_t rows = 5000;
+    arrow::Int64Builder builder;
+    for (int64_t i = 0; i < rows; i++) {
+      REQUIRE(builder.Append(i % 10 == 0 ? 42 : (i * 7919) % 1000 - 500).ok());
+    }
+    std::shared_ptr<arrow::Array> values;
+    REQUIRE(builder.Finish(&values).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64())}), {values});
+    std::shared_ptr<cylon::Table> table, sorted;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+    REQUIRE(table->DistributedSort(0, sorted).is_ok());
+
+    std::shared_ptr<arrow::Table> sorted_table;
+    REQUIRE(sorted->ToArrowTable(sorted_table).is_ok());
+    auto sorted_values =
+        std::static_pointer_cast<arrow::Int64Array>(sorted_table->column(0)->chunk(0));
+    for (int64_t i = 1; i < sorted_values->length(); i++) {
+      REQUIRE(sorted_values->Value(i - 1) <= sorted_values->Value(i));
+    }
+
+    // no rows are lost and the ranges of the workers are in order
+    const int world_size = ctx->GetWorldSize();
+    int64_t local[3] = {sorted_values->length(), INT64_MAX, INT64_MIN};
+    if (sorted_values->length() > 0) {
+      local[1] = sorted_values->Value(0);
+      local[2] = sorted_values->Value(sorted_values->length() - 1);
+    }
+    std::vector<int64_t> all(3 * world_size);
+    REQUIRE(ctx->GetCommunicator()->Allgather(local, 3, all.data(), Int64()).is_ok());
+    int64_t total = 0, previous_max = INT64_MIN;
+    for (int i = 0; i < world_size; i++) {
+      total += all[3 * i];
+      if (all[3 * i] > 0) {
+        REQUIRE(previous_max <= all[3 * i + 1]);
+        previous_max = all[3 * i + 2];
+      }
+    }
+    REQUIRE(total == rows * world_size);
+  }
+
+  SECTION("testing distributed sort - duplicate keys") {
+    // most of the rows share one key, a splitter on the value alone would send them to one worker
+    const int64_t rows = 5000;
+    const int64_t heavy_key = 42;
+    arrow::Int64Builder builder;
+    for (int64_t i = 0; i < rows; i++) {
+      REQUIRE(builder.Append(i % 5 == 0 ? i % 1000 : heavy_key).ok());
+    }
+    std::shared_ptr<arrow::Array> values;
+    REQUIRE(builder.Finish(&values).ok());
+    auto arrow_table = arrow::Table::Make(
+        arrow::schema({arrow::field("col0", arrow::int64())}), {values});
+    std::shared_ptr<cylon::Table> table, sorted;
+    REQUIRE(cylon::Table::FromArrowTable(ctx, arrow_table, &table).is_ok());
+    REQUIRE(table->DistributedSort(0, sorted).is_ok());
+
+    std::shared_ptr<arrow::Table> sorted_table;
+    REQUIRE(sorted->ToArrowTable(sorted_table).is_ok());
+    REQUIRE(sorted_table->column(0)->num_chunks() <= 1);
+    int64_t local[4] = {0, 0, INT64_MAX, INT64_MIN};
+    if (sorted_table->num_rows() > 0) {
+      auto sorted_values =
+          std::static_pointer_cast<arrow::Int64Array>(sorted_table->column(0)->chunk(0));
+      for (int64_t i = 0; i < sorted_values->length(); i++) {
+        if (i > 0) {
+          REQUIRE(sorted_values->Value(i - 1) <= sorted_values->Value(i));
+        }
+        local[1] += sorted_values->Value(i) == heavy_key ? 1 : 0;
+      }
+      local[0] = sorted_values->length();
+      local[2] = sorted_values->Value(0);
+      local[3] = sorted_values->Value(sorted_values->length() - 1);
+    }
+    const int world_size = ctx->GetWorldSize();
+    std::vector<int64_t> all(4 * world_size);
+    REQUIRE(ctx->GetCommunicator()->Allgather(local, 4, all.data(), Int64()).is_ok());
+
+    int64_t total = 0, heavy_total = 0, heavy_workers = 0, previous_max = INT64_MIN;
+    for (int i = 0; i < world_size; i++) {
+      total += all[4 * i];
+      heavy_total += all[4 * i + 1];
+      heavy_workers += all[4 * i + 1] > 0 ? 1 : 0;
+      if (all[4 * i] > 0) {
+        REQUIRE(previous_max <= all[4 * i + 2]);
+        previous_max = all[4 * i + 3];
+      }
+    }
+    REQUIRE(total == rows * world_size);
+    REQUIRE(heavy_total == rows * world_size * 4 / 5);
+    // regular sampling bounds every worker by twice its fair share, even for the duplicated key
+    for (int i = 0; i < world_size; i++) {
+      REQUIRE(all[4 * i] <= 2 * total / world_size);
+    }
+    if (world_size > 1) {
+      REQUIRE(heavy_workers > 1);
+    }
+  }
 }
@@ -0,0 +1,283 @@
+/*
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <net/tcp/tcp_channel.hpp>
+#include <algorithm>
+#include <thread>
+#include "test_header.hpp"
+
+using namespace cylon;
+
+/**
+ * Receive buffer of the test channels
+ */
+class TestBuffer : public Buffer {
+ public:
+  explicit TestBuffer(int64_t length) : data(length) {}
+
+  int64_t GetLength() override {
+    return static_cast<int64_t>(data.size());
+  }
+
+  uint8_t *GetByteBuffer() override {
+    return data.data();
+  }
+
+  std::vector<uint8_t> data;
+};
+
+struct TestMessage {
+  std::vector<int> header;
+  std::vector<uint8_t> data;
+};
+
+/**
+ * A TCP channel to all the workers of a communicator, keeping the received messages of each
+ * source and the completed sends of each target in their order
+ */
+class TestChannel : public ChannelReceiveCallback, public ChannelSendCallback, public Allocator {
+ public:
+  TestChannel(net::TCPCommunicator *comm, int edge, int64_t max_queued_bytes)
+      : channel(comm, max_queued_bytes), world_size(comm->GetWorldSize()),
+        received(world_size), completed(world_size), finished(world_size, false) {
+    std::vector<int> workers;
+    for (int i = 0; i < world_size; i++) {
+      workers.push_back(i);
+    }
+    channel.init(edge, workers, workers, this, this, this);
+  }
+
+  Status Allocate(int64_t length, std::shared_ptr<Buffer> *buffer) override {
+    *buffer = std::make_shared<TestBuffer>(length);
+    return Status::OK();
+  }
+
+  void receivedHeader(int source, int fin, int *header, int header_length) override {
+    if (fin) {
+      REQUIRE_FALSE(finished[source]);
+      finished[source] = true;
+      return;
+    }
+    received[source].push_back(TestMessage{std::vector<int>(header, header + header_length), {}});
+    delete[] header;
+  }
+
+  void receivedData(int source, std::shared_ptr<Buffer> buffer, int length) override {
+    REQUIRE_FALSE(received[source].empty());
+    received[source].back().data.assign(buffer->GetByteBuffer(),
+                                        buffer->GetByteBuffer() + length);
+  }
+
+  void sendComplete(std::shared_ptr<TxRequest> request) override {
+    completed[request->target].push_back(request);
+  }
+
+  void sendFinishComplete(std::shared_ptr<TxRequest> request) override {
+    fins_sent++;
+  }
+
+  void Progress() {
+    uint64_t events = channel.events();
+    channel.progressSends();
+    channel.progressReceives();
+    if (events == channel.events()) {
+      channel.waitForEvents();
+    }
+  }
+
+  /**
+   * Send the message, progressing the channel while it is rejected
+   * @return number of times the message is rejected
+   */
+  int Send(const std::shared_ptr<TxRequest> &request) {
+    int rejected = 0;
+    while (channel.send(request) != 1) {
+      rejected++;
+      Progress();
+    }
+    return rejected;
+  }
+
+  /**
+   * Finish the sends to every worker and wait for the finish of every worker
+   */
+  void Finish() {
+    for (int i = 0; i < world_size; i++) {
+      REQUIRE(channel.sendFin(std::make_shared<TxRequest>(i)) == 1);
+    }
+    while (fins_sent < world_size
+        || std::find(finished.begin(), finished.end(), false) != finished.end()) {
+      Progress();
+    }
+    channel.close();
+  }
+
+  TCPChannel channel;
+  int world_size;
+  std::vector<std::vector<TestMessage>> received;
+  std::vector<std::vector<std::shared_ptr<TxRequest>>> completed;
+  std::vector<bool> finished;
+  int fins_sent = 0;
+};
+
+static uint8_t MessageByte(int source, int index, int64_t i) {
+  return static_cast<uint8_t>(source * 31 + index * 7 + i);
+}
+
+/**
+ * Messages of a source with every header length, including empty messages, a message larger than
+ * the socket buffers and a last one that may be rejected behind it
+ */
+static const std::vector<int64_t> MESSAGE_LENGTHS = {0, 1, 100, 0, 4096, (1 << 16) + 3,
+                                                     (8 << 20) + 5, 1000};
+
+static std::vector<uint8_t> MessageData(int source, int index) {
+  std::vector<uint8_t> data(MESSAGE_LENGTHS[index]);
+  for (int64_t i = 0; i < MESSAGE_LENGTHS[index]; i++) {
+    data[i] = MessageByte(source, index, i);
+  }
+  return data;
+}
+
+static std::vector<int> MessageHeader(int source, int index) {
+  std::vector<int> header;
+  for (int j = 0; j < index % 7; j++) {
+    header.push_back(source * 1000 + index * 10 + j);
+  }
+  return header;
+}
+
+/**
+ * Send the messages of this worker to every worker and check the messages of every worker
+ * @param source_ranks world rank of each worker of the communicator, the source of the data
+ * @return number of times the sends are rejected
+ */
+static int ExchangeMessages(TestChannel *test, int rank, const std::vector<int> &source_ranks) {
+  const int world_size = test->world_size;
+  const int messages = static_cast<int>(MESSAGE_LENGTHS.size());
+  const int me = source_ranks[rank];
+  // the data is read until the sends complete, the same data goes to every worker
+  std::vector<std::vector<uint8_t>> data;
+  for (int index = 0; index < messages; index++) {
+    data.push_back(MessageData(me, index));
+  }
+  int rejected = 0;
+  for (int index = 0; index < messages; index++) {
+    std::vector<int> header = MessageHeader(me, index);
+    for (int target = 0; target < world_size; target++) {
+      rejected += test->Send(std::make_shared<TxRequest>(
+          target, data[index].data(), static_cast<int>(data[index].size()), header.data(),
+          static_cast<int>(header.size())));
+    }
+  }
+  test->Finish();
+
+  for (int worker = 0; worker < world_size; worker++) {
+    // the sends complete in their order
+    REQUIRE(test->completed[worker].size() == MESSAGE_LENGTHS.size());
+    for (int index = 0; index < messages; index++) {
+      REQUIRE(test->completed[worker][index]->length == MESSAGE_LENGTHS[index]);
+    }
+    // and are received in their order
+    const int source = source_ranks[worker];
+    REQUIRE(test->received[worker].size() == MESSAGE_LENGTHS.size());
+    for (int index = 0; index < messages; index++) {
+      REQUIRE(test->received[worker][index].header == MessageHeader(source, index));
+      REQUIRE(test->received[worker][index].data == MessageData(source, index));
+    }
+  }
+  return rejected;
+}
+
+TEST_CASE("TCP channel testing", "[tcp]") {
+  auto comm = std::static_pointer_cast<net::TCPCommunicator>(ctx->GetCommunicator());
+  REQUIRE(comm->GetCommType() == net::CommType::TCP);
+  std::vector<int> ranks;
+  for (int i = 0; i < WORLD_SZ; i++) {
+    ranks.push_back(i);
+  }
+
+  SECTION("testing frames of a channel") {
+    TestChannel test(comm.get(), ctx->GetNextSequence(), TCPChannel::DEFAULT_MAX_QUEUED_BYTES);
+    ExchangeMessages(&test, RANK, ranks);
+  }
+
+  SECTION("testing sends rejected by the queue limits") {
+    // the large message waits for the queue to drain and is then sent alone
+    TestChannel test(comm.get(), ctx->GetNextSequence(), 1 << 20);
+    REQUIRE(ExchangeMessages(&test, RANK, ranks) > 0);
+
+    // the messages are only written by a progress, so the queue of a target fills up
+    TestChannel count(comm.get(), ctx->GetNextSequence(), 0);
+    const int target = (RANK + 1) % WORLD_SZ;
+    int accepted = 0;
+    while (accepted < 2000 && count.channel.send(std::make_shared<TxRequest>(target)) == 1) {
+      accepted++;
+    }
+    REQUIRE(accepted == 1001);
+    count.Finish();
+    REQUIRE(count.completed[target].size() == 1001);
+    REQUIRE(count.received[(RANK + WORLD_SZ - 1) % WORLD_SZ].size() == 1001);
+  }
+
+  SECTION("testing messages of a channel created late") {
+    // the others send before this channel exists here, their connections wait for it
+    const int edge = ctx->GetNextSequence();
+    if (RANK != 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    TestChannel test(comm.get(), edge, TCPChannel::DEFAULT_MAX_QUEUED_BYTES);
+    ExchangeMessages(&test, RANK, ranks);
+
+    // the connections carry the collectives after the parked messages
+    int64_t one = 1, total = 0;
+    REQUIRE(comm->AllReduce(&one, &total, 1, Int64(), net::ReduceOp::SUM).is_ok());
+    REQUIRE(total == WORLD_SZ);
+  }
+
+  SECTION("testing channels of groups") {
+    // the even and the odd workers, both groups use the same edge over the same connections
+    auto group = std::static_pointer_cast<net::TCPCommunicator>(comm->Split(RANK % 2, RANK));
+    REQUIRE(group != nullptr);
+    std::vector<int> members;
+    for (int i = RANK % 2; i < WORLD_SZ; i += 2) {
+      members.push_back(i);
+    }
+    REQUIRE(group->GetWorldSize() == static_cast<int>(members.size()));
+    REQUIRE(group->GetRank() == RANK / 2);
+
+    const int edge = ctx->GetNextSequence();
+    TestChannel test(group.get(), edge, TCPChannel::DEFAULT_MAX_QUEUED_BYTES);
+    ExchangeMessages(&test, group->GetRank(), members);
+    group->Barrier();
+    group->Finalize();
+  }
+
+  SECTION("testing barrier") {
+    // the barrier waits for the last worker
+    if (RANK == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    }
+    auto start = std::chrono::steady_clock::now();
+    comm->Barrier();
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    if (RANK != 0) {
+      REQUIRE(waited >= 200);
+    }
+    for (int i = 0; i < 50; i++) {
+      comm->Barrier();
+    }
+  }
+}
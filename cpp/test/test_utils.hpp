@@ -50,6 +50,33 @@ static int Verify(std::shared_ptr<cylon::CylonContext> &ctx, std::shared_ptr<Tab
   }
 }
 
+/**
+ * Compare the result with the expected result over all the workers, for operations that do not
+ * leave the rows of the result on the workers of the expected files
+ */
+static int VerifyGlobally(std::shared_ptr<cylon::CylonContext> &ctx,
+                          std::shared_ptr<Table> &result,
+                          std::shared_ptr<Table> &expected_result) {
+  Status status;
+  std::shared_ptr<Table> missing, extra;
+  if (!(status = cylon::Table::DistributedSubtract(expected_result, result, missing)).is_ok()
+      || !(status = cylon::Table::DistributedSubtract(result, expected_result, extra)).is_ok()) {
+    LOG(ERROR) << "subtract FAIL! " << status.get_msg();
+    return 1;
+  }
+  int64_t local[4] = {result->Rows(), expected_result->Rows(), missing->Rows(), extra->Rows()};
+  int64_t global[4] = {0, 0, 0, 0};
+  status = ctx->GetCommunicator()->AllReduce(local, global, 4, cylon::Int64(),
+                                             cylon::net::ReduceOp::SUM);
+  if (!status.is_ok() || global[0] != global[1] || global[2] != 0 || global[3] != 0) {
+    LOG(ERROR) << "verification FAIL! expected:" << global[1] << " found:" << global[0]
+               << " missing:" << global[2] << " extra:" << global[3];
+    return 1;
+  }
+  LOG(INFO) << "verification SUCCESS!";
+  return 0;
+}
+
 typedef Status(*fun_ptr)(std::shared_ptr<Table> &,
                          std::shared_ptr<Table> &,
                          std::shared_ptr<Table> &);
@@ -117,11 +144,17 @@ int TestSetOperation(fun_ptr fn,
 #endif
 }
 
+/**
+ * Join the tables of the paths and compare the result with the expected result of out_path
+ * @param verify_globally compare the results of all the workers together, instead of the result
+ * of each worker with its expected result
+ */
 int TestJoinOperation(const cylon::join::config::JoinConfig &join_config,
 					  std::shared_ptr<cylon::CylonContext> &ctx,
                       const std::string &path1,
                       const std::string &path2,
-                      const std::string &out_path) {
+                      const std::string &out_path,
+                      bool verify_globally = false) {
   Status status;
   std::shared_ptr<cylon::Table> table1, table2, joined_expected, joined, verification;
 
@@ -166,7 +199,8 @@ int TestJoinOperation(const cylon::join::config::JoinConfig &join_config,
             << "[ms]";
 
 #if EXECUTE
-  if (test::Verify(ctx, joined, joined_expected)) {
+  if (verify_globally ? test::VerifyGlobally(ctx, joined, joined_expected)
+                      : test::Verify(ctx, joined, joined_expected)) {
     LOG(ERROR) << "join failed!";
     return 1;
   }
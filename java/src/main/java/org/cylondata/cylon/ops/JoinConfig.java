@@ -27,7 +27,7 @@ public class JoinConfig {
    * Types of join algorithms
    */
   public enum Algorithm {
-    SORT, HASH
+    SORT, HASH, RADIX_HASH
   }
 
   /**
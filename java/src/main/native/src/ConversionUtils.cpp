@@ -6,6 +6,7 @@ std::unordered_map<int32_t, std::shared_ptr<cylon::CylonContext>> contexts{};
 
 std::unordered_map<std::string, cylon::join::config::JoinAlgorithm> join_algorithms{
     std::pair<std::string, cylon::join::config::JoinAlgorithm>("HASH", cylon::join::config::JoinAlgorithm::HASH),
+    std::pair<std::string, cylon::join::config::JoinAlgorithm>("RADIX_HASH", cylon::join::config::JoinAlgorithm::RADIX_HASH),
     std::pair<std::string, cylon::join::config::JoinAlgorithm>("SORT", cylon::join::config::JoinAlgorithm::SORT)
 };
 
@@ -22,4 +22,5 @@ cdef extern from "../../../cpp/src/cylon/net/comm_type.hpp" namespace "cylon::ne
         _LOCAL 'cylon::net::CommType::LOCAL'
         _MPI 'cylon::net::CommType::MPI'
         _TCP 'cylon::net::CommType::TCP'
-        _UCX 'cylon::net::CommType::UCX'
\ No newline at end of file
+        _UCX 'cylon::net::CommType::UCX'
+        _SHM 'cylon::net::CommType::SHM'
\ No newline at end of file
@@ -17,4 +17,5 @@ from pycylon.net.comm_type import CommType
 assert CommType.LOCAL.value == 0
 assert CommType.MPI.value == 1
 assert CommType.TCP.value == 2
-assert CommType.UCX.value == 3
\ No newline at end of file
+assert CommType.UCX.value == 3
+assert CommType.SHM.value == 4
\ No newline at end of file